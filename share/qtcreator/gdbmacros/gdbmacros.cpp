@@ -98,6 +98,8 @@
 #include <set>
 #include <vector>
 
+#include <stdlib.h>
+
 #ifdef QT_BOOTSTRAPPED
 
 #   define NS ""
@@ -509,6 +511,15 @@ struct QDumper
     const char *innerType; // 'inner type' for class templates
     const void *data;      // pointer to raw data
     bool dumpChildren;     // do we want to see children?
+    int childrenStart;     // first child wanted by the frontend, -1 for all
+    int childrenEnd;       // one past the last child wanted by the frontend
+
+    // the window of children of a container with count items to dump
+    bool isPaged() const { return childrenStart >= 0; }
+    void childrenRange(int count, int *begin, int *end);
+    // checksum of the raw bytes of the children in the window, lets the
+    // frontend reuse children of simple types that did not change
+    void putChildrenChecksum(const void *base, int size, int begin, int end);
 
     // handling of nested templates
     void setupTemplateParameters();
@@ -535,6 +546,33 @@ QDumper::QDumper()
     pos = 1;
     currentChildType = 0;
     currentChildNumChild = 0;
+    childrenStart = -1;
+    childrenEnd = -1;
+}
+
+void QDumper::childrenRange(int count, int *begin, int *end)
+{
+    if (!isPaged()) {
+        *begin = 0;
+        *end = qMin(count, 1000);
+        return;
+    }
+    *begin = qMin(childrenStart, count);
+    *end = qMin(qMin(childrenEnd, count), *begin + 1000);
+}
+
+void QDumper::putChildrenChecksum(const void *base, int size, int begin, int end)
+{
+    // The sum of per-child hashes can be extended page by page.
+    const unsigned char *bytes = static_cast<const unsigned char *>(base);
+    unsigned sum = 0;
+    for (int i = begin; i < end; ++i) {
+        unsigned hash = 2166136261u ^ unsigned(i);
+        for (int j = 0; j != size; ++j)
+            hash = (hash ^ bytes[i * size + j]) * 16777619u;
+        sum += hash;
+    }
+    putItem("childrenchecksum", sum);
 }
 
 QDumper::~QDumper()
@@ -1628,7 +1666,8 @@ static void qDumpQList(QDumper &d)
     if (nn < 0)
         return;
     const bool innerTypeIsPointer = isPointerType(d.innerType);
-    const int n = qMin(nn, 1000);
+    int begin, n;
+    d.childrenRange(nn, &begin, &n);
     if (nn > 0) {
         if (pdata.d->begin < 0)
             return;
@@ -1641,16 +1680,23 @@ static void qDumpQList(QDumper &d)
         qCheckAccess(pdata.d->array);
         // Additional checks on pointer arrays
         if (innerTypeIsPointer)
-            for (int i = 0; i != n; ++i)
+            for (int i = begin; i != n; ++i)
                 if (const void *p = pdata.d->array + i + pdata.d->begin)
                     qCheckPointer(deref(p));
     }
 
     d.putItemCount("value", nn);
     d.putItem("valueeditable", "false");
-    d.putItem("numchild", n);
+    d.putItem("numchild", nn);
+    const unsigned innerSize = d.extraInt[0];
+    if (d.isPaged()) {
+        d.putItem("datapointer", pdata.d->array + pdata.d->begin);
+        // Simple values small enough are stored in the list itself.
+        if (isSimpleType(d.innerType) && innerSize <= sizeof(void*))
+            d.putChildrenChecksum(pdata.d->array + pdata.d->begin,
+                sizeof(void*), begin, n);
+    }
     if (d.dumpChildren) {
-        const unsigned innerSize = d.extraInt[0];
         QByteArray strippedInnerType = stripPointerType(d.innerType);
 
         // The exact condition here is:
@@ -1661,8 +1707,10 @@ static void qDumpQList(QDumper &d)
         bool isInternal = innerSize <= int(sizeof(void*))
             && isMovableType(d.innerType);
         d.putItem("internal", (int)isInternal);
-        d.beginChildren(n ? d.innerType : 0);
-        for (int i = 0; i != n; ++i) {
+        if (d.isPaged())
+            d.putItem("childrenstart", begin);
+        d.beginChildren(n > begin ? d.innerType : 0);
+        for (int i = begin; i != n; ++i) {
             d.beginHash();
             if (innerTypeIsPointer) {
                 void *p = pdata.d->array + i + pdata.d->begin;
@@ -1688,7 +1736,7 @@ static void qDumpQList(QDumper &d)
             }
             d.endHash();
         }
-        if (n < nn)
+        if (n < nn && !d.isPaged())
             d.putEllipsis();
         d.endChildren();
     }
@@ -2931,27 +2979,36 @@ static void qDumpQVector(QDumper &d)
         return;
     const bool innerIsPointerType = isPointerType(d.innerType);
     const unsigned innersize = d.extraInt[0];
-    const int n = qMin(nn, 1000);
+    int begin, n;
+    d.childrenRange(nn, &begin, &n);
     // Check pointers
     if (innerIsPointerType && nn > 0)
-        for (int i = 0; i != n; ++i)
+        for (int i = begin; i != n; ++i)
             if (const void *p = addOffset(v, i * innersize + typeddatasize))
                 qCheckPointer(deref(p));
 
-    d.putItemCount("value", n);
+    d.putItemCount("value", nn);
     d.putItem("valueeditable", "false");
     d.putItem("numchild", nn);
+    if (d.isPaged()) {
+        d.putItem("datapointer", addOffset(v, typeddatasize));
+        if (isSimpleType(d.innerType))
+            d.putChildrenChecksum(addOffset(v, typeddatasize),
+                innersize, begin, n);
+    }
     if (d.dumpChildren) {
         QByteArray strippedInnerType = stripPointerType(d.innerType);
         const char *stripped = innerIsPointerType ? strippedInnerType.data() : 0;
+        if (d.isPaged())
+            d.putItem("childrenstart", begin);
         d.beginChildren(d.innerType);
-        for (int i = 0; i != n; ++i) {
+        for (int i = begin; i != n; ++i) {
             d.beginHash();
             qDumpInnerValueOrPointer(d, d.innerType, stripped,
                 addOffset(v, i * innersize + typeddatasize));
             d.endHash();
         }
-        if (n < nn)
+        if (n < nn && !d.isPaged())
             d.putEllipsis();
         d.endChildren();
     }
@@ -3373,25 +3430,31 @@ static void qDumpStdVector(QDumper &d)
         qCheckAccess(v->end_of_storage);
     }
 
-    int n = nn;
-    d.putItemCount("value", n);
+    d.putItemCount("value", nn);
     d.putItem("valueeditable", "false");
-    d.putItem("numchild", n);
+    d.putItem("numchild", nn);
+    const unsigned innersize = d.extraInt[0];
+    int begin, n;
+    d.childrenRange(nn, &begin, &n);
+    if (d.isPaged()) {
+        d.putItem("datapointer", v->start);
+        if (isSimpleType(d.innerType))
+            d.putChildrenChecksum(v->start, innersize, begin, n);
+    }
     if (d.dumpChildren) {
-        unsigned innersize = d.extraInt[0];
         QByteArray strippedInnerType = stripPointerType(d.innerType);
         const char *stripped =
             isPointerType(d.innerType) ? strippedInnerType.data() : 0;
-        if (n > 1000)
-            n = 1000;
-        d.beginChildren(n ? d.innerType : 0);
-        for (int i = 0; i != n; ++i) {
+        if (d.isPaged())
+            d.putItem("childrenstart", begin);
+        d.beginChildren(n > begin ? d.innerType : 0);
+        for (int i = begin; i != n; ++i) {
             d.beginHash();
             qDumpInnerValueOrPointer(d, d.innerType, stripped,
                 addOffset(v->start, i * innersize));
             d.endHash();
         }
-        if (n < nn)
+        if (n < nn && !d.isPaged())
             d.putEllipsis();
         d.endChildren();
     }
@@ -3896,6 +3959,11 @@ void *qDumpObjectData440(
         d.exp       = inbuffer; while (*inbuffer) ++inbuffer; ++inbuffer;
         d.innerType = inbuffer; while (*inbuffer) ++inbuffer; ++inbuffer;
         d.iname     = inbuffer; while (*inbuffer) ++inbuffer; ++inbuffer;
+        // optional window of children, "<start>" and "<end>"
+        if (*inbuffer) {
+            d.childrenStart = atoi(inbuffer); while (*inbuffer) ++inbuffer; ++inbuffer;
+            d.childrenEnd   = atoi(inbuffer); while (*inbuffer) ++inbuffer; ++inbuffer;
+        }
 #if 0
         qDebug() << "data=" << d.data << "dumpChildren=" << d.dumpChildren
                 << " extra=" << d.extraInt[0] << d.extraInt[1]  << d.extraInt[2]  << d.extraInt[3]
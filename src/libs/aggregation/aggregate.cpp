@@ -29,6 +29,7 @@
 
 #include "aggregate.h"
 
+#include <QtCore/QAtomicInt>
 #include <QtCore/QWriteLocker>
 
 /*!
@@ -153,6 +154,12 @@
 
 using namespace Aggregation;
 
+static QAtomicInt &revisionCounter()
+{
+    static QAtomicInt counter;
+    return counter;
+}
+
 /*!
     \fn Aggregate *Aggregate::parentAggregate(QObject *obj)
 
@@ -180,6 +187,58 @@ QReadWriteLock &Aggregate::lock()
     return lock;
 }
 
+QSet<QObject *> &Aggregate::observedObjects()
+{
+    static QSet<QObject *> objects;
+    return objects;
+}
+
+/*!
+    \fn void Aggregate::setObserved(QObject *obj, bool observed)
+
+    Marks \a obj as \a observed: changes of the aggregate that \a obj is
+    or becomes part of, or of \a obj itself if it is an aggregate, are
+    reported by revision(). Changes of other aggregates are not.
+
+    \sa Aggregate::revision()
+*/
+void Aggregate::setObserved(QObject *obj, bool observed)
+{
+    QWriteLocker locker(&lock());
+    if (observed)
+        observedObjects().insert(obj);
+    else
+        observedObjects().remove(obj);
+}
+
+/*!
+    \fn int Aggregate::revision()
+
+    Returns a number that changes whenever components are added to or
+    removed from an aggregate that contains an observed object.
+    Used to invalidate caches of query results over observed objects.
+
+    \sa Aggregate::setObserved()
+*/
+int Aggregate::revision()
+{
+    return revisionCounter();
+}
+
+// Caller holds the lock
+bool Aggregate::isObserved() const
+{
+    const QSet<QObject *> &observed = observedObjects();
+    if (observed.isEmpty())
+        return false;
+    if (observed.contains(const_cast<Aggregate *>(this)))
+        return true;
+    foreach (QObject *component, m_components)
+        if (observed.contains(component))
+            return true;
+    return false;
+}
+
 /*!
     \fn Aggregate::Aggregate(QObject *parent)
 
@@ -202,6 +261,8 @@ Aggregate::Aggregate(QObject *parent)
 Aggregate::~Aggregate()
 {
     QWriteLocker locker(&lock());
+    if (isObserved())
+        revisionCounter().ref();
     foreach (QObject *component, m_components) {
         disconnect(component, SIGNAL(destroyed(QObject*)), this, SLOT(deleteSelf(QObject*)));
         aggregateMap().remove(component);
@@ -215,6 +276,8 @@ void Aggregate::deleteSelf(QObject *obj)
 {
     {
         QWriteLocker locker(&lock());
+        if (isObserved())
+            revisionCounter().ref();
         aggregateMap().remove(obj);
         m_components.removeAll(obj);
     }
@@ -241,6 +304,8 @@ void Aggregate::add(QObject *component)
     m_components.append(component);
     connect(component, SIGNAL(destroyed(QObject*)), this, SLOT(deleteSelf(QObject*)));
     aggregateMap().insert(component, this);
+    if (isObserved())
+        revisionCounter().ref();
 }
 
 /*!
@@ -255,6 +320,8 @@ void Aggregate::remove(QObject *component)
     if (!component)
         return;
     QWriteLocker locker(&lock());
+    if (isObserved())
+        revisionCounter().ref();
     aggregateMap().remove(component);
     m_components.removeAll(component);
     disconnect(component, SIGNAL(destroyed(QObject*)), this, SLOT(deleteSelf(QObject*)));
@@ -35,6 +35,7 @@
 #include <QtCore/QObject>
 #include <QtCore/QList>
 #include <QtCore/QHash>
+#include <QtCore/QSet>
 #include <QtCore/QReadWriteLock>
 #include <QtCore/QReadLocker>
 
@@ -73,12 +74,16 @@ public:
 
     static Aggregate *parentAggregate(QObject *obj);
     static QReadWriteLock &lock();
+    static void setObserved(QObject *obj, bool observed);
+    static int revision();
 
 private slots:
     void deleteSelf(QObject *obj);
 
 private:
     static QHash<QObject *, Aggregate *> &aggregateMap();
+    static QSet<QObject *> &observedObjects();
+    bool isObserved() const;
 
     QList<QObject *> m_components;
 };
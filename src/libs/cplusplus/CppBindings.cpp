@@ -40,6 +40,9 @@
 #include <SymbolVisitor.h>
 
 #include <QtDebug>
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
 
 using namespace CPlusPlus;
 
@@ -61,13 +64,96 @@ Location::Location(StringLiteral *fileId, unsigned sourceLocation)
     : _fileId(fileId), _sourceLocation(sourceLocation)
 { }
 
+////////////////////////////////////////////////////////////////////////////////
+// SymbolIndex
+////////////////////////////////////////////////////////////////////////////////
+
+namespace CPlusPlus {
+
+class SymbolIndex
+{
+public:
+    void insert(Symbol *symbol, Binding *binding)
+    {
+        _bySymbol.insert(symbol, binding);
+        _byLocation.insert(locationKey(symbol), binding);
+    }
+
+    Binding *find(Symbol *symbol, Identifier *id) const
+    {
+        if (Binding *binding = _bySymbol.value(symbol))
+            return binding;
+
+        // The symbol may come from a document that was parsed again from
+        // the same source, e.g. by Find Usages.
+        Binding *binding = _byLocation.value(locationKey(symbol));
+
+        if (! binding)
+            return 0;
+
+        Identifier *bindingId = 0;
+        if (NamespaceBinding *namespaceBinding = binding->asNamespaceBinding())
+            bindingId = namespaceBinding->identifier();
+        else if (ClassBinding *classBinding = binding->asClassBinding())
+            bindingId = classBinding->identifier();
+
+        if (! id || ! bindingId)
+            return id == bindingId ? binding : 0;
+        else if (! id->isEqualTo(bindingId))
+            return 0;
+
+        return binding;
+    }
+
+private:
+    static QByteArray locationKey(Symbol *symbol)
+    {
+        if (! symbol->fileId())
+            return QByteArray();
+
+        QByteArray key(symbol->fileName(), symbol->fileNameLength());
+        key += ':';
+        key += QByteArray::number(symbol->line());
+        key += ':';
+        key += QByteArray::number(symbol->column());
+        return key;
+    }
+
+    QHash<Symbol *, Binding *> _bySymbol;
+    QHash<QByteArray, Binding *> _byLocation;
+};
+
+} // end of namespace CPlusPlus
+
+static void buildSymbolIndex_helper(ClassBinding *binding, SymbolIndex *index)
+{
+    foreach (Class *symbol, binding->symbols)
+        index->insert(symbol, binding);
+
+    foreach (ClassBinding *nestedClassBinding, binding->children)
+        buildSymbolIndex_helper(nestedClassBinding, index);
+}
+
+static void buildSymbolIndex_helper(NamespaceBinding *binding, SymbolIndex *index)
+{
+    foreach (Namespace *symbol, binding->symbols)
+        index->insert(symbol, binding);
+
+    foreach (ClassBinding *classBinding, binding->classBindings)
+        buildSymbolIndex_helper(classBinding, index);
+
+    foreach (NamespaceBinding *nestedBinding, binding->children)
+        buildSymbolIndex_helper(nestedBinding, index);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // NamespaceBinding
 ////////////////////////////////////////////////////////////////////////////////
 
 NamespaceBinding::NamespaceBinding(NamespaceBinding *parent)
     : parent(parent),
-      anonymousNamespaceBinding(0)
+      anonymousNamespaceBinding(0),
+      _symbolIndex(0)
 {
     if (parent)
         parent->children.append(this);
@@ -77,6 +163,91 @@ NamespaceBinding::~NamespaceBinding()
 {
     qDeleteAll(children);
     qDeleteAll(classBindings);
+    delete _symbolIndex;
+}
+
+void NamespaceBinding::buildSymbolIndex()
+{
+    delete _symbolIndex;
+    _symbolIndex = new SymbolIndex;
+    buildSymbolIndex_helper(this, _symbolIndex);
+}
+
+static void clone_helper(ClassBinding *binding, Binding *parentCopy,
+                         QHash<Binding *, Binding *> *copies)
+{
+    ClassBinding *copy;
+    if (NamespaceBinding *namespaceBinding = parentCopy->asNamespaceBinding())
+        copy = new ClassBinding(namespaceBinding);
+    else
+        copy = new ClassBinding(parentCopy->asClassBinding());
+
+    copy->symbols = binding->symbols;
+    copies->insert(binding, copy);
+
+    foreach (ClassBinding *nestedClassBinding, binding->children)
+        clone_helper(nestedClassBinding, copy, copies);
+}
+
+static void clone_helper(NamespaceBinding *binding, NamespaceBinding *parentCopy,
+                         QHash<Binding *, Binding *> *copies)
+{
+    NamespaceBinding *copy = new NamespaceBinding(parentCopy);
+    copy->symbols = binding->symbols;
+    copies->insert(binding, copy);
+
+    foreach (ClassBinding *classBinding, binding->classBindings)
+        clone_helper(classBinding, copy, copies);
+
+    foreach (NamespaceBinding *nestedBinding, binding->children)
+        clone_helper(nestedBinding, copy, copies);
+}
+
+NamespaceBinding *NamespaceBinding::clone() const
+{
+    NamespaceBinding *self = const_cast<NamespaceBinding *>(this);
+    QHash<Binding *, Binding *> copies;
+
+    NamespaceBinding *copy = new NamespaceBinding;
+    copy->symbols = symbols;
+    copies.insert(self, copy);
+
+    foreach (ClassBinding *classBinding, classBindings)
+        clone_helper(classBinding, copy, &copies);
+
+    foreach (NamespaceBinding *nestedBinding, children)
+        clone_helper(nestedBinding, copy, &copies);
+
+    // Now that all bindings exist, point the references at the copies.
+    QHashIterator<Binding *, Binding *> it(copies);
+    while (it.hasNext()) {
+        it.next();
+
+        if (NamespaceBinding *namespaceBinding = it.key()->asNamespaceBinding()) {
+            NamespaceBinding *namespaceCopy = it.value()->asNamespaceBinding();
+
+            if (namespaceBinding->anonymousNamespaceBinding)
+                namespaceCopy->anonymousNamespaceBinding =
+                        copies.value(namespaceBinding->anonymousNamespaceBinding)->asNamespaceBinding();
+
+            foreach (NamespaceBinding *u, namespaceBinding->usings) {
+                if (Binding *usingCopy = copies.value(u))
+                    namespaceCopy->usings.append(usingCopy->asNamespaceBinding());
+            }
+
+        } else if (ClassBinding *classBinding = it.key()->asClassBinding()) {
+            ClassBinding *classCopy = it.value()->asClassBinding();
+
+            foreach (ClassBinding *baseClassBinding, classBinding->baseClassBindings) {
+                ClassBinding *baseClassCopy = 0;
+                if (Binding *b = copies.value(baseClassBinding))
+                    baseClassCopy = b->asClassBinding();
+                classCopy->baseClassBindings.append(baseClassCopy);
+            }
+        }
+    }
+
+    return copy;
 }
 
 NameId *NamespaceBinding::name() const
@@ -567,6 +738,8 @@ Identifier *ClassBinding::identifier() const
 
 namespace {
 
+typedef QList<QPair<QString, Document::Ptr> > IncludeClosure;
+
 ////////////////////////////////////////////////////////////////////////////////
 // Binder
 ////////////////////////////////////////////////////////////////////////////////
@@ -578,26 +751,54 @@ public:
     virtual ~Binder();
 
     NamespaceBinding *operator()(Document::Ptr doc, const Snapshot &snapshot)
+    {
+        QList<Document::Ptr> documents;
+        documents.append(doc);
+        return operator()(documents, snapshot);
+    }
+
+    NamespaceBinding *operator()(const QList<Document::Ptr> &documents, const Snapshot &snapshot)
     {
         namespaceBinding = _globals;
         const Snapshot previousSnapshot = _snapshot;
 
         _snapshot = snapshot;
-        (void) bind(doc);
+        QSet<QString> processed;
+        foreach (Document::Ptr doc, documents)
+            (void) bind(doc, &processed);
         _snapshot = previousSnapshot;
 
         return _globals;
     }
 
-    Snapshot _snapshot;
-
-protected:
-    NamespaceBinding *bind(Document::Ptr doc)
+    // Binds the documents included by \a doc, but not \a doc itself. Every
+    // include looked up in the snapshot is recorded in \a closure.
+    void bindIncludes(Document::Ptr doc, const Snapshot &snapshot, IncludeClosure *closure)
     {
+        namespaceBinding = _globals;
+        const Snapshot previousSnapshot = _snapshot;
+        IncludeClosure *previousClosure = _closure;
+
+        _snapshot = snapshot;
+        _closure = closure;
         QSet<QString> processed;
-        return bind(doc, &processed);
+        processed.insert(doc->fileName());
+        bindIncludes(doc, &processed);
+        _snapshot = previousSnapshot;
+        _closure = previousClosure;
     }
 
+    // Binds the global namespace of \a doc, assuming its includes are
+    // already bound.
+    void bindGlobalNamespace(Document::Ptr doc)
+    {
+        namespaceBinding = _globals;
+        bindGlobalNamespace_helper(doc);
+    }
+
+    Snapshot _snapshot;
+
+protected:
     NamespaceBinding *bind(Document::Ptr doc, QSet<QString> *processed)
     {
         if (processed->contains(doc->fileName()))
@@ -605,12 +806,25 @@ protected:
 
         processed->insert(doc->fileName());
 
+        bindIncludes(doc, processed);
+        return bindGlobalNamespace_helper(doc);
+    }
+
+    void bindIncludes(Document::Ptr doc, QSet<QString> *processed)
+    {
         foreach (const Document::Include &i, doc->includes()) {
-            if (Document::Ptr includedDoc = _snapshot.value(i.fileName())) {
-                /*NamepaceBinding *binding = */ bind(includedDoc, processed);
-            }
+            Document::Ptr includedDoc = _snapshot.value(i.fileName());
+
+            if (_closure)
+                _closure->append(qMakePair(i.fileName(), includedDoc));
+
+            if (includedDoc)
+                (void) bind(includedDoc, processed);
         }
+    }
 
+    NamespaceBinding *bindGlobalNamespace_helper(Document::Ptr doc)
+    {
         Namespace *ns = doc->globalNamespace();
         _globals->symbols.append(ns);
 
@@ -644,12 +858,14 @@ private:
     NamespaceBinding *_globals;
     NamespaceBinding *namespaceBinding;
     ClassBinding *classBinding;
+    IncludeClosure *_closure;
 };
 
 Binder::Binder(NamespaceBinding *globals)
     : _globals(globals),
       namespaceBinding(0),
-      classBinding(0)
+      classBinding(0),
+      _closure(0)
 { }
 
 Binder::~Binder()
@@ -834,22 +1050,137 @@ static ClassBinding *find_helper(Class *symbol, Binding *binding,
 
 NamespaceBinding *NamespaceBinding::find(Namespace *symbol, NamespaceBinding *binding)
 {
+    if (binding && ! binding->parent && binding->_symbolIndex) {
+        if (Binding *b = binding->_symbolIndex->find(symbol, symbol->identifier()))
+            return b->asNamespaceBinding();
+
+        return 0;
+    }
+
     QSet<NamespaceBinding *> processed;
     return find_helper(symbol, binding, &processed);
 }
 
 ClassBinding *NamespaceBinding::find(Class *symbol, NamespaceBinding *binding)
 {
+    if (binding && ! binding->parent && binding->_symbolIndex) {
+        if (Binding *b = binding->_symbolIndex->find(symbol, symbol->identifier()))
+            return b->asClassBinding();
+
+        return 0;
+    }
+
     QSet<Binding *> processed;
     return find_helper(symbol, binding, &processed);
 }
 
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////
+// BindingCache
+////////////////////////////////////////////////////////////////////////////////
+
+// Keeps the bindings of the most recently bound documents. The bindings of
+// the includes are kept apart, so that binding a new revision of a document
+// only has to bind the document itself. Shared trees are never modified.
+class BindingCache
+{
+public:
+    enum { MaxDocuments = 16 };
+
+    struct Entry
+    {
+        QStringList includes;
+        IncludeClosure closure;
+        NamespaceBindingPtr includesBinding;
+        Document::Ptr doc;
+        NamespaceBindingPtr binding;
+    };
+
+    bool find(const QString &fileName, Entry *entry)
+    {
+        QMutexLocker locker(&_mutex);
+
+        if (! _entries.contains(fileName))
+            return false;
+
+        _recent.removeAll(fileName);
+        _recent.append(fileName);
+        *entry = _entries.value(fileName);
+        return true;
+    }
+
+    void insert(const QString &fileName, const Entry &entry)
+    {
+        QMutexLocker locker(&_mutex);
+
+        _recent.removeAll(fileName);
+        _recent.append(fileName);
+        _entries.insert(fileName, entry);
+
+        while (_recent.size() > MaxDocuments)
+            _entries.remove(_recent.takeFirst());
+    }
+
+private:
+    QMutex _mutex;
+    QHash<QString, Entry> _entries;
+    QStringList _recent;
+};
+
+} // end of anonymous namespace
+
+Q_GLOBAL_STATIC(BindingCache, bindingCache)
+
+static QStringList includedFiles(Document::Ptr doc)
+{
+    QStringList files;
+    foreach (const Document::Include &i, doc->includes())
+        files.append(i.fileName());
+    return files;
+}
+
+static bool isValid(const IncludeClosure &closure, const Snapshot &snapshot)
+{
+    for (int i = 0; i < closure.size(); ++i) {
+        const QPair<QString, Document::Ptr> &include = closure.at(i);
+        if (snapshot.value(include.first) != include.second)
+            return false;
+    }
+
+    return true;
+}
+
 NamespaceBindingPtr CPlusPlus::bind(Document::Ptr doc, Snapshot snapshot)
 {
-    NamespaceBindingPtr global(new NamespaceBinding());
+    BindingCache *cache = bindingCache();
+    BindingCache::Entry entry;
+    const QStringList includes = includedFiles(doc);
+
+    if (cache && cache->find(doc->fileName(), &entry)
+            && entry.includes == includes && isValid(entry.closure, snapshot)) {
+        if (entry.doc == doc)
+            return entry.binding;
+    } else {
+        entry.includes = includes;
+        entry.closure.clear();
+        entry.includesBinding = NamespaceBindingPtr(new NamespaceBinding());
+
+        Binder binder(entry.includesBinding.data());
+        binder.bindIncludes(doc, snapshot, &entry.closure);
+    }
+
+    NamespaceBindingPtr global(entry.includesBinding->clone());
+
+    Binder binder(global.data());
+    binder.bindGlobalNamespace(doc);
+    global->buildSymbolIndex();
+
+    entry.doc = doc;
+    entry.binding = global;
+
+    if (cache)
+        cache->insert(doc->fileName(), entry);
 
-    Binder bind(global.data());
-    bind(doc, snapshot);
     return global;
 }
-
@@ -43,6 +43,7 @@ class Location;
 class Binding;
 class NamespaceBinding;
 class ClassBinding;
+class SymbolIndex;
 
 typedef QSharedPointer<Binding> BindingPtr;
 typedef QSharedPointer<ClassBinding> ClassBindingPtr;
@@ -128,6 +129,13 @@ public:
     static NamespaceBinding *find(Namespace *symbol, NamespaceBinding *binding);
     static ClassBinding *find(Class *symbol, NamespaceBinding *binding);
 
+    /// Indexes the namespace and class symbols of this global binding, so
+    /// find() does not walk the tree. Must be called once the tree is complete.
+    void buildSymbolIndex();
+
+    /// Returns a deep copy of this global binding.
+    NamespaceBinding *clone() const;
+
 private:
     NamespaceBinding *findNamespaceBindingForNameId(NameId *name,
                                                     bool lookAtParentNamespace);
@@ -153,6 +161,9 @@ public: // attributes
     QList<Namespace *> symbols;
 
     QList<ClassBinding *> classBindings;
+
+private:
+    SymbolIndex *_symbolIndex;
 };
 
 class CPLUSPLUS_EXPORT ClassBinding: public Binding
@@ -188,6 +199,8 @@ public: // attributes
     QList<ClassBinding *> baseClassBindings;
 };
 
+/// Returns the bindings of the document and its includes. The result is
+/// shared with other callers and must not be modified.
 CPLUSPLUS_EXPORT NamespaceBindingPtr bind(Document::Ptr doc, Snapshot snapshot);
 
 } // end of namespace CPlusPlus
@@ -67,6 +67,11 @@ QList<int> FindUsages::operator()(Symbol *symbol, Identifier *id, AST *ast)
         _exprDoc = Document::create("<references>");
         accept(ast);
     }
+    // The usages of a document are reported at once, so that the
+    // search results are appended in one batch.
+    if (_future && ! _usages.isEmpty())
+        _future->reportResults(_usages);
+    _usages.clear();
     return _references;
 }
 
@@ -121,7 +126,7 @@ void FindUsages::reportResult(unsigned tokenIndex)
     const int len = tk.f.length;
 
     if (_future) {
-        _future->reportResult(Usage(_doc->fileName(), line, lineText, col, len));
+        _usages.append(Usage(_doc->fileName(), line, lineText, col, len));
     }
 
     _references.append(tokenIndex);
@@ -37,6 +37,7 @@
 
 #include <ASTVisitor.h>
 #include <QtCore/QFutureInterface>
+#include <QtCore/QVector>
 
 namespace CPlusPlus {
 
@@ -101,6 +102,7 @@ protected:
 
 private:
     QFutureInterface<Usage> *_future;
+    QVector<Usage> _usages;
     Identifier *_id;
     Symbol *_declSymbol;
     Document::Ptr _doc;
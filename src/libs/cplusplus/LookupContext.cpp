@@ -40,15 +40,131 @@
 #include <Control.h>
 
 #include <QtDebug>
+#include <QHash>
+#include <QSet>
+#include <QMutex>
+#include <QMutexLocker>
 
 using namespace CPlusPlus;
 
+namespace CPlusPlus {
+namespace Internal {
+
+/////////////////////////////////////////////////////////////////////
+// GlobalScopes
+/////////////////////////////////////////////////////////////////////
+class GlobalScopes
+{
+public:
+    GlobalScopes()
+        : _indexed(false)
+    { }
+
+    // The document and the includes (as found in the snapshot, possibly null)
+    // the scopes were built from. Holding the documents keeps the scopes alive.
+    Document::Ptr thisDocument;
+    QList<QPair<QString, Document::Ptr> > includes;
+
+    // The expanded global scopes.
+    QList<Scope *> scopes;
+
+    bool isValid(Document::Ptr doc, const Snapshot &snapshot) const
+    {
+        if (doc != thisDocument)
+            return false;
+
+        for (int i = 0; i < includes.size(); ++i) {
+            const QPair<QString, Document::Ptr> &incl = includes.at(i);
+            if (snapshot.value(incl.first) != incl.second)
+                return false;
+        }
+
+        return true;
+    }
+
+    // The named symbols of all scopes with the given identifier, in the order
+    // a scan of the scopes with Scope::lookat() finds them.
+    QList<Symbol *> symbols(Identifier *id)
+    {
+        QMutexLocker locker(&_mutex);
+
+        if (! _indexed) {
+            foreach (Scope *scope, scopes) {
+                for (int i = int(scope->symbolCount()) - 1; i >= 0; --i) {
+                    Symbol *symbol = scope->symbolAt(i);
+
+                    if (! symbol->name())
+                        continue;
+                    else if (Identifier *symbolId = symbol->identifier())
+                        _symbols[QByteArray(symbolId->chars(), symbolId->size())].append(symbol);
+                }
+            }
+            _indexed = true;
+        }
+
+        return _symbols.value(QByteArray::fromRawData(id->chars(), id->size()));
+    }
+
+private:
+    QMutex _mutex;
+    bool _indexed;
+    QHash<QByteArray, QList<Symbol *> > _symbols;
+};
+
+} // end of namespace Internal
+} // end of namespace CPlusPlus
+
+using namespace CPlusPlus::Internal;
+
+namespace {
+
+// Keeps the global scopes of the most recently used documents.
+class GlobalScopesCache
+{
+public:
+    enum { MaxDocuments = 16 };
+
+    QSharedPointer<GlobalScopes> find(Document::Ptr doc, const Snapshot &snapshot)
+    {
+        QMutexLocker locker(&_mutex);
+        QSharedPointer<GlobalScopes> globalScopes = _cache.value(doc->fileName());
+
+        if (globalScopes && globalScopes->isValid(doc, snapshot))
+            return globalScopes;
+
+        return QSharedPointer<GlobalScopes>();
+    }
+
+    void insert(QSharedPointer<GlobalScopes> globalScopes)
+    {
+        QMutexLocker locker(&_mutex);
+        const QString fileName = globalScopes->thisDocument->fileName();
+
+        _recent.removeAll(fileName);
+        _recent.append(fileName);
+        _cache.insert(fileName, globalScopes);
+
+        while (_recent.size() > MaxDocuments)
+            _cache.remove(_recent.takeFirst());
+    }
+
+private:
+    QMutex _mutex;
+    QHash<QString, QSharedPointer<GlobalScopes> > _cache;
+    QStringList _recent;
+};
+
+} // end of anonymous namespace
+
+Q_GLOBAL_STATIC(GlobalScopesCache, globalScopesCache)
+
 /////////////////////////////////////////////////////////////////////
 // LookupContext
 /////////////////////////////////////////////////////////////////////
 LookupContext::LookupContext(Control *control)
     : _control(control),
-      _symbol(0)
+      _symbol(0),
+      _localScopeCount(0)
 { }
 
 LookupContext::LookupContext(Symbol *symbol,
@@ -58,12 +174,40 @@ LookupContext::LookupContext(Symbol *symbol,
     : _symbol(symbol),
       _expressionDocument(expressionDocument),
       _thisDocument(thisDocument),
-      _snapshot(snapshot)
+      _snapshot(snapshot),
+      _localScopeCount(0)
 {
     _control = _expressionDocument->control();
     _visibleScopes = buildVisibleScopes();
 }
 
+LookupContext::LookupContext(const LookupContext &other)
+    : _control(other._control),
+      _symbol(other._symbol),
+      _expressionDocument(other._expressionDocument),
+      _thisDocument(other._thisDocument),
+      _snapshot(other._snapshot),
+      _visibleScopes(other._visibleScopes),
+      _globalScopes(other._globalScopes),
+      _localScopeCount(other._localScopeCount)
+{ }
+
+LookupContext &LookupContext::operator = (const LookupContext &other)
+{
+    _control = other._control;
+    _symbol = other._symbol;
+    _expressionDocument = other._expressionDocument;
+    _thisDocument = other._thisDocument;
+    _snapshot = other._snapshot;
+    _visibleScopes = other._visibleScopes;
+    _globalScopes = other._globalScopes;
+    _localScopeCount = other._localScopeCount;
+    return *this;
+}
+
+LookupContext::~LookupContext()
+{ }
+
 bool LookupContext::isValid() const
 { return _control != 0; }
 
@@ -87,7 +231,7 @@ Snapshot LookupContext::snapshot() const
 
 bool LookupContext::maybeValidSymbol(Symbol *symbol,
                                      ResolveMode mode,
-                                     const QList<Symbol *> &candidates)
+                                     const QSet<Symbol *> &candidates)
 {
     if (((mode & ResolveNamespace) && symbol->isNamespace()) ||
         ((mode & ResolveClass)     && symbol->isClass())     ||
@@ -131,6 +275,7 @@ QList<Symbol *> LookupContext::resolveQualifiedNameId(QualifiedNameId *q,
                                                       ResolveMode mode) const
 {
     QList<Symbol *> candidates;
+    QSet<Symbol *> processed;
 
     if (true || mode & ResolveClass) {
         for (int i = 0; i < visibleScopes.size(); ++i) {
@@ -146,7 +291,7 @@ QList<Symbol *> LookupContext::resolveQualifiedNameId(QualifiedNameId *q,
 
                 if (! qq)
                     continue;
-                else if (! maybeValidSymbol(symbol, mode, candidates))
+                else if (! maybeValidSymbol(symbol, mode, processed))
                     continue;
 
                 if (! q->unqualifiedNameId()->isEqualTo(qq->unqualifiedNameId()))
@@ -163,8 +308,10 @@ QList<Symbol *> LookupContext::resolveQualifiedNameId(QualifiedNameId *q,
                             break;
                     }
 
-                    if (j == q->nameCount())
+                    if (j == q->nameCount()) {
+                        processed.insert(symbol);
                         candidates.append(symbol);
+                    }
                 }
             }
         }
@@ -230,62 +377,85 @@ QList<Symbol *> LookupContext::resolve(Name *name, const QList<Scope *> &visible
         return resolveOperatorNameId(opId, visibleScopes, mode);
 
     else if (Identifier *id = name->identifier()) {
-        for (int scopeIndex = 0; scopeIndex < visibleScopes.size(); ++scopeIndex) {
-            Scope *scope = visibleScopes.at(scopeIndex);
+        QSet<Symbol *> processed;
 
-            for (Symbol *symbol = scope->lookat(id); symbol; symbol = symbol->next()) {
-                if (! symbol->name())
-                    continue; // nothing to do, the symbol is anonymous.
+        foreach (Symbol *symbol, lookat(id, visibleScopes)) {
+            if (! maybeValidSymbol(symbol, mode, processed))
+                continue; // skip it, we're not looking for this kind of symbols
 
-                else if (! maybeValidSymbol(symbol, mode, candidates))
-                    continue; // skip it, we're not looking for this kind of symbols
+            if (QualifiedNameId *q = symbol->name()->asQualifiedNameId()) {
 
-                else if (Identifier *symbolId = symbol->identifier()) {
-                    if (! symbolId->isEqualTo(id))
-                        continue; // skip it, the symbol's id is not compatible with this lookup.
-                }
+                if (name->isDestructorNameId() != q->unqualifiedNameId()->isDestructorNameId())
+                    continue;
 
-                if (QualifiedNameId *q = symbol->name()->asQualifiedNameId()) {
+                else if (q->nameCount() > 1) {
+                    Name *classOrNamespaceName = control()->qualifiedNameId(q->names(),
+                                                                            q->nameCount() - 1);
 
-                    if (name->isDestructorNameId() != q->unqualifiedNameId()->isDestructorNameId())
-                        continue;
+                    if (Identifier *classOrNamespaceNameId = identifier(classOrNamespaceName)) {
+                        if (classOrNamespaceNameId->isEqualTo(id))
+                            continue;
+                    }
 
-                    else if (q->nameCount() > 1) {
-                        Name *classOrNamespaceName = control()->qualifiedNameId(q->names(),
-                                                                                q->nameCount() - 1);
+                    const QList<Symbol *> resolvedClassOrNamespace =
+                            resolveClassOrNamespace(classOrNamespaceName, visibleScopes);
 
-                        if (Identifier *classOrNamespaceNameId = identifier(classOrNamespaceName)) {
-                            if (classOrNamespaceNameId->isEqualTo(id))
-                                continue;
+                    bool good = false;
+                    foreach (Symbol *classOrNamespace, resolvedClassOrNamespace) {
+                        ScopedSymbol *scoped = classOrNamespace->asScopedSymbol();
+                        if (visibleScopes.contains(scoped->members())) {
+                            good = true;
+                            break;
                         }
+                    }
 
-                        const QList<Symbol *> resolvedClassOrNamespace =
-                                resolveClassOrNamespace(classOrNamespaceName, visibleScopes);
+                    if (! good)
+                        continue;
+                }
+            } else if (symbol->name()->isDestructorNameId() != name->isDestructorNameId()) {
+                // ### FIXME: this is wrong!
+                continue;
+            }
 
-                        bool good = false;
-                        foreach (Symbol *classOrNamespace, resolvedClassOrNamespace) {
-                            ScopedSymbol *scoped = classOrNamespace->asScopedSymbol();
-                            if (visibleScopes.contains(scoped->members())) {
-                                good = true;
-                                break;
-                            }
-                        }
+            processed.insert(symbol);
+            candidates.append(symbol);
+        }
+    }
 
-                        if (! good)
-                            continue;
-                    }
-                } else if (symbol->name()->isDestructorNameId() != name->isDestructorNameId()) {
-                    // ### FIXME: this is wrong!
-                    continue;
-                }
+    return candidates;
+}
+
+// Returns the named symbols with the given identifier in the visible scopes.
+// For the visible scopes of this context, the global part comes from the
+// shared index instead of looking at each scope.
+QList<Symbol *> LookupContext::lookat(Identifier *id, const QList<Scope *> &visibleScopes) const
+{
+    QList<Symbol *> symbols;
+
+    const bool isOwnScopes = _globalScopes && visibleScopes.size() == _visibleScopes.size()
+                             && visibleScopes.constBegin() == _visibleScopes.constBegin();
+    const int scopeCount = isOwnScopes ? _localScopeCount : visibleScopes.size();
+
+    for (int scopeIndex = 0; scopeIndex < scopeCount; ++scopeIndex) {
+        Scope *scope = visibleScopes.at(scopeIndex);
+
+        for (Symbol *symbol = scope->lookat(id); symbol; symbol = symbol->next()) {
+            if (! symbol->name())
+                continue; // nothing to do, the symbol is anonymous.
 
-                if (! candidates.contains(symbol))
-                    candidates.append(symbol);
+            else if (Identifier *symbolId = symbol->identifier()) {
+                if (! symbolId->isEqualTo(id))
+                    continue; // skip it, the symbol's id is not compatible with this lookup.
             }
+
+            symbols.append(symbol);
         }
     }
 
-    return candidates;
+    if (isOwnScopes)
+        symbols += _globalScopes->symbols(id);
+
+    return symbols;
 }
 
 Identifier *LookupContext::identifier(const Name *name) const
@@ -297,7 +467,8 @@ Identifier *LookupContext::identifier(const Name *name) const
 }
 
 void LookupContext::buildVisibleScopes_helper(Document::Ptr doc, QList<Scope *> *scopes,
-                                              QSet<QString> *processed)
+                                              QSet<QString> *processed,
+                                              QList<QPair<QString, Document::Ptr> > *includes)
 {
     if (doc && ! processed->contains(doc->fileName())) {
         processed->insert(doc->fileName());
@@ -306,12 +477,66 @@ void LookupContext::buildVisibleScopes_helper(Document::Ptr doc, QList<Scope *>
             scopes->append(doc->globalSymbols());
 
         foreach (const Document::Include &incl, doc->includes()) {
-            buildVisibleScopes_helper(_snapshot.value(incl.fileName()),
-                                      scopes, processed);
+            Document::Ptr includedDoc = _snapshot.value(incl.fileName());
+            includes->append(qMakePair(incl.fileName(), includedDoc));
+            buildVisibleScopes_helper(includedDoc, scopes, processed, includes);
         }
     }
 }
 
+// Expands the global scopes of the current document and its includes, or
+// takes them from the cache when none of these documents changed.
+QSharedPointer<GlobalScopes> LookupContext::buildGlobalScopes()
+{
+    QSharedPointer<GlobalScopes> globalScopes = globalScopesCache()->find(_thisDocument, _snapshot);
+    if (globalScopes)
+        return globalScopes;
+
+    globalScopes = QSharedPointer<GlobalScopes>(new GlobalScopes);
+    globalScopes->thisDocument = _thisDocument;
+
+    QList<Scope *> scopes;
+    QSet<QString> processed;
+    buildVisibleScopes_helper(_thisDocument, &scopes, &processed, &globalScopes->includes);
+    globalScopes->scopes = expandUntilFixpoint(scopes, QList<Scope *>());
+
+    globalScopesCache()->insert(globalScopes);
+    return globalScopes;
+}
+
+// Expands scopes until no new scopes are found. The expandedScopes are
+// visible and known to be expanded already, they are appended to the result.
+QList<Scope *> LookupContext::expandUntilFixpoint(QList<Scope *> scopes,
+                                                  const QList<Scope *> &expandedScopes) const
+{
+    // Scopes that are among the expandedScopes are not appended again, so
+    // the number of scopes does not tell whether new ones were found.
+    QSet<Scope *> knownScopes = scopes.toSet() + expandedScopes.toSet();
+
+    while (true) {
+        QList<Scope *> expanded = expandedScopes;
+        const QList<Scope *> visibleScopes = scopes + expandedScopes;
+
+        foreach (Scope *scope, scopes)
+            expand(scope, visibleScopes, &expanded);
+
+        const QList<Scope *> newScopes = expanded.mid(expandedScopes.size());
+
+        bool foundNewScopes = false;
+        foreach (Scope *scope, newScopes) {
+            if (! knownScopes.contains(scope)) {
+                knownScopes.insert(scope);
+                foundNewScopes = true;
+            }
+        }
+
+        if (! foundNewScopes)
+            return newScopes + expandedScopes;
+
+        scopes = newScopes;
+    }
+}
+
 QList<Scope *> LookupContext::buildVisibleScopes()
 {
     QList<Scope *> scopes;
@@ -330,20 +555,11 @@ QList<Scope *> LookupContext::buildVisibleScopes()
         }
     }
 
-    QSet<QString> processed;
-    buildVisibleScopes_helper(_thisDocument, &scopes, &processed);
+    _globalScopes = buildGlobalScopes();
 
-    while (true) {
-        QList<Scope *> expandedScopes;
-        expand(scopes, &expandedScopes);
-
-        if (expandedScopes.size() == scopes.size())
-            return expandedScopes;
-
-        scopes = expandedScopes;
-    }
-
-    return scopes;
+    const QList<Scope *> visibleScopes = expandUntilFixpoint(scopes, _globalScopes->scopes);
+    _localScopeCount = visibleScopes.size() - _globalScopes->scopes.size();
+    return visibleScopes;
 }
 
 QList<Scope *> LookupContext::visibleScopes(const QPair<FullySpecifiedType, Symbol *> &result) const
@@ -356,9 +572,8 @@ QList<Scope *> LookupContext::visibleScopes(Symbol *symbol) const
         for (Scope *scope = symbol->scope(); scope; scope = scope->enclosingScope())
             scopes.append(scope);
     }
-    scopes += visibleScopes();
-    scopes = expand(scopes);
-    return scopes;
+    // the visible scopes of this context are expanded already
+    return expandUntilFixpoint(scopes, visibleScopes());
 }
 
 void LookupContext::expandEnumOrAnonymousSymbol(ScopedSymbol *scopedSymbol,
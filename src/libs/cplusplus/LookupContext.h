@@ -32,9 +32,14 @@
 
 #include "CppDocument.h"
 #include <QPair>
+#include <QSharedPointer>
 
 namespace CPlusPlus {
 
+namespace Internal {
+class GlobalScopes;
+}
+
 class CPLUSPLUS_EXPORT LookupContext
 {
 public:
@@ -45,6 +50,10 @@ public:
                   Document::Ptr thisDocument,
                   const Snapshot &snapshot);
 
+    LookupContext(const LookupContext &other);
+    LookupContext &operator = (const LookupContext &other);
+    ~LookupContext();
+
     bool isValid() const;
 
     Control *control() const;
@@ -147,14 +156,22 @@ private:
 
     Identifier *identifier(const Name *name) const;
 
+    QList<Symbol *> lookat(Identifier *id, const QList<Scope *> &visibleScopes) const;
+
     QList<Scope *> buildVisibleScopes();
 
+    QSharedPointer<Internal::GlobalScopes> buildGlobalScopes();
+
     void buildVisibleScopes_helper(Document::Ptr doc, QList<Scope *> *scopes,
-                                   QSet<QString> *processed);
+                                   QSet<QString> *processed,
+                                   QList<QPair<QString, Document::Ptr> > *includes);
+
+    QList<Scope *> expandUntilFixpoint(QList<Scope *> scopes,
+                                       const QList<Scope *> &expandedScopes) const;
 
     static bool maybeValidSymbol(Symbol *symbol,
                                  ResolveMode mode,
-                                 const QList<Symbol *> &candidates);
+                                 const QSet<Symbol *> &candidates);
 
 private:
     Control *_control;
@@ -173,6 +190,13 @@ private:
 
     // Visible scopes.
     QList<Scope *> _visibleScopes;
+
+    // The expanded scopes of the current document and its includes,
+    // shared by all contexts for the same document and include closure.
+    QSharedPointer<Internal::GlobalScopes> _globalScopes;
+
+    // The scopes in front of the global ones in _visibleScopes.
+    int _localScopeCount;
 };
 
 } // end of namespace CPlusPlus
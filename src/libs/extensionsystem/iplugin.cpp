@@ -206,6 +206,9 @@
        been initialized completely (implying that they have put
        objects in the object pool, if they want that during the
        initialization sequence).
+    \o After the main event loop has started, the delayedInitialize methods
+       are called in 'leaf-to-root' order, one plugin at a time, for
+       work that is not needed to show the main window.
     \endlist
     If library loading or initialization of a plugin fails, all plugins
     that depend on that plugin also fail.
@@ -239,6 +242,18 @@
     \sa initialize()
 */
 
+/*!
+    \fn bool IPlugin::delayedInitialize()
+    Called after all plugins' IPlugin::extensionsInitialized() methods have
+    been called and the event loop is running. Plugins can move expensive
+    setup that is not required at startup, like reading settings of
+    optional features, into this method.
+    Return true if the plugin did noticeable work, so the plugin manager
+    gives the event loop some time before calling the next plugin.
+    The default implementation does nothing and returns false.
+    \sa PluginManager::initializationDone()
+*/
+
 /*!
     \fn void IPlugin::shutdown()
     Called during a shutdown sequence in the same order as initialization
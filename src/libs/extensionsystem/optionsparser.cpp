@@ -37,6 +37,7 @@ using namespace ExtensionSystem::Internal;
 static const char *END_OF_OPTIONS = "--";
 const char *OptionsParser::NO_LOAD_OPTION = "-noload";
 const char *OptionsParser::TEST_OPTION = "-test";
+const char *OptionsParser::TRACE_OPTION = "-trace";
 
 OptionsParser::OptionsParser(const QStringList &args,
         const QMap<QString, bool> &appOptions,
@@ -71,6 +72,8 @@ bool OptionsParser::parse()
             continue;
         if (checkForTestOption())
             continue;
+        if (checkForTraceOption())
+            continue;
         if (checkForAppOption())
             continue;
         if (checkForPluginOption())
@@ -113,6 +116,15 @@ bool OptionsParser::checkForTestOption()
     return true;
 }
 
+bool OptionsParser::checkForTraceOption()
+{
+    if (m_currentArg != QLatin1String(TRACE_OPTION))
+        return false;
+    if (nextToken(RequiredToken))
+        m_pmPrivate->traceFileName = m_currentArg;
+    return true;
+}
+
 bool OptionsParser::checkForNoLoadOption()
 {
     if (m_currentArg != QLatin1String(NO_LOAD_OPTION))
@@ -36,8 +36,14 @@
 
 #include <QtCore/QMetaProperty>
 #include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFutureSynchronizer>
+#include <QtCore/QMutexLocker>
 #include <QtCore/QTextStream>
+#include <QtCore/QThread>
+#include <QtCore/QTimer>
 #include <QtCore/QWriteLocker>
+#include <QtCore/QtConcurrentRun>
 #include <QtDebug>
 #ifdef WITH_TESTS
 #include <QTest>
@@ -47,6 +53,9 @@ typedef QList<ExtensionSystem::PluginSpec *> PluginSpecSet;
 
 enum { debugLeaks = 0 };
 
+// Pause between two plugins that did work in delayedInitialize()
+enum { DelayedInitializeInterval = 20 };
+
 /*!
     \namespace ExtensionSystem
     \brief The ExtensionSystem namespace provides classes that belong to the core plugin system.
@@ -232,6 +241,38 @@ QList<QObject *> PluginManager::allObjects() const
     return d->allObjects;
 }
 
+/*!
+    \fn QList<QObject *> PluginManager::indexedObjects(const void *type, ObjectMatcher matcher) const
+    \internal
+
+    Returns the pool objects that \a matcher accepts. The result is kept per
+    \a type until objects are added to or removed from the pool, or an
+    aggregate containing a pool object changes, so repeated lookups do not
+    query every object.
+    The caller holds the read lock.
+*/
+QList<QObject *> PluginManager::indexedObjects(const void *type, ObjectMatcher matcher) const
+{
+    QMutexLocker locker(&d->objectIndexLock);
+    const int revision = Aggregation::Aggregate::revision();
+    if (revision != d->objectIndexRevision) {
+        d->objectIndex.clear();
+        d->objectIndexRevision = revision;
+    }
+
+    QHash<const void *, QList<QObject *> >::const_iterator it = d->objectIndex.constFind(type);
+    if (it != d->objectIndex.constEnd())
+        return it.value();
+
+    QList<QObject *> objects;
+    foreach (QObject *obj, d->allObjects) {
+        if (matcher(obj))
+            objects.append(obj);
+    }
+    d->objectIndex.insert(type, objects);
+    return objects;
+}
+
 /*!
     \fn void PluginManager::loadPlugins()
     Tries to load all the plugins that were previously found when
@@ -246,6 +287,30 @@ void PluginManager::loadPlugins()
     return d->loadPlugins();
 }
 
+/*!
+    \fn bool PluginManager::isInitializationDone() const
+    Returns true once the IPlugin::delayedInitialize() methods of all
+    plugins have been called.
+
+    \sa initializationDone()
+*/
+bool PluginManager::isInitializationDone() const
+{
+    return d->initializationDone;
+}
+
+/*!
+    \fn bool PluginManager::writeStartupTrace(const QString &fileName) const
+    Writes the time spent reading, loading and initializing each plugin to
+    \a fileName, in the JSON trace event format that chrome://tracing reads.
+    The \c{-trace <file>} command line option writes the trace automatically
+    once initialization is done. Returns false if the file cannot be written.
+*/
+bool PluginManager::writeStartupTrace(const QString &fileName) const
+{
+    return d->writeTrace(fileName);
+}
+
 /*!
     \fn QStringList PluginManager::pluginPaths() const
     The list of paths were the plugin manager searches for plugins.
@@ -380,6 +445,9 @@ void PluginManager::formatOptions(QTextStream &str, int optionIndentation, int d
     formatOption(str, QLatin1String(OptionsParser::NO_LOAD_OPTION),
                  QLatin1String("plugin"), QLatin1String("Do not load <plugin>"),
                  optionIndentation, descriptionIndentation);
+    formatOption(str, QLatin1String(OptionsParser::TRACE_OPTION),
+                 QLatin1String("file"), QLatin1String("Write plugin startup times to <file>"),
+                 optionIndentation, descriptionIndentation);
 }
 
 /*!
@@ -419,6 +487,11 @@ void PluginManager::formatPluginVersions(QTextStream &str) const
     }
 }
 
+void PluginManager::nextDelayedInitialize()
+{
+    d->nextDelayedInitialize();
+}
+
 void PluginManager::startTests()
 {
 #ifdef WITH_TESTS
@@ -489,8 +562,11 @@ PluginSpecPrivate *PluginManagerPrivate::privateSpec(PluginSpec *spec)
     \internal
 */
 PluginManagerPrivate::PluginManagerPrivate(PluginManager *pluginManager)
-    : extension("xml"), q(pluginManager)
+    : extension("xml"), objectIndexRevision(-1),
+      delayedInitializeTimer(0), initializationDone(false),
+      q(pluginManager)
 {
+    traceClock.start();
 }
 
 /*!
@@ -499,6 +575,9 @@ PluginManagerPrivate::PluginManagerPrivate(PluginManager *pluginManager)
 */
 PluginManagerPrivate::~PluginManagerPrivate()
 {
+    delete delayedInitializeTimer;
+    delayedInitializeTimer = 0;
+    delayedInitializeQueue.clear();
     stopAll();
     qDeleteAll(pluginSpecs);
     if (!allObjects.isEmpty()) {
@@ -540,6 +619,10 @@ void PluginManagerPrivate::addObject(QObject *obj)
             qDebug() << "PluginManagerPrivate::addObject" << obj << obj->objectName();
 
         allObjects.append(obj);
+        // Changes of aggregates holding pool objects invalidate the index
+        Aggregation::Aggregate::setObserved(obj, true);
+        QMutexLocker indexLock(&objectIndexLock);
+        objectIndex.clear();
     }
     emit q->objectAdded(obj);
 }
@@ -566,6 +649,9 @@ void PluginManagerPrivate::removeObject(QObject *obj)
     emit q->aboutToRemoveObject(obj);
     QWriteLocker lock(&(q->m_lock));
     allObjects.removeAll(obj);
+    Aggregation::Aggregate::setObserved(obj, false);
+    QMutexLocker indexLock(&objectIndexLock);
+    objectIndex.clear();
 }
 
 /*!
@@ -575,18 +661,71 @@ void PluginManagerPrivate::removeObject(QObject *obj)
 void PluginManagerPrivate::loadPlugins()
 {
     QList<PluginSpec *> queue = loadQueue();
+
+    // Plugin libraries are loaded in the main thread: loading runs their
+    // static initializers, which may create QObjects.
+    int start;
     foreach (PluginSpec *spec, queue) {
+        start = traceTime();
         loadPlugin(spec, PluginSpec::Loaded);
+        addTraceEvent(spec->name(), "load", start);
     }
     foreach (PluginSpec *spec, queue) {
+        start = traceTime();
         loadPlugin(spec, PluginSpec::Initialized);
+        addTraceEvent(spec->name(), "initialize", start);
     }
+    delayedInitializeQueue.clear();
     QListIterator<PluginSpec *> it(queue);
     it.toBack();
     while (it.hasPrevious()) {
-        loadPlugin(it.previous(), PluginSpec::Running);
+        PluginSpec *spec = it.previous();
+        start = traceTime();
+        loadPlugin(spec, PluginSpec::Running);
+        addTraceEvent(spec->name(), "extensionsInitialized", start);
+        if (spec->state() == PluginSpec::Running)
+            delayedInitializeQueue.append(spec);
     }
     emit q->pluginsChanged();
+
+    initializationDone = false;
+    if (!delayedInitializeTimer) {
+        delayedInitializeTimer = new QTimer;
+        delayedInitializeTimer->setInterval(DelayedInitializeInterval);
+        delayedInitializeTimer->setSingleShot(true);
+        QObject::connect(delayedInitializeTimer, SIGNAL(timeout()),
+                         q, SLOT(nextDelayedInitialize()));
+    }
+    delayedInitializeTimer->start();
+}
+
+/*!
+    \fn void PluginManagerPrivate::nextDelayedInitialize()
+    \internal
+
+    Calls delayedInitialize() of the queued plugins until one of them
+    reports that it did work, then waits for the timer again.
+*/
+void PluginManagerPrivate::nextDelayedInitialize()
+{
+    while (!delayedInitializeQueue.isEmpty()) {
+        PluginSpec *spec = delayedInitializeQueue.takeFirst();
+        const int start = traceTime();
+        const bool delay = spec->d->delayedInitialize();
+        addTraceEvent(spec->name(), "delayedInitialize", start);
+        if (delay)
+            break;
+    }
+    if (!delayedInitializeQueue.isEmpty()) {
+        delayedInitializeTimer->start();
+        return;
+    }
+    delete delayedInitializeTimer;
+    delayedInitializeTimer = 0;
+    initializationDone = true;
+    if (!traceFileName.isEmpty() && !writeTrace(traceFileName))
+        qWarning() << "Cannot write startup trace to" << traceFileName;
+    emit q->initializationDone();
 }
 
 /*!
@@ -709,17 +848,34 @@ void PluginManagerPrivate::readPluginPaths()
         foreach (const QFileInfo &subdir, dirs)
             searchPaths << subdir.absoluteFilePath();
     }
+    // The specs are created here so they live in the main thread, only
+    // parsing the files happens in parallel
+    const int start = traceTime();
+    QFutureSynchronizer<void> synchronizer;
     foreach (const QString &specFile, specFiles) {
         PluginSpec *spec = new PluginSpec;
-        spec->d->read(specFile);
         pluginSpecs.append(spec);
+        synchronizer.addFuture(QtConcurrent::run(this, &PluginManagerPrivate::readPluginSpec, spec, specFile));
     }
+    synchronizer.waitForFinished();
+    addTraceEvent(QLatin1String("Read plugin specs"), "read", start);
     resolveDependencies();
     // ensure deterministic plugin load order by sorting
     qSort(pluginSpecs.begin(), pluginSpecs.end(), lessThanByPluginName);
     emit q->pluginsChanged();
 }
 
+/*!
+    \fn void PluginManagerPrivate::readPluginSpec(PluginSpec *spec, const QString &fileName)
+    \internal
+*/
+void PluginManagerPrivate::readPluginSpec(PluginSpec *spec, const QString &fileName)
+{
+    const int start = traceTime();
+    spec->d->read(fileName);
+    addTraceEvent(spec->name().isEmpty() ? fileName : spec->name(), "read", start);
+}
+
 void PluginManagerPrivate::resolveDependencies()
 {
     foreach (PluginSpec *spec, pluginSpecs) {
@@ -759,3 +915,67 @@ PluginSpec *PluginManagerPrivate::pluginByName(const QString &name) const
     return 0;
 }
 
+/*!
+    \fn int PluginManagerPrivate::traceTime() const
+    \internal
+
+    Milliseconds since the plugin manager was created.
+*/
+int PluginManagerPrivate::traceTime() const
+{
+    return traceClock.elapsed();
+}
+
+/*!
+    \fn void PluginManagerPrivate::addTraceEvent(const QString &name, const char *phase, int start)
+    \internal
+
+    Records that \a phase of \a name ran from \a start until now in the
+    current thread. Can be called from worker threads.
+*/
+void PluginManagerPrivate::addTraceEvent(const QString &name, const char *phase, int start)
+{
+    TraceEvent event;
+    event.name = name;
+    event.phase = phase;
+    event.start = start;
+    event.duration = traceTime() - start;
+    event.thread = quintptr(QThread::currentThreadId());
+    QMutexLocker locker(&traceLock);
+    traceEvents.append(event);
+}
+
+static QString escapeJson(QString str)
+{
+    str.replace(QLatin1Char('\\'), QLatin1String("\\\\"));
+    str.replace(QLatin1Char('"'), QLatin1String("\\\""));
+    return str;
+}
+
+/*!
+    \fn bool PluginManagerPrivate::writeTrace(const QString &fileName) const
+    \internal
+*/
+bool PluginManagerPrivate::writeTrace(const QString &fileName) const
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+        return false;
+    QTextStream str(&file);
+    str << "{\"traceEvents\":[";
+    QMutexLocker locker(&traceLock);
+    for (int i = 0; i < traceEvents.size(); ++i) {
+        const TraceEvent &event = traceEvents.at(i);
+        if (i)
+            str << ',';
+        // complete events, timestamps are in microseconds
+        str << "\n{\"name\":\"" << escapeJson(event.name)
+            << "\",\"cat\":\"" << event.phase
+            << "\",\"ph\":\"X\",\"ts\":" << qint64(event.start) * 1000
+            << ",\"dur\":" << qint64(event.duration) * 1000
+            << ",\"pid\":1,\"tid\":" << event.thread << '}';
+    }
+    str << "\n]}\n";
+    str.flush();
+    return file.error() == QFile::NoError;
+}
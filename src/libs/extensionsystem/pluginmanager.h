@@ -45,6 +45,11 @@ namespace ExtensionSystem {
 
 namespace Internal {
     class PluginManagerPrivate;
+
+    // Identifies a type in the object pool index by the address of key.
+    // Not const: identical read-only constants may be folded by the linker.
+    template <typename T> struct ObjectPoolKey { static char key; };
+    template <typename T> char ObjectPoolKey<T>::key = 0;
 }
 
 class IPlugin;
@@ -69,29 +74,28 @@ public:
     {
         QReadLocker lock(&m_lock);
         QList<T *> results;
-        QList<QObject *> all = allObjects();
-        QList<T *> result;
-        foreach (QObject *obj, all) {
-            result = Aggregation::query_all<T>(obj);
-            if (!result.isEmpty())
-                results += result;
-        }
+        const QList<QObject *> objects =
+            indexedObjects(&Internal::ObjectPoolKey<T>::key, &PluginManager::matches<T>);
+        foreach (QObject *obj, objects)
+            results += Aggregation::query_all<T>(obj);
         return results;
     }
     template <typename T> T *getObject() const
     {
         QReadLocker lock(&m_lock);
-        QList<QObject *> all = allObjects();
-        T *result = 0;
-        foreach (QObject *obj, all) {
-            if ((result = Aggregation::query<T>(obj)) != 0)
-                break;
+        const QList<QObject *> objects =
+            indexedObjects(&Internal::ObjectPoolKey<T>::key, &PluginManager::matches<T>);
+        foreach (QObject *obj, objects) {
+            if (T *result = Aggregation::query<T>(obj))
+                return result;
         }
-        return result;
+        return 0;
     }
 
     // Plugin operations
     void loadPlugins();
+    bool isInitializationDone() const;
+    bool writeStartupTrace(const QString &fileName) const;
     QStringList pluginPaths() const;
     void setPluginPaths(const QStringList &paths);
     QList<PluginSpec *> plugins() const;
@@ -116,10 +120,17 @@ signals:
     void aboutToRemoveObject(QObject *obj);
 
     void pluginsChanged();
+    void initializationDone();
 private slots:
+    void nextDelayedInitialize();
     void startTests();
 
 private:
+    typedef bool (*ObjectMatcher)(QObject *);
+    template <typename T> static bool matches(QObject *obj)
+    { return Aggregation::query<T>(obj) != 0; }
+    QList<QObject *> indexedObjects(const void *type, ObjectMatcher matcher) const;
+
     Internal::PluginManagerPrivate *d;
     static PluginManager *m_instance;
     mutable QReadWriteLock m_lock;
@@ -32,10 +32,17 @@
 
 #include "pluginspec.h"
 
+#include <QtCore/QHash>
 #include <QtCore/QList>
+#include <QtCore/QMutex>
 #include <QtCore/QSet>
 #include <QtCore/QStringList>
 #include <QtCore/QObject>
+#include <QtCore/QTime>
+
+QT_BEGIN_NAMESPACE
+class QTimer;
+QT_END_NAMESPACE
 
 namespace ExtensionSystem {
 
@@ -61,6 +68,19 @@ public:
     QList<PluginSpec *> loadQueue();
     void loadPlugin(PluginSpec *spec, PluginSpec::State destState);
     void resolveDependencies();
+    void nextDelayedInitialize();
+
+    // Startup trace
+    struct TraceEvent {
+        QString name;
+        const char *phase;
+        int start;
+        int duration;
+        quintptr thread;
+    };
+    int traceTime() const;
+    void addTraceEvent(const QString &name, const char *phase, int start);
+    bool writeTrace(const QString &fileName) const;
 
     QList<PluginSpec *> pluginSpecs;
     QList<PluginSpec *> testSpecs;
@@ -68,8 +88,23 @@ public:
     QString extension;
     QList<QObject *> allObjects; // ### make this a QList<QPointer<QObject> > > ?
 
+    // Pool objects per queried type, cleared when the pool or an aggregate
+    // holding a pool object changes
+    QHash<const void *, QList<QObject *> > objectIndex;
+    QMutex objectIndexLock;
+    int objectIndexRevision;
+
     QStringList arguments;
 
+    QList<PluginSpec *> delayedInitializeQueue;
+    QTimer *delayedInitializeTimer;
+    bool initializationDone;
+
+    QTime traceClock;
+    QList<TraceEvent> traceEvents;
+    mutable QMutex traceLock;
+    QString traceFileName;
+
     // Look in argument descriptions of the specs for the option.
     PluginSpec *pluginForOption(const QString &option, bool *requiresArgument) const;
     PluginSpec *pluginByName(const QString &name) const;
@@ -81,6 +116,7 @@ private:
     PluginManager *q;
 
     void readPluginPaths();
+    void readPluginSpec(PluginSpec *spec, const QString &fileName);
     bool loadQueue(PluginSpec *spec,
             QList<PluginSpec *> &queue,
             QList<PluginSpec *> &circularityCheckQueue);
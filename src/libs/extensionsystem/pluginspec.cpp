@@ -667,10 +667,13 @@ bool PluginSpecPrivate::provides(const QString &pluginName, const QString &plugi
     \fn QRegExp &PluginSpecPrivate::versionRegExp()
     \internal
 */
+Q_GLOBAL_STATIC_WITH_ARGS(QRegExp, versionRegExpInstance,
+    (QLatin1String("([0-9]+)(?:[.]([0-9]+))?(?:[.]([0-9]+))?(?:_([0-9]+))?")))
+
 QRegExp &PluginSpecPrivate::versionRegExp()
 {
-    static QRegExp reg("([0-9]+)(?:[.]([0-9]+))?(?:[.]([0-9]+))?(?:_([0-9]+))?");
-    return reg;
+    // Specs are read from several threads, so match on copies only
+    return *versionRegExpInstance();
 }
 /*!
     \fn bool PluginSpecPrivate::isValidVersion(const QString &version)
@@ -678,7 +681,8 @@ QRegExp &PluginSpecPrivate::versionRegExp()
 */
 bool PluginSpecPrivate::isValidVersion(const QString &version)
 {
-    return versionRegExp().exactMatch(version);
+    QRegExp reg = versionRegExp();
+    return reg.exactMatch(version);
 }
 
 /*!
@@ -748,42 +752,50 @@ bool PluginSpecPrivate::resolveDependencies(const QList<PluginSpec *> &specs)
 }
 
 /*!
-    \fn bool PluginSpecPrivate::loadLibrary()
+    \fn QString PluginSpecPrivate::libraryFileName() const
     \internal
 */
-bool PluginSpecPrivate::loadLibrary()
+QString PluginSpecPrivate::libraryFileName() const
 {
-    if (hasError)
-        return false;
-    if (state != PluginSpec::Resolved) {
-        if (state == PluginSpec::Loaded)
-            return true;
-        errorString = QCoreApplication::translate("PluginSpec", "Loading the library failed because state != Resolved");
-        hasError = true;
-        return false;
-    }
 #ifdef QT_NO_DEBUG
 
 #ifdef Q_OS_WIN
-    QString libName = QString("%1/%2.dll").arg(location).arg(name);
+    return QString("%1/%2.dll").arg(location).arg(name);
 #elif defined(Q_OS_MAC)
-    QString libName = QString("%1/lib%2.dylib").arg(location).arg(name);
+    return QString("%1/lib%2.dylib").arg(location).arg(name);
 #else
-    QString libName = QString("%1/lib%2.so").arg(location).arg(name);
+    return QString("%1/lib%2.so").arg(location).arg(name);
 #endif
 
 #else //Q_NO_DEBUG
 
 #ifdef Q_OS_WIN
-    QString libName = QString("%1/%2d.dll").arg(location).arg(name);
+    return QString("%1/%2d.dll").arg(location).arg(name);
 #elif defined(Q_OS_MAC)
-    QString libName = QString("%1/lib%2_debug.dylib").arg(location).arg(name);
+    return QString("%1/lib%2_debug.dylib").arg(location).arg(name);
 #else
-    QString libName = QString("%1/lib%2.so").arg(location).arg(name);
+    return QString("%1/lib%2.so").arg(location).arg(name);
 #endif
 
 #endif
+}
 
+/*!
+    \fn bool PluginSpecPrivate::loadLibrary()
+    \internal
+*/
+bool PluginSpecPrivate::loadLibrary()
+{
+    if (hasError)
+        return false;
+    if (state != PluginSpec::Resolved) {
+        if (state == PluginSpec::Loaded)
+            return true;
+        errorString = QCoreApplication::translate("PluginSpec", "Loading the library failed because state != Resolved");
+        hasError = true;
+        return false;
+    }
+    const QString libName = libraryFileName();
     PluginLoader loader(libName);
     if (!loader.load()) {
         hasError = true;
@@ -858,6 +870,17 @@ bool PluginSpecPrivate::initializeExtensions()
     return true;
 }
 
+/*!
+    \fn bool PluginSpecPrivate::delayedInitialize()
+    \internal
+*/
+bool PluginSpecPrivate::delayedInitialize()
+{
+    if (hasError || state != PluginSpec::Running || !plugin)
+        return false;
+    return plugin->delayedInitialize();
+}
+
 /*!
     \fn bool PluginSpecPrivate::stop()
     \internal
@@ -79,5 +79,15 @@ void MyPlugin1::extensionsInitialized()
     addAutoReleasedObject(obj);
 }
 
+bool MyPlugin1::delayedInitialize()
+{
+    if (!initializeCalled)
+        return false;
+    QObject *obj = new QObject;
+    obj->setObjectName("MyPlugin1_delayed");
+    addAutoReleasedObject(obj);
+    return true;
+}
+
 Q_EXPORT_PLUGIN(MyPlugin1)
 
@@ -45,6 +45,7 @@ public:
 
     bool initialize(const QStringList &arguments, QString *errorString);
     void extensionsInitialized();
+    bool delayedInitialize();
 
 private:
     bool initializeCalled;
@@ -30,9 +30,12 @@
 #include <extensionsystem/pluginmanager.h>
 #include <extensionsystem/pluginspec.h>
 #include <extensionsystem/iplugin.h>
+#include <aggregation/aggregate.h>
 
 #include <QtTest/QtTest>
 
+#include <QtCore/QDir>
+#include <QtCore/QFile>
 #include <QtCore/QObject>
 
 using namespace ExtensionSystem;
@@ -49,9 +52,12 @@ private slots:
     void addRemoveObjects();
     void getObject();
     void getObjects();
+    void getAggregatedObject();
+    void getObjectsBenchmark();
     void plugins();
     void circularPlugins();
     void correctPlugins1();
+    void delayedInitialize();
 
 private:
     PluginManager *m_pm;
@@ -194,6 +200,56 @@ void tst_PluginManager::getObjects()
     delete object11;
 }
 
+void tst_PluginManager::getAggregatedObject()
+{
+    MyClass1 *object1 = new MyClass1;
+    MyClass2 *object2 = new MyClass2;
+    m_pm->addObject(object1);
+    QCOMPARE(m_pm->getObject<MyClass2>(), (MyClass2*)0);
+    // aggregating after the object was added must be visible to later lookups
+    Aggregation::Aggregate *aggregate = new Aggregation::Aggregate;
+    aggregate->add(object1);
+    aggregate->add(object2);
+    QCOMPARE(m_pm->getObject<MyClass2>(), object2);
+    QCOMPARE(m_pm->getObjects<MyClass1>(), QList<MyClass1*>() << object1);
+    aggregate->remove(object2);
+    QCOMPARE(m_pm->getObject<MyClass2>(), (MyClass2*)0);
+    m_pm->removeObject(object1);
+    delete aggregate;
+    delete object2;
+}
+
+void tst_PluginManager::getObjectsBenchmark()
+{
+    // roughly the size of the pool after all plugins are loaded
+    QList<QObject *> objects;
+    for (int i = 0; i < 300; ++i) {
+        QObject *obj;
+        switch (i % 3) {
+        case 0: obj = new MyClass1; break;
+        case 1: obj = new MyClass2; break;
+        default: obj = new QObject; break;
+        }
+        objects.append(obj);
+        m_pm->addObject(obj);
+    }
+    MyClass11 *object11 = new MyClass11;
+    m_pm->addObject(object11);
+
+    QBENCHMARK {
+        QCOMPARE(m_pm->getObjects<MyClass1>().size(), 101);
+        QCOMPARE(m_pm->getObjects<MyClass2>().size(), 100);
+        QCOMPARE(m_pm->getObject<MyClass11>(), object11);
+    }
+
+    m_pm->removeObject(object11);
+    delete object11;
+    foreach (QObject *obj, objects) {
+        m_pm->removeObject(obj);
+        delete obj;
+    }
+}
+
 void tst_PluginManager::plugins()
 {
     m_pm->setPluginPaths(QStringList() << "plugins");
@@ -259,6 +315,36 @@ void tst_PluginManager::correctPlugins1()
     QVERIFY(plugin3running);
 }
 
+void tst_PluginManager::delayedInitialize()
+{
+    m_pm->setFileExtension("spec");
+    m_pm->setPluginPaths(QStringList() << "correctplugins1");
+    m_pm->loadPlugins();
+    QVERIFY(!m_pm->isInitializationDone());
+    QSignalSpy spy(m_pm, SIGNAL(initializationDone()));
+    for (int i = 0; i < 50 && spy.isEmpty(); ++i)
+        QTest::qWait(20);
+    QCOMPARE(spy.count(), 1);
+    QVERIFY(m_pm->isInitializationDone());
+    bool delayed = false;
+    foreach (QObject *obj, m_pm->allObjects()) {
+        if (obj->objectName() == "MyPlugin1_delayed")
+            delayed = true;
+    }
+    QVERIFY(delayed);
+
+    const QString traceFile = QDir::temp().absoluteFilePath("tst_pluginmanager_trace.json");
+    QVERIFY(m_pm->writeStartupTrace(traceFile));
+    QFile file(traceFile);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QByteArray trace = file.readAll();
+    file.close();
+    QFile::remove(traceFile);
+    QVERIFY(trace.startsWith("{\"traceEvents\":["));
+    QVERIFY(trace.contains("\"name\":\"plugin1\",\"cat\":\"initialize\""));
+    QVERIFY(trace.contains("\"name\":\"plugin1\",\"cat\":\"delayedInitialize\""));
+}
+
 QTEST_MAIN(tst_PluginManager)
 
 #include "tst_pluginmanager.moc"
@@ -36,6 +36,9 @@
 #include <QtCore/QFutureInterface>
 #include <QtCore/QtConcurrentRun>
 #include <QtCore/QRegExp>
+#include <QtCore/QTextCodec>
+#include <QtCore/QTextStream>
+#include <QtCore/QVector>
 #include <QtCore/QCoreApplication>
 
 #include <qtconcurrent/runextensions.h>
@@ -72,7 +75,7 @@ void runFileSearch(QFutureInterface<FileSearchResult> &future,
                    QString searchTerm,
                    QStringList files,
                    QTextDocument::FindFlags flags,
-                   QMap<QString, QString> fileToContentsMap)
+                   QMap<QString, QByteArray> fileToContentsMap)
 {
     future.setProgressRange(0, files.size());
     int numFilesSearched = 0;
@@ -95,6 +98,7 @@ void runFileSearch(QFutureInterface<FileSearchResult> &future,
 
     QFile file;
     QBuffer buffer;
+    QVector<FileSearchResult> results;
     foreach (QString s, files) {
         if (future.isPaused())
             future.waitForResume();
@@ -104,7 +108,7 @@ void runFileSearch(QFutureInterface<FileSearchResult> &future,
         }
         QIODevice *device;
         if (fileToContentsMap.contains(s)) {
-            buffer.setData(fileToContentsMap.value(s).toLocal8Bit());
+            buffer.setData(fileToContentsMap.value(s));
             device = &buffer;
         } else {
             file.setFileName(s);
@@ -169,7 +173,7 @@ void runFileSearch(QFutureInterface<FileSearchResult> &future,
                             int n = 0;
                             while (startOfLastLine[i] != '\n' && startOfLastLine[i] != '\r' && i < textLength && n++ < 256)
                                 res.append(startOfLastLine[i++]);
-                            future.reportResult(FileSearchResult(s, lineNr, QString(res),
+                            results.append(FileSearchResult(s, lineNr, QString(res),
                                                           regionPtr - startOfLastLine, sa.length()));
                             ++numMatches;
                         }
@@ -178,6 +182,11 @@ void runFileSearch(QFutureInterface<FileSearchResult> &future,
             }
             firstChunk = false;
         }
+        // Report the matches of a file at once, they are shown in one batch.
+        if (!results.isEmpty()) {
+            future.reportResults(results);
+            results.clear();
+        }
         ++numFilesSearched;
         future.setProgressValueAndText(numFilesSearched, msgFound(searchTerm, numMatches, numFilesSearched, files.size()));
         device->close();
@@ -190,7 +199,7 @@ void runFileSearchRegExp(QFutureInterface<FileSearchResult> &future,
                    QString searchTerm,
                    QStringList files,
                    QTextDocument::FindFlags flags,
-                   QMap<QString, QString> fileToContentsMap)
+                   QMap<QString, QByteArray> fileToContentsMap)
 {
     future.setProgressRange(0, files.size());
     int numFilesSearched = 0;
@@ -201,8 +210,9 @@ void runFileSearchRegExp(QFutureInterface<FileSearchResult> &future,
     const QRegExp expression(searchTerm, caseSensitivity);
 
     QFile file;
-    QString str;
+    QBuffer buffer;
     QTextStream stream;
+    QVector<FileSearchResult> results;
     foreach (const QString &s, files) {
         if (future.isPaused())
             future.waitForResume();
@@ -211,33 +221,39 @@ void runFileSearchRegExp(QFutureInterface<FileSearchResult> &future,
             break;
         }
 
-        bool needsToCloseFile = false;
+        QIODevice *device;
         if (fileToContentsMap.contains(s)) {
-            str = fileToContentsMap.value(s);
-            stream.setString(&str);
+            buffer.setData(fileToContentsMap.value(s));
+            device = &buffer;
+            stream.setCodec(QTextCodec::codecForName("UTF-8"));
         } else {
             file.setFileName(s);
-            if (!file.open(QIODevice::ReadOnly))
-                continue;
-            needsToCloseFile = true;
-            stream.setDevice(&file);
+            device = &file;
+            stream.setCodec(QTextCodec::codecForLocale());
         }
+        if (!device->open(QIODevice::ReadOnly))
+            continue;
+        stream.setDevice(device);
         int lineNr = 1;
         QString line;
         while (!stream.atEnd()) {
             line = stream.readLine();
             int pos = 0;
             while ((pos = expression.indexIn(line, pos)) != -1) {
-                future.reportResult(FileSearchResult(s, lineNr, line,
+                results.append(FileSearchResult(s, lineNr, line,
                                               pos, expression.matchedLength()));
                 pos += expression.matchedLength();
             }
             ++lineNr;
         }
+        if (!results.isEmpty()) {
+            future.reportResults(results);
+            results.clear();
+        }
         ++numFilesSearched;
         future.setProgressValueAndText(numFilesSearched, msgFound(searchTerm, numMatches, numFilesSearched, files.size()));
-        if (needsToCloseFile)
-            file.close();
+        stream.setDevice(0);
+        device->close();
     }
     if (!future.isCanceled())
         future.setProgressValueAndText(numFilesSearched, msgFound(searchTerm, numMatches, numFilesSearched));
@@ -247,15 +263,15 @@ void runFileSearchRegExp(QFutureInterface<FileSearchResult> &future,
 
 
 QFuture<FileSearchResult> Utils::findInFiles(const QString &searchTerm, const QStringList &files,
-    QTextDocument::FindFlags flags, QMap<QString, QString> fileToContentsMap)
+    QTextDocument::FindFlags flags, QMap<QString, QByteArray> fileToContentsMap)
 {
-    return QtConcurrent::run<FileSearchResult, QString, QStringList, QTextDocument::FindFlags, QMap<QString, QString> >
+    return QtConcurrent::run<FileSearchResult, QString, QStringList, QTextDocument::FindFlags, QMap<QString, QByteArray> >
             (runFileSearch, searchTerm, files, flags, fileToContentsMap);
 }
 
 QFuture<FileSearchResult> Utils::findInFilesRegExp(const QString &searchTerm, const QStringList &files,
-    QTextDocument::FindFlags flags, QMap<QString, QString> fileToContentsMap)
+    QTextDocument::FindFlags flags, QMap<QString, QByteArray> fileToContentsMap)
 {
-    return QtConcurrent::run<FileSearchResult, QString, QStringList, QTextDocument::FindFlags, QMap<QString, QString> >
+    return QtConcurrent::run<FileSearchResult, QString, QStringList, QTextDocument::FindFlags, QMap<QString, QByteArray> >
             (runFileSearchRegExp, searchTerm, files, flags, fileToContentsMap);
 }
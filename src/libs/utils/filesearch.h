@@ -54,11 +54,13 @@ public:
     int matchLength;
 };
 
+// fileToContentsMap holds the UTF-8 contents to search instead of the files on disk,
+// for example of documents open in editors. The contents are shared, not copied.
 QTCREATOR_UTILS_EXPORT QFuture<FileSearchResult> findInFiles(const QString &searchTerm, const QStringList &files,
-    QTextDocument::FindFlags flags, QMap<QString, QString> fileToContentsMap = QMap<QString, QString>());
+    QTextDocument::FindFlags flags, QMap<QString, QByteArray> fileToContentsMap = QMap<QString, QByteArray>());
 
 QTCREATOR_UTILS_EXPORT QFuture<FileSearchResult> findInFilesRegExp(const QString &searchTerm, const QStringList &files,
-    QTextDocument::FindFlags flags, QMap<QString, QString> fileToContentsMap = QMap<QString, QString>());
+    QTextDocument::FindFlags flags, QMap<QString, QByteArray> fileToContentsMap = QMap<QString, QByteArray>());
 
 } // namespace Utils
 
@@ -11,6 +11,9 @@
 #include <texteditor/texteditorsettings.h>
 #include <qtscripteditor/qtscripteditor.h>
 #include <projectexplorer/project.h>
+#include <projectexplorer/buildmanager.h>
+#include <projectexplorer/buildparserinterface.h>
+#include "ananasprojectconstants.h"
 #include "libananas/configinfo.h"
 
 using namespace AnanasProjectManager;
@@ -163,7 +166,7 @@ if (item->hasChildren())
 return false;
 }
 
-AnanasExplorerSideBar::AnanasExplorerSideBar(/*const QString &fname,*/ QWidget *parent):QTreeView(parent)
+AnanasExplorerSideBar::AnanasExplorerSideBar(/*const QString &fname,*/ QWidget *parent):QTreeView(parent), cfgValidator(0)
 {
     ProjectExplorer::ProjectExplorerPlugin *pe = ProjectExplorer::ProjectExplorerPlugin::instance();
     connect(pe, SIGNAL(currentProjectChanged(ProjectExplorer::Project*)),
@@ -256,6 +259,12 @@ int AnanasExplorerSideBar::read_xml()
         return RC_ERROR;
     }
     cfg = new DomCfgItem(xml,0,0);
+    cfgWriter.scan(buf, valueRc["configfile"]);
+
+    delete cfgValidator;
+    cfgValidator = new aCfgValidator(cfg, this);
+    connect(cfgValidator, SIGNAL(diagnosticsChanged()), this, SLOT(publishDiagnostics()));
+    cfgValidator->scheduleValidation();
     return RC_OK;
 }
 
@@ -282,6 +291,10 @@ QDomNode node = item->node();
             info->show();
         }
     }
+    if (a->text()==tr("Save")) {
+        if (node.nodeName()=="xml")
+            saveConfiguration();
+    }
     if (a->text()==tr("Edit")) {
         if (node.nodeName()==md_catalogue) {
            QString titlePattern = tr("Catalogue $");
@@ -296,7 +309,6 @@ QDomNode node = item->node();
            if (!QMetaObject::invokeMethod(editor->widget(), "setData",Qt::DirectConnection,
             Q_ARG(DomCfgItem*, item)))
                qCritical() << "Can't invoke method!";
-            connect(manager,SIGNAL(editorsClosed(QList<Core::IEditor*>)),editor->widget(),SLOT(updateMD(QList<Core::IEditor*>)));
           }
         }
         //JOURNAL EDITOR
@@ -313,7 +325,6 @@ QDomNode node = item->node();
             if (!QMetaObject::invokeMethod(editor->widget(), "setData",Qt::DirectConnection,
               Q_ARG(DomCfgItem*, item)))
                  qCritical() << "Can't invoke method!";
-              connect(manager,SIGNAL(editorsClosed(QList<Core::IEditor*>)),editor->widget(),SLOT(updateMD(QList<Core::IEditor*>)));
             }
         }
     }
@@ -336,7 +347,6 @@ QDomNode node = item->node();
            if (!QMetaObject::invokeMethod(editor->widget(), "setData",Qt::DirectConnection,
             Q_ARG(DomCfgItem*, catalogue)))
                qCritical() << "Can't invoke method!";
-            connect(manager,SIGNAL(editorsClosed(QList<Core::IEditor*>)),editor->widget(),SLOT(updateMD(QList<Core::IEditor*>)));
           }
         }
         if(node.nodeName()==md_journal){
@@ -354,7 +364,6 @@ QDomNode node = item->node();
             if (!QMetaObject::invokeMethod(editor->widget(), "setData",Qt::DirectConnection,
              Q_ARG(DomCfgItem*, journal)))
                 qCritical() << "Can't invoke method!";
-             connect(manager,SIGNAL(editorsClosed(QList<Core::IEditor*>)),editor->widget(),SLOT(updateMD(QList<Core::IEditor*>)));
         }
         }
     }
@@ -376,6 +385,34 @@ QDomNode node = item->node();
         }
 }
 
+void AnanasExplorerSideBar::saveConfiguration()
+{
+    QTime timer;
+    timer.start();
+    if (!cfgWriter.save(cfg, valueRc["configfile"])) {
+        Core::ICore::instance()->messageManager()->printToOutputPane(
+            tr("Error saving configuration: %1").arg(cfgWriter.errorString()), true);
+        return;
+    }
+    if (debug)
+        qDebug() << "AnanasExplorerSideBar::saveConfiguration()" << timer.elapsed() << "ms,"
+                 << cfgWriter.copiedBytes() << "bytes copied unchanged";
+}
+
+void AnanasExplorerSideBar::publishDiagnostics()
+{
+    ProjectExplorer::BuildManager *buildManager =
+        ProjectExplorer::ProjectExplorerPlugin::instance()->buildManager();
+    const QString category = QLatin1String(Constants::TASK_CATEGORY_VALIDATION);
+    buildManager->clearTasks(category);
+    foreach (const aCfgDiagnostic &diagnostic, cfgValidator->diagnostics()) {
+        const int type = diagnostic.type == aCfgDiagnostic::Error
+                         ? ProjectExplorer::BuildParserInterface::Error
+                         : ProjectExplorer::BuildParserInterface::Warning;
+        buildManager->addTask(category, valueRc["configfile"], type, diagnostic.line, diagnostic.description);
+    }
+}
+
 void AnanasExplorerSideBar::updateActions()
 {
 //    foreach (Core::IEditor *editor, editors) {
@@ -419,7 +456,6 @@ if ( index.isValid() ) {
              manager->activateEditor(editor);
              QMetaObject::invokeMethod(editor->widget(), "setData",
              Q_ARG(DomCfgItem*, item));
-             connect(manager,SIGNAL(editorsClosed(QList<Core::IEditor*>)),editor->widget(),SLOT(updateMD(QList<Core::IEditor*>)));
           }
         }
 //        if ( nodeName==md_form )
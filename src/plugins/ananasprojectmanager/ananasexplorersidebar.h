@@ -6,6 +6,8 @@
 #include <QTreeWidget>
 #include <projectexplorer/projectexplorer.h>
 #include "libananas/acfg.h"
+#include "libananas/acfgwriter.h"
+#include "libananas/acfgvalidator.h"
 
 namespace AnanasProjectManager {
 namespace Internal {
@@ -45,7 +47,10 @@ public:
 private:
     QHash<QString, QString> read(const QString &fname);
     int read_xml();
+    void saveConfiguration();
     DomCfgItem *cfg;
+    aCfgWriter cfgWriter;
+    aCfgValidator *cfgValidator;
     QString  cfgFile;
     QHash<QString, QString> valueRc;
 private:
@@ -58,6 +63,7 @@ private slots:
         void doubleClicked ( const QModelIndex & index );
         void setCurrentFile(ProjectExplorer::Project* project);
         void updateActions();
+        void publishDiagnostics();
 };
 }
 }
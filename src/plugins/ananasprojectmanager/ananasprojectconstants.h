@@ -49,6 +49,9 @@ const char *const PROJECT_KIND       = "ANANAS";
 const char *const FILES_EDITOR       = ".ananasproject Editor";
 const char *const FILES_MIMETYPE     = ANANASMIMETYPE;
 
+// task window category of the configuration validator
+const char *const TASK_CATEGORY_VALIDATION = "AnanasProject.Validation";
+
 } // namespace Constants
 } // namespace AnanasProjectManager
 
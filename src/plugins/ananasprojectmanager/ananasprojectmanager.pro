@@ -17,6 +17,8 @@ HEADERS = ananasproject.h \
     ananasviewnavigationwidgetfactory.h \
     ananasexplorersidebar.h \
     libananas/acfg.h \
+    libananas/acfgwriter.h \
+    libananas/acfgvalidator.h \
     libananas/configinfo.h
 SOURCES = ananasproject.cpp \
     ananasprojectplugin.cpp \
@@ -29,6 +31,8 @@ SOURCES = ananasproject.cpp \
     ananasviewnavigationwidgetfactory.cpp \
     ananasexplorersidebar.cpp \
     libananas/acfg.cpp \
+    libananas/acfgwriter.cpp \
+    libananas/acfgvalidator.cpp \
     libananas/configinfo.cpp
 FORMS = libananas/configinfo.ui
 RESOURCES += ananasproject.qrc \
@@ -84,30 +84,18 @@ void AnanasProjectNode::refresh()
 {
     using namespace ProjectExplorer;
 
-    // remove the existing nodes.
-    removeFileNodes(fileNodes(), this);
-    removeFolderNodes(subFolderNodes(), this);
-
-    //ProjectExplorerPlugin::instance()->setCurrentNode(0); // ### remove me
-
-    FileNode *projectFilesNode = new FileNode(m_project->filesFileName(),
-                                              ProjectFileType,
-                                              /* generated = */ false);
-
-    QStringList files = m_project->files();
-    files.removeAll(m_project->filesFileName());
-
-    addFileNodes(QList<FileNode *>()
-                 << projectFilesNode,
-                 this);
-    if (m_rc.contains("configfile")) {
-        FileNode *configFilesNode = new FileNode(m_rc.value("configfile"),
-                                              ProjectFileType,
-                                              /* generated = */ false);
-        addFileNodes(QList<FileNode *>()
-                  << configFilesNode,
-                 this);
-    }
+    // re-read the rc file, the config file may have moved.
+    m_rc.clear();
+    parseRc();
+
+    QHash<QString, FileType> projectFiles;
+    projectFiles.insert(m_project->filesFileName(), ProjectFileType);
+    if (m_rc.contains("configfile"))
+        projectFiles.insert(m_rc.value("configfile"), ProjectFileType);
+
+    // only the changed nodes are removed and added.
+    updateFileNodes(projectFiles, this);
+
 //    QStringList filePaths;
 //    QHash<QString, QStringList> filesInPath;
 //
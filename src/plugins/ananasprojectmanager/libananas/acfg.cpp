@@ -114,7 +114,7 @@ void (*cfg_messageproc)(int , const char *)=NULL;
 //}
 
 
-DomCfgItem::DomCfgItem(QDomNode &node, int row, DomCfgItem *parent):QObject(parent)
+DomCfgItem::DomCfgItem(QDomNode &node, int row, DomCfgItem *parent):QObject(parent), fCompressed(false), fModified(false)
 {
     domNode = node;
 
@@ -207,8 +207,9 @@ if (childNode.nodeName()==md_root)
 QDomElement images = childNode.firstChildElement(md_image_collection);
 
 if (!images.isNull()) {
-childItem = new DomCfgItem(images, 7, this);
-         childItems[7] = childItem;
+if (!childItems.contains(7))
+    childItems[7] = new DomCfgItem(images, 7, this);
+childItem = childItems[7];
 }
 
 QDomElement metadata = childNode.firstChildElement(md_metadata);
@@ -216,32 +217,37 @@ for(int j=0;j<metadata.childNodes().count();j++) {
 QDomNode childNodeL = metadata.childNodes().item(j);
 QString nodeName = childNodeL.nodeName();
 if (nodeName==md_catalogues) {
-childItem = new DomCfgItem(childNodeL, 1, this);
-         childItems[1] = childItem;
+if (!childItems.contains(1))
+    childItems[1] = new DomCfgItem(childNodeL, 1, this);
+childItem = childItems[1];
 firstChildItem=childItem;
 };
 if (nodeName==md_documents) {
-childItem = new DomCfgItem(childNodeL, 2, this);
-         childItems[2] = childItem;
+if (!childItems.contains(2))
+    childItems[2] = new DomCfgItem(childNodeL, 2, this);
+childItem = childItems[2];
 }
 if (nodeName==md_journals) {
-childItem = new DomCfgItem(childNodeL, 3, this);
-         childItems[3] = childItem;
+if (!childItems.contains(3))
+    childItems[3] = new DomCfgItem(childNodeL, 3, this);
+childItem = childItems[3];
 }
 if (nodeName==md_reports) {
-childItem = new DomCfgItem(childNodeL, 4, this);
-         childItems[4] = childItem;
+if (!childItems.contains(4))
+    childItems[4] = new DomCfgItem(childNodeL, 4, this);
+childItem = childItems[4];
 }
 if (nodeName==md_registers) {
 for(int j1=0;j1<childNodeL.childNodes().count();j1++)
 {
 QDomNode childReg = childNodeL.childNodes().item(j1);
-childItem = new DomCfgItem(childReg, 5+j1, this);
-         childItems[5+j1] = childItem;
+if (!childItems.contains(5+j1))
+    childItems[5+j1] = new DomCfgItem(childReg, 5+j1, this);
+childItem = childItems[5+j1];
 }
 }
 }
-return firstChildItem;
+return childItems.contains(i) ? childItems.value(i) : firstChildItem;
 }
         if (domNode.nodeName()==md_element || domNode.nodeName()==md_group)
 {
@@ -253,15 +259,16 @@ return firstChildItem;
             if (listNode.item(j).nodeName()==md_field)
             {
                 QDomNode item = listNode.item(j);
-                childItem = new DomCfgItem(item, nodeI, this);
-                childItems[nodeI]=childItem;
+                if (!childItems.contains(nodeI))
+                    childItems[nodeI] = new DomCfgItem(item, nodeI, this);
+                childItem = childItems[nodeI];
                 if (!firstChildItem)
                                 firstChildItem=childItem;
                 nodeI++;
             }
         }
 
-        return childItems[i];
+        return childItems.value(i);
     }
 
 if (domNode.nodeName()==md_columns )
@@ -270,15 +277,16 @@ int nodeI = 0;
 QDomNode cur = domNode.firstChild();
 while(!cur.isNull()) {
 if (cur.nodeName()!=md_used_doc) {
-childItem = new DomCfgItem(cur, nodeI, this);
-childItems[nodeI]=childItem;
+if (!childItems.contains(nodeI))
+    childItems[nodeI] = new DomCfgItem(cur, nodeI, this);
+childItem = childItems[nodeI];
 nodeI++;
 if (!firstChildItem)
 firstChildItem=childItem;
 }
 cur = cur.nextSibling();
 }
-return firstChildItem;
+return childItems.contains(i) ? childItems.value(i) : firstChildItem;
 }
 if (domNode.nodeName()==md_aregister || domNode.nodeName()==md_iregister)
 {
@@ -286,15 +294,16 @@ int nodeI = 0;
 QDomNode cur = domNode.firstChild();
 while(!cur.isNull()) {
 if (cur.nodeName()!=md_description) {
-childItem = new DomCfgItem(cur, nodeI, this);
-childItems[nodeI]=childItem;
+if (!childItems.contains(nodeI))
+    childItems[nodeI] = new DomCfgItem(cur, nodeI, this);
+childItem = childItems[nodeI];
 nodeI++;
 if (!firstChildItem)
 firstChildItem=childItem;
 }
 cur = cur.nextSibling();
 }
-return firstChildItem;
+return childItems.contains(i) ? childItems.value(i) : firstChildItem;
 }
 if (domNode.nodeName()==md_form)
 {
@@ -335,8 +344,27 @@ return 0;
 
 bool DomCfgItem::remove(int i)
 {
- node().removeChild(child(i)->node());
+ DomCfgItem *item = child(i);
+ if (item==0)
+  return false;
+ node().removeChild(item->node());
+ setModified(node(), true);
+ if (rootNode->hashId.value(item->attr(mda_id))==item)
+  rootNode->hashId.remove(item->attr(mda_id));
+
+ // The items below i move up a row
+ QList<int> rows = childItems.keys();
+ qSort(rows);
  childItems.remove(i);
+ foreach (int row, rows) {
+  if (row<=i)
+   continue;
+  DomCfgItem *moved = childItems.take(row);
+  if (moved!=0)
+   moved->rowNumber = row-1;
+  childItems.insert(row-1, moved);
+ }
+ emit childRemoved(i);
  return true;
 }
 
@@ -466,6 +494,7 @@ if (domNode.nodeName()=="xml") {
 QMenu *contextMenu = new QMenu(tr("Context menu"));
 contextMenu->addAction("Open global module");
 contextMenu->addAction("Property");
+contextMenu->addAction("Save");
 return contextMenu;
 }
         if (domNode.nodeName()==md_catalogue || domNode.nodeName()==md_journal) {
@@ -564,11 +593,14 @@ DomCfgItem *DomCfgItem::find(QString f)
   if (nodeName()==f)
 return this;
 for(int i=0;i<childCount();i++) {
-if (child(i)->nodeName()==f)
-return child(i);
+DomCfgItem *item=child(i);
+if (item==0)
+continue;
+if (item->nodeName()==f)
+return item;
 else {
-if (child(i)->hasChildren()) {
-DomCfgItem *fl=child(i)->find(f);
+if (item->hasChildren()) {
+DomCfgItem *fl=item->find(f);
 if (fl!=0)
 return fl;
 }
@@ -620,7 +652,7 @@ gobj = find( md_forms );
 if ( gobj!=0 ) {
 for (int i=0;i<gobj->childCount();i++)
 {
-if (gobj->child(i)->cfgName()==oName) {
+if (gobj->child(i)!=0 && gobj->child(i)->cfgName()==oName) {
 item=gobj->child(i);
 break;
 }
@@ -664,6 +696,8 @@ if (type.at(1)=="D")
 return QObject::tr("Date");
 if (type.at(1)=="O") {
 DomCfgItem *item = findObjectById(type.at(3));
+if (item==0)
+return QObject::tr("Unknown object %1").arg(type.at(3));
                 return QObject::tr("%1").arg(item->configName());
 }
 if (type.at(1)=="N")
@@ -686,11 +720,14 @@ else
 for (int i=0;i<childCount();i++)
 {
 //aLog::print(aLog::Debug,"DomCfgItem::findObjectById(QString id) "+id+" "+child(i)->node().attributes().namedItem(mda_id).nodeValue()+"\n");
-if (child(i)->node().attributes().namedItem(mda_id).nodeValue()==id)
-return child(i);
+DomCfgItem *item=child(i);
+if (item==0)
+continue;
+if (item->node().attributes().namedItem(mda_id).nodeValue()==id)
+return item;
 else {
-if (child(i)->hasChildren()) {
-DomCfgItem *f=child(i)->findObjectById(id);
+if (item->hasChildren()) {
+DomCfgItem *f=item->findObjectById(id);
 if (f!=0)
 return f;
 }
@@ -732,6 +769,23 @@ i = xml.createElement(otype);
 if ( id >= 100 ) i.setAttribute(mda_id,QString::number(id));
 if ( !name.isNull()) i.setAttribute(mda_name,name);
 context->node().appendChild( i );
+setModified(context->node(), true);
+int row = context->childRow(i);
+if (row>=0) {
+ // Only the new item is created, the items of the other rows are kept
+ // as editors may hold them. Those at and below row move down a row.
+ QList<int> rows = context->childItems.keys();
+ qSort(rows);
+ for (int k=rows.size()-1; k>=0 && rows.at(k)>=row; --k) {
+  DomCfgItem *moved = context->childItems.take(rows.at(k));
+  if (moved!=0)
+   moved->rowNumber = rows.at(k)+1;
+  context->childItems.insert(rows.at(k)+1, moved);
+ }
+ QDomNode newNode = i;
+ context->childItems.insert(row, new DomCfgItem(newNode, row, context));
+ emit context->childInserted(row);
+}
 }
 
 bool DomCfgItem::moveUp()
@@ -741,9 +795,14 @@ bool DomCfgItem::moveUp()
     int prevrow=row()-1;
     if (currentrow==0)
             return true;
-    if (!p->node().insertBefore(node(),p->child(prevrow)->node()).isNull()) {
-        p->childItems.remove(prevrow);
-        p->childItems.remove(currentrow);
+    DomCfgItem* previous = p->child(prevrow);
+    if (!p->node().insertBefore(node(),previous->node()).isNull()) {
+        setModified(p->node(), true);
+        p->childItems[prevrow] = this;
+        p->childItems[currentrow] = previous;
+        rowNumber = prevrow;
+        previous->rowNumber = currentrow;
+        emit p->childrenSwapped(prevrow, currentrow);
         return true;
     }
     return false;
@@ -757,9 +816,14 @@ bool DomCfgItem::moveDown()
     if (currentrow==p->childCount()-1)
             return true;
 
-    if (!p->node().insertAfter(node(),p->child(prevrow)->node()).isNull()) {
-        p->childItems.remove(prevrow);
-        p->childItems.remove(currentrow);
+    DomCfgItem* next = p->child(prevrow);
+    if (!p->node().insertAfter(node(),next->node()).isNull()) {
+        setModified(p->node(), true);
+        p->childItems[prevrow] = this;
+        p->childItems[currentrow] = next;
+        rowNumber = prevrow;
+        next->rowNumber = currentrow;
+        emit p->childrenSwapped(currentrow, prevrow);
         return true;
     }
     return false;
@@ -839,10 +903,73 @@ else b.data()[ i ] = 0;
 }
 return b;
 }
+/*!
+ * Marks the whole configuration as modified. Nothing of it is copied
+ * from the source file on the next save.
+ */
 void DomCfgItem::setModified()
 {
   root()->fModified=true;
+  root()->rewritten.insert(QString());
+  emit root()->changed(QString(), true);
+}
+
+/*!
+ * Marks the changed node as modified. With structure set the children of
+ * changed were inserted, removed or moved, so none of them can be copied
+ * from the source file on the next save either.
+ */
+void DomCfgItem::setModified(const QDomNode &changed, bool structure)
+{
+  DomCfgItem *r = root();
+  r->fModified=true;
+  QString path = nodePath(changed);
+  emit r->changed(path, structure);
+  if (structure)
+    r->rewritten.insert(path);
+  while (!path.isEmpty()) {
+    r->touched.insert(path);
+    path.truncate(qMax(0, path.lastIndexOf('/')));
+  }
+}
+
+void DomCfgItem::clearModified()
+{
+  DomCfgItem *r = root();
+  r->fModified=false;
+  r->touched.clear();
+  r->rewritten.clear();
+}
+
+const QSet<QString> &DomCfgItem::touchedPaths() const
+{
+  return rootNode->touched;
+}
+
+const QSet<QString> &DomCfgItem::rewrittenPaths() const
+{
+  return rootNode->rewritten;
+}
+
+/*!
+ * Returns the position of node in its document as tag names with the
+ * index among the same named siblings, e.g.
+ * "ananas_configuration[0]/metadata[0]/catalogues[0]/catalogue[2]".
+ */
+QString DomCfgItem::nodePath(const QDomNode &node)
+{
+  QStringList parts;
+  QDomElement e = node.toElement();
+  while (!e.isNull()) {
+    int index = 0;
+    for (QDomElement s = e.previousSiblingElement(e.tagName()); !s.isNull(); s = s.previousSiblingElement(e.tagName()))
+      ++index;
+    parts.prepend(QString("%1[%2]").arg(e.tagName()).arg(index));
+    e = e.parentNode().toElement();
+  }
+  return parts.join("/");
 }
+
 bool DomCfgItem::modified()
 {
 return root()->fModified;
@@ -874,6 +1001,8 @@ return 0;
 for ( uint i = 0; i < cobj->childCount(); i++ )
 {
 fobj = cobj->child(i);
+if ( fobj->child(md_defaultmod)==0 )
+continue;
 fa = fobj->child(md_defaultmod)->nodeValue().toInt();
 if ( (fa>>formtype)%2 && fobj->attr(mda_type).toInt() == mode )
 return fobj->attr(mda_id).toInt();
@@ -893,7 +1022,8 @@ cur.removeChild( cur.firstChild() );
 QDomDocument xml;
 t = xml.createTextNode( value );
 cur.appendChild( t );
-setModified();
+setModified(cur, true);
+notifyDataChanged(name);
 }
 
 
@@ -906,7 +1036,45 @@ if ( v.section(" ", 2).isEmpty() ) v.append(" 0 *");
 if ( v.section(" ", 3).isEmpty() ) v.append(" *");
 }
   node().toElement().setAttribute( name, v );
-setModified( );
+setModified( node() );
+notifyDataChanged(name);
+}
+
+/*!
+ * Tells the editors showing this item or its parent that name changed.
+ */
+void DomCfgItem::notifyDataChanged(const QString &name)
+{
+  emit dataChanged(name);
+  // The rows of the root are groups, not children
+  if (parentItem!=0 && parentItem->parentItem!=0)
+    emit parentItem->childChanged(rowNumber);
+}
+
+/*!
+ * Returns the row of childNode as child(int) numbers it, or -1 if
+ * child(int) leaves it out.
+ */
+int DomCfgItem::childRow(const QDomNode &childNode) const
+{
+  if (parentItem==0 || domNode.nodeName()==md_form)
+    return -1;
+  const QString name = domNode.nodeName();
+  int row = 0;
+  for (QDomNode cur = domNode.firstChild(); !cur.isNull(); cur = cur.nextSibling()) {
+    bool counted = true;
+    if (name==md_element || name==md_group)
+      counted = cur.nodeName()==md_field;
+    else if (name==md_columns)
+      counted = cur.nodeName()!=md_used_doc;
+    else if (name==md_aregister || name==md_iregister)
+      counted = cur.nodeName()!=md_description;
+    if (cur==childNode)
+      return counted ? row : -1;
+    if (counted)
+      ++row;
+  }
+  return -1;
 }
 
 
@@ -43,6 +43,7 @@ Ananas configuration objects.
 #include <qmenu.h>
 #include <QtXml/qdom.h>
 #include <QHash>
+#include <QSet>
 
 #ifdef __BORLANDC__
 #define CHECK_POINT 	printf("%s:%i %s()\n",__FILE__,__LINE__,__FUNC__);
@@ -352,10 +353,23 @@ public:
     bool moveUp();
     bool moveDown();
     void setModified();
+    void setModified(const QDomNode &changed, bool structure = false);
+    void clearModified();
+    const QSet<QString> &touchedPaths() const;
+    const QSet<QString> &rewrittenPaths() const;
+    static QString nodePath(const QDomNode &node);
     long getDefaultFormId(DomCfgItem *owner,int actiontype,int mode);
     void setText(const QString &name,const QString &value );
     void setAttr(const QString &name, const QString &value);
     void setSText(const QString & subname, const QString &value);
+signals:
+    void changed(const QString &path, bool structure);	// emitted by the root item
+    // Emitted by the changed item, rows are those of child(int)
+    void dataChanged(const QString &name);	// an attribute or a text child
+    void childChanged(int row);
+    void childInserted(int row);
+    void childRemoved(int row);
+    void childrenSwapped(int row, int otherRow);
 protected:
 	QDomNode domNode;
 	QHash<int,DomCfgItem*> childItems;
@@ -365,7 +379,11 @@ private:
     DomCfgItem *parentItem;	
     int rowNumber;
     bool fCompressed, fModified;
+    QSet<QString> touched;	// paths of changed elements and their ancestors
+    QSet<QString> rewritten;	// paths of elements whose children were inserted, removed or moved
 
+    int childRow(const QDomNode &childNode) const;
+    void notifyDataChanged(const QString &name);
 };
 
 class ANANAS_EXPORT DomCfgItemInterfaces : public DomCfgItem
@@ -0,0 +1,358 @@
+#include "acfgvalidator.h"
+#include "acfg.h"
+
+#include <QHash>
+#include <QStringList>
+#include <QtConcurrentRun>
+#include <QtXml/qdom.h>
+
+enum { ValidationDelay = 500 };
+
+namespace {
+
+bool isSectionTag(const QString &tagName)
+{
+    return tagName == md_catalogue || tagName == md_document
+        || tagName == md_journal || tagName == md_report
+        || tagName == md_iregister || tagName == md_aregister;
+}
+
+bool isGroupTag(const QString &tagName)
+{
+    return tagName == md_catalogues || tagName == md_documents
+        || tagName == md_journals || tagName == md_reports
+        || tagName == md_iregisters || tagName == md_aregisters;
+}
+
+QString childPath(const QString &parentPath, const QString &tagName, int index)
+{
+    const QString part = QString("%1[%2]").arg(tagName).arg(index);
+    return parentPath.isEmpty() ? part : parentPath + '/' + part;
+}
+
+QString tagOf(const QString &path)
+{
+    const QString part = path.mid(path.lastIndexOf('/') + 1);
+    return part.left(part.indexOf('['));
+}
+
+// Resolves a path of DomCfgItem::nodePath() in document.
+QDomElement elementAt(const QDomDocument &document, const QString &path)
+{
+    QDomNode parent = document;
+    QDomElement element;
+    foreach (const QString &part, path.split('/')) {
+        const int bracket = part.indexOf('[');
+        const QString tagName = part.left(bracket);
+        int index = part.mid(bracket + 1, part.size() - bracket - 2).toInt();
+        element = parent.firstChildElement(tagName);
+        while (index-- > 0 && !element.isNull())
+            element = element.nextSiblingElement(tagName);
+        if (element.isNull())
+            break;
+        parent = element;
+    }
+    return element;
+}
+
+QString describe(const QDomElement &element)
+{
+    const QString name = element.attribute(mda_name);
+    return name.isEmpty() ? element.tagName() : QString("%1 %2").arg(element.tagName(), name);
+}
+
+void readObject(const QDomElement &element, const QString &description,
+                QList<aCfgObjectInfo> *objects)
+{
+    const QString id = element.attribute(mda_id);
+    const QString type = element.attribute(mda_type);
+    const bool isReference = type.startsWith("O ");
+    if (!id.isEmpty() || isReference) {
+        aCfgObjectInfo object;
+        object.id = id;
+        if (isReference)
+            object.reference = type.section(' ', 1, 1);
+        object.description = description;
+        object.line = element.lineNumber();
+        objects->append(object);
+    }
+}
+
+void readObjects(const QDomElement &element, const QString &section,
+                 QList<aCfgObjectInfo> *objects, bool skipSections)
+{
+    readObject(element, section.isEmpty() ? describe(element) : section + ", " + describe(element), objects);
+
+    for (QDomElement child = element.firstChildElement(); !child.isNull(); child = child.nextSiblingElement()) {
+        if (!skipSections || !isSectionTag(child.tagName()))
+            readObjects(child, section, objects, skipSections);
+    }
+}
+
+aCfgSection readSection(const QDomElement &element)
+{
+    aCfgSection section;
+    section.description = describe(element);
+    section.line = element.lineNumber();
+    section.defaultForms = -1;
+
+    if (element.tagName() == md_catalogue || element.tagName() == md_document) {
+        const QDomElement forms = element.firstChildElement(md_forms);
+        if (!forms.firstChildElement(md_form).isNull()) {
+            section.defaultForms = 0;
+            for (QDomElement form = forms.firstChildElement(md_form); !form.isNull(); form = form.nextSiblingElement(md_form))
+                section.defaultForms |= form.firstChildElement(md_defaultmod).text().toInt();
+        }
+    }
+
+    readObject(element, section.description, &section.objects);
+    for (QDomElement child = element.firstChildElement(); !child.isNull(); child = child.nextSiblingElement())
+        readObjects(child, section.description, &section.objects, false);
+    return section;
+}
+
+// Collects the sections below parent into sections.
+void readSections(const QDomElement &parent, const QString &parentPath,
+                  QMap<QString, aCfgSection> *sections)
+{
+    QHash<QString, int> siblings;
+    for (QDomElement element = parent.firstChildElement(); !element.isNull(); element = element.nextSiblingElement()) {
+        const QString path = childPath(parentPath, element.tagName(), siblings[element.tagName()]++);
+        if (isSectionTag(element.tagName()))
+            sections->insert(path, readSection(element));
+        else
+            readSections(element, path, sections);
+    }
+}
+
+QDomDocument documentOf(DomCfgItem *root)
+{
+    const QDomNode node = root->node();
+    return node.isDocument() ? node.toDocument() : node.ownerDocument();
+}
+
+} // anonymous namespace
+
+aCfgValidator::aCfgValidator(DomCfgItem *root, QObject *parent)
+    : QObject(parent), m_root(root), m_scanned(false), m_pending(false)
+{
+    m_snapshot.lastId = -1;
+    m_snapshot.lastIdLine = -1;
+
+    m_timer.setSingleShot(true);
+    m_timer.setInterval(ValidationDelay);
+    connect(&m_timer, SIGNAL(timeout()), this, SLOT(startValidation()));
+    connect(&m_watcher, SIGNAL(finished()), this, SLOT(validationFinished()));
+    connect(m_root->root(), SIGNAL(changed(QString,bool)), this, SLOT(nodeChanged(QString)));
+}
+
+aCfgValidator::~aCfgValidator()
+{
+    m_watcher.waitForFinished();
+}
+
+QList<aCfgDiagnostic> aCfgValidator::diagnostics() const
+{
+    return m_diagnostics;
+}
+
+/*!
+ * Checks the configuration right away, on the calling thread.
+ */
+QList<aCfgDiagnostic> aCfgValidator::validate()
+{
+    m_watcher.waitForFinished();
+    updateSnapshot();
+    m_diagnostics = check(m_snapshot);
+    return m_diagnostics;
+}
+
+void aCfgValidator::scheduleValidation()
+{
+    m_timer.start();
+}
+
+void aCfgValidator::nodeChanged(const QString &path)
+{
+    m_changedPaths.insert(path);
+    m_timer.start();
+}
+
+void aCfgValidator::startValidation()
+{
+    if (m_watcher.isRunning()) {
+        m_pending = true;
+        return;
+    }
+    updateSnapshot();
+    m_watcher.setFuture(QtConcurrent::run(&aCfgValidator::check, m_snapshot));
+}
+
+void aCfgValidator::validationFinished()
+{
+    m_diagnostics = m_watcher.result();
+    emit diagnosticsChanged();
+
+    if (m_pending) {
+        m_pending = false;
+        startValidation();
+    }
+}
+
+/*!
+ * Reads the sections touched since the last update from the document.
+ */
+void aCfgValidator::updateSnapshot()
+{
+    const QDomDocument document = documentOf(m_root);
+    const QDomElement rootElement = document.documentElement();
+
+    bool full = !m_scanned || m_changedPaths.contains(QString());
+    bool rest = false;
+    QStringList groups;
+    QSet<QString> sections;
+
+    foreach (const QString &path, m_changedPaths) {
+        if (full)
+            break;
+        if (isGroupTag(tagOf(path))) {
+            groups.append(path);
+            continue;
+        }
+
+        QString section = path;
+        while (!section.isEmpty() && !m_snapshot.sections.contains(section))
+            section.truncate(qMax(0, section.lastIndexOf('/')));
+        if (!section.isEmpty()) {
+            sections.insert(section);
+            continue;
+        }
+
+        // An ancestor of the groups changed, anything may have moved.
+        const QString prefix = path + '/';
+        QMap<QString, aCfgSection>::const_iterator below = m_snapshot.sections.lowerBound(prefix);
+        if (below != m_snapshot.sections.constEnd() && below.key().startsWith(prefix))
+            full = true;
+        else
+            rest = true;
+    }
+    m_changedPaths.clear();
+
+    if (full) {
+        m_snapshot.sections.clear();
+        if (!rootElement.isNull())
+            readSections(rootElement, childPath(QString(), rootElement.tagName(), 0), &m_snapshot.sections);
+        m_scanned = true;
+        rest = true;
+    } else {
+        foreach (const QString &group, groups) {
+            const QString prefix = group + '/';
+            QMap<QString, aCfgSection>::iterator it = m_snapshot.sections.lowerBound(prefix);
+            while (it != m_snapshot.sections.end() && it.key().startsWith(prefix))
+                it = m_snapshot.sections.erase(it);
+            const QDomElement element = elementAt(document, group);
+            if (!element.isNull())
+                readSections(element, group, &m_snapshot.sections);
+        }
+        foreach (const QString &section, sections) {
+            const QDomElement element = elementAt(document, section);
+            if (element.isNull() || !isSectionTag(element.tagName()))
+                m_snapshot.sections.remove(section);
+            else
+                m_snapshot.sections.insert(section, readSection(element));
+        }
+    }
+
+    if (rest) {
+        aCfgSection restSection;
+        restSection.line = -1;
+        restSection.defaultForms = -1;
+        if (!rootElement.isNull())
+            readObjects(rootElement, QString(), &restSection.objects, true);
+        m_snapshot.sections.insert(QString(), restSection);
+    }
+
+    const QDomElement lastId = rootElement.firstChildElement(md_info).firstChildElement(md_info_lastid);
+    bool ok = false;
+    m_snapshot.lastId = lastId.text().toLongLong(&ok);
+    if (!ok)
+        m_snapshot.lastId = -1;
+    m_snapshot.lastIdLine = lastId.lineNumber();
+}
+
+/*!
+ * Runs the checks over snapshot. Safe to call from any thread.
+ */
+QList<aCfgDiagnostic> aCfgValidator::check(const Snapshot &snapshot)
+{
+    QList<aCfgDiagnostic> diagnostics;
+    QHash<QString, const aCfgObjectInfo *> objectsById;
+    qlonglong highestId = 0;
+
+    QMap<QString, aCfgSection>::const_iterator section = snapshot.sections.constBegin();
+    for (; section != snapshot.sections.constEnd(); ++section) {
+        QList<aCfgObjectInfo>::const_iterator object = section->objects.constBegin();
+        for (; object != section->objects.constEnd(); ++object) {
+            if (object->id.isEmpty())
+                continue;
+            bool ok = false;
+            const qlonglong id = object->id.toLongLong(&ok);
+            if (ok && id > highestId)
+                highestId = id;
+
+            if (const aCfgObjectInfo *first = objectsById.value(object->id)) {
+                aCfgDiagnostic diagnostic;
+                diagnostic.type = aCfgDiagnostic::Error;
+                diagnostic.description = QObject::tr("Duplicate id %1 of %2, already used by %3 (line %4)")
+                                         .arg(object->id, object->description, first->description)
+                                         .arg(first->line);
+                diagnostic.line = object->line;
+                diagnostics.append(diagnostic);
+            } else {
+                objectsById.insert(object->id, &*object);
+            }
+        }
+    }
+
+    static const int formTypes[] = { md_form_new, md_form_view, md_form_edit };
+    const QString formActions[] = { QObject::tr("new objects"), QObject::tr("viewing"), QObject::tr("editing") };
+
+    for (section = snapshot.sections.constBegin(); section != snapshot.sections.constEnd(); ++section) {
+        QList<aCfgObjectInfo>::const_iterator object = section->objects.constBegin();
+        for (; object != section->objects.constEnd(); ++object) {
+            if (object->reference.isEmpty() || objectsById.contains(object->reference))
+                continue;
+            aCfgDiagnostic diagnostic;
+            diagnostic.type = aCfgDiagnostic::Error;
+            diagnostic.description = QObject::tr("%1 refers to the missing object %2")
+                                     .arg(object->description, object->reference);
+            diagnostic.line = object->line;
+            diagnostics.append(diagnostic);
+        }
+
+        if (section->defaultForms < 0)
+            continue;
+        for (int i = 0; i < 3; ++i) {
+            if ((section->defaultForms >> formTypes[i]) & 1)
+                continue;
+            aCfgDiagnostic diagnostic;
+            diagnostic.type = aCfgDiagnostic::Warning;
+            diagnostic.description = QObject::tr("%1 has no default form for %2")
+                                     .arg(section->description, formActions[i]);
+            diagnostic.line = section->line;
+            diagnostics.append(diagnostic);
+        }
+    }
+
+    if (snapshot.lastId >= 0 && snapshot.lastId < highestId) {
+        aCfgDiagnostic diagnostic;
+        diagnostic.type = aCfgDiagnostic::Error;
+        diagnostic.description = QObject::tr("The last id %1 is lower than the highest id in use, %2; "
+                                             "new objects would get used ids")
+                                 .arg(snapshot.lastId).arg(highestId);
+        diagnostic.line = snapshot.lastIdLine;
+        diagnostics.append(diagnostic);
+    }
+
+    return diagnostics;
+}
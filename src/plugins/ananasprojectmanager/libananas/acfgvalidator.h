@@ -0,0 +1,100 @@
+#ifndef ACFGVALIDATOR_H
+#define ACFGVALIDATOR_H
+
+#include "ananasglobal.h"
+
+#include <QFutureWatcher>
+#include <QList>
+#include <QMap>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QTimer>
+
+class DomCfgItem;
+
+struct ANANAS_EXPORT aCfgDiagnostic
+{
+    enum Type { Warning, Error };
+
+    Type type;
+    QString description;
+    int line;
+};
+
+/*!
+ * What the checks need to know about one element of the configuration:
+ * its id and the object an "O" type refers to.
+ */
+struct aCfgObjectInfo
+{
+    QString id;
+    QString reference;
+    QString description;
+    int line;
+};
+
+/*!
+ * The objects of one catalogue, document, journal, report or register,
+ * or of everything outside of them.
+ */
+struct aCfgSection
+{
+    QString description;
+    int line;
+    int defaultForms;           // md_form_* bits set by defaultmod, -1 if not checked
+    QList<aCfgObjectInfo> objects;
+};
+
+/*!
+ * Checks a configuration for duplicate ids, references to missing
+ * objects, missing default forms and a stale last id.
+ *
+ * The checks run on a worker thread over a snapshot of the configuration.
+ * After a change only the sections touched by DomCfgItem mutations are
+ * read from the document again.
+ */
+class ANANAS_EXPORT aCfgValidator : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Snapshot {
+        QMap<QString, aCfgSection> sections; // by DomCfgItem::nodePath()
+        qlonglong lastId;
+        int lastIdLine;
+    };
+
+    aCfgValidator(DomCfgItem *root, QObject *parent = 0);
+    ~aCfgValidator();
+
+    QList<aCfgDiagnostic> diagnostics() const;
+    QList<aCfgDiagnostic> validate();
+
+    static QList<aCfgDiagnostic> check(const Snapshot &snapshot);
+
+public slots:
+    void scheduleValidation();
+
+signals:
+    void diagnosticsChanged();
+
+private slots:
+    void nodeChanged(const QString &path);
+    void startValidation();
+    void validationFinished();
+
+private:
+    void updateSnapshot();
+
+    DomCfgItem *m_root;
+    Snapshot m_snapshot;
+    bool m_scanned;
+    QSet<QString> m_changedPaths;
+    QTimer m_timer;
+    QFutureWatcher<QList<aCfgDiagnostic> > m_watcher;
+    bool m_pending;
+    QList<aCfgDiagnostic> m_diagnostics;
+};
+
+#endif // ACFGVALIDATOR_H
@@ -0,0 +1,370 @@
+#include "acfgwriter.h"
+#include "acfg.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QObject>
+#include <QStringList>
+#include <QXmlStreamReader>
+#include <QXmlStreamWriter>
+#include <QtXml/qdom.h>
+
+enum {
+    MaxCopyDepth = 4,               // ananas_configuration/metadata/catalogues/catalogue
+    CopyChunkSize = 64 * 1024
+};
+
+namespace {
+
+// Maps the character offsets of QXmlStreamReader to byte offsets in UTF-8
+// data. Offsets have to be asked for in increasing order.
+class Utf8Cursor
+{
+public:
+    Utf8Cursor(const QByteArray &data)
+        : m_data(data), m_chars(0), m_bytes(0)
+    {
+        if (data.startsWith("\xef\xbb\xbf"))
+            m_bytes = 3;
+    }
+
+    qint64 byteOffset(qint64 charOffset)
+    {
+        while (m_chars < charOffset && m_bytes < m_data.size()) {
+            const uchar c = m_data.at(m_bytes);
+            if (c >= 0xf0) {
+                m_bytes += 4;
+                m_chars += 2; // surrogate pair
+            } else if (c >= 0xe0) {
+                m_bytes += 3;
+                ++m_chars;
+            } else if (c >= 0xc0) {
+                m_bytes += 2;
+                ++m_chars;
+            } else {
+                ++m_bytes;
+                ++m_chars;
+            }
+        }
+        return m_bytes;
+    }
+
+private:
+    const QByteArray &m_data;
+    qint64 m_chars;
+    qint64 m_bytes;
+};
+
+// True if data holds the start tag of tagName at offset.
+bool startsElement(const QByteArray &data, const QString &tagName)
+{
+    const QByteArray start = '<' + tagName.toUtf8();
+    if (!data.startsWith(start) || data.size() <= start.size())
+        return false;
+    const char next = data.at(start.size());
+    return next == '>' || next == '/' || next == ' ' || next == '\t' || next == '\r' || next == '\n';
+}
+
+QString pathPart(const QString &tagName, int index)
+{
+    return QString("%1[%2]").arg(tagName).arg(index);
+}
+
+} // anonymous namespace
+
+aCfgWriter::aCfgWriter()
+    : m_sourceSize(0), m_root(0), m_source(0), m_target(0), m_copiedBytes(0)
+{
+}
+
+/*!
+ * Records where the elements of the configuration read from fileName
+ * start and end in source. Only UTF-8 documents are scanned; for other
+ * encodings save() writes every element.
+ */
+bool aCfgWriter::scan(const QByteArray &source, const QString &fileName)
+{
+    m_ranges.clear();
+    m_pathsByOffset.clear();
+
+    const QFileInfo fileInfo(fileName);
+    m_sourceFileName = fileInfo.absoluteFilePath();
+    m_sourceSize = fileInfo.size();
+    m_sourceModified = fileInfo.lastModified();
+    if (m_sourceSize != source.size())
+        return false;
+
+    QXmlStreamReader reader(source);
+    reader.setNamespaceProcessing(false);
+    Utf8Cursor cursor(source);
+
+    QStringList path;
+    QList<qint64> begins;
+    QList<QHash<QString, int> > siblings;
+    siblings.append(QHash<QString, int>());
+
+    while (!reader.atEnd()) {
+        const qint64 previousEnd = reader.characterOffset();
+        switch (reader.readNext()) {
+        case QXmlStreamReader::StartDocument: {
+            const QString encoding = reader.documentEncoding().toString();
+            if (!encoding.isEmpty() && encoding.compare("UTF-8", Qt::CaseInsensitive))
+                return false;
+            break;
+        }
+        case QXmlStreamReader::StartElement: {
+            const QString tagName = reader.qualifiedName().toString();
+            path.append(pathPart(tagName, siblings.last()[tagName]++));
+            siblings.append(QHash<QString, int>());
+            begins.append(cursor.byteOffset(previousEnd));
+            break;
+        }
+        case QXmlStreamReader::EndElement: {
+            if (path.size() <= MaxCopyDepth) {
+                Range range;
+                range.begin = begins.last();
+                range.end = cursor.byteOffset(reader.characterOffset());
+                while (range.begin < range.end && source.at(range.begin) != '<')
+                    ++range.begin;
+                const QString tagName = reader.qualifiedName().toString();
+                if (range.end > range.begin && source.at(range.end - 1) == '>'
+                    && startsElement(source.mid(range.begin, tagName.size() + 2), tagName)) {
+                    const QString key = path.join("/");
+                    m_ranges.insert(key, range);
+                    m_pathsByOffset.insert(range.begin, key);
+                }
+            }
+            path.removeLast();
+            begins.removeLast();
+            siblings.removeLast();
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+    if (reader.hasError()) {
+        m_ranges.clear();
+        m_pathsByOffset.clear();
+        return false;
+    }
+    return true;
+}
+
+/*!
+ * Writes the configuration of root to fileName. The file is replaced only
+ * after the new contents were written completely.
+ */
+bool aCfgWriter::save(DomCfgItem *root, const QString &fileName)
+{
+    m_errorString.clear();
+    m_newRanges.clear();
+    m_copiedBytes = 0;
+
+    const QDomNode rootNode = root->node();
+    const QDomDocument document = rootNode.isDocument() ? rootNode.toDocument() : rootNode.ownerDocument();
+
+    // Copying from the source is only safe while it is what scan() saw.
+    QFile source(m_sourceFileName);
+    bool copyable = !m_ranges.isEmpty() && !root->rewrittenPaths().contains(QString());
+    if (copyable) {
+        const QFileInfo sourceInfo(m_sourceFileName);
+        copyable = sourceInfo.size() == m_sourceSize
+                   && sourceInfo.lastModified() == m_sourceModified
+                   && source.open(QIODevice::ReadOnly);
+    }
+
+    const QString tmpName = fileName + QLatin1String(".tmp");
+    QFile target(tmpName);
+    if (!target.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        m_errorString = QObject::tr("Cannot write %1: %2").arg(tmpName, target.errorString());
+        return false;
+    }
+
+    m_root = root;
+    m_source = &source;
+    m_target = &target;
+
+    QXmlStreamWriter writer(&target);
+    writer.setCodec("UTF-8");
+    writer.setAutoFormatting(false);
+    writer.writeStartDocument();
+    writer.writeCharacters("\n");
+    QHash<QString, int> siblings;
+    for (QDomNode node = document.firstChild(); !node.isNull(); node = node.nextSibling())
+        writeNode(writer, node, QString(), siblings, 1, copyable);
+    writer.writeEndDocument();
+
+    m_root = 0;
+    m_source = 0;
+    m_target = 0;
+    source.close();
+    target.close();
+
+    if (m_errorString.isEmpty() && target.error() != QFile::NoError)
+        m_errorString = QObject::tr("Cannot write %1: %2").arg(tmpName, target.errorString());
+    if (!m_errorString.isEmpty()) {
+        QFile::remove(tmpName);
+        return false;
+    }
+
+    // Keep the old configuration until the new one is in place.
+    const QString backupName = fileName + QLatin1String(".bak");
+    QFile::remove(backupName);
+    if (QFile::exists(fileName) && !QFile::rename(fileName, backupName)) {
+        m_errorString = QObject::tr("Cannot replace %1").arg(fileName);
+        QFile::remove(tmpName);
+        return false;
+    }
+    if (!QFile::rename(tmpName, fileName)) {
+        m_errorString = QObject::tr("Cannot replace %1").arg(fileName);
+        QFile::rename(backupName, fileName);
+        return false;
+    }
+    QFile::remove(backupName);
+
+    // The saved file is the source of the next save.
+    const QFileInfo fileInfo(fileName);
+    m_sourceFileName = fileInfo.absoluteFilePath();
+    m_sourceSize = fileInfo.size();
+    m_sourceModified = fileInfo.lastModified();
+    m_ranges = m_newRanges;
+    m_newRanges.clear();
+    m_pathsByOffset.clear();
+    for (RangeHash::const_iterator it = m_ranges.constBegin(); it != m_ranges.constEnd(); ++it)
+        m_pathsByOffset.insert(it.value().begin, it.key());
+
+    root->clearModified();
+    return true;
+}
+
+QString aCfgWriter::errorString() const
+{
+    return m_errorString;
+}
+
+/*!
+ * Returns the number of bytes the last save() copied from the source
+ * instead of writing them anew.
+ */
+qint64 aCfgWriter::copiedBytes() const
+{
+    return m_copiedBytes;
+}
+
+void aCfgWriter::writeNode(QXmlStreamWriter &writer, const QDomNode &node,
+                           const QString &parentPath, QHash<QString, int> &siblings,
+                           int depth, bool copyable)
+{
+    switch (node.nodeType()) {
+    case QDomNode::ElementNode: {
+        const QDomElement element = node.toElement();
+        const QString part = pathPart(element.tagName(), siblings[element.tagName()]++);
+        const QString path = parentPath.isEmpty() ? part : parentPath + '/' + part;
+        writeElement(writer, element, path, depth, copyable);
+        break;
+    }
+    case QDomNode::TextNode:
+        writer.writeCharacters(node.nodeValue());
+        break;
+    case QDomNode::CDATASectionNode:
+        writer.writeCDATA(node.nodeValue());
+        break;
+    case QDomNode::CommentNode:
+        writer.writeComment(node.nodeValue());
+        break;
+    case QDomNode::ProcessingInstructionNode: {
+        // The XML declaration was written by writeStartDocument()
+        const QDomProcessingInstruction pi = node.toProcessingInstruction();
+        if (pi.target() != "xml")
+            writer.writeProcessingInstruction(pi.target(), pi.data());
+        break;
+    }
+    case QDomNode::EntityReferenceNode:
+        writer.writeEntityReference(node.nodeName());
+        break;
+    case QDomNode::DocumentTypeNode: {
+        const QString name = node.toDocumentType().name();
+        if (!name.isEmpty())
+            writer.writeDTD(QString("<!DOCTYPE %1>").arg(name));
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+void aCfgWriter::writeElement(QXmlStreamWriter &writer, const QDomElement &element,
+                              const QString &path, int depth, bool copyable)
+{
+    // Closes the start tag of the parent, so the target position is exact.
+    writer.writeCharacters(QString());
+
+    if (copyable && depth <= MaxCopyDepth
+        && !m_root->touchedPaths().contains(path)
+        && copyElement(element, path))
+        return;
+
+    Range range;
+    range.begin = m_target->pos();
+
+    writer.writeStartElement(element.tagName());
+    const QDomNamedNodeMap attributes = element.attributes();
+    for (int i = 0; i < attributes.count(); ++i) {
+        const QDomAttr attribute = attributes.item(i).toAttr();
+        writer.writeAttribute(attribute.name(), attribute.value());
+    }
+
+    const bool copyChildren = copyable && depth < MaxCopyDepth
+                              && !m_root->rewrittenPaths().contains(path);
+    QHash<QString, int> siblings;
+    for (QDomNode child = element.firstChild(); !child.isNull(); child = child.nextSibling())
+        writeNode(writer, child, path, siblings, depth + 1, copyChildren);
+    writer.writeEndElement();
+
+    if (depth <= MaxCopyDepth) {
+        range.end = m_target->pos();
+        m_newRanges.insert(path, range);
+    }
+}
+
+/*!
+ * Copies the unmodified element at path from the source, together with
+ * the recorded ranges inside it. Returns false if the element has to be
+ * written instead.
+ */
+bool aCfgWriter::copyElement(const QDomElement &element, const QString &path)
+{
+    const RangeHash::const_iterator it = m_ranges.constFind(path);
+    if (it == m_ranges.constEnd())
+        return false;
+    const Range range = it.value();
+
+    if (!m_source->seek(range.begin)
+        || !startsElement(m_source->read(element.tagName().size() + 2), element.tagName())
+        || !m_source->seek(range.begin))
+        return false;
+
+    const qint64 begin = m_target->pos();
+    for (qint64 remaining = range.end - range.begin; remaining > 0; ) {
+        const QByteArray chunk = m_source->read(qMin<qint64>(remaining, CopyChunkSize));
+        if (chunk.isEmpty() || m_target->write(chunk) != chunk.size()) {
+            // Part of the element is written already, the save has failed.
+            m_errorString = QObject::tr("Cannot copy %1 from %2").arg(path, m_sourceFileName);
+            return true;
+        }
+        remaining -= chunk.size();
+    }
+    m_copiedBytes += range.end - range.begin;
+
+    PathMap::const_iterator inner = m_pathsByOffset.lowerBound(range.begin);
+    for (; inner != m_pathsByOffset.constEnd() && inner.key() < range.end; ++inner) {
+        const Range old = m_ranges.value(inner.value());
+        Range moved;
+        moved.begin = old.begin - range.begin + begin;
+        moved.end = old.end - range.begin + begin;
+        m_newRanges.insert(inner.value(), moved);
+    }
+    return true;
+}
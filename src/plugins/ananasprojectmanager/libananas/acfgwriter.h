@@ -0,0 +1,68 @@
+#ifndef ACFGWRITER_H
+#define ACFGWRITER_H
+
+#include "ananasglobal.h"
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QHash>
+#include <QMap>
+#include <QString>
+
+class DomCfgItem;
+class QDomElement;
+class QDomNode;
+class QFile;
+class QXmlStreamWriter;
+
+/*!
+ * Writes a configuration back to disk.
+ *
+ * The document is streamed into a temporary file that replaces the
+ * configuration only once it is complete, so the text of the whole
+ * document is never held in memory. Elements that were not modified
+ * since the configuration was read are copied byte for byte from the
+ * source file, using the offsets recorded by scan().
+ */
+class ANANAS_EXPORT aCfgWriter
+{
+public:
+    aCfgWriter();
+
+    bool scan(const QByteArray &source, const QString &fileName);
+    bool save(DomCfgItem *root, const QString &fileName);
+
+    QString errorString() const;
+    qint64 copiedBytes() const;
+
+private:
+    struct Range {
+        qint64 begin;
+        qint64 end;
+    };
+    typedef QHash<QString, Range> RangeHash;
+    typedef QMap<qint64, QString> PathMap;
+
+    void writeNode(QXmlStreamWriter &writer, const QDomNode &node,
+                   const QString &parentPath, QHash<QString, int> &siblings,
+                   int depth, bool copyable);
+    void writeElement(QXmlStreamWriter &writer, const QDomElement &element,
+                      const QString &path, int depth, bool copyable);
+    bool copyElement(const QDomElement &element, const QString &path);
+
+    QString m_sourceFileName;
+    qint64 m_sourceSize;
+    QDateTime m_sourceModified;
+    RangeHash m_ranges;
+    PathMap m_pathsByOffset; // element paths in document order
+
+    // Only valid during save()
+    DomCfgItem *m_root;
+    QFile *m_source;
+    QFile *m_target;
+    RangeHash m_newRanges;
+    qint64 m_copiedBytes;
+    QString m_errorString;
+};
+
+#endif // ACFGWRITER_H
@@ -42,6 +42,7 @@ newInfoElement.appendChild(comment);
 
 
 element.replaceChild(newInfoElement, oldInfoElement);
+node->setModified(element, true);
 QDialog::accept();
 }
 
@@ -45,6 +45,10 @@
 
 using namespace BINEditor;
 
+// Line numbers are ints (they are scroll bar values), which limits the
+// range that can be shown in lazy mode to about 32 GB.
+static const qint64 MaxLazySize = qint64(INT_MAX - 1) * 16;
+
 // QByteArray::toLower() is broken, it stops at the first \0
 static void lower(QByteArray &ba)
 {
@@ -57,7 +61,7 @@ static void lower(QByteArray &ba)
     }
 }
 
-static QByteArray calculateHexPattern(const QByteArray &pattern)
+QByteArray BinEditor::calculateHexPattern(const QByteArray &pattern)
 {
     QByteArray result;
     if (pattern.size() % 2 == 0) {
@@ -93,6 +97,7 @@ BinEditor::BinEditor(QWidget *parent)
     m_lowNibble = false;
     m_cursorVisible = false;
     m_caseSensitiveSearch = false;
+    m_lazyData.setMaxCost(LazyCacheSize);
     setFocusPolicy(Qt::WheelFocus);
 }
 
@@ -112,7 +117,7 @@ void BinEditor::init()
     m_lineHeight = fm.lineSpacing();
     m_charWidth = fm.width(QChar(QLatin1Char('M')));
     m_columnWidth = 2 * m_charWidth + fm.width(QChar(QLatin1Char(' ')));
-    m_numLines = m_size / 16 + 1;
+    m_numLines = int(m_size / 16) + 1;
     m_numVisibleLines = viewport()->height() / m_lineHeight;
     m_textWidth = 16 * m_charWidth + m_charWidth;
     int m_numberWidth = fm.width(QChar(QLatin1Char('9')));
@@ -155,16 +160,24 @@ void BinEditor::addLazyData(quint64 block, const QByteArray &data)
     Q_ASSERT(data.size() == m_blockSize);
     const quint64 addr = block * m_blockSize;
     if (addr >= m_baseAddr && addr <= m_baseAddr + m_size - 1) {
-        if (m_lazyData.size() * m_blockSize >= 64 * 1024 * 1024)
-            m_lazyData.clear();
         const int translatedBlock = (addr - m_baseAddr) / m_blockSize;
-        m_lazyData.insert(translatedBlock, data);
+        m_lazyData.insert(translatedBlock, new QByteArray(data), data.size());
         m_lazyRequests.remove(translatedBlock);
         viewport()->update();
     }
 }
 
-bool BinEditor::requestDataAt(int pos, bool synchronous) const
+// Drops the blocks fetched so far, e.g. because the memory they came from
+// has changed. They are requested again as soon as they are shown.
+void BinEditor::clearLazyData()
+{
+    Q_ASSERT(m_inLazyMode);
+    m_lazyData.clear();
+    m_lazyRequests.clear();
+    viewport()->update();
+}
+
+bool BinEditor::requestDataAt(qint64 pos, bool synchronous) const
 {
     if (!m_inLazyMode)
         return true;
@@ -173,8 +186,7 @@ bool BinEditor::requestDataAt(int pos, bool synchronous) const
     QMap<int, QByteArray>::const_iterator it = m_modifiedData.find(block);
     if (it != m_modifiedData.constEnd())
         return true;
-    it = m_lazyData.find(block);
-    if (it == m_lazyData.end()) {
+    if (!m_lazyData.contains(block)) {
         if (!m_lazyRequests.contains(block)) {
             m_lazyRequests.insert(block);
             emit const_cast<BinEditor*>(this)->
@@ -188,48 +200,46 @@ bool BinEditor::requestDataAt(int pos, bool synchronous) const
     return true;
 }
 
-char BinEditor::dataAt(int pos) const
+char BinEditor::dataAt(qint64 pos) const
 {
     if (!m_inLazyMode)
-        return m_data.at(pos);
+        return m_data.at(int(pos));
     int block = pos / m_blockSize;
-    return blockData(block).at(pos - (block*m_blockSize));
+    return blockData(block).at(int(pos % m_blockSize));
 }
 
-void BinEditor::changeDataAt(int pos, char c)
+void BinEditor::changeDataAt(qint64 pos, char c)
 {
     if (!m_inLazyMode) {
-        m_data[pos] = c;
+        m_data[int(pos)] = c;
         return;
     }
     int block = pos / m_blockSize;
+    const int offset = int(pos - qint64(block) * m_blockSize);
     QMap<int, QByteArray>::iterator it = m_modifiedData.find(block);
     if (it != m_modifiedData.end()) {
-        it.value()[pos - (block*m_blockSize)] = c;
-    } else {
-        it = m_lazyData.find(block);
-        if (it != m_lazyData.end()) {
-            QByteArray data = it.value();
-            data[pos - (block*m_blockSize)] = c;
-            m_modifiedData.insert(block, data);
-        }
+        it.value()[offset] = c;
+    } else if (const QByteArray *cached = m_lazyData.object(block)) {
+        QByteArray data = *cached;
+        data[offset] = c;
+        m_modifiedData.insert(block, data);
     }
 }
 
-QByteArray BinEditor::dataMid(int from, int length) const
+QByteArray BinEditor::dataMid(qint64 from, int length) const
 {
     if (!m_inLazyMode)
-        return m_data.mid(from, length);
+        return m_data.mid(int(from), length);
 
-    int end = from + length;
+    const qint64 end = from + length;
     int block = from / m_blockSize;
 
     QByteArray data;
     do {
         data += blockData(block++);
-    } while (block * m_blockSize < end);
+    } while (qint64(block) * m_blockSize < end);
 
-    return data.mid(from - ((from / m_blockSize) * m_blockSize), length);
+    return data.mid(int(from % m_blockSize), length);
 }
 
 QByteArray BinEditor::blockData(int block) const
@@ -241,8 +251,10 @@ QByteArray BinEditor::blockData(int block) const
         return data;
     }
     QMap<int, QByteArray>::const_iterator it = m_modifiedData.find(block);
-    return it != m_modifiedData.constEnd()
-            ? it.value() : m_lazyData.value(block, m_emptyBlock);
+    if (it != m_modifiedData.constEnd())
+        return it.value();
+    const QByteArray *cached = m_lazyData.object(block);
+    return cached ? *cached : m_emptyBlock;
 }
 
 
@@ -382,7 +394,7 @@ bool BinEditor::save(const QString &oldFileName, const QString &newFileName)
         const qint64 size = output.size();
         for (QMap<int, QByteArray>::const_iterator it = m_modifiedData.constBegin();
             it != m_modifiedData.constEnd(); ++it) {
-            if (!output.seek(it.key() * m_blockSize))
+            if (!output.seek(qint64(it.key()) * m_blockSize))
                 return false;
             if (output.write(it.value()) < m_blockSize)
                 return false;
@@ -400,7 +412,7 @@ bool BinEditor::save(const QString &oldFileName, const QString &newFileName)
     return true;
 }
 
-void BinEditor::setLazyData(quint64 startAddr, int range, int blockSize)
+void BinEditor::setLazyData(quint64 startAddr, qint64 range, int blockSize)
 {
     m_inLazyMode = true;
     m_blockSize = blockSize;
@@ -418,6 +430,7 @@ void BinEditor::setLazyData(quint64 startAddr, int range, int blockSize)
     m_baseAddr = (m_baseAddr / blockSize) * blockSize;
     m_size = m_baseAddr != 0 && static_cast<quint64>(range) >= -m_baseAddr
              ? -m_baseAddr : range;
+    m_size = qMin(m_size, MaxLazySize);
     m_addressBytes = (m_baseAddr + m_size < quint64(1) << 32
                       && m_baseAddr + m_size >= m_baseAddr) ? 4 : 8;
 
@@ -427,8 +440,8 @@ void BinEditor::setLazyData(quint64 startAddr, int range, int blockSize)
 
     init();
 
-    m_cursorPosition = startAddr - m_baseAddr;
-    verticalScrollBar()->setValue(m_cursorPosition / 16);
+    m_cursorPosition = qMin<qint64>(startAddr - m_baseAddr, m_size - 1);
+    verticalScrollBar()->setValue(int(m_cursorPosition / 16));
 
     emit cursorPositionChanged(m_cursorPosition);
     viewport()->update();
@@ -474,10 +487,10 @@ void BinEditor::wheelEvent(QWheelEvent *e)
 QRect BinEditor::cursorRect() const
 {
     int topLine = verticalScrollBar()->value();
-    int line = m_cursorPosition / 16;
+    int line = int(m_cursorPosition / 16);
     int y = (line - topLine) * m_lineHeight;
     int xoffset = horizontalScrollBar()->value();
-    int column = m_cursorPosition % 16;
+    int column = int(m_cursorPosition % 16);
     int x = m_hexCursor ?
             (-xoffset + m_margin + m_labelWidth + column * m_columnWidth)
             : (-xoffset + m_margin + m_labelWidth + 16 * m_columnWidth + m_charWidth + column * m_charWidth);
@@ -485,7 +498,7 @@ QRect BinEditor::cursorRect() const
     return QRect(x, y, w, m_lineHeight);
 }
 
-int BinEditor::posAt(const QPoint &pos) const
+qint64 BinEditor::posAt(const QPoint &pos) const
 {
     int xoffset = horizontalScrollBar()->value();
     int x = xoffset + pos.x() - m_margin - m_labelWidth;
@@ -497,7 +510,7 @@ int BinEditor::posAt(const QPoint &pos) const
     if (x > 16 * m_columnWidth + m_charWidth/2) {
         x -= 16 * m_columnWidth + m_charWidth;
         for (column = 0; column < 15; ++column) {
-            int pos = (topLine + line) * 16 + column;
+            qint64 pos = qint64(topLine + line) * 16 + column;
             if (pos < 0 || pos >= m_size)
                 break;
             QChar qc(QLatin1Char(dataAt(pos)));
@@ -509,7 +522,7 @@ int BinEditor::posAt(const QPoint &pos) const
         }
     }
 
-    return (qMin(m_size, qMin(m_numLines, topLine + line) * 16) + column);
+    return (qMin(m_size, qint64(qMin(m_numLines, topLine + line)) * 16) + column);
 }
 
 bool BinEditor::inTextArea(const QPoint &pos) const
@@ -524,21 +537,21 @@ void BinEditor::updateLines()
     updateLines(m_cursorPosition, m_cursorPosition);
 }
 
-void BinEditor::updateLines(int fromPosition, int toPosition)
+void BinEditor::updateLines(qint64 fromPosition, qint64 toPosition)
 {
     int topLine = verticalScrollBar()->value();
-    int firstLine = qMin(fromPosition, toPosition) / 16;
-    int lastLine = qMax(fromPosition, toPosition) / 16;
+    int firstLine = int(qMin(fromPosition, toPosition) / 16);
+    int lastLine = int(qMax(fromPosition, toPosition) / 16);
     int y = (firstLine - topLine) * m_lineHeight;
     int h = (lastLine - firstLine + 1 ) * m_lineHeight;
 
     viewport()->update(0, y, viewport()->width(), h);
 }
 
-int BinEditor::dataIndexOf(const QByteArray &pattern, int from, bool caseSensitive) const
+qint64 BinEditor::dataIndexOf(const QByteArray &pattern, qint64 from, bool caseSensitive) const
 {
     if (!m_inLazyMode && caseSensitive) {
-        return m_data.indexOf(pattern, from);
+        return m_data.indexOf(pattern, int(from));
     }
 
     int trailing = pattern.size();
@@ -551,10 +564,9 @@ int BinEditor::dataIndexOf(const QByteArray &pattern, int from, bool caseSensiti
     QByteArrayMatcher matcher(pattern);
 
     int block = from / m_blockSize;
-    const int end =
-        qMin<qint64>(static_cast<qint64>(from) + SearchStride, m_size);
+    const qint64 end = qMin(from + SearchStride, m_size);
     while (from < end) {
-        if (!requestDataAt(block * m_blockSize, true))
+        if (!requestDataAt(qint64(block) * m_blockSize, true))
             return -1;
         QByteArray data = blockData(block);
         ::memcpy(b, b + m_blockSize, trailing);
@@ -563,19 +575,19 @@ int BinEditor::dataIndexOf(const QByteArray &pattern, int from, bool caseSensiti
         if (!caseSensitive)
             ::lower(buffer);
 
-        int pos = matcher.indexIn(buffer, from - (block * m_blockSize) + trailing);
+        int pos = matcher.indexIn(buffer, int(from - qint64(block) * m_blockSize) + trailing);
         if (pos >= 0)
-            return pos + block * m_blockSize - trailing;
+            return pos + qint64(block) * m_blockSize - trailing;
         ++block;
-        from = block * m_blockSize - trailing;
+        from = qint64(block) * m_blockSize - trailing;
     }
     return end == m_size ? -1 : -2;
 }
 
-int BinEditor::dataLastIndexOf(const QByteArray &pattern, int from, bool caseSensitive) const
+qint64 BinEditor::dataLastIndexOf(const QByteArray &pattern, qint64 from, bool caseSensitive) const
 {
     if (!m_inLazyMode && caseSensitive)
-        return m_data.lastIndexOf(pattern, from);
+        return m_data.lastIndexOf(pattern, int(from));
 
     int trailing = pattern.size();
     if (trailing > m_blockSize)
@@ -586,9 +598,9 @@ int BinEditor::dataLastIndexOf(const QByteArray &pattern, int from, bool caseSen
     char *b = buffer.data();
 
     int block = from / m_blockSize;
-    const int lowerBound = qMax(0, from - SearchStride);
+    const qint64 lowerBound = qMax(qint64(0), from - SearchStride);
     while (from > lowerBound) {
-        if (!requestDataAt(block * m_blockSize, true))
+        if (!requestDataAt(qint64(block) * m_blockSize, true))
             return -1;
         QByteArray data = blockData(block);
         ::memcpy(b + m_blockSize, b, trailing);
@@ -597,18 +609,18 @@ int BinEditor::dataLastIndexOf(const QByteArray &pattern, int from, bool caseSen
         if (!caseSensitive)
             ::lower(buffer);
 
-        int pos = buffer.lastIndexOf(pattern, from - (block * m_blockSize));
+        int pos = buffer.lastIndexOf(pattern, int(from - qint64(block) * m_blockSize));
         if (pos >= 0)
-            return pos + block * m_blockSize;
+            return pos + qint64(block) * m_blockSize;
         --block;
-        from = block * m_blockSize + (m_blockSize-1) + trailing;
+        from = qint64(block) * m_blockSize + (m_blockSize-1) + trailing;
     }
     return lowerBound == 0 ? -1 : -2;
 }
 
 
-int BinEditor::find(const QByteArray &pattern_arg, int from,
-                    QTextDocument::FindFlags findFlags)
+qint64 BinEditor::find(const QByteArray &pattern_arg, qint64 from,
+                       QTextDocument::FindFlags findFlags)
 {
     if (pattern_arg.isEmpty())
         return 0;
@@ -621,18 +633,18 @@ int BinEditor::find(const QByteArray &pattern_arg, int from,
         ::lower(pattern);
 
     bool backwards = (findFlags & QTextDocument::FindBackward);
-    int found = backwards ? dataLastIndexOf(pattern, from, caseSensitiveSearch)
-                : dataIndexOf(pattern, from, caseSensitiveSearch);
+    qint64 found = backwards ? dataLastIndexOf(pattern, from, caseSensitiveSearch)
+                   : dataIndexOf(pattern, from, caseSensitiveSearch);
 
-    int foundHex = -1;
+    qint64 foundHex = -1;
     QByteArray hexPattern = calculateHexPattern(pattern_arg);
     if (!hexPattern.isEmpty()) {
         foundHex = backwards ? dataLastIndexOf(hexPattern, from)
                    : dataIndexOf(hexPattern, from);
     }
 
-    int pos = foundHex == -1 || (found >= 0 && (foundHex == -2 || found < foundHex))
-              ? found : foundHex;
+    qint64 pos = foundHex == -1 || (found >= 0 && (foundHex == -2 || found < foundHex))
+                 ? found : foundHex;
 
     if (pos >= m_size)
         pos = -1;
@@ -644,12 +656,12 @@ int BinEditor::find(const QByteArray &pattern_arg, int from,
     return pos;
 }
 
-int BinEditor::findPattern(const QByteArray &data, const QByteArray &dataHex, int from, int offset, int *match)
+qint64 BinEditor::findPattern(const QByteArray &data, const QByteArray &dataHex, qint64 from, qint64 offset, int *match)
 {
     if (m_searchPattern.isEmpty())
         return -1;
-    int normal = m_searchPattern.isEmpty()? -1 : data.indexOf(m_searchPattern, from - offset);
-    int hex = m_searchPatternHex.isEmpty()? -1 : dataHex.indexOf(m_searchPatternHex, from - offset);
+    int normal = m_searchPattern.isEmpty()? -1 : data.indexOf(m_searchPattern, int(from - offset));
+    int hex = m_searchPatternHex.isEmpty()? -1 : dataHex.indexOf(m_searchPatternHex, int(from - offset));
 
     if (normal >= 0 && (hex < 0 || normal < hex)) {
         if (match)
@@ -717,19 +729,19 @@ void BinEditor::paintEvent(QPaintEvent *e)
     int matchLength = 0;
 
     QByteArray patternData, patternDataHex;
-    int patternOffset = qMax(0, topLine*16 - m_searchPattern.size());
+    qint64 patternOffset = qMax(qint64(0), qint64(topLine) * 16 - m_searchPattern.size());
     if (!m_searchPattern.isEmpty()) {
-        patternData = dataMid(patternOffset, m_numVisibleLines * 16 + (topLine*16 - patternOffset));
+        patternData = dataMid(patternOffset, m_numVisibleLines * 16 + int(qint64(topLine) * 16 - patternOffset));
         patternDataHex = patternData;
         if (!m_caseSensitiveSearch)
             ::lower(patternData);
     }
 
 
-    int foundPatternAt = findPattern(patternData, patternDataHex, patternOffset, patternOffset, &matchLength);
+    qint64 foundPatternAt = findPattern(patternData, patternDataHex, patternOffset, patternOffset, &matchLength);
 
-    int selStart = qMin(m_cursorPosition, m_anchorPosition);
-    int selEnd = qMax(m_cursorPosition, m_anchorPosition);
+    qint64 selStart = qMin(m_cursorPosition, m_anchorPosition);
+    qint64 selEnd = qMax(m_cursorPosition, m_anchorPosition);
 
     QString itemString(16*3, QLatin1Char(' '));
     QChar *itemStringData = itemString.data();
@@ -741,6 +753,7 @@ void BinEditor::paintEvent(QPaintEvent *e)
         int line = topLine + i;
         if (line >= m_numLines)
             break;
+        const qint64 lineStart = qint64(line) * 16;
 
         int y = i * m_lineHeight + m_ascent;
         if (y - m_ascent > e->rect().bottom())
@@ -750,19 +763,19 @@ void BinEditor::paintEvent(QPaintEvent *e)
 
 
         painter.drawText(-xoffset, i * m_lineHeight + m_ascent,
-                         addressString(m_baseAddr + ((uint) line) * 16));
+                         addressString(m_baseAddr + lineStart));
 
         int cursor = -1;
-        if (line * 16 <= m_cursorPosition && m_cursorPosition < line * 16 + 16)
-            cursor = m_cursorPosition - line * 16;
+        if (lineStart <= m_cursorPosition && m_cursorPosition < lineStart + 16)
+            cursor = int(m_cursorPosition - lineStart);
 
-        bool hasData = requestDataAt(line * 16);
+        bool hasData = requestDataAt(lineStart);
 
         QString printable;
 
         if (hasData) {
             for (int c = 0; c < 16; ++c) {
-                int pos = line * 16 + c;
+                qint64 pos = lineStart + c;
                 if (pos >= m_size)
                     break;
                 QChar qc(QLatin1Char(dataAt(pos)));
@@ -777,11 +790,11 @@ void BinEditor::paintEvent(QPaintEvent *e)
         QRect selectionRect;
         QRect printableSelectionRect;
 
-        bool isFullySelected = (selStart < selEnd && selStart <= line*16 && (line+1)*16 <= selEnd);
+        bool isFullySelected = (selStart < selEnd && selStart <= lineStart && lineStart + 16 <= selEnd);
 
         if (hasData) {
             for (int c = 0; c < 16; ++c) {
-                int pos = line * 16 + c;
+                qint64 pos = lineStart + c;
                 if (pos >= m_size) {
                     while (c < 16) {
                         itemStringData[c*3] = itemStringData[c*3+1] = ' ';
@@ -902,20 +915,20 @@ void BinEditor::paintEvent(QPaintEvent *e)
 }
 
 
-int BinEditor::cursorPosition() const
+qint64 BinEditor::cursorPosition() const
 {
     return m_cursorPosition;
 }
 
-void BinEditor::setCursorPosition(int pos, MoveMode moveMode)
+void BinEditor::setCursorPosition(qint64 pos, MoveMode moveMode)
 {
-    pos = qMin(m_size-1, qMax(0, pos));
+    pos = qMin(m_size-1, qMax(qint64(0), pos));
     if (pos == m_cursorPosition
         && (m_anchorPosition == m_cursorPosition || moveMode == KeepAnchor)
         && !m_lowNibble)
         return;
 
-    int oldCursorPosition = m_cursorPosition;
+    qint64 oldCursorPosition = m_cursorPosition;
 
     bool hasSelection = m_anchorPosition != m_cursorPosition;
     m_lowNibble = false;
@@ -943,9 +956,9 @@ void BinEditor::ensureCursorVisible()
     QRect vr = viewport()->rect();
     if (!vr.contains(cr)) {
         if (cr.top() < vr.top())
-            verticalScrollBar()->setValue(m_cursorPosition / 16);
+            verticalScrollBar()->setValue(int(m_cursorPosition / 16));
         else if (cr.bottom() > vr.bottom())
-            verticalScrollBar()->setValue(m_cursorPosition / 16 - m_numVisibleLines + 1);
+            verticalScrollBar()->setValue(int(m_cursorPosition / 16) - m_numVisibleLines + 1);
     }
 }
 
@@ -1050,10 +1063,10 @@ void BinEditor::keyPressEvent(QKeyEvent *e)
         break;
     case Qt::Key_PageUp:
     case Qt::Key_PageDown: {
-        int line = qMax(0, m_cursorPosition / 16 - verticalScrollBar()->value());
+        int line = qMax(0, int(m_cursorPosition / 16) - verticalScrollBar()->value());
         verticalScrollBar()->triggerAction(e->key() == Qt::Key_PageUp ?
                                            QScrollBar::SliderPageStepSub : QScrollBar::SliderPageStepAdd);
-        setCursorPosition((verticalScrollBar()->value() + line) * 16 + m_cursorPosition % 16, moveMode);
+        setCursorPosition(qint64(verticalScrollBar()->value() + line) * 16 + m_cursorPosition % 16, moveMode);
     } break;
 
     case Qt::Key_Home:
@@ -1121,10 +1134,10 @@ void BinEditor::zoomOut(int range)
 
 void BinEditor::copy()
 {
-    int selStart = qMin(m_cursorPosition, m_anchorPosition);
-    int selEnd = qMax(m_cursorPosition, m_anchorPosition);
-    if (selStart < selEnd)
-        QApplication::clipboard()->setText(QString::fromLatin1(dataMid(selStart, selEnd - selStart)));
+    qint64 selStart = qMin(m_cursorPosition, m_anchorPosition);
+    qint64 selEnd = qMax(m_cursorPosition, m_anchorPosition);
+    if (selStart < selEnd && selEnd - selStart <= INT_MAX)
+        QApplication::clipboard()->setText(QString::fromLatin1(dataMid(selStart, int(selEnd - selStart))));
 }
 
 void BinEditor::highlightSearchResults(const QByteArray &pattern, QTextDocument::FindFlags findFlags)
@@ -1140,7 +1153,7 @@ void BinEditor::highlightSearchResults(const QByteArray &pattern, QTextDocument:
 }
 
 
-void BinEditor::changeData(int position, uchar character, bool highNibble)
+void BinEditor::changeData(qint64 position, uchar character, bool highNibble)
 {
     if (!requestDataAt(position))
         return;
@@ -31,6 +31,7 @@
 #define BINEDITOR_H
 
 #include <QtCore/QBasicTimer>
+#include <QtCore/QCache>
 #include <QtCore/QMap>
 #include <QtCore/QSet>
 #include <QtCore/QStack>
@@ -63,12 +64,13 @@ public:
     void setData(const QByteArray &data);
     QByteArray data() const;
 
-    inline int dataSize() const { return m_size; }
+    inline qint64 dataSize() const { return m_size; }
 
     inline bool inLazyMode() const { return m_inLazyMode; }
-    Q_INVOKABLE void setLazyData(quint64 startAddr, int range, int blockSize = 4096);
+    Q_INVOKABLE void setLazyData(quint64 startAddr, qint64 range, int blockSize = 4096);
     inline int lazyDataBlockSize() const { return m_blockSize; }
     Q_INVOKABLE void addLazyData(quint64 block, const QByteArray &data);
+    Q_INVOKABLE void clearLazyData();
     bool save(const QString &oldFileName, const QString &newFileName);
 
     void zoomIn(int range = 1);
@@ -79,8 +81,8 @@ public:
         KeepAnchor
     };
 
-    int cursorPosition() const;
-    void setCursorPosition(int pos, MoveMode moveMode = MoveAnchor);
+    qint64 cursorPosition() const;
+    void setCursorPosition(qint64 pos, MoveMode moveMode = MoveAnchor);
 
     void setModified(bool);
     bool isModified() const;
@@ -88,8 +90,9 @@ public:
     void setReadOnly(bool);
     bool isReadOnly() const;
 
-    int find(const QByteArray &pattern, int from = 0,
-             QTextDocument::FindFlags findFlags = 0);
+    qint64 find(const QByteArray &pattern, qint64 from = 0,
+                QTextDocument::FindFlags findFlags = 0);
+    bool hasModifiedData() const { return !m_modifiedData.isEmpty(); }
 
     void selectAll();
     void clear();
@@ -101,8 +104,8 @@ public:
     void setEditorInterface(Core::IEditor *ieditor) { m_ieditor = ieditor; }
 
     bool hasSelection() const { return m_cursorPosition != m_anchorPosition; }
-    int selectionStart() const { return qMin(m_anchorPosition, m_cursorPosition); }
-    int selectionEnd() const { return qMax(m_anchorPosition, m_cursorPosition); }
+    qint64 selectionStart() const { return qMin(m_anchorPosition, m_cursorPosition); }
+    qint64 selectionEnd() const { return qMax(m_anchorPosition, m_cursorPosition); }
 
     bool event(QEvent*);
 
@@ -110,8 +113,11 @@ public:
     bool isRedoAvailable() const { return m_redoStack.size(); }
 
     QString addressString(quint64 address);
+    static QByteArray calculateHexPattern(const QByteArray &pattern);
 
     static const int SearchStride = 1024 * 1024;
+    // Upper bound in bytes for blocks kept in lazy mode, least recently used go first
+    static const int LazyCacheSize = 64 * 1024 * 1024;
 
 public Q_SLOTS:
     void setFontSettings(const TextEditor::FontSettings &fs);
@@ -123,7 +129,7 @@ Q_SIGNALS:
     void undoAvailable(bool);
     void redoAvailable(bool);
     void copyAvailable(bool);
-    void cursorPositionChanged(int position);
+    void cursorPositionChanged(qint64 position);
 
     void lazyDataRequested(quint64 block, bool synchronous);
 
@@ -144,21 +150,21 @@ protected:
 private:
     bool m_inLazyMode;
     QByteArray m_data;
-    QMap <int, QByteArray> m_lazyData;
+    QCache<int, QByteArray> m_lazyData;
     int m_blockSize;
     QMap <int, QByteArray> m_modifiedData;
     mutable QSet<int> m_lazyRequests;
     QByteArray m_emptyBlock;
     QByteArray m_lowerBlock;
-    int m_size;
+    qint64 m_size;
 
-    int dataIndexOf(const QByteArray &pattern, int from, bool caseSensitive = true) const;
-    int dataLastIndexOf(const QByteArray &pattern, int from, bool caseSensitive = true) const;
+    qint64 dataIndexOf(const QByteArray &pattern, qint64 from, bool caseSensitive = true) const;
+    qint64 dataLastIndexOf(const QByteArray &pattern, qint64 from, bool caseSensitive = true) const;
 
-    bool requestDataAt(int pos, bool synchronous = false) const;
-    char dataAt(int pos) const;
-    void changeDataAt(int pos, char c);
-    QByteArray dataMid(int from, int length) const;
+    bool requestDataAt(qint64 pos, bool synchronous = false) const;
+    char dataAt(qint64 pos) const;
+    void changeDataAt(qint64 pos, char c);
+    QByteArray dataMid(qint64 from, int length) const;
     QByteArray blockData(int block) const;
 
     int m_unmodifiedState;
@@ -177,8 +183,8 @@ private:
     quint64 m_baseAddr;
 
     bool m_cursorVisible;
-    int m_cursorPosition;
-    int m_anchorPosition;
+    qint64 m_cursorPosition;
+    qint64 m_anchorPosition;
     bool m_hexCursor;
     bool m_lowNibble;
     bool m_isMonospacedFont;
@@ -190,21 +196,21 @@ private:
     QBasicTimer m_cursorBlinkTimer;
 
     void init();
-    int posAt(const QPoint &pos) const;
+    qint64 posAt(const QPoint &pos) const;
     bool inTextArea(const QPoint &pos) const;
     QRect cursorRect() const;
     void updateLines();
-    void updateLines(int fromPosition, int toPosition);
+    void updateLines(qint64 fromPosition, qint64 toPosition);
     void ensureCursorVisible();
     void setBlinkingCursorEnabled(bool enable);
 
-    void changeData(int position, uchar character, bool highNibble = false);
+    void changeData(qint64 position, uchar character, bool highNibble = false);
 
-    int findPattern(const QByteArray &data, const QByteArray &dataHex, int from, int offset, int *match);
+    qint64 findPattern(const QByteArray &data, const QByteArray &dataHex, qint64 from, qint64 offset, int *match);
     void drawItems(QPainter *painter, int x, int y, const QString &itemString);
 
     struct BinEditorEditCommand {
-        int position;
+        qint64 position;
         uchar character;
         bool highNibble;
     };
@@ -33,6 +33,7 @@
 
 #include <QtCore/QFile>
 #include <QtCore/QFileInfo>
+#include <QtCore/QFuture>
 #include <QtCore/QDebug>
 #include <QtGui/QMenu>
 #include <QtGui/QAction>
@@ -46,9 +47,11 @@
 #include <coreplugin/editormanager/ieditor.h>
 #include <coreplugin/icore.h>
 #include <coreplugin/mimedatabase.h>
+#include <coreplugin/progressmanager/progressmanager.h>
 #include <coreplugin/uniqueidmanager.h>
 #include <extensionsystem/pluginmanager.h>
 #include <find/ifindsupport.h>
+#include <qtconcurrent/runextensions.h>
 #include <texteditor/fontsettings.h>
 #include <texteditor/texteditorsettings.h>
 #include <utils/linecolumnlabel.h>
@@ -57,113 +60,149 @@
 using namespace BINEditor;
 using namespace BINEditor::Internal;
 
+namespace {
 
-class BinEditorFind : public Find::IFindSupport
+// A search over a memory mapped file, run in a worker thread.
+struct MappedSearch
 {
-    Q_OBJECT
-public:
-    BinEditorFind(BinEditor *editor)
-    {
-        m_editor = editor;
-        m_incrementalStartPos = m_contPos = -1;
-    }
-    ~BinEditorFind() {}
+    const uchar *data;
+    qint64 size;
+    qint64 from;
+    QByteArray pattern; // Lower case unless caseSensitive is set.
+    QByteArray hexPattern;
+    bool backwards;
+    bool caseSensitive;
+};
 
-    bool supportsReplace() const { return false; }
-    IFindSupport::FindFlags supportedFindFlags() const
-    {
-        return IFindSupport::FindBackward | IFindSupport::FindCaseSensitively;
-    }
+struct MappedMatch
+{
+    qint64 position; // -1 if nothing was found.
+    int length;
+};
 
-    void resetIncrementalSearch()
-    {
-        m_incrementalStartPos = m_contPos = -1;
-    }
+} // anonymous namespace
 
-    void clearResults() { m_editor->highlightSearchResults(QByteArray()); }
-    QString currentFindString() const { return QString(); }
-    QString completedFindString() const { return QString(); }
+static inline uchar lowerByte(uchar c)
+{
+    return (c >= 0x41 && c <= 0x5A) ? c + 0x20 : c;
+}
 
+static bool matchesAt(const uchar *data, const QByteArray &pattern, bool caseSensitive)
+{
+    if (caseSensitive)
+        return ::memcmp(data, pattern.constData(), pattern.size()) == 0;
+    for (int i = 0; i < pattern.size(); ++i) {
+        if (lowerByte(data[i]) != uchar(pattern.at(i)))
+            return false;
+    }
+    return true;
+}
 
-    int find(const QByteArray &pattern, int pos, Find::IFindSupport::FindFlags findFlags) {
-        if (pattern.isEmpty()) {
-            m_editor->setCursorPosition(pos);
-            return pos;
+// Finds the first match starting in [from, to). memchr() skips to the
+// candidates, which is a lot faster than comparing byte by byte.
+static qint64 indexInMapping(const MappedSearch &search, const QByteArray &pattern,
+                             bool caseSensitive, qint64 from, qint64 to)
+{
+    const qint64 last = qMin(to, search.size - pattern.size() + 1);
+    const uchar first = pattern.at(0);
+    const uchar upper = (!caseSensitive && first >= 0x61 && first <= 0x7A) ? first - 0x20 : first;
+    qint64 pos = from;
+    while (pos < last) {
+        const uchar *start = search.data + pos;
+        const uchar *hit = static_cast<const uchar *>(::memchr(start, first, last - pos));
+        if (upper != first) {
+            const qint64 length = hit ? hit - start : last - pos;
+            if (const void *upperHit = ::memchr(start, upper, length))
+                hit = static_cast<const uchar *>(upperHit);
         }
+        if (!hit)
+            return -1;
+        pos = hit - search.data;
+        if (matchesAt(hit, pattern, caseSensitive))
+            return pos;
+        ++pos;
+    }
+    return -1;
+}
 
-        return m_editor->find(pattern, pos, Find::IFindSupport::textDocumentFlagsForFindFlags(findFlags));
+// Finds the last match starting in [to, from]. The windows are scanned
+// backwards with a Horspool skip on their first byte: the window moves to
+// the next position where that byte lines up with the same byte in the
+// pattern, so most bytes are never compared.
+static qint64 lastIndexInMapping(const MappedSearch &search, const QByteArray &pattern,
+                                 bool caseSensitive, qint64 from, qint64 to)
+{
+    const int length = pattern.size();
+    int skip[256];
+    for (int c = 0; c < 256; ++c)
+        skip[c] = length;
+    for (int i = length - 1; i > 0; --i) {
+        const uchar c = pattern.at(i);
+        skip[c] = i;
+        if (!caseSensitive && c >= 0x61 && c <= 0x7A)
+            skip[c - 0x20] = i;
     }
 
-    Result findIncremental(const QString &txt, Find::IFindSupport::FindFlags findFlags) {
-        QByteArray pattern = txt.toLatin1();
-        if (pattern != m_lastPattern)
-            resetIncrementalSearch(); // Because we don't search for nibbles.
-        m_lastPattern = pattern;
-        if (m_incrementalStartPos < 0)
-            m_incrementalStartPos = m_editor->selectionStart();
-        if (m_contPos == -1)
-            m_contPos = m_incrementalStartPos;
-        findFlags &= ~Find::IFindSupport::FindBackward;
-        int found = find(pattern, m_contPos, findFlags);
-        Result result;
-        if (found >= 0) {
-            result = Found;
-            m_editor->highlightSearchResults(pattern, Find::IFindSupport::textDocumentFlagsForFindFlags(findFlags));
-            m_contPos = -1;
+    const uchar first = pattern.at(0);
+    qint64 pos = qMin(from, search.size - length);
+    while (pos >= to) {
+        const uchar *window = search.data + pos;
+        const uchar c = caseSensitive ? *window : lowerByte(*window);
+        if (c == first && matchesAt(window, pattern, caseSensitive))
+            return pos;
+        pos -= skip[*window];
+    }
+    return -1;
+}
+
+static void searchMapping(QFutureInterface<MappedMatch> &future, MappedSearch search)
+{
+    const qint64 stride = BinEditor::SearchStride;
+    const qint64 range = search.backwards ? search.from + 1 : search.size - search.from;
+    const int chunkCount = int((range + stride - 1) / stride);
+    future.setProgressRange(0, chunkCount);
+
+    MappedMatch match;
+    match.position = -1;
+    match.length = 0;
+    for (int chunk = 0; chunk < chunkCount; ++chunk) {
+        if (future.isCanceled())
+            return;
+        qint64 found = -1;
+        qint64 foundHex = -1;
+        if (search.backwards) {
+            const qint64 from = search.from - chunk * stride;
+            const qint64 to = qMax(qint64(0), from - stride + 1);
+            found = lastIndexInMapping(search, search.pattern, search.caseSensitive, from, to);
+            if (!search.hexPattern.isEmpty())
+                foundHex = lastIndexInMapping(search, search.hexPattern, true, from, to);
+            if (foundHex > found) {
+                found = foundHex;
+                match.length = search.hexPattern.size();
+            } else {
+                match.length = search.pattern.size();
+            }
         } else {
-            if (found == -2) {
-                result = NotYetFound;
-                m_contPos +=
-                        findFlags & Find::IFindSupport::FindBackward
-                        ? -BinEditor::SearchStride : BinEditor::SearchStride;
+            const qint64 from = search.from + chunk * stride;
+            const qint64 to = qMin(search.size, from + stride);
+            found = indexInMapping(search, search.pattern, search.caseSensitive, from, to);
+            if (!search.hexPattern.isEmpty())
+                foundHex = indexInMapping(search, search.hexPattern, true, from, to);
+            if (foundHex >= 0 && (found < 0 || foundHex < found)) {
+                found = foundHex;
+                match.length = search.hexPattern.size();
             } else {
-                result = NotFound;
-                m_contPos = -1;
-                m_editor->highlightSearchResults(QByteArray(), 0);
+                match.length = search.pattern.size();
             }
         }
-        return result;
-    }
-
-    Result findStep(const QString &txt, Find::IFindSupport::FindFlags findFlags) {
-        QByteArray pattern = txt.toLatin1();
-        bool wasReset = (m_incrementalStartPos < 0);
-        if (m_contPos == -1) {
-            m_contPos = m_editor->cursorPosition();
-            if (findFlags & Find::IFindSupport::FindBackward)
-                m_contPos = m_editor->selectionStart()-1;
-        }
-        int found = find(pattern, m_contPos, findFlags);
-        Result result;
+        future.setProgressValue(chunk + 1);
         if (found >= 0) {
-            result = Found;
-            m_incrementalStartPos = found;
-            m_contPos = -1;
-            if (wasReset)
-                m_editor->highlightSearchResults(pattern, Find::IFindSupport::textDocumentFlagsForFindFlags(findFlags));
-        } else if (found == -2) {
-            result = NotYetFound;
-            m_contPos += findFlags & Find::IFindSupport::FindBackward
-                         ? -BinEditor::SearchStride : BinEditor::SearchStride;
-        } else {
-            result = NotFound;
-            m_contPos = -1;
+            match.position = found;
+            break;
         }
-
-        return result;
     }
-
-    bool replaceStep(const QString &, const QString &,
-                     Find::IFindSupport::FindFlags) { return false;}
-    int replaceAll(const QString &, const QString &,
-                   Find::IFindSupport::FindFlags) { return 0; }
-
-private:
-    BinEditor *m_editor;
-    int m_incrementalStartPos;
-    int m_contPos; // Only valid if last result was NotYetFound.
-    QByteArray m_lastPattern;
-};
+    future.reportResult(match);
+}
 
 
 class BinEditorFile : public Core::IFile
@@ -172,57 +211,95 @@ class BinEditorFile : public Core::IFile
 public:
     BinEditorFile(BinEditor *parent) :
         Core::IFile(parent),
-        m_mimeType(QLatin1String(BINEditor::Constants::C_BINEDITOR_MIMETYPE))
+        m_mimeType(QLatin1String(BINEditor::Constants::C_BINEDITOR_MIMETYPE)),
+        m_mapping(0)
     {
         m_editor = parent;
         connect(m_editor, SIGNAL(lazyDataRequested(quint64, bool)), this, SLOT(provideData(quint64)));
     }
-    ~BinEditorFile() {}
+    ~BinEditorFile() { closeFile(); }
 
     virtual QString mimeType() const { return m_mimeType; }
 
     bool save(const QString &fileName = QString()) {
-        if (m_editor->save(m_fileName, fileName)) {
+        // Do not write through a file we still have mapped.
+        const bool wasOpen = m_file.isOpen();
+        closeFile();
+        const bool saved = m_editor->save(m_fileName, fileName);
+        if (saved)
             m_fileName = fileName;
+        if (wasOpen)
+            openFile(m_fileName);
+        if (saved) {
             m_editor->editorInterface()->
                 setDisplayName(QFileInfo(fileName).fileName());
             emit changed();
-            return true;
-        } else {
-            return false;
         }
+        return saved;
     }
 
     bool open(const QString &fileName) {
-        QFile file(fileName);
-        if (file.open(QIODevice::ReadOnly)) {
-            m_fileName = fileName;
-            if (file.isSequential() && file.size() <= 64 * 1024 * 1024) {
-                m_editor->setData(file.readAll());
-            } else {
-                m_editor->setLazyData(0, qMin(file.size(),
-                                              static_cast<qint64>(INT_MAX-16)));
-                m_editor->editorInterface()->
-                        setDisplayName(QFileInfo(fileName).fileName());
-            }
-            file.close();
-            return true;
+        closeFile();
+        if (!openFile(fileName))
+            return false;
+        m_fileName = fileName;
+        if (m_file.isSequential() && m_file.size() <= 64 * 1024 * 1024) {
+            m_editor->setData(m_file.readAll());
+            closeFile();
+        } else {
+            m_editor->setLazyData(0, m_file.size());
+            m_editor->editorInterface()->
+                    setDisplayName(QFileInfo(fileName).fileName());
         }
-        return false;
+        return true;
+    }
+
+    // The worker search needs the raw file contents, so it is only
+    // available while the file is mapped and nothing has been edited.
+    bool canSearchMapping() const {
+        return m_mapping && !m_editor->hasModifiedData();
+    }
+
+    QFuture<MappedMatch> searchMapping(const QByteArray &pattern, const QByteArray &hexPattern,
+                                       qint64 from, QTextDocument::FindFlags findFlags) {
+        cancelSearch();
+        MappedSearch search;
+        search.data = m_mapping;
+        search.size = qMin(m_file.size(), m_editor->dataSize());
+        search.from = from;
+        search.pattern = pattern;
+        search.hexPattern = hexPattern;
+        search.backwards = findFlags & QTextDocument::FindBackward;
+        search.caseSensitive = findFlags & QTextDocument::FindCaseSensitively;
+        m_search = QtConcurrent::run(&::searchMapping, search);
+        Core::ICore::instance()->progressManager()->addTask(m_search, tr("Searching"),
+                                                            Constants::TASK_SEARCH,
+                                                            Core::ProgressManager::CloseOnSuccess);
+        return m_search;
+    }
+
+    void cancelSearch() {
+        m_search.cancel();
     }
 
 private slots:
     void provideData(quint64 block) {
-        QFile file(m_fileName);
-        if (file.open(QIODevice::ReadOnly)) {
-            int blockSize = m_editor->lazyDataBlockSize();
-            file.seek(block * blockSize);
-            QByteArray data = file.read(blockSize);
-            if (data.size() != blockSize)
-                data.resize(blockSize);
-            m_editor->addLazyData(block, data);
-            file.close();
+        const int blockSize = m_editor->lazyDataBlockSize();
+        const qint64 offset = block * blockSize;
+        QByteArray data;
+        if (m_mapping) {
+            if (offset < m_file.size())
+                data = QByteArray(reinterpret_cast<const char *>(m_mapping + offset),
+                                  int(qMin<qint64>(blockSize, m_file.size() - offset)));
+        } else if (m_file.isOpen()) {
+            if (m_file.seek(offset))
+                data = m_file.read(blockSize);
+        } else {
+            return;
         }
+        if (data.size() != blockSize)
+            data.resize(blockSize);
+        m_editor->addLazyData(block, data);
     }
 public:
 
@@ -288,9 +365,199 @@ public:
     }
 
 private:
+    // Keeps the file open for lazy loading. Mapping can fail, e.g. for
+    // huge files in a 32 bit address space, then blocks are read instead.
+    bool openFile(const QString &fileName) {
+        m_file.setFileName(fileName);
+        if (!m_file.open(QIODevice::ReadOnly))
+            return false;
+        if (!m_file.isSequential() && m_file.size() > 0)
+            m_mapping = m_file.map(0, m_file.size());
+        return true;
+    }
+
+    void closeFile() {
+        // The search works on the mapping, so it has to be gone first.
+        cancelSearch();
+        m_search.waitForFinished();
+        if (m_mapping) {
+            m_file.unmap(m_mapping);
+            m_mapping = 0;
+        }
+        m_file.close();
+    }
+
     const QString m_mimeType;
     BinEditor *m_editor;
     QString m_fileName;
+    QFile m_file;
+    uchar *m_mapping;
+    QFuture<MappedMatch> m_search;
+};
+
+
+class BinEditorFind : public Find::IFindSupport
+{
+    Q_OBJECT
+public:
+    BinEditorFind(BinEditor *editor, BinEditorFile *file)
+    {
+        m_editor = editor;
+        m_file = file;
+        m_incrementalStartPos = m_contPos = -1;
+        m_searchingMapping = false;
+        m_searchFrom = -1;
+        m_searchFlags = 0;
+    }
+    ~BinEditorFind() {}
+
+    bool supportsReplace() const { return false; }
+    IFindSupport::FindFlags supportedFindFlags() const
+    {
+        return IFindSupport::FindBackward | IFindSupport::FindCaseSensitively;
+    }
+
+    void resetIncrementalSearch()
+    {
+        m_incrementalStartPos = m_contPos = -1;
+    }
+
+    void clearResults() { m_editor->highlightSearchResults(QByteArray()); }
+    QString currentFindString() const { return QString(); }
+    QString completedFindString() const { return QString(); }
+
+
+    qint64 find(const QByteArray &pattern, qint64 pos, Find::IFindSupport::FindFlags findFlags) {
+        const QTextDocument::FindFlags flags = Find::IFindSupport::textDocumentFlagsForFindFlags(findFlags);
+        m_searchingMapping = !pattern.isEmpty() && m_file->canSearchMapping();
+        if (!m_searchingMapping) {
+            m_file->cancelSearch();
+            m_searchPattern.clear();
+        }
+
+        if (pattern.isEmpty()) {
+            m_editor->setCursorPosition(pos);
+            return pos;
+        }
+        if (!m_searchingMapping)
+            return m_editor->find(pattern, pos, flags);
+        return findInMapping(pattern, pos, flags);
+    }
+
+    // Starts a search in a worker thread and reports -2 until it is done.
+    // The find tool bar polls for as long as NotYetFound is returned.
+    qint64 findInMapping(const QByteArray &pattern, qint64 pos, QTextDocument::FindFlags flags) {
+        if (m_searchPattern.isEmpty() || pattern != m_searchPattern
+            || pos != m_searchFrom || flags != m_searchFlags) {
+            QByteArray lowerPattern = pattern;
+            if (!(flags & QTextDocument::FindCaseSensitively)) {
+                for (int i = 0; i < lowerPattern.size(); ++i)
+                    lowerPattern[i] = lowerByte(lowerPattern.at(i));
+            }
+            m_searchPattern = pattern;
+            m_searchFrom = pos;
+            m_searchFlags = flags;
+            m_search = m_file->searchMapping(lowerPattern, BinEditor::calculateHexPattern(pattern),
+                                             pos, flags);
+            return -2;
+        }
+        if (!m_search.isFinished())
+            return -2;
+
+        // Canceled searches, e.g. from the progress bar, report nothing.
+        const bool hasResult = !m_search.isCanceled() && m_search.resultCount() > 0;
+        MappedMatch match;
+        match.position = -1;
+        match.length = 0;
+        if (hasResult)
+            match = m_search.result();
+        m_search = QFuture<MappedMatch>();
+        m_searchPattern.clear();
+        if (match.position < 0)
+            return -1;
+        m_editor->setCursorPosition(match.position);
+        m_editor->setCursorPosition(match.position + match.length, BinEditor::KeepAnchor);
+        return match.position;
+    }
+
+    Result findIncremental(const QString &txt, Find::IFindSupport::FindFlags findFlags) {
+        QByteArray pattern = txt.toLatin1();
+        if (pattern != m_lastPattern)
+            resetIncrementalSearch(); // Because we don't search for nibbles.
+        m_lastPattern = pattern;
+        if (m_incrementalStartPos < 0)
+            m_incrementalStartPos = m_editor->selectionStart();
+        if (m_contPos == -1)
+            m_contPos = m_incrementalStartPos;
+        findFlags &= ~Find::IFindSupport::FindBackward;
+        qint64 found = find(pattern, m_contPos, findFlags);
+        Result result;
+        if (found >= 0) {
+            result = Found;
+            m_editor->highlightSearchResults(pattern, Find::IFindSupport::textDocumentFlagsForFindFlags(findFlags));
+            m_contPos = -1;
+        } else {
+            if (found == -2) {
+                result = NotYetFound;
+                if (!m_searchingMapping)
+                    m_contPos +=
+                            findFlags & Find::IFindSupport::FindBackward
+                            ? -BinEditor::SearchStride : BinEditor::SearchStride;
+            } else {
+                result = NotFound;
+                m_contPos = -1;
+                m_editor->highlightSearchResults(QByteArray(), 0);
+            }
+        }
+        return result;
+    }
+
+    Result findStep(const QString &txt, Find::IFindSupport::FindFlags findFlags) {
+        QByteArray pattern = txt.toLatin1();
+        bool wasReset = (m_incrementalStartPos < 0);
+        if (m_contPos == -1) {
+            m_contPos = m_editor->cursorPosition();
+            if (findFlags & Find::IFindSupport::FindBackward)
+                m_contPos = m_editor->selectionStart()-1;
+        }
+        qint64 found = find(pattern, m_contPos, findFlags);
+        Result result;
+        if (found >= 0) {
+            result = Found;
+            m_incrementalStartPos = found;
+            m_contPos = -1;
+            if (wasReset)
+                m_editor->highlightSearchResults(pattern, Find::IFindSupport::textDocumentFlagsForFindFlags(findFlags));
+        } else if (found == -2) {
+            result = NotYetFound;
+            if (!m_searchingMapping)
+                m_contPos += findFlags & Find::IFindSupport::FindBackward
+                             ? -BinEditor::SearchStride : BinEditor::SearchStride;
+        } else {
+            result = NotFound;
+            m_contPos = -1;
+        }
+
+        return result;
+    }
+
+    bool replaceStep(const QString &, const QString &,
+                     Find::IFindSupport::FindFlags) { return false;}
+    int replaceAll(const QString &, const QString &,
+                   Find::IFindSupport::FindFlags) { return 0; }
+
+private:
+    BinEditor *m_editor;
+    BinEditorFile *m_file;
+    qint64 m_incrementalStartPos;
+    qint64 m_contPos; // Only valid if last result was NotYetFound.
+    QByteArray m_lastPattern;
+
+    bool m_searchingMapping;
+    QFuture<MappedMatch> m_search;
+    QByteArray m_searchPattern;
+    qint64 m_searchFrom;
+    QTextDocument::FindFlags m_searchFlags;
 };
 
 class BinEditorInterface : public Core::IEditor
@@ -318,7 +585,7 @@ public:
         m_toolBar->setSizePolicy(QSizePolicy::Minimum, QSizePolicy::Minimum);
         m_toolBar->addWidget(w);
 
-        connect(m_editor, SIGNAL(cursorPositionChanged(int)), this, SLOT(updateCursorPosition(int)));
+        connect(m_editor, SIGNAL(cursorPositionChanged(qint64)), this, SLOT(updateCursorPosition(qint64)));
     }
     ~BinEditorInterface() {
         delete m_editor;
@@ -352,9 +619,9 @@ public:
     bool isTemporary() const { return false; }
 
 public slots:
-    void updateCursorPosition(int position) {
-        m_cursorPositionLabel->setText(m_editor->addressString((uint)position),
-                                       m_editor->addressString((uint)m_editor->data().size()));
+    void updateCursorPosition(qint64 position) {
+        m_cursorPositionLabel->setText(m_editor->addressString(quint64(position)),
+                                       m_editor->addressString(quint64(m_editor->dataSize())));
     }
 
 private:
@@ -465,7 +732,8 @@ void BinEditorPlugin::initializeEditor(BinEditor *editor)
     QObject::connect(editor, SIGNAL(copyAvailable(bool)), this, SLOT(updateActions()));
 
     Aggregation::Aggregate *aggregate = new Aggregation::Aggregate;
-    BinEditorFind *binEditorFind = new BinEditorFind(editor);
+    BinEditorFind *binEditorFind =
+        new BinEditorFind(editor, static_cast<BinEditorFile *>(editorInterface->file()));
     aggregate->add(binEditorFind);
     aggregate->add(editor);
 }
@@ -29,10 +29,13 @@
 
 #include "settingsdatabase.h"
 
+#include <QtCore/QBasicTimer>
 #include <QtCore/QDir>
 #include <QtCore/QMap>
+#include <QtCore/QSet>
 #include <QtCore/QString>
 #include <QtCore/QStringList>
+#include <QtCore/QTimerEvent>
 #include <QtCore/QVariant>
 
 #include <QtSql/QSqlDatabase>
@@ -49,6 +52,9 @@
     is asked for. It also does incremental updates of the database rather than
     rewriting the whole file each time one of the settings change.
 
+    Changes are written behind: modified keys are collected and written out
+    in a single transaction shortly after, on sync() and on destruction.
+
     The SettingsDatabase API mimics that of QSettings.
 */
 
@@ -57,6 +63,8 @@ using namespace Core::Internal;
 
 enum { debug_settings = 0 };
 
+enum { FlushInterval = 1000 };
+
 namespace Core {
 namespace Internal {
 
@@ -79,10 +87,27 @@ public:
         return g;
     }
 
+    // The keys below the given group are a contiguous range of the sorted map
+    SettingsMap::iterator groupBegin(const QString &group)
+    {
+        return m_settings.lowerBound(group + QLatin1Char('/'));
+    }
+
+    static bool isInGroup(const QString &key, const QString &group)
+    {
+        return key.length() > group.length()
+                && key.at(group.length()) == QLatin1Char('/')
+                && key.startsWith(group);
+    }
+
+    void flush();
+
     SettingsMap m_settings;
 
     QStringList m_groups;
-    QStringList m_dirtyKeys;
+    QSet<QString> m_dirtyKeys;
+    QStringList m_removedKeys; // Also removes the keys below, in this order
+    QBasicTimer m_flushTimer;
 
     QSqlDatabase m_db;
 };
@@ -90,6 +115,45 @@ public:
 } // namespace Internal
 } // namespace Core
 
+void SettingsDatabasePrivate::flush()
+{
+    m_flushTimer.stop();
+    if (!m_db.isOpen() || (m_dirtyKeys.isEmpty() && m_removedKeys.isEmpty()))
+        return;
+
+    m_db.transaction();
+
+    // Removals come first, keys that were set again since are dirty
+    QSqlQuery removeQuery(m_db);
+    removeQuery.prepare(QLatin1String("DELETE FROM settings WHERE key = ? OR (key >= ? AND key < ?)"));
+    foreach (const QString &key, m_removedKeys) {
+        // '0' follows '/', so this covers exactly the keys below
+        removeQuery.addBindValue(key);
+        removeQuery.addBindValue(QString(key + QLatin1Char('/')));
+        removeQuery.addBindValue(QString(key + QLatin1Char('0')));
+        removeQuery.exec();
+    }
+
+    QSqlQuery insertQuery(m_db);
+    insertQuery.prepare(QLatin1String("INSERT INTO settings VALUES (?, ?)"));
+    foreach (const QString &key, m_dirtyKeys) {
+        const QVariant value = m_settings.value(key);
+        insertQuery.addBindValue(key);
+        insertQuery.addBindValue(value);
+        insertQuery.exec();
+
+        if (debug_settings)
+            qDebug() << "Stored:" << key << "=" << value;
+    }
+
+    if (!m_db.commit())
+        qWarning().nospace() << "Warning: Failed to write settings database ("
+                             << m_db.lastError().driverText() << ")";
+
+    m_dirtyKeys.clear();
+    m_removedKeys.clear();
+}
+
 SettingsDatabase::SettingsDatabase(const QString &path,
                                    const QString &application,
                                    QObject *parent)
@@ -151,15 +215,9 @@ void SettingsDatabase::setValue(const QString &key, const QVariant &value)
     if (!d->m_db.isOpen())
         return;
 
-    // Instant apply (TODO: Delay writing out settings)
-    QSqlQuery query(d->m_db);
-    query.prepare(QLatin1String("INSERT INTO settings VALUES (?, ?)"));
-    query.addBindValue(effectiveKey);
-    query.addBindValue(value);
-    query.exec();
-
-    if (debug_settings)
-        qDebug() << "Stored:" << effectiveKey << "=" << value;
+    d->m_dirtyKeys.insert(effectiveKey);
+    if (!d->m_flushTimer.isActive())
+        d->m_flushTimer.start(FlushInterval, this);
 }
 
 QVariant SettingsDatabase::value(const QString &key, const QVariant &defaultValue) const
@@ -167,9 +225,14 @@ QVariant SettingsDatabase::value(const QString &key, const QVariant &defaultValu
     const QString effectiveKey = d->effectiveKey(key);
     QVariant value = defaultValue;
 
-    SettingsMap::const_iterator i = d->m_settings.constFind(effectiveKey);
-    if (i != d->m_settings.constEnd() && i.value().isValid()) {
-        value = i.value();
+    // All keys are known from the start, only values are loaded lazily
+    SettingsMap::iterator i = d->m_settings.find(effectiveKey);
+    if (i == d->m_settings.end())
+        return value;
+
+    if (i.value().isValid() || d->m_dirtyKeys.contains(effectiveKey)) {
+        if (i.value().isValid())
+            value = i.value();
     } else if (d->m_db.isOpen()) {
         // Try to read the value from the database
         QSqlQuery query(d->m_db);
@@ -184,7 +247,7 @@ QVariant SettingsDatabase::value(const QString &key, const QVariant &defaultValu
         }
 
         // Cache the result
-        d->m_settings.insert(effectiveKey, value);
+        i.value() = value;
     }
 
     return value;
@@ -199,26 +262,23 @@ void SettingsDatabase::remove(const QString &key)
 {
     const QString effectiveKey = d->effectiveKey(key);
 
-    // Remove keys from the cache
-    foreach (const QString &k, d->m_settings.keys()) {
-        // Either it's an exact match, or it matches up to a /
-        if (k.startsWith(effectiveKey)
-            && (k.length() == effectiveKey.length()
-                || k.at(effectiveKey.length()) == QLatin1Char('/')))
-        {
-            d->m_settings.remove(k);
-        }
+    // Remove keys from the cache, either it's an exact match, or it
+    // matches up to a /
+    d->m_settings.remove(effectiveKey);
+    d->m_dirtyKeys.remove(effectiveKey);
+    SettingsMap::iterator i = d->groupBegin(effectiveKey);
+    while (i != d->m_settings.end() && SettingsDatabasePrivate::isInGroup(i.key(), effectiveKey)) {
+        d->m_dirtyKeys.remove(i.key());
+        i = d->m_settings.erase(i);
     }
 
     if (!d->m_db.isOpen())
         return;
 
-    // Delete keys from the database
-    QSqlQuery query(d->m_db);
-    query.prepare(QLatin1String("DELETE FROM settings WHERE key = ? OR key LIKE ?"));
-    query.addBindValue(effectiveKey);
-    query.addBindValue(QString(effectiveKey + QLatin1String("/%")));
-    query.exec();
+    // Delete keys from the database on the next flush
+    d->m_removedKeys.append(effectiveKey);
+    if (!d->m_flushTimer.isActive())
+        d->m_flushTimer.start(FlushInterval, this);
 }
 
 void SettingsDatabase::beginGroup(const QString &prefix)
@@ -241,11 +301,18 @@ QStringList SettingsDatabase::childKeys() const
     QStringList childs;
 
     const QString g = group();
-    QMapIterator<QString, QVariant> i(d->m_settings);
-    while (i.hasNext()) {
-        const QString &key = i.next().key();
-        if (key.startsWith(g) && key.indexOf(QLatin1Char('/'), g.length() + 1) == -1) {
-            childs.append(key.mid(g.length() + 1));
+    const int prefixLength = g.isEmpty() ? 0 : g.length() + 1;
+    SettingsMap::const_iterator i = g.isEmpty() ? d->m_settings.constBegin() : d->groupBegin(g);
+    const SettingsMap::const_iterator end = d->m_settings.constEnd();
+    for (; i != end && (g.isEmpty() || SettingsDatabasePrivate::isInGroup(i.key(), g)); ++i) {
+        const QString &key = i.key();
+        const int slash = key.indexOf(QLatin1Char('/'), prefixLength);
+        if (slash == -1) {
+            childs.append(key.mid(prefixLength));
+        } else {
+            // Skip the keys of the subgroup
+            i = d->m_settings.lowerBound(key.left(slash) + QLatin1Char('0'));
+            --i;
         }
     }
 
@@ -254,5 +321,13 @@ QStringList SettingsDatabase::childKeys() const
 
 void SettingsDatabase::sync()
 {
-    // TODO: Delay writing of dirty keys and save them here
+    d->flush();
+}
+
+void SettingsDatabase::timerEvent(QTimerEvent *event)
+{
+    if (event->timerId() == d->m_flushTimer.timerId())
+        d->flush();
+    else
+        QObject::timerEvent(event);
 }
@@ -67,7 +67,7 @@ CppFindReferences::CppFindReferences(CppTools::CppModelManagerInterface *modelMa
       _resultWindow(ExtensionSystem::PluginManager::instance()->getObject<Find::SearchResultWindow>())
 {
     m_watcher.setPendingResultsLimit(1);
-    connect(&m_watcher, SIGNAL(resultReadyAt(int)), this, SLOT(displayResult(int)));
+    connect(&m_watcher, SIGNAL(resultsReadyAt(int,int)), this, SLOT(displayResults(int,int)));
     connect(&m_watcher, SIGNAL(finished()), this, SLOT(searchFinished()));
 }
 
@@ -334,14 +334,21 @@ void CppFindReferences::onReplaceButtonClicked(const QString &text,
     _resultWindow->hide();
 }
 
-void CppFindReferences::displayResult(int index)
+void CppFindReferences::displayResults(int first, int last)
 {
-    Usage result = m_watcher.future().resultAt(index);
-    _resultWindow->addResult(result.path,
-                             result.line,
-                             result.lineText,
-                             result.col,
-                             result.len);
+    QList<Find::SearchResultItem> items;
+    for (int index = first; index < last; ++index) {
+        const Usage result = m_watcher.future().resultAt(index);
+        Find::SearchResultItem item;
+        item.fileName = result.path;
+        item.lineNumber = result.line;
+        item.lineText = result.lineText;
+        item.searchTermStart = result.col;
+        item.searchTermLength = result.len;
+        item.index = index;
+        items.append(item);
+    }
+    _resultWindow->addResults(items);
 }
 
 void CppFindReferences::searchFinished()
@@ -76,8 +76,10 @@
 #include <cplusplus/LookupContext.h>
 
 #include <QtCore/QCoreApplication>
+#include <QtCore/QDateTime>
 #include <QtCore/QDebug>
 #include <QtCore/QMutexLocker>
+#include <QtCore/QSettings>
 #include <QtCore/QTime>
 #include <QtCore/QTimer>
 #include <QtConcurrentMap>
@@ -641,6 +643,10 @@ CppModelManager::CppModelManager(QObject *parent)
     m_core = Core::ICore::instance(); // FIXME
     m_dirty = true;
 
+    m_includeIndexLoaded = false;
+    m_includeIndexFileName = QFileInfo(m_core->settings()->fileName()).path()
+            + QLatin1String("/qtcreator/includeindex.dat");
+
     ProjectExplorer::ProjectExplorerPlugin *pe =
        ProjectExplorer::ProjectExplorerPlugin::instance();
 
@@ -751,16 +757,28 @@ QByteArray CppModelManager::internalDefinedMacros() const
     return macros;
 }
 
-void CppModelManager::setIncludesInPaths(const QMap<QString, QStringList> &includesInPaths)
+void CppModelManager::setFrameworksInPaths(const QMap<QString, QStringList> &frameworksInPaths)
 {
     QMutexLocker locker(&mutex);
-    QMapIterator<QString, QStringList> i(includesInPaths);
+    QMapIterator<QString, QStringList> i(frameworksInPaths);
     while (i.hasNext()) {
         i.next();
-        m_includesInPaths.insert(i.key(), i.value());
+        m_frameworksInPaths.insert(i.key(), i.value());
     }
 }
 
+IncludeIndex CppModelManager::includeIndex() const
+{
+    QMutexLocker locker(&mutex);
+    return m_includeIndex;
+}
+
+void CppModelManager::setIncludeIndex(const IncludeIndex &index)
+{
+    QMutexLocker locker(&mutex);
+    m_includeIndex = index;
+}
+
 void CppModelManager::addEditorSupport(AbstractEditorSupport *editorSupport)
 {
     m_addtionalEditorSupport.insert(editorSupport);
@@ -867,7 +885,10 @@ void CppModelManager::updateProjectInfo(const ProjectInfo &pinfo)
 QStringList CppModelManager::includesInPath(const QString &path) const
 {
     QMutexLocker locker(&mutex);
-    return m_includesInPaths.value(path);
+    QMap<QString, QStringList>::const_iterator it = m_frameworksInPaths.constFind(path);
+    if (it != m_frameworksInPaths.constEnd())
+        return it.value();
+    return m_includeIndex.entries(path);
 }
 
 QFuture<void> CppModelManager::refreshSourceFiles(const QStringList &sourceFiles)
@@ -1169,16 +1190,48 @@ void CppModelManager::onAboutToUnloadSession()
     GC();
 }
 
+namespace {
+
+class ScanDirectory
+{
+public:
+    typedef IncludeIndex::Directory result_type;
+
+    ScanDirectory(const QStringList &suffixes)
+        : m_suffixes(suffixes)
+    { }
+
+    IncludeIndex::Directory operator()(const QString &path) const
+    { return IncludeIndex::scanDirectory(path, m_suffixes); }
+
+private:
+    QStringList m_suffixes;
+};
+
+} // anonymous namespace
+
 void CppModelManager::updateIncludesInPaths(QFutureInterface<void> &future,
                                             CppModelManager *manager,
                                             QStringList paths,
                                             QStringList frameworkPaths,
                                             QStringList suffixes)
 {
-    QMap<QString, QStringList> entriesInPaths;
-    typedef QPair<QString, QString> SymLink;
-    typedef QList<SymLink> SymLinks;
-    SymLinks symlinks;
+    // One scan at a time, each one continues with the index of the last.
+    QMutexLocker scanLocker(&manager->m_includeScanMutex);
+
+    IncludeIndex index = manager->includeIndex();
+    bool changed = false;
+    if (!manager->m_includeIndexLoaded) {
+        manager->m_includeIndexLoaded = true;
+        if (index.load(manager->m_includeIndexFileName))
+            manager->setIncludeIndex(index); // Completion works before the scan is done
+    }
+    if (index.suffixes() != suffixes) {
+        index.setSuffixes(suffixes);
+        changed = true;
+    }
+
+    QMap<QString, QStringList> frameworksInPaths;
     int processed = 0;
 
     future.setProgressRange(0, paths.size());
@@ -1198,73 +1251,63 @@ void CppModelManager::updateIncludesInPaths(QFutureInterface<void> &future,
             framework.chop(10); // remove the ".framework"
             entriesInFrameworkPath.append(framework + QLatin1Char('/'));
         }
-        entriesInPaths.insert(fwPath, entriesInFrameworkPath);
+        frameworksInPaths.insert(fwPath, entriesInFrameworkPath);
     }
+    manager->setFrameworksInPaths(frameworksInPaths);
 
+    // Walk the tree one level at a time. Directories whose modification time
+    // did not change are taken from the index, the others are listed in
+    // parallel.
+    QSet<QString> visited;
     while (!paths.isEmpty()) {
         if (future.isPaused())
             future.waitForResume();
 
         if (future.isCanceled())
-            return;
+            break;
 
-        const QString path = paths.takeFirst();
+        QStringList outdated;
+        QStringList next;
+        foreach (const QString &p, paths) {
+            const QString path = QDir::cleanPath(p);
 
-        // Skip already scanned paths
-        if (entriesInPaths.contains(path))
-            continue;
+            // Skip already scanned paths
+            if (visited.contains(path))
+                continue;
+            visited.insert(path);
 
-        QStringList entries;
-
-        QDirIterator i(path, QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot);
-        while (i.hasNext()) {
-            const QString fileName = i.next();
-            const QFileInfo fileInfo = i.fileInfo();
-            const QString suffix = fileInfo.suffix();
-            if (suffix.isEmpty() || suffixes.contains(suffix)) {
-                QString text = fileInfo.fileName();
-                if (fileInfo.isDir()) {
-                    text += QLatin1Char('/');
-
-                    // Also scan subdirectory, but avoid endless recursion with symbolic links
-                    if (fileInfo.isSymLink()) {
-                        QString target = fileInfo.symLinkTarget();
-
-                        // Don't add broken symlinks
-                        if (!QFileInfo(target).exists())
-                            continue;
-
-                        QMap<QString, QStringList>::const_iterator result = entriesInPaths.find(target);
-                        if (result != entriesInPaths.constEnd()) {
-                            entriesInPaths.insert(fileName, result.value());
-                        } else {
-                            paths.append(target);
-                            symlinks.append(SymLink(fileName, target));
-                        }
-                    } else {
-                        paths.append(fileName);
-                    }
-                }
-                entries.append(text);
-            }
+            const QFileInfo fileInfo(path);
+            if (!fileInfo.isDir())
+                continue;
+            if (index.isUpToDate(path, fileInfo.lastModified().toTime_t()))
+                next += index.subDirectories(path);
+            else
+                outdated.append(path);
         }
 
-        entriesInPaths.insert(path, entries);
+        const QList<IncludeIndex::Directory> directories =
+                QtConcurrent::blockingMapped<QList<IncludeIndex::Directory> >(outdated, ScanDirectory(suffixes));
+        foreach (const IncludeIndex::Directory &directory, directories) {
+            index.setDirectory(directory);
+            foreach (const QString &subDirectory, directory.directories)
+                next.append(directory.path + QLatin1Char('/') + subDirectory);
+            for (int i = 0; i < directory.links.size(); ++i)
+                next.append(directory.links.at(i).second);
+        }
+        if (!directories.isEmpty()) {
+            manager->setIncludeIndex(index);
+            changed = true;
+        }
 
-        ++processed;
+        processed += paths.size();
+        paths = next;
         future.setProgressRange(0, processed + paths.size());
         future.setProgressValue(processed);
     }
-    // link symlinks
-    QListIterator<SymLink> it(symlinks);
-    it.toBack();
-    while (it.hasPrevious()) {
-        SymLink v = it.previous();
-        QMap<QString, QStringList>::const_iterator result = entriesInPaths.find(v.second);
-        entriesInPaths.insert(v.first, result.value());
-    }
 
-    manager->setIncludesInPaths(entriesInPaths);
+    // Also keep what was scanned before a cancel
+    if (changed)
+        index.save(manager->m_includeIndexFileName);
 
     future.reportFinished();
 }
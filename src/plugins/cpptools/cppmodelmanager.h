@@ -31,6 +31,7 @@
 #define CPPMODELMANAGER_H
 
 #include <cpptools/cppmodelmanagerinterface.h>
+#include "includeindex.h"
 #include <projectexplorer/project.h>
 #include <cplusplus/CppDocument.h>
 
@@ -163,7 +164,9 @@ private:
     QStringList internalFrameworkPaths() const;
     QByteArray internalDefinedMacros() const;
 
-    void setIncludesInPaths(const QMap<QString, QStringList> &includesInPaths);
+    void setFrameworksInPaths(const QMap<QString, QStringList> &frameworksInPaths);
+    IncludeIndex includeIndex() const;
+    void setIncludeIndex(const IncludeIndex &index);
 
     static void updateIncludesInPaths(QFutureInterface<void> &future,
                                       CppModelManager *manager,
@@ -186,7 +189,11 @@ private:
     QStringList m_frameworkPaths;
     QByteArray m_definedMacros;
 
-    QMap<QString, QStringList> m_includesInPaths;
+    QMap<QString, QStringList> m_frameworksInPaths;
+    IncludeIndex m_includeIndex;
+    QString m_includeIndexFileName;
+    bool m_includeIndexLoaded; // guarded by m_includeScanMutex
+    QMutex m_includeScanMutex;
     QStringList m_headerSuffixes;
 
     // editor integration
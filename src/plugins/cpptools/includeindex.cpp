@@ -0,0 +1,343 @@
+/**************************************************************************
+**
+** This file is part of Qt Creator
+**
+** Copyright (c) 2009 Nokia Corporation and/or its subsidiary(-ies).
+**
+** Contact: Nokia Corporation (qt-info@nokia.com)
+**
+** Commercial Usage
+**
+** Licensees holding valid Qt Commercial licenses may use this file in
+** accordance with the Qt Commercial License Agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Nokia.
+**
+** GNU Lesser General Public License Usage
+**
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** If you are unsure which license is appropriate for your use, please
+** contact the sales department at http://qt.nokia.com/contact.
+**
+**************************************************************************/
+
+#include "includeindex.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QMap>
+
+using namespace CppTools::Internal;
+
+enum {
+    IndexMagic = 0x43494458,
+    IndexVersion = 1,
+    MaxLinkHops = 16
+};
+
+IncludeIndex::IncludeIndex()
+{
+    Node root;
+    root.isDirectory = true;
+    m_nodes.append(root);
+}
+
+bool IncludeIndex::isEmpty() const
+{
+    return m_nodes.size() <= 1;
+}
+
+void IncludeIndex::setSuffixes(const QStringList &suffixes)
+{
+    if (suffixes == m_suffixes)
+        return;
+    *this = IncludeIndex();
+    m_suffixes = suffixes;
+}
+
+QStringList IncludeIndex::suffixes() const
+{
+    return m_suffixes;
+}
+
+QStringList IncludeIndex::entries(const QString &path) const
+{
+    QStringList result;
+    const int node = findNode(path);
+    if (node < 0)
+        return result;
+    foreach (int child, m_nodes.at(node).children) {
+        const Node &n = m_nodes.at(child);
+        result.append(n.isDirectory ? n.name + QLatin1Char('/') : n.name);
+    }
+    return result;
+}
+
+bool IncludeIndex::isUpToDate(const QString &path, uint modified) const
+{
+    const int node = findNode(path);
+    return node >= 0 && m_nodes.at(node).modified == modified;
+}
+
+QStringList IncludeIndex::subDirectories(const QString &path) const
+{
+    QStringList result;
+    const int node = findNode(path);
+    if (node < 0)
+        return result;
+    foreach (int child, m_nodes.at(node).children) {
+        const Node &n = m_nodes.at(child);
+        if (!n.linkTarget.isEmpty())
+            result.append(n.linkTarget);
+        else if (n.isDirectory)
+            result.append(path + QLatin1Char('/') + n.name);
+    }
+    return result;
+}
+
+void IncludeIndex::setDirectory(const Directory &directory)
+{
+    const int node = insertNode(directory.path);
+    if (node < 0)
+        return;
+
+    // Reuse the nodes of subdirectories that are still there, so that
+    // their contents do not have to be scanned again.
+    QMap<QString, int> children;
+    foreach (const QString &name, directory.files) {
+        const int child = childNode(node, name);
+        Node &n = m_nodes[child];
+        n.isDirectory = false;
+        n.linkTarget.clear();
+        n.children.clear();
+        n.modified = 0;
+        children.insert(name, child);
+    }
+    foreach (const QString &name, directory.directories) {
+        const int child = childNode(node, name);
+        Node &n = m_nodes[child];
+        if (!n.isDirectory || !n.linkTarget.isEmpty()) {
+            n.linkTarget.clear();
+            n.modified = 0;
+        }
+        n.isDirectory = true;
+        children.insert(name, child);
+    }
+    for (int i = 0; i < directory.links.size(); ++i) {
+        const QPair<QString, QString> &link = directory.links.at(i);
+        const int child = childNode(node, link.first);
+        Node &n = m_nodes[child];
+        n.isDirectory = true;
+        n.linkTarget = link.second;
+        n.children.clear();
+        n.modified = 0;
+        children.insert(link.first, child);
+    }
+
+    Node &n = m_nodes[node];
+    n.children = children.values().toVector();
+    n.modified = directory.modified;
+}
+
+IncludeIndex::Directory IncludeIndex::scanDirectory(const QString &path, const QStringList &suffixes)
+{
+    Directory directory;
+    directory.path = path;
+    // Taken before listing, so changes made meanwhile trigger another scan.
+    directory.modified = QFileInfo(path).lastModified().toTime_t();
+
+    QDirIterator i(path, QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot);
+    while (i.hasNext()) {
+        i.next();
+        const QFileInfo fileInfo = i.fileInfo();
+        const QString suffix = fileInfo.suffix();
+        if (!suffix.isEmpty() && !suffixes.contains(suffix))
+            continue;
+        if (!fileInfo.isDir()) {
+            directory.files.append(fileInfo.fileName());
+        } else if (fileInfo.isSymLink()) {
+            // Don't add broken symlinks
+            const QString target = fileInfo.symLinkTarget();
+            if (QFileInfo(target).exists())
+                directory.links.append(qMakePair(fileInfo.fileName(), target));
+        } else {
+            directory.directories.append(fileInfo.fileName());
+        }
+    }
+    return directory;
+}
+
+bool IncludeIndex::load(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream in(&file);
+    quint32 magic = 0;
+    quint32 version = 0;
+    in >> magic >> version;
+    if (magic != IndexMagic || version != IndexVersion)
+        return false;
+
+    IncludeIndex index;
+    in >> index.m_suffixes;
+    index.m_nodes.clear();
+    if (index.readNode(in) != 0 || in.status() != QDataStream::Ok)
+        return false;
+    *this = index;
+    return true;
+}
+
+bool IncludeIndex::save(const QString &fileName) const
+{
+    const QFileInfo fileInfo(fileName);
+    if (!QDir().mkpath(fileInfo.absolutePath()))
+        return false;
+
+    // Write to a temporary file first, a partial index is worse than none.
+    const QString tmpName = fileName + QLatin1String(".tmp");
+    QFile file(tmpName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+    QDataStream out(&file);
+    out << quint32(IndexMagic) << quint32(IndexVersion) << m_suffixes;
+    writeNode(out, 0);
+    file.close();
+    if (out.status() != QDataStream::Ok || file.error() != QFile::NoError) {
+        QFile::remove(tmpName);
+        return false;
+    }
+    QFile::remove(fileName);
+    return QFile::rename(tmpName, fileName);
+}
+
+void IncludeIndex::writeNode(QDataStream &out, int node) const
+{
+    const Node &n = m_nodes.at(node);
+    out << n.name << n.linkTarget << quint32(n.modified) << n.isDirectory
+        << quint32(n.children.size());
+    foreach (int child, n.children)
+        writeNode(out, child);
+}
+
+int IncludeIndex::readNode(QDataStream &in)
+{
+    Node n;
+    quint32 modified = 0;
+    quint32 childCount = 0;
+    in >> n.name >> n.linkTarget >> modified >> n.isDirectory >> childCount;
+    if (in.status() != QDataStream::Ok)
+        return -1;
+    n.modified = modified;
+
+    const int node = m_nodes.size();
+    m_nodes.append(n);
+    for (quint32 i = 0; i < childCount; ++i) {
+        const int child = readNode(in);
+        if (child < 0)
+            return -1;
+        m_nodes[node].children.append(child);
+    }
+    return node;
+}
+
+static QStringList pathComponents(const QString &path)
+{
+    return QDir::cleanPath(QDir::fromNativeSeparators(path))
+            .split(QLatin1Char('/'), QString::SkipEmptyParts);
+}
+
+int IncludeIndex::findNode(const QString &path) const
+{
+    QStringList components = pathComponents(path);
+    int node = 0;
+    int hops = 0;
+    for (int i = 0; i < components.size(); ++i) {
+        node = findChild(node, components.at(i));
+        if (node < 0)
+            return -1;
+        const QString &linkTarget = m_nodes.at(node).linkTarget;
+        if (!linkTarget.isEmpty()) {
+            if (++hops > MaxLinkHops)
+                return -1;
+            components = pathComponents(linkTarget) + components.mid(i + 1);
+            node = 0;
+            i = -1;
+        }
+    }
+    return m_nodes.at(node).modified ? node : -1;
+}
+
+int IncludeIndex::insertNode(const QString &path)
+{
+    QStringList components = pathComponents(path);
+    int node = 0;
+    int hops = 0;
+    for (int i = 0; i < components.size(); ++i) {
+        const QString &name = components.at(i);
+        int child = findChild(node, name);
+        if (child < 0) {
+            child = childNode(node, name);
+            m_nodes[child].isDirectory = true;
+
+            // Keep the children sorted
+            QVector<int> &children = m_nodes[node].children;
+            int pos = 0;
+            while (pos < children.size() && m_nodes.at(children.at(pos)).name < name)
+                ++pos;
+            children.insert(pos, child);
+        }
+        node = child;
+        const QString linkTarget = m_nodes.at(node).linkTarget;
+        if (!linkTarget.isEmpty()) {
+            if (++hops > MaxLinkHops)
+                return -1;
+            components = pathComponents(linkTarget) + components.mid(i + 1);
+            node = 0;
+            i = -1;
+        }
+    }
+    return node;
+}
+
+int IncludeIndex::findChild(int node, const QString &name) const
+{
+    const QVector<int> &children = m_nodes.at(node).children;
+    int begin = 0;
+    int end = children.size();
+    while (begin < end) {
+        const int middle = (begin + end) / 2;
+        const QString &middleName = m_nodes.at(children.at(middle)).name;
+        if (middleName < name)
+            begin = middle + 1;
+        else if (name < middleName)
+            end = middle;
+        else
+            return children.at(middle);
+    }
+    return -1;
+}
+
+// Returns the existing child, or a new node which still has to be added
+// to the children of parent.
+int IncludeIndex::childNode(int parent, const QString &name)
+{
+    const int child = findChild(parent, name);
+    if (child >= 0)
+        return child;
+    Node n;
+    n.name = name;
+    m_nodes.append(n);
+    return m_nodes.size() - 1;
+}
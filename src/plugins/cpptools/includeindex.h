@@ -0,0 +1,109 @@
+/**************************************************************************
+**
+** This file is part of Qt Creator
+**
+** Copyright (c) 2009 Nokia Corporation and/or its subsidiary(-ies).
+**
+** Contact: Nokia Corporation (qt-info@nokia.com)
+**
+** Commercial Usage
+**
+** Licensees holding valid Qt Commercial licenses may use this file in
+** accordance with the Qt Commercial License Agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Nokia.
+**
+** GNU Lesser General Public License Usage
+**
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** If you are unsure which license is appropriate for your use, please
+** contact the sales department at http://qt.nokia.com/contact.
+**
+**************************************************************************/
+
+#ifndef INCLUDEINDEX_H
+#define INCLUDEINDEX_H
+
+#include <QPair>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+QT_BEGIN_NAMESPACE
+class QDataStream;
+QT_END_NAMESPACE
+
+namespace CppTools {
+namespace Internal {
+
+// Directory contents below the include paths, used for #include completion.
+// Directories are stored as a trie of path components together with their
+// modification time, so unchanged directories need not be listed again.
+// The index can be saved to disk and reused by the next session.
+class IncludeIndex
+{
+public:
+    struct Directory
+    {
+        Directory() : modified(0) {}
+
+        QString path;
+        uint modified;
+        QStringList files;
+        QStringList directories;
+        QList<QPair<QString, QString> > links; // name, target
+    };
+
+    IncludeIndex();
+
+    bool isEmpty() const;
+
+    // Throws away the contents if the header suffixes differ
+    void setSuffixes(const QStringList &suffixes);
+    QStringList suffixes() const;
+
+    // Entries of the given directory, directories end with a slash
+    QStringList entries(const QString &path) const;
+
+    bool isUpToDate(const QString &path, uint modified) const;
+    QStringList subDirectories(const QString &path) const;
+    void setDirectory(const Directory &directory);
+
+    static Directory scanDirectory(const QString &path, const QStringList &suffixes);
+
+    bool load(const QString &fileName);
+    bool save(const QString &fileName) const;
+
+private:
+    struct Node
+    {
+        Node() : modified(0), isDirectory(false) {}
+
+        QString name;
+        QString linkTarget;
+        QVector<int> children; // Sorted by name
+        uint modified; // 0 if not scanned yet
+        bool isDirectory;
+    };
+
+    void writeNode(QDataStream &out, int node) const;
+    int readNode(QDataStream &in);
+    int findNode(const QString &path) const;
+    int findChild(int node, const QString &name) const;
+    int insertNode(const QString &path);
+    int childNode(int parent, const QString &name);
+
+    QStringList m_suffixes;
+    QVector<Node> m_nodes; // The root is always the first node
+};
+
+} // namespace Internal
+} // namespace CppTools
+
+#endif // INCLUDEINDEX_H
@@ -1543,6 +1543,7 @@ void CdbDebugEngine::fetchMemory(MemoryViewAgent *agent, quint64 addr, quint64 l
     if (FAILED(hr)) {
         warning(tr("Unable to retrieve %1 bytes of memory at 0x%2: %3").
                 arg(length).arg(addr, 0, 16).arg(msgComFailed("ReadVirtual", hr)));
+        agent->fetchFailed(addr);
         return;
     }
     if (received < length)
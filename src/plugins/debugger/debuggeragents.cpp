@@ -44,6 +44,8 @@
 #include <utils/qtcassert.h>
 
 #include <QtCore/QDebug>
+#include <QtCore/QMap>
+#include <QtCore/QTimer>
 
 #include <QtGui/QMessageBox>
 #include <QtGui/QPlainTextEdit>
@@ -70,13 +72,15 @@ namespace Internal {
 */
 
 MemoryViewAgent::MemoryViewAgent(DebuggerManager *manager, quint64 addr)
-    : QObject(manager), m_engine(manager->currentEngine()), m_manager(manager)
+    : QObject(manager), m_engine(manager->currentEngine()), m_manager(manager),
+      m_cache(CacheBlocks)
 {
     init(addr);
 }
 
 MemoryViewAgent::MemoryViewAgent(DebuggerManager *manager, const QString &addr)
-    : QObject(manager), m_engine(manager->currentEngine()), m_manager(manager) 
+    : QObject(manager), m_engine(manager->currentEngine()), m_manager(manager),
+      m_cache(CacheBlocks)
 {
     bool ok = true;
     init(addr.toULongLong(&ok, 0));
@@ -91,6 +95,12 @@ MemoryViewAgent::~MemoryViewAgent()
 
 void MemoryViewAgent::init(quint64 addr)
 {
+    m_lastBlock = addr / BinBlockSize;
+    m_direction = 1;
+    m_flushScheduled = false;
+    m_needsRefresh = false;
+    connect(m_manager, SIGNAL(stateChanged(int)), this, SLOT(handleStateChanged(int)));
+
     Core::EditorManager *editorManager = Core::EditorManager::instance();
     QString titlePattern = tr("Memory $");
     m_editor = editorManager->openEditorWithContents(
@@ -101,7 +111,7 @@ void MemoryViewAgent::init(quint64 addr)
             this, SLOT(fetchLazyData(quint64,bool)));
         editorManager->activateEditor(m_editor);
         QMetaObject::invokeMethod(m_editor->widget(), "setLazyData",
-            Q_ARG(quint64, addr), Q_ARG(int, 1024 * 1024), Q_ARG(int, BinBlockSize));
+            Q_ARG(quint64, addr), Q_ARG(qint64, 1024 * 1024), Q_ARG(int, BinBlockSize));
     } else {
         m_manager->showMessageBox(QMessageBox::Warning,
             tr("No memory viewer available"),
@@ -114,15 +124,142 @@ void MemoryViewAgent::init(quint64 addr)
 void MemoryViewAgent::fetchLazyData(quint64 block, bool sync)
 {
     Q_UNUSED(sync); // FIXME: needed support for incremental searching
-    if (m_engine)
-        m_engine->fetchMemory(this, BinBlockSize * block, BinBlockSize);
+    if (const QByteArray *data = m_cache.object(block)) {
+        deliverBlock(block, *data);
+        return;
+    }
+    if (block != m_lastBlock)
+        m_direction = block > m_lastBlock ? 1 : -1;
+    m_lastBlock = block;
+    if (m_fetchedBlocks.contains(block) || m_failedBlocks.contains(block))
+        return;
+
+    // The editor asks for one block at a time while painting,
+    // collect them and fetch adjacent ones together.
+    m_wantedBlocks.insert(block);
+    if (!m_flushScheduled) {
+        m_flushScheduled = true;
+        QTimer::singleShot(0, this, SLOT(flushRequests()));
+    }
+}
+
+void MemoryViewAgent::flushRequests()
+{
+    m_flushScheduled = false;
+    if (!m_engine || m_wantedBlocks.isEmpty())
+        return;
+
+    QList<quint64> wanted = m_wantedBlocks.toList();
+    qSort(wanted);
+    QSet<quint64> blocks = m_wantedBlocks;
+    m_wantedBlocks.clear();
+
+    // Read ahead in scroll direction.
+    const quint64 edge = m_direction > 0 ? wanted.last() : wanted.first();
+    for (quint64 i = 1; i <= quint64(ReadAheadBlocks); ++i) {
+        if (m_direction < 0 && edge < i)
+            break;
+        const quint64 block = m_direction > 0 ? edge + i : edge - i;
+        if (!m_cache.contains(block) && !m_fetchedBlocks.contains(block)
+                && !m_failedBlocks.contains(block))
+            blocks.insert(block);
+    }
+
+    QList<quint64> sorted = blocks.toList();
+    qSort(sorted);
+    for (int i = 0; i < sorted.size(); ) {
+        const quint64 first = sorted.at(i);
+        int count = 1;
+        while (i + count < sorted.size() && count < MaxFetchBlocks
+                && sorted.at(i + count) == first + count)
+            ++count;
+        for (int j = 0; j != count; ++j)
+            m_fetchedBlocks.insert(first + j);
+        PendingFetch &fetch = m_pendingFetches[first * BinBlockSize];
+        fetch.blocks = count;
+        fetch.time.start();
+        m_engine->fetchMemory(this, first * BinBlockSize, count * BinBlockSize);
+        i += count;
+    }
 }
 
 void MemoryViewAgent::addLazyData(quint64 addr, const QByteArray &ba)
+{
+    // Fetches issued before the inferior continued hold old memory.
+    if (!m_pendingFetches.contains(addr))
+        return;
+    const PendingFetch fetch = m_pendingFetches.take(addr);
+    if (m_manager)
+        m_manager->showDebuggerOutput(LogMisc,
+            tr("Fetched %1 bytes of memory at 0x%2 in %3 ms")
+            .arg(ba.size()).arg(addr, 0, 16).arg(fetch.time.elapsed()));
+
+    const quint64 first = addr / BinBlockSize;
+    for (int i = 0; i != fetch.blocks; ++i) {
+        QByteArray data = ba.mid(i * BinBlockSize, BinBlockSize);
+        if (data.size() < BinBlockSize) // Short read.
+            data += QByteArray(BinBlockSize - data.size(), '\0');
+        m_fetchedBlocks.remove(first + i);
+        m_cache.insert(first + i, new QByteArray(data));
+        deliverBlock(first + i, data);
+    }
+}
+
+void MemoryViewAgent::fetchFailed(quint64 addr)
+{
+    // Fetches issued before the inferior continued are forgotten.
+    if (!m_pendingFetches.contains(addr))
+        return;
+    const PendingFetch fetch = m_pendingFetches.take(addr);
+    const quint64 first = addr / BinBlockSize;
+    if (m_manager)
+        m_manager->showDebuggerOutput(LogMisc,
+            tr("Unable to fetch %1 bytes of memory at 0x%2")
+            .arg(fetch.blocks * BinBlockSize).arg(addr, 0, 16));
+
+    if (fetch.blocks == 1 || !m_engine) {
+        // Nothing left to try until the inferior continues.
+        for (int i = 0; i != fetch.blocks; ++i) {
+            m_fetchedBlocks.remove(first + i);
+            m_failedBlocks.insert(first + i);
+        }
+        return;
+    }
+
+    // A single unreadable byte, e.g. in a read-ahead block beyond the
+    // end of a mapping, fails a whole coalesced read. Fetch the blocks
+    // one by one to get everything that is readable.
+    for (int i = 0; i != fetch.blocks; ++i) {
+        const quint64 block = first + i;
+        PendingFetch &retry = m_pendingFetches[block * BinBlockSize];
+        retry.blocks = 1;
+        retry.time.start();
+        m_engine->fetchMemory(this, block * BinBlockSize, BinBlockSize);
+    }
+}
+
+void MemoryViewAgent::deliverBlock(quint64 block, const QByteArray &data)
 {
     if (m_editor && m_editor->widget())
         QMetaObject::invokeMethod(m_editor->widget(), "addLazyData",
-            Q_ARG(quint64, addr / BinBlockSize), Q_ARG(QByteArray, ba));
+            Q_ARG(quint64, block), Q_ARG(QByteArray, data));
+}
+
+void MemoryViewAgent::handleStateChanged(int state)
+{
+    if (state == InferiorRunning) {
+        // Anything read so far may change now.
+        m_cache.clear();
+        m_wantedBlocks.clear();
+        m_fetchedBlocks.clear();
+        m_failedBlocks.clear();
+        m_pendingFetches.clear();
+        m_needsRefresh = true;
+    } else if (state == InferiorStopped && m_needsRefresh) {
+        m_needsRefresh = false;
+        if (m_editor && m_editor->widget())
+            QMetaObject::invokeMethod(m_editor->widget(), "clearLazyData");
+    }
 }
 
 
@@ -151,13 +288,110 @@ public:
     void documentClosing() {}
 };
 
+/*!
+    \class DisassemblerCache
+
+     Keeps the decoded instructions fetched so far, indexed by address.
+     Each chunk covers a contiguous address range; fetches overlapping an
+     existing chunk are merged into it. The least recently used chunks are
+     dropped once the cached text exceeds the budget.
+*/
+
+// One entry per instruction. In mixed mode the source lines leading to
+// the instruction precede its line in the entry's text.
+typedef QMap<quint64, QString> DisassemblerLines;
+
+struct DisassemblerChunk
+{
+    DisassemblerChunk() : lastUse(0), cost(0) {}
+    quint64 firstAddress() const { return lines.begin().key(); }
+    quint64 lastAddress() const { return (--lines.end()).key(); }
+
+    DisassemblerLines lines;
+    int lastUse;
+    int cost;
+};
+
+class DisassemblerCache
+{
+public:
+    enum { Budget = 1024 * 1024 }; // In characters.
+
+    DisassemblerCache() : m_useCounter(0), m_cost(0) {}
+
+    const DisassemblerChunk &chunk(int index) const { return m_chunks.at(index); }
+
+    // Returns the index of the chunk holding an instruction at address, or -1.
+    int find(quint64 address) const
+    {
+        for (int i = 0; i != m_chunks.size(); ++i)
+            if (m_chunks.at(i).lines.contains(address))
+                return i;
+        return -1;
+    }
+
+    void touch(int index)
+    {
+        m_chunks[index].lastUse = ++m_useCounter;
+    }
+
+    // Returns the index of the chunk the lines were merged into.
+    int insert(const DisassemblerLines &lines)
+    {
+        QTC_ASSERT(!lines.isEmpty(), return -1);
+        DisassemblerChunk merged;
+        merged.lines = lines;
+        const quint64 first = merged.firstAddress();
+        const quint64 last = merged.lastAddress();
+        for (int i = m_chunks.size(); --i >= 0; ) {
+            const DisassemblerChunk &chunk = m_chunks.at(i);
+            if (chunk.firstAddress() > last || chunk.lastAddress() < first)
+                continue;
+            // The new lines win within their own range.
+            DisassemblerLines::ConstIterator it = chunk.lines.constBegin();
+            for ( ; it != chunk.lines.constEnd(); ++it)
+                if (it.key() < first || it.key() > last)
+                    merged.lines.insert(it.key(), it.value());
+            m_cost -= chunk.cost;
+            m_chunks.removeAt(i);
+        }
+        foreach (const QString &text, merged.lines)
+            merged.cost += text.size();
+        merged.lastUse = ++m_useCounter;
+        m_cost += merged.cost;
+        m_chunks.append(merged);
+
+        while (m_cost > Budget && m_chunks.size() > 1) {
+            int oldest = 0;
+            for (int i = 1; i != m_chunks.size(); ++i)
+                if (m_chunks.at(i).lastUse < m_chunks.at(oldest).lastUse)
+                    oldest = i;
+            m_cost -= m_chunks.at(oldest).cost;
+            m_chunks.removeAt(oldest);
+        }
+        return m_chunks.size() - 1;
+    }
+
+    void clear()
+    {
+        m_chunks.clear();
+        m_cost = 0;
+    }
+
+private:
+    QList<DisassemblerChunk> m_chunks;
+    int m_useCounter;
+    int m_cost;
+};
+
 struct DisassemblerViewAgentPrivate
 {
     QPointer<TextEditor::ITextEditor> editor;
     StackFrame frame;
     QPointer<DebuggerManager> manager;
     LocationMark2 *locationMark;
-    QHash<QString, QString> cache;
+    DisassemblerCache cache;
+    DisassemblerLines shown; // What the editor currently displays.
 };
 
 /*!
@@ -225,36 +459,101 @@ void DisassemblerViewAgent::resetLocation()
         d->editor->markableInterface()->removeMark(d->locationMark);
 }
 
-QString frameKey(const StackFrame &frame)
+static quint64 addressOf(const QString &address)
 {
-    return _("%1:%2:%3").arg(frame.function).arg(frame.file).arg(frame.from);
+    bool ok = true;
+    return address.toULongLong(&ok, 0);
+}
+
+// Instruction lines start with their address, everything
+// else is attached to the next instruction.
+static DisassemblerLines parseContents(const QString &contents)
+{
+    DisassemblerLines lines;
+    QString pending;
+    foreach (const QString &line, contents.split(QLatin1Char('\n'))) {
+        if (line.startsWith(_("0x"))) {
+            int end = line.indexOf(QLatin1Char(' '));
+            if (end == -1)
+                end = line.size();
+            bool ok = false;
+            const quint64 address = line.left(end).toULongLong(&ok, 0);
+            if (ok) {
+                pending += line;
+                lines.insert(address, pending);
+                pending.clear();
+                continue;
+            }
+        }
+        if (!line.isEmpty()) {
+            pending += line;
+            pending += QLatin1Char('\n');
+        }
+    }
+    return lines;
 }
 
 void DisassemblerViewAgent::setFrame(const StackFrame &frame)
 {
     d->frame = frame;
-    if (!frame.function.isEmpty() && frame.function != _("??")) {
-        QHash<QString, QString>::ConstIterator it = d->cache.find(frameKey(frame));
-        if (it != d->cache.end()) {
+    const quint64 address = addressOf(frame.address);
+    const int index = d->cache.find(address);
+    if (index != -1) {
+        // Stepping within a cached range needs no round trip as long
+        // as there is context on both sides.
+        const DisassemblerChunk &chunk = d->cache.chunk(index);
+        if (address != chunk.firstAddress() && address != chunk.lastAddress()) {
             QString msg = _("Use cache dissassembler for '%1' in '%2'")
                 .arg(frame.function).arg(frame.file);
             d->manager->showDebuggerOutput(msg);
-            setContents(*it);
+            d->cache.touch(index);
+            showLines(chunk.lines);
             return;
         }
-    } 
+    }
     IDebuggerEngine *engine = d->manager->currentEngine();
     QTC_ASSERT(engine, return);
     engine->fetchDisassembler(this, frame);
 }
 
+void DisassemblerViewAgent::trimToMissingRange(quint64 *start, quint64 *end) const
+{
+    const int index = d->cache.find(addressOf(d->frame.address));
+    if (index == -1)
+        return;
+    const DisassemblerChunk &chunk = d->cache.chunk(index);
+    const quint64 first = chunk.firstAddress();
+    const quint64 last = chunk.lastAddress();
+    // The boundary instruction is fetched again so that decoding starts
+    // at a known instruction and the result overlaps the cached range.
+    if (first <= *start && last < *end)
+        *start = last;
+    else if (first > *start && last >= *end)
+        *end = first + 1;
+}
+
 void DisassemblerViewAgent::setContents(const QString &contents)
 {
     QTC_ASSERT(d, return);
+    const DisassemblerLines lines = parseContents(contents);
+    if (lines.isEmpty()) {
+        // Nothing to index, show as is.
+        if (QPlainTextEdit *plainTextEdit = ensureEditor())
+            plainTextEdit->setPlainText(contents);
+        d->shown.clear();
+        if (d->editor)
+            d->editor->markableInterface()->removeMark(d->locationMark);
+        return;
+    }
+    const int index = d->cache.insert(lines);
+    showLines(d->cache.chunk(index).lines);
+}
+
+QPlainTextEdit *DisassemblerViewAgent::ensureEditor()
+{
     using namespace Core;
     using namespace TextEditor;
 
-    d->cache.insert(frameKey(d->frame), contents);
     QPlainTextEdit *plainTextEdit = 0;
     EditorManager *editorManager = EditorManager::instance();
     if (!d->editor) {
@@ -263,39 +562,95 @@ void DisassemblerViewAgent::setContents(const QString &contents)
             editorManager->openEditorWithContents(
                 Core::Constants::K_DEFAULT_TEXT_EDITOR,
                 &titlePattern));
-        QTC_ASSERT(d->editor, return);
+        QTC_ASSERT(d->editor, return 0);
         if ((plainTextEdit = qobject_cast<QPlainTextEdit *>(d->editor->widget())))
             (void) new DisassemblerHighlighter(plainTextEdit);
+        d->shown.clear();
     }
 
     editorManager->activateEditor(d->editor);
+    d->editor->setDisplayName(_("Disassembler (%1)").arg(d->frame.function));
+    return qobject_cast<QPlainTextEdit *>(d->editor->widget());
+}
 
-    plainTextEdit = qobject_cast<QPlainTextEdit *>(d->editor->widget());
-    if (plainTextEdit)
-        plainTextEdit->setPlainText(contents);
+static QString joinLines(DisassemblerLines::ConstIterator from,
+    DisassemblerLines::ConstIterator to)
+{
+    QString result;
+    for (DisassemblerLines::ConstIterator it = from; it != to; ++it) {
+        if (!result.isEmpty())
+            result += QLatin1Char('\n');
+        result += it.value();
+    }
+    return result;
+}
 
-    d->editor->markableInterface()->removeMark(d->locationMark);
-    d->editor->setDisplayName(_("Disassembler (%1)").arg(d->frame.function));
+// Returns whether the displayed lines are an unchanged part of lines.
+static bool isContainedIn(const DisassemblerLines &shown, const DisassemblerLines &lines)
+{
+    if (shown.isEmpty())
+        return false;
+    DisassemblerLines::ConstIterator it = lines.find(shown.begin().key());
+    DisassemblerLines::ConstIterator jt = shown.constBegin();
+    for ( ; jt != shown.constEnd(); ++jt, ++it) {
+        if (it == lines.constEnd() || it.key() != jt.key() || it.value() != jt.value())
+            return false;
+    }
+    return true;
+}
 
-    for (int pos = 0, line = 0; ; ++line, ++pos) {
-        if (contents.midRef(pos, d->frame.address.size()) == d->frame.address) {
-            d->editor->markableInterface()->addMark(d->locationMark, line + 1);
-            if (plainTextEdit) {
-                QTextCursor tc = plainTextEdit->textCursor();
-                tc.setPosition(pos);
-                plainTextEdit->setTextCursor(tc);
+void DisassemblerViewAgent::showLines(const DisassemblerLines &lines)
+{
+    QPlainTextEdit *plainTextEdit = ensureEditor();
+    QTC_ASSERT(d->editor, return);
+
+    if (plainTextEdit) {
+        if (isContainedIn(d->shown, lines)) {
+            // Only add what was fetched around the displayed range, so
+            // the layout of the existing text is kept.
+            const QString prefix = joinLines(lines.constBegin(),
+                lines.constFind(d->shown.constBegin().key()));
+            const QString suffix = joinLines(++lines.constFind((--d->shown.constEnd()).key()),
+                lines.constEnd());
+            QTextCursor tc(plainTextEdit->document());
+            if (!prefix.isEmpty()) {
+                tc.movePosition(QTextCursor::Start);
+                tc.insertText(prefix + QLatin1Char('\n'));
             }
-            break;
+            if (!suffix.isEmpty()) {
+                tc.movePosition(QTextCursor::End);
+                tc.insertText(QLatin1Char('\n') + suffix);
+            }
+        } else {
+            plainTextEdit->setPlainText(joinLines(lines.constBegin(), lines.constEnd()));
         }
-        pos = contents.indexOf('\n', pos + 1);
-        if (pos == -1)
-            break;
+    }
+    d->shown = lines;
+
+    d->editor->markableInterface()->removeMark(d->locationMark);
+
+    const quint64 address = addressOf(d->frame.address);
+    int line = 0;
+    DisassemblerLines::ConstIterator it = lines.constBegin();
+    for ( ; it != lines.constEnd() && it.key() < address; ++it)
+        line += it.value().count(QLatin1Char('\n')) + 1;
+    if (it == lines.constEnd() || it.key() != address)
+        return;
+    line += it.value().count(QLatin1Char('\n'));
+    d->editor->markableInterface()->addMark(d->locationMark, line + 1);
+    if (plainTextEdit) {
+        QTextCursor tc = plainTextEdit->textCursor();
+        tc.setPosition(plainTextEdit->document()->findBlockByNumber(line).position());
+        plainTextEdit->setTextCursor(tc);
     }
 }
 
 bool DisassemblerViewAgent::contentsCoversAddress(const QString &contents) const
 {
     QTC_ASSERT(d, return false);
+    // Partial fetches only cover the range missing around a cached address.
+    if (d->cache.find(addressOf(d->frame.address)) != -1)
+        return true;
     for (int pos = 0, line = 0; ; ++line, ++pos) { 
         if (contents.midRef(pos, d->frame.address.size()) == d->frame.address)
             return true;
@@ -36,10 +36,19 @@
 #include <coreplugin/editormanager/ieditor.h>
 
 #include <QtCore/QObject>
+#include <QtCore/QCache>
 #include <QtCore/QDebug>
+#include <QtCore/QHash>
+#include <QtCore/QMap>
 #include <QtCore/QPointer>
+#include <QtCore/QSet>
+#include <QtCore/QTime>
 #include <QtGui/QAction>
 
+QT_BEGIN_NAMESPACE
+class QPlainTextEdit;
+QT_END_NAMESPACE
+
 
 namespace Debugger {
 class DebuggerManager;
@@ -57,20 +66,46 @@ public:
     explicit MemoryViewAgent(DebuggerManager *manager, const QString &startaddr);
     ~MemoryViewAgent();
 
-    enum { BinBlockSize = 1024 };
+    enum { BinBlockSize = 1024,
+           ReadAheadBlocks = 8,  // Fetched beyond a request in scroll direction
+           MaxFetchBlocks = 64,  // Upper bound for one coalesced read
+           CacheBlocks = 512 };  // Kept until the inferior continues
 
 public slots:
     // Called from Engine
     void addLazyData(quint64 addr, const QByteArray &data);
+    void fetchFailed(quint64 addr);
     // Called from Editor
     void fetchLazyData(quint64 block, bool sync);
 
+private slots:
+    void flushRequests();
+    void handleStateChanged(int state);
+
 private:
     void init(quint64 startaddr);
+    void deliverBlock(quint64 block, const QByteArray &data);
+
+    struct PendingFetch
+    {
+        PendingFetch() : blocks(0) {}
+        QTime time;
+        int blocks;
+    };
 
     QPointer<IDebuggerEngine> m_engine;
     QPointer<Core::IEditor> m_editor;
     QPointer<DebuggerManager> m_manager;
+
+    QSet<quint64> m_wantedBlocks; // Requested by the editor, not yet fetched.
+    QSet<quint64> m_fetchedBlocks; // Fetched, not yet answered.
+    QHash<quint64, PendingFetch> m_pendingFetches; // By start address.
+    QSet<quint64> m_failedBlocks; // Unreadable until the inferior continues.
+    QCache<quint64, QByteArray> m_cache;
+    quint64 m_lastBlock;
+    int m_direction;
+    bool m_flushScheduled;
+    bool m_needsRefresh;
 };
 
 
@@ -88,9 +123,15 @@ public:
     Q_SLOT void setContents(const QString &contents);
     QString address() const;
     bool contentsCoversAddress(const QString &contents) const;
+    // Called from Engine. Narrows the range wanted around the current
+    // address to the part that is not cached yet.
+    void trimToMissingRange(quint64 *start, quint64 *end) const;
     void cleanup();
 
 private:
+    QPlainTextEdit *ensureEditor();
+    void showLines(const QMap<quint64, QString> &lines);
+
     DisassemblerViewAgentPrivate *d;
 };
 
@@ -171,7 +171,10 @@ DEBUGGER_EXPORT QDebug operator<<(QDebug str, const DebuggerStartParameters &p)
             << " remoteArchitecture=" << p.remoteArchitecture
             << " symbolFileName=" << p.symbolFileName
             << " serverStartScript=" << p.serverStartScript
-            << " toolchain=" << p.toolChainType << '\n';
+            << " toolchain=" << p.toolChainType;
+    if (!p.replayTranscript.isEmpty())
+        nospace << " replayTranscript=" << p.replayTranscript;
+    nospace << '\n';
     return str;
 }
 
@@ -239,6 +242,7 @@ void DebuggerStartParameters::clear()
     serverStartScript.clear();
     toolChainType = ProjectExplorer::ToolChain::UNKNOWN;
     startMode = NoStartMode;
+    replayTranscript.clear();
 }
 
 
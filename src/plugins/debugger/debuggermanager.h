@@ -124,6 +124,9 @@ public:
     QString dumperLibrary;
     QStringList dumperLibraryLocations;
     DebuggerStartMode startMode;
+
+    // gdb log to answer from instead of running gdb, for benchmarks
+    QString replayTranscript;
 };
 
 typedef QSharedPointer<DebuggerStartParameters> DebuggerStartParametersPtr;
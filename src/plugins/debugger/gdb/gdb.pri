@@ -7,6 +7,7 @@ include(../../../shared/trk/trk.pri)
 
 HEADERS += \
     $$PWD/gdbmi.h \
+    $$PWD/gdbtranscript.h \
     $$PWD/gdbengine.h \
     $$PWD/gdboptionspage.h \
     $$PWD/trkoptions.h \
@@ -18,11 +19,13 @@ HEADERS += \
     $$PWD/plaingdbadapter.h \
     $$PWD/termgdbadapter.h \
     $$PWD/remotegdbadapter.h \
+    $$PWD/replaygdbadapter.h \
     $$PWD/trkgdbadapter.h \
     $$PWD/s60debuggerbluetoothstarter.h
 
 SOURCES += \
     $$PWD/gdbmi.cpp \
+    $$PWD/gdbtranscript.cpp \
     $$PWD/gdbengine.cpp \
     $$PWD/gdboptionspage.cpp \
     $$PWD/trkoptions.cpp \
@@ -34,6 +37,7 @@ SOURCES += \
     $$PWD/plaingdbadapter.cpp \
     $$PWD/termgdbadapter.cpp \
     $$PWD/remotegdbadapter.cpp \
+    $$PWD/replaygdbadapter.cpp \
     $$PWD/trkgdbadapter.cpp \
     $$PWD/s60debuggerbluetoothstarter.cpp
 
@@ -39,6 +39,7 @@
 #include "plaingdbadapter.h"
 #include "termgdbadapter.h"
 #include "remotegdbadapter.h"
+#include "replaygdbadapter.h"
 #include "trkgdbadapter.h"
 
 #include "watchutils.h"
@@ -190,7 +191,9 @@ GdbEngine::GdbEngine(DebuggerManager *manager) :
 #endif
 {
     m_trkOptions = QSharedPointer<TrkOptions>(new TrkOptions);
-    m_trkOptions->fromSettings(Core::ICore::instance()->settings());
+    // No core when driven standalone, e.g. by the replay benchmark.
+    if (Core::ICore *core = Core::ICore::instance())
+        m_trkOptions->fromSettings(core->settings());
     m_gdbAdapter = 0;
 
     m_commandTimer = new QTimer(this);
@@ -269,6 +272,7 @@ void GdbEngine::initializeVariables()
     m_fullToShortName.clear();
     m_shortToFullName.clear();
     m_varToType.clear();
+    m_cachedChildren.clear();
 
     invalidateSourcesList();
     m_sourcesListUpdating = false;
@@ -614,6 +618,11 @@ void GdbEngine::readGdbStandardError()
 }
 
 void GdbEngine::readGdbStandardOutput()
+{
+    handleGdbStandardOutput(m_gdbProc.readAllStandardOutput());
+}
+
+void GdbEngine::handleGdbStandardOutput(const QByteArray &output)
 {
     if (m_commandTimer->isActive()) 
         m_commandTimer->start(); // Retrigger
@@ -621,7 +630,7 @@ void GdbEngine::readGdbStandardOutput()
     int newstart = 0;
     int scan = m_inbuffer.size();
 
-    m_inbuffer.append(m_gdbProc.readAllStandardOutput());
+    m_inbuffer.append(output);
 
     // This can trigger when a dialog starts a nested event loop
     if (m_busy)
@@ -1613,6 +1622,16 @@ bool GdbEngine::checkConfiguration(int toolChain, QString *errorMessage, QString
 
 AbstractGdbAdapter *GdbEngine::createAdapter(const DebuggerStartParametersPtr &sp)
 {
+    // Answer from a recorded debugger log instead of running gdb. Only
+    // set explicitly by benchmarks, never by a normal debugging session.
+    if (!sp->replayTranscript.isEmpty()) {
+        const QString msg = tr("Replaying the gdb log %1 instead of running gdb.")
+            .arg(sp->replayTranscript);
+        qWarning("%s", qPrintable(msg));
+        manager()->showDebuggerOutput(LogWarning, msg);
+        showStatusMessage(msg);
+        return new ReplayGdbAdapter(this, sp->replayTranscript);
+    }
     switch (sp->toolChainType) {
     case ProjectExplorer::ToolChain::WINSCW: // S60
     case ProjectExplorer::ToolChain::GCCE:
@@ -2947,8 +2966,16 @@ void GdbEngine::runDebuggingHelper(const WatchData &data0, bool dumpChildren)
     }
     WatchData data = data0;
 
+    // Ask only for the value of a container whose children might be
+    // reused from the previous stop.
+    const bool probe = dumpChildren && data.childrenStart == 0
+        && m_cachedChildren.contains(data.iname);
+    if (probe)
+        dumpChildren = false;
+
     // Avoid endless loops created by faulty dumpers.
-    QString processedName = QString(_("%1-%2").arg(dumpChildren).arg(data.iname));
+    QString processedName = QString(_("%1-%2-%3").arg(dumpChildren)
+        .arg(data.childrenStart).arg(data.iname));
     if (m_processedNames.contains(processedName)) {
         gdbInputAvailable(LogStatus,
             _("<Breaking endless loop for %1>").arg(data.iname));
@@ -2964,6 +2991,15 @@ void GdbEngine::runDebuggingHelper(const WatchData &data0, bool dumpChildren)
     QStringList extraArgs;
     const QtDumperHelper::TypeData td = m_dumperHelper.typeData(data0.type);
     m_dumperHelper.evaluationParameters(data, td, QtDumperHelper::GdbDebugger, &params, &extraArgs);
+    if (dumpChildren || probe) {
+        // Only the window of children that is shown is dumped.
+        const int childrenEnd = qMax(data.childrenStart,
+            manager()->watchHandler()->childrenLimit(data.iname));
+        params.append(QByteArray::number(data.childrenStart));
+        params.append('\0');
+        params.append(QByteArray::number(childrenEnd));
+        params.append('\0');
+    }
 
     //int protocol = (data.iname.startsWith("watch") && data.type == "QImage") ? 3 : 2;
     //int protocol = data.iname.startsWith("watch") ? 3 : 2;
@@ -2991,8 +3027,12 @@ void GdbEngine::runDebuggingHelper(const WatchData &data0, bool dumpChildren)
     showStatusMessage(msgRetrievingWatchData(m_pendingRequests + 1), 10000);
 
     // retrieve response
-    postCommand(_("p (char*)&qDumpOutBuffer"), WatchUpdate,
-        CB(handleDebuggingHelperValue2), qVariantFromValue(data));
+    if (probe)
+        postCommand(_("p (char*)&qDumpOutBuffer"), WatchUpdate,
+            CB(handleDebuggingHelperProbe), qVariantFromValue(data));
+    else
+        postCommand(_("p (char*)&qDumpOutBuffer"), WatchUpdate,
+            CB(handleDebuggingHelperValue2), qVariantFromValue(data));
 }
 
 void GdbEngine::createGdbVariable(const WatchData &data)
@@ -3446,9 +3486,80 @@ void GdbEngine::handleDebuggingHelperValue2(const GdbResponse &response)
     handleChildren(data, contents, &list);
     //for (int i = 0; i != list.size(); ++i)
     //    qDebug() << "READ: " << list.at(i).toString();
+    cacheChildren(data, contents, list);
+    manager()->watchHandler()->insertBulkData(list);
+}
+
+void GdbEngine::handleDebuggingHelperProbe(const GdbResponse &response)
+{
+    WatchData data = response.cookie.value<WatchData>();
+    QTC_ASSERT(data.isValid(), return);
+
+    const CachedChildren cached = m_cachedChildren.take(data.iname);
+
+    GdbMi contents;
+    if (m_cookieForToken.contains(response.token - 1)
+            || response.resultClass != GdbResultDone
+            || !parseConsoleStream(response, &contents)) {
+        // Let the regular request deal with the failure.
+        if (m_cookieForToken.remove(response.token - 1))
+            --m_pendingRequests;
+        runDebuggingHelper(data, true);
+        return;
+    }
+
+    // Elements changed in place keep size and data pointer, only the
+    // checksum of the shown children tells.
+    const GdbMi checksum = contents.findChild("childrenchecksum");
+    if (!checksum.isValid()
+            || checksum.data().toUInt() != cached.checksum
+            || contents.findChild("datapointer").data() != cached.dataPointer
+            || contents.findChild("numchild").data().toInt() != cached.childCount) {
+        runDebuggingHelper(data, true);
+        return;
+    }
+
+    // The container did not change since the last stop, reuse its children.
+    setWatchDataType(data, response.data.findChild("type"));
+    setWatchDataDisplayedType(data, response.data.findChild("displaytype"));
+    QList<WatchData> list;
+    handleChildren(data, contents, &list);
+    list.first().childCount = cached.childCount;
+    list.first().setChildrenUnneeded();
+    list += cached.children;
+    m_cachedChildren.insert(data.iname, cached);
     manager()->watchHandler()->insertBulkData(list);
 }
 
+void GdbEngine::cacheChildren(const WatchData &data, const GdbMi &contents,
+    const QList<WatchData> &list)
+{
+    const GdbMi childrenStart = contents.findChild("childrenstart");
+    const GdbMi dataPointer = contents.findChild("datapointer");
+    const GdbMi checksum = contents.findChild("childrenchecksum");
+    if (!childrenStart.isValid() || !dataPointer.isValid() || !checksum.isValid()) {
+        m_cachedChildren.remove(data.iname);
+        return;
+    }
+
+    const int childCount = contents.findChild("numchild").data().toInt();
+    CachedChildren &cached = m_cachedChildren[data.iname];
+    if (childrenStart.data().toInt() == 0) {
+        cached.dataPointer = dataPointer.data();
+        cached.childCount = childCount;
+        cached.checksum = 0;
+        cached.children.clear();
+    } else if (cached.dataPointer != dataPointer.data()
+            || cached.childCount != childCount
+            || childrenStart.data().toInt() != cached.children.size()) {
+        m_cachedChildren.remove(data.iname);
+        return;
+    }
+    // The checksum of a window is the sum of the checksums of its pages.
+    cached.checksum += checksum.data().toUInt();
+    cached.children += list.mid(1);
+}
+
 void GdbEngine::handleChildren(const WatchData &data0, const GdbMi &item,
     QList<WatchData> *list)
 {
@@ -3472,6 +3583,11 @@ void GdbEngine::handleChildren(const WatchData &data0, const GdbMi &item,
     setWatchDataEditValue(data, item.findChild("editvalue"));
     setWatchDataExpression(data, item.findChild("exp"));
     setWatchDataChildCount(data, item.findChild("numchild"));
+    // Paged containers report their full size, more children can be fetched.
+    const GdbMi childrenStart = item.findChild("childrenstart");
+    if (childrenStart.isValid())
+        data.childCount = item.findChild("numchild").data().toInt();
+    data.childrenStart = 0;
     setWatchDataValue(data, item.findChild("value"),
         item.findChild("valueencoded").data().toInt());
     setWatchDataAddress(data, item.findChild("addr"));
@@ -3489,7 +3605,7 @@ void GdbEngine::handleChildren(const WatchData &data0, const GdbMi &item,
     setWatchDataChildCount(childtemplate, item.findChild("childnumchild"));
     //qDebug() << "CHILD TEMPLATE:" << childtemplate.toString();
 
-    int i = 0;
+    int i = childrenStart.data().toInt();
     foreach (GdbMi child, children.children()) {
         WatchData data1 = childtemplate;
         GdbMi name = child.findChild("name");
@@ -4154,18 +4270,29 @@ void GdbEngine::handleFetchMemory(const GdbResponse &response)
     // data=["1","0","0","0","5","0","0","0","0","0","0","0","0","0","0","0"]}]
     MemoryAgentCookie ac = response.cookie.value<MemoryAgentCookie>();
     QTC_ASSERT(ac.agent, return);
+    // The agent splits up failed reads, so it needs to know about them.
+    if (response.resultClass != GdbResultDone) {
+        ac.agent->fetchFailed(ac.address);
+        return;
+    }
     QByteArray ba;
     GdbMi memory = response.data.findChild("memory");
-    QTC_ASSERT(memory.children().size() <= 1, return);
-    if (memory.children().isEmpty())
+    QTC_ASSERT(memory.children().size() <= 1,
+        ac.agent->fetchFailed(ac.address); return);
+    if (memory.children().isEmpty()) {
+        ac.agent->fetchFailed(ac.address);
         return;
+    }
     GdbMi memory0 = memory.children().at(0); // we asked for only one 'row'
     GdbMi data = memory0.findChild("data");
     foreach (const GdbMi &child, data.children()) {
         bool ok = true;
         unsigned char c = '?';
         c = child.data().toUInt(&ok, 0);
-        QTC_ASSERT(ok, return);
+        if (!ok) { // "N/A" for unreadable bytes.
+            ac.agent->fetchFailed(ac.address);
+            return;
+        }
         ba.append(c);
     }
     ac.agent->addLazyData(ac.address, ba);
@@ -4202,8 +4329,11 @@ void GdbEngine::fetchDisassemblerByAddress(DisassemblerViewAgent *agent,
     bool ok = true;
     quint64 address = agent->address().toULongLong(&ok, 0);
     QTC_ASSERT(ok, qDebug() << "ADDRESS: " << agent->address() << address; return);
-    QString start = QString::number(address - 20, 16);
-    QString end = QString::number(address + 100, 16);
+    quint64 startAddress = address - 20;
+    quint64 endAddress = address + 100;
+    agent->trimToMissingRange(&startAddress, &endAddress);
+    QString start = QString::number(startAddress, 16);
+    QString end = QString::number(endAddress, 16);
     // -data-disassemble [ -s start-addr -e end-addr ]
     //  | [ -f filename -l linenum [ -n lines ] ] -- mode
     if (useMixedMode) 
@@ -4312,7 +4442,7 @@ void GdbEngine::handleFetchDisassemblerByAddress1(const GdbResponse &response)
         else {
             QString contents = parseDisassembler(lines);
             if (ac.agent->contentsCoversAddress(contents)) {
-                ac.agent->setContents(parseDisassembler(lines));
+                ac.agent->setContents(contents);
             } else {
                 debugMessage(_("FALL BACK TO NON-MIXED"));
                 fetchDisassemblerByAddress(ac.agent, false);
@@ -4383,6 +4513,12 @@ bool GdbEngine::startGdb(const QStringList &args, const QString &gdb, const QStr
     connect(&m_gdbProc, SIGNAL(readyReadStandardError()),
         SLOT(readGdbStandardError()));
 
+    initializeGdb();
+    return true;
+}
+
+void GdbEngine::initializeGdb()
+{
     debugMessage(_("GDB STARTED, INITIALIZING IT"));
     int timeOut = theDebuggerAction(GdbWatchdogTimeout)->value().toInt();
     m_commandTimer->setInterval(1000 * qMax(20, timeOut));
@@ -4476,7 +4612,6 @@ bool GdbEngine::startGdb(const QStringList &args, const QString &gdb, const QStr
         postCommand(cmd);
         m_debuggingHelperState = DebuggingHelperLoadTried;
     }
-    return true;
 }
 
 void GdbEngine::handleGdbError(QProcess::ProcessError error)
@@ -96,6 +96,7 @@ private:
     friend class PlainGdbAdapter;
     friend class TermGdbAdapter;
     friend class RemoteGdbAdapter;
+    friend class ReplayGdbAdapter;
     friend class TrkGdbAdapter;
 
 private: ////////// General Interface //////////
@@ -132,6 +133,7 @@ private: ////////// Gdb Process Management //////////
     bool startGdb(const QStringList &args = QStringList(),
                   const QString &gdb = QString(),
                   const QString &settingsIdHint = QString());
+    void initializeGdb();
     void startInferiorPhase2();
 
     void handleInferiorShutdown(const GdbResponse &response);
@@ -146,6 +148,7 @@ private slots:
     void handleGdbFinished(int, QProcess::ExitStatus status);
     void handleGdbError(QProcess::ProcessError error);
     void readGdbStandardOutput();
+    void handleGdbStandardOutput(const QByteArray &output);
     void readGdbStandardError();
     void readDebugeeOutput(const QByteArray &data);
 
@@ -443,6 +446,7 @@ private: ////////// View & Data Stuff //////////
     //void handleToolTip(const GdbResponse &response);
     void handleQueryDebuggingHelper(const GdbResponse &response);
     void handleDebuggingHelperValue2(const GdbResponse &response);
+    void handleDebuggingHelperProbe(const GdbResponse &response);
     void handleDebuggingHelperValue3(const GdbResponse &response);
     void handleDebuggingHelperEditValue(const GdbResponse &response);
     void handleDebuggingHelperSetup(const GdbResponse &response);
@@ -460,6 +464,20 @@ private: ////////// View & Data Stuff //////////
     QSet<QString> m_processedNames;
     QMap<QString, QString> m_varToType;
 
+    // Children of expanded containers of simple values as of the last
+    // dump. They are reused as long as the container keeps its size, its
+    // data pointer and the checksum of the shown children.
+    struct CachedChildren
+    {
+        QByteArray dataPointer;
+        int childCount;
+        uint checksum;
+        QList<WatchData> children;
+    };
+    void cacheChildren(const WatchData &data, const GdbMi &contents,
+        const QList<WatchData> &list);
+    QHash<QString, CachedChildren> m_cachedChildren;
+
 private: ////////// Dumper Management //////////
     QString qtDumperLibraryName() const;
     bool checkDebuggingHelpers();
@@ -0,0 +1,196 @@
+/**************************************************************************
+**
+** This file is part of Qt Creator
+**
+** Copyright (c) 2009 Nokia Corporation and/or its subsidiary(-ies).
+**
+** Contact: Nokia Corporation (qt-info@nokia.com)
+**
+** Commercial Usage
+**
+** Licensees holding valid Qt Commercial licenses may use this file in
+** accordance with the Qt Commercial License Agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Nokia.
+**
+** GNU Lesser General Public License Usage
+**
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** If you are unsure which license is appropriate for your use, please
+** contact the sales department at http://qt.nokia.com/contact.
+**
+**************************************************************************/
+
+
+#include "gdbtranscript.h"
+
+#include <QtCore/QHash>
+
+#include <ctype.h>
+
+namespace Debugger {
+namespace Internal {
+
+///////////////////////////////////////////////////////////////////////
+//
+// GdbTranscript
+//
+///////////////////////////////////////////////////////////////////////
+
+GdbTranscript::GdbTranscript()
+    : m_next(0)
+{
+}
+
+QByteArray GdbTranscript::stripToken(const QByteArray &line, QByteArray *token)
+{
+    int pos = 0;
+    while (pos < line.size() && isdigit(line.at(pos)))
+        ++pos;
+    if (token)
+        *token = line.left(pos);
+    return line.mid(pos);
+}
+
+// Commands flagged with EmbedToken refer to their own token as "<token>+1",
+// which differs between the recording and the replay.
+QByteArray GdbTranscript::normalized(const QByteArray &command, const QByteArray &token)
+{
+    QByteArray result = command;
+    const QByteArray needle = token + '+';
+    int pos = 0;
+    while ((pos = result.indexOf(needle, pos)) != -1) {
+        if (pos > 0 && isdigit(result.at(pos - 1))) {
+            pos += needle.size();
+            continue;
+        }
+        result.replace(pos, token.size(), "%T");
+        pos += 3;
+    }
+    return result;
+}
+
+bool GdbTranscript::load(const QByteArray &log)
+{
+    m_exchanges.clear();
+    m_initialOutput.clear();
+    m_next = 0;
+
+    QHash<QByteArray, int> pending; // Token -> exchange awaiting its result.
+    QList<QByteArray> streams; // Stream output not yet claimed by a result.
+    int last = -1; // Exchange receiving asynchronous output.
+
+    foreach (QByteArray line, log.split('\n')) {
+        if (line.endsWith('\r'))
+            line.chop(1);
+        if (line.size() < 2)
+            continue;
+        const char channel = line.at(0);
+        QByteArray token;
+        const QByteArray record = stripToken(line.mid(1), &token);
+        if (record.isEmpty())
+            continue;
+
+        if (channel == '<') {
+            if (token.isEmpty())
+                continue;
+            if (m_exchanges.isEmpty()) {
+                m_initialOutput += streams;
+                streams.clear();
+            }
+            Exchange exchange;
+            exchange.command = normalized(record, token);
+            pending.insert(token, m_exchanges.size());
+            m_exchanges.append(exchange);
+        } else if (channel == '>') {
+            switch (record.at(0)) {
+            case '~':
+            case '@':
+            case '&':
+                streams.append(record);
+                break;
+            case '^': {
+                const int index = pending.value(token, -1);
+                if (index == -1)
+                    break; // Result of a command sent before recording started.
+                pending.remove(token);
+                QList<QByteArray> &output = m_exchanges[index].output;
+                output += streams;
+                output.append(record);
+                streams.clear();
+                last = index;
+                break;
+            }
+            default: {
+                if (record.startsWith("(gdb)"))
+                    break;
+                QList<QByteArray> &output =
+                    last == -1 ? m_initialOutput : m_exchanges[last].output;
+                output += streams;
+                output.append(record);
+                streams.clear();
+                break;
+            }
+            }
+        }
+    }
+    if (last == -1)
+        m_initialOutput += streams;
+    else
+        m_exchanges[last].output += streams;
+    return !m_exchanges.isEmpty();
+}
+
+int GdbTranscript::findExchange(const QByteArray &command) const
+{
+    // Commands are usually replayed in recorded order, so start looking
+    // where the last match left off and wrap around for the rest.
+    const int n = m_exchanges.size();
+    for (int i = 0; i != n; ++i) {
+        const int index = (m_next + i) % n;
+        const Exchange &exchange = m_exchanges.at(index);
+        if (!exchange.replayed && exchange.command == command)
+            return index;
+    }
+    return -1;
+}
+
+QList<QByteArray> GdbTranscript::reply(const QByteArray &command)
+{
+    QByteArray token;
+    const QByteArray plain = stripToken(command.trimmed(), &token);
+
+    QList<QByteArray> result;
+    const int index = findExchange(normalized(plain, token));
+    if (index == -1) {
+        result.append(token + "^done");
+        return result;
+    }
+
+    Exchange &exchange = m_exchanges[index];
+    exchange.replayed = true;
+    if (index == m_next) {
+        while (m_next < m_exchanges.size() && m_exchanges.at(m_next).replayed)
+            ++m_next;
+    }
+
+    foreach (const QByteArray &line, exchange.output)
+        result.append(line.startsWith('^') ? token + line : line);
+    return result;
+}
+
+void GdbTranscript::rewind()
+{
+    for (int i = 0; i != m_exchanges.size(); ++i)
+        m_exchanges[i].replayed = false;
+    m_next = 0;
+}
+
+} // namespace Internal
+} // namespace Debugger
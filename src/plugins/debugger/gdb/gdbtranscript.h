@@ -0,0 +1,89 @@
+/**************************************************************************
+**
+** This file is part of Qt Creator
+**
+** Copyright (c) 2009 Nokia Corporation and/or its subsidiary(-ies).
+**
+** Contact: Nokia Corporation (qt-info@nokia.com)
+**
+** Commercial Usage
+**
+** Licensees holding valid Qt Commercial licenses may use this file in
+** accordance with the Qt Commercial License Agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Nokia.
+**
+** GNU Lesser General Public License Usage
+**
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** If you are unsure which license is appropriate for your use, please
+** contact the sales department at http://qt.nokia.com/contact.
+**
+**************************************************************************/
+
+
+#ifndef DEBUGGER_GDBTRANSCRIPT_H
+#define DEBUGGER_GDBTRANSCRIPT_H
+
+#include <QtCore/QByteArray>
+#include <QtCore/QList>
+
+namespace Debugger {
+namespace Internal {
+
+// GdbTranscript holds a conversation with gdb as saved from the combined
+// view of the debugger log: lines starting with '<' are commands sent to
+// gdb, lines starting with '>' are gdb's output, everything else is
+// ignored. Each command is associated with the stream output preceding
+// its result record, the result record itself, and the asynchronous
+// records following it. Tokens are stripped on load and replaced by the
+// tokens of the live session on replay.
+class GdbTranscript
+{
+public:
+    GdbTranscript();
+
+    bool load(const QByteArray &log);
+    bool isEmpty() const { return m_exchanges.isEmpty(); }
+    int size() const { return m_exchanges.size(); }
+
+    // Output gdb produced before the first command was sent.
+    QList<QByteArray> initialOutput() const { return m_initialOutput; }
+
+    // Returns the recorded output for the token-prefixed command as it
+    // was written to gdb, with result records carrying the live token.
+    // Commands without recording are answered with a plain "^done".
+    QList<QByteArray> reply(const QByteArray &command);
+
+    // Makes all recorded exchanges available for replay again.
+    void rewind();
+
+    static QByteArray stripToken(const QByteArray &line, QByteArray *token = 0);
+
+private:
+    struct Exchange
+    {
+        Exchange() : replayed(false) {}
+        QByteArray command;
+        QList<QByteArray> output;
+        bool replayed;
+    };
+
+    static QByteArray normalized(const QByteArray &command, const QByteArray &token);
+    int findExchange(const QByteArray &command) const;
+
+    QList<Exchange> m_exchanges;
+    QList<QByteArray> m_initialOutput;
+    int m_next;
+};
+
+} // namespace Internal
+} // namespace Debugger
+
+#endif // DEBUGGER_GDBTRANSCRIPT_H
@@ -0,0 +1,184 @@
+/**************************************************************************
+**
+** This file is part of Qt Creator
+**
+** Copyright (c) 2009 Nokia Corporation and/or its subsidiary(-ies).
+**
+** Contact: Nokia Corporation (qt-info@nokia.com)
+**
+** Commercial Usage
+**
+** Licensees holding valid Qt Commercial licenses may use this file in
+** accordance with the Qt Commercial License Agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Nokia.
+**
+** GNU Lesser General Public License Usage
+**
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** If you are unsure which license is appropriate for your use, please
+** contact the sales department at http://qt.nokia.com/contact.
+**
+**************************************************************************/
+
+
+#include "replaygdbadapter.h"
+
+#include "gdbengine.h"
+#include "debuggerstringutils.h"
+
+#include <utils/qtcassert.h>
+
+#include <QtCore/QFile>
+#include <QtCore/QTimer>
+
+namespace Debugger {
+namespace Internal {
+
+#define CB(callback) \
+    static_cast<GdbEngine::AdapterCallback>(&ReplayGdbAdapter::callback), \
+    STRINGIFY(callback)
+
+///////////////////////////////////////////////////////////////////////
+//
+// ReplayGdbAdapter
+//
+///////////////////////////////////////////////////////////////////////
+
+ReplayGdbAdapter::ReplayGdbAdapter(GdbEngine *engine, const QString &fileName,
+        QObject *parent)
+    : AbstractGdbAdapter(engine, parent),
+      m_fileName(fileName),
+      m_exiting(false),
+      m_bytesParsed(0),
+      m_msecsParsing(0)
+{
+}
+
+AbstractGdbAdapter::DumperHandling ReplayGdbAdapter::dumperHandling() const
+{
+    // Whatever the recorded session did is in the transcript.
+    return DumperLoadedByGdb;
+}
+
+void ReplayGdbAdapter::write(const QByteArray &data)
+{
+    QByteArray token;
+    const QByteArray command = GdbTranscript::stripToken(data.trimmed(), &token);
+    if (command == "-gdb-exit") {
+        // There is no process whose exit could be waited for.
+        m_exiting = true;
+        queueOutput(QList<QByteArray>() << token + "^exit");
+        return;
+    }
+    queueOutput(m_transcript.reply(data));
+}
+
+void ReplayGdbAdapter::queueOutput(const QList<QByteArray> &lines)
+{
+    if (m_output.isEmpty())
+        QTimer::singleShot(0, this, SLOT(deliverOutput()));
+    foreach (const QByteArray &line, lines) {
+        m_output += line;
+        m_output += '\n';
+    }
+}
+
+void ReplayGdbAdapter::deliverOutput()
+{
+    if (m_output.isEmpty())
+        return;
+    const QByteArray output = m_output;
+    m_output.clear();
+
+    if (!m_stopTime.isValid() && output.contains("*stopped"))
+        m_stopTime.start();
+
+    QTime timer;
+    timer.start();
+    m_engine->handleGdbStandardOutput(output);
+    m_msecsParsing += timer.elapsed();
+    m_bytesParsed += output.size();
+
+    // The views are up to date once all commands triggered by
+    // the stop have been answered.
+    if (m_stopTime.isValid() && m_engine->m_cookieForToken.isEmpty()) {
+        debugMessage(_("REPLAY: STOP HANDLED IN %1 MS").arg(m_stopTime.elapsed()));
+        m_stopTime = QTime();
+    }
+
+    if (m_exiting) {
+        m_exiting = false;
+        m_engine->handleGdbFinished(0, QProcess::NormalExit);
+    }
+}
+
+void ReplayGdbAdapter::startAdapter()
+{
+    QTC_ASSERT(state() == EngineStarting, qDebug() << state());
+    setState(AdapterStarting);
+    debugMessage(_("TRYING TO START ADAPTER"));
+
+    QFile file(m_fileName);
+    if (!file.open(QIODevice::ReadOnly) || !m_transcript.load(file.readAll())) {
+        emit adapterStartFailed(tr("Cannot read gdb transcript '%1'.")
+            .arg(m_fileName), QString());
+        return;
+    }
+    debugMessage(_("REPLAYING %1 COMMANDS FROM %2")
+        .arg(m_transcript.size()).arg(m_fileName));
+
+    queueOutput(m_transcript.initialOutput());
+    m_engine->initializeGdb();
+
+    emit adapterStarted();
+}
+
+void ReplayGdbAdapter::startInferior()
+{
+    QTC_ASSERT(state() == InferiorStarting, qDebug() << state());
+    emit inferiorPrepared();
+}
+
+void ReplayGdbAdapter::startInferiorPhase2()
+{
+    setState(InferiorRunningRequested);
+    m_engine->postCommand(_("-exec-run"), GdbEngine::RunRequest, CB(handleExecRun));
+}
+
+void ReplayGdbAdapter::handleExecRun(const GdbResponse &response)
+{
+    if (response.resultClass == GdbResultRunning) {
+        QTC_ASSERT(state() == InferiorRunning, qDebug() << state());
+        debugMessage(_("INFERIOR STARTED"));
+        showStatusMessage(msgInferiorStarted());
+    } else {
+        QTC_ASSERT(state() == InferiorRunningRequested, qDebug() << state());
+        const QString &msg = QString::fromLocal8Bit(response.data.findChild("msg").data());
+        emit inferiorStartFailed(msg);
+    }
+}
+
+void ReplayGdbAdapter::interruptInferior()
+{
+    queueOutput(QList<QByteArray>() << QByteArray("*stopped,reason=\"signal-received\","
+        "signal-name=\"SIGINT\",signal-meaning=\"Interrupt\",thread-id=\"1\""));
+}
+
+void ReplayGdbAdapter::shutdown()
+{
+    debugMessage(_("REPLAY ADAPTER SHUTDOWN %1").arg(state()));
+    if (m_msecsParsing > 0)
+        debugMessage(_("REPLAY: %1 BYTES HANDLED IN %2 MS (%3 KB/S)")
+            .arg(m_bytesParsed).arg(m_msecsParsing)
+            .arg(m_bytesParsed / m_msecsParsing * 1000 / 1024));
+}
+
+} // namespace Internal
+} // namespace Debugger
@@ -0,0 +1,90 @@
+/**************************************************************************
+**
+** This file is part of Qt Creator
+**
+** Copyright (c) 2009 Nokia Corporation and/or its subsidiary(-ies).
+**
+** Contact: Nokia Corporation (qt-info@nokia.com)
+**
+** Commercial Usage
+**
+** Licensees holding valid Qt Commercial licenses may use this file in
+** accordance with the Qt Commercial License Agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Nokia.
+**
+** GNU Lesser General Public License Usage
+**
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** If you are unsure which license is appropriate for your use, please
+** contact the sales department at http://qt.nokia.com/contact.
+**
+**************************************************************************/
+
+
+#ifndef DEBUGGER_REPLAYGDBADAPTER_H
+#define DEBUGGER_REPLAYGDBADAPTER_H
+
+#include "abstractgdbadapter.h"
+#include "gdbtranscript.h"
+
+#include <QtCore/QTime>
+
+namespace Debugger {
+namespace Internal {
+
+///////////////////////////////////////////////////////////////////////
+//
+// ReplayGdbAdapter
+//
+///////////////////////////////////////////////////////////////////////
+
+// ReplayGdbAdapter answers the engine's commands from a recorded
+// transcript instead of a gdb process. It is selected by setting
+// DebuggerStartParameters::replayTranscript to a saved debugger log and
+// lets the engine and the views be exercised and timed without gdb.
+class ReplayGdbAdapter : public AbstractGdbAdapter
+{
+    Q_OBJECT
+
+public:
+    ReplayGdbAdapter(GdbEngine *engine, const QString &fileName, QObject *parent = 0);
+
+    virtual DumperHandling dumperHandling() const;
+
+    void write(const QByteArray &data);
+
+    void startAdapter();
+    void startInferior();
+    void startInferiorPhase2();
+    void interruptInferior();
+    void shutdown();
+
+private slots:
+    void deliverOutput();
+
+private:
+    void queueOutput(const QList<QByteArray> &lines);
+    void handleExecRun(const GdbResponse &response);
+
+    QString m_fileName;
+    GdbTranscript m_transcript;
+    QByteArray m_output;
+    bool m_exiting;
+
+    // Statistics
+    QTime m_stopTime; // Valid while a stop is being processed.
+    qint64 m_bytesParsed;
+    int m_msecsParsing;
+};
+
+} // namespace Internal
+} // namespace Debugger
+
+#endif // DEBUGGER_REPLAYGDBADAPTER_H
@@ -32,6 +32,7 @@
 #include "moduleshandler.h" // for model roles
 #include "debuggeractions.h"
 #include "debuggermanager.h"
+#include "name_demangler.h"
 
 #include <QtCore/QDebug>
 #include <QtCore/QProcess>
@@ -205,11 +206,18 @@ void ModulesWindow::showSymbols(const QString &name)
     w->setAlternatingRowColors(true);
     w->setHeaderLabels(QStringList() << tr("Address") << tr("Code") << tr("Symbol"));
     w->setWindowTitle(tr("Symbols in \"%1\"").arg(name));
-    foreach (const Symbol &s, symbols) {
+    QStringList mangledNames;
+    foreach (const Symbol &s, symbols)
+        mangledNames.append(s.name);
+    const QStringList demangledNames = NameDemangler::demangleAll(mangledNames);
+    for (int i = 0; i != symbols.size(); ++i) {
+        const Symbol &s = symbols.at(i);
         QTreeWidgetItem *it = new QTreeWidgetItem;
         it->setData(0, Qt::DisplayRole, s.address);
         it->setData(1, Qt::DisplayRole, s.state);
-        it->setData(2, Qt::DisplayRole, s.name);
+        it->setData(2, Qt::DisplayRole, demangledNames.at(i));
+        if (demangledNames.at(i) != s.name)
+            it->setData(2, Qt::ToolTipRole, s.name);
         w->addTopLevelItem(it);
     }
     emit newDockRequested(w);
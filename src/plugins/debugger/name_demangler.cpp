@@ -27,14 +27,20 @@
 **
 **************************************************************************/
 
+#include <QtCore/QCache>
 #include <QtCore/QChar>
 #include <QtCore/QCoreApplication>
+#include <QtCore/QHash>
 #include <QtCore/QLatin1String>
 #include <QtCore/QMap>
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
 #include <QtCore/QRegExp>
 #include <QtCore/QSet>
 #include <QtCore/QString>
 #include <QtCore/QStringList>
+#include <QtCore/QThread>
+#include <QtCore/QtConcurrentMap>
 
 #include "name_demangler.h"
 
@@ -53,6 +59,49 @@
 namespace Debugger {
 namespace Internal {    
 
+namespace {
+
+struct DemangleResult
+{
+    QString demangledName;
+    QString errorString;
+    bool ok;
+};
+
+// Shared by all demanglers, so a name demangled by one of them, e.g. in
+// a chunk of demangleAll(), is cheap for all others.
+class DemangleCache
+{
+public:
+    DemangleCache() : m_cache(CacheSize) {}
+
+    bool lookup(const QString &mangledName, DemangleResult *result)
+    {
+        QMutexLocker locker(&m_mutex);
+        const DemangleResult *cached = m_cache.object(mangledName);
+        if (!cached)
+            return false;
+        *result = *cached;
+        return true;
+    }
+
+    void insert(const QString &mangledName, const DemangleResult &result)
+    {
+        QMutexLocker locker(&m_mutex);
+        m_cache.insert(mangledName, new DemangleResult(result));
+    }
+
+private:
+    enum { CacheSize = 4096 }; // In entries.
+
+    QMutex m_mutex;
+    QCache<QString, DemangleResult> m_cache;
+};
+
+} // anonymous namespace
+
+Q_GLOBAL_STATIC(DemangleCache, demangleCache)
+
 class NameDemanglerPrivate
 {
     Q_DECLARE_TR_FUNCTIONS(NameDemanglerPrivate)
@@ -63,8 +112,12 @@ public:
     bool demangle(const QString &mangledName);
     const QString &errorString() const { return m_errorString; }
     const QString &demangledName() const { return m_demangledName; }
+    int cacheHits() const { return m_cacheHits; }
+    int cacheMisses() const { return m_cacheMisses; }
 
 private:
+    bool parse(const QString &mangledName);
+
     class Operator
     {
     public:
@@ -254,13 +307,20 @@ private:
     void error(const QString &errorSpec);
 
     static const QChar eoi;
+    static const UnaryOperator vendorOp;
+    static const UnaryOperator pseudoOp;
     bool parseError;
     int pos;
     QString mangledName;
     QString m_errorString;
     QString m_demangledName;
     QStringList substitutions;
+    QSet<QString> substitutionSet; // For fast duplicate checks.
     QStringList templateParams;
+    UnaryOperator castOp; // Its representation depends on the input.
+
+    int m_cacheHits;
+    int m_cacheMisses;
 
     QMap<QString, Operator *> ops;
 
@@ -302,8 +362,16 @@ private:
 
 
 const QChar NameDemanglerPrivate::eoi('$');
+// TODO: Implement vendor-extended operators.
+const NameDemanglerPrivate::UnaryOperator
+    NameDemanglerPrivate::vendorOp(QLatin1String("v"), QLatin1String("[unimplemented]"));
+const NameDemanglerPrivate::UnaryOperator
+    NameDemanglerPrivate::pseudoOp(QLatin1String("invalid"), QLatin1String("invalid"));
 
 NameDemanglerPrivate::NameDemanglerPrivate()
+    : castOp(QLatin1String("cv"), QLatin1String("")),
+      m_cacheHits(0),
+      m_cacheMisses(0)
 {
     setupFirstSets();
     setupOps();
@@ -315,12 +383,33 @@ NameDemanglerPrivate::~NameDemanglerPrivate()
 }
 
 bool NameDemanglerPrivate::demangle(const QString &mangledName)
+{
+    // The same symbols tend to come up again and again.
+    DemangleResult result;
+    if (demangleCache()->lookup(mangledName, &result)) {
+        ++m_cacheHits;
+        m_demangledName = result.demangledName;
+        m_errorString = result.errorString;
+        return result.ok;
+    }
+    ++m_cacheMisses;
+
+    result.ok = parse(mangledName);
+    result.demangledName = m_demangledName;
+    result.errorString = m_errorString;
+    demangleCache()->insert(mangledName, result);
+    return result.ok;
+}
+
+bool NameDemanglerPrivate::parse(const QString &mangledName)
 {
     this->mangledName = mangledName;
     pos = 0;
     parseError = false;
     m_demangledName.clear();
+    m_errorString.clear();
     substitutions.clear();
+    substitutionSet.clear();
     templateParams.clear();
     m_demangledName = parseMangledName();
     m_demangledName.replace(
@@ -1491,9 +1580,6 @@ const NameDemanglerPrivate::Operator &NameDemanglerPrivate::parseOperatorName()
 
     const Operator *op;
     if (peek() == 'v') {
-        // TODO: Implement vendor-extended operators.
-        static const UnaryOperator vendorOp(QLatin1String("v"),
-                                            QLatin1String("[unimplemented]"));
         advance();
         int numExprs = parseDigit();
         Q_UNUSED(numExprs);
@@ -1504,16 +1590,12 @@ const NameDemanglerPrivate::Operator &NameDemanglerPrivate::parseOperatorName()
         const QString id = readAhead(2);
         advance(2);
         if (id == QLatin1String("cv")) {
-            static UnaryOperator castOp(QLatin1String("cv"),
-                                        QLatin1String(""));
             QString type = parseType();
             castOp.repr = QString::fromLocal8Bit("(%1)").arg(type);
             op = &castOp;
         } else {
             op = ops.value(id);
             if (op == 0) {
-                static const UnaryOperator pseudoOp(QLatin1String("invalid"),
-                                                    QLatin1String("invalid"));
                 op = &pseudoOp;
                 error(tr("Invalid operator-name '%s'").arg(id));
             }
@@ -2156,8 +2238,10 @@ void NameDemanglerPrivate::setupOps(){
 
 void NameDemanglerPrivate::addSubstitution(const QString &symbol)
 {
-    if (!symbol.isEmpty() && !substitutions.contains(symbol))
+    if (!symbol.isEmpty() && !substitutionSet.contains(symbol)) {
         substitutions.append(symbol);
+        substitutionSet.insert(symbol);
+    }
 }
 
 void NameDemanglerPrivate::insertQualifier(QString &type,
@@ -2214,6 +2298,62 @@ const QString &NameDemangler::demangledName() const
     return pImpl->demangledName();
 }
 
+int NameDemangler::cacheHits() const
+{
+    return pImpl->cacheHits();
+}
+
+int NameDemangler::cacheMisses() const
+{
+    return pImpl->cacheMisses();
+}
+
+static QStringList demangleChunk(const QStringList &mangledNames)
+{
+    // One demangler per chunk, so the tables set up
+    // in its constructor are used for many names.
+    NameDemangler demangler;
+    QStringList result;
+    foreach (const QString &name, mangledNames)
+        result.append(demangler.demangle(name) ? demangler.demangledName() : name);
+    return result;
+}
+
+QStringList NameDemangler::demangleAll(const QStringList &mangledNames)
+{
+    enum { MinChunkSize = 256 };
+
+    // Each distinct name is demangled only once.
+    QStringList uniqueNames;
+    QHash<QString, int> uniqueIndex;
+    foreach (const QString &name, mangledNames) {
+        if (!uniqueIndex.contains(name)) {
+            uniqueIndex.insert(name, uniqueNames.size());
+            uniqueNames.append(name);
+        }
+    }
+
+    const int threadCount = qMax(1, QThread::idealThreadCount());
+    const int chunkSize =
+        qMax(int(MinChunkSize), (uniqueNames.size() + threadCount - 1) / threadCount);
+    QList<QStringList> chunks;
+    for (int i = 0; i < uniqueNames.size(); i += chunkSize)
+        chunks.append(uniqueNames.mid(i, chunkSize));
+
+    QStringList demangledNames;
+    if (chunks.size() == 1) {
+        demangledNames = demangleChunk(chunks.first());
+    } else if (chunks.size() > 1) {
+        foreach (const QStringList &part, QtConcurrent::blockingMapped(chunks, demangleChunk))
+            demangledNames += part;
+    }
+
+    QStringList result;
+    foreach (const QString &name, mangledNames)
+        result.append(demangledNames.at(uniqueIndex.value(name)));
+    return result;
+}
+
 } // namespace Internal
 } // namespace Debugger
 
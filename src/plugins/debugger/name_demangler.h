@@ -32,6 +32,7 @@
 
 QT_BEGIN_NAMESPACE
 class QString;
+class QStringList;
 QT_END_NAMESPACE
 
 namespace Debugger {
@@ -66,6 +67,21 @@ public:
      */
     const QString &demangledName() const;
 
+    /*
+     * Results are memoized in a cache shared by all demanglers, so
+     * demangling a name seen before is cheap. These count this demangler's
+     * lookups that were answered from the cache and those that needed a
+     * full parse.
+     */
+    int cacheHits() const;
+    int cacheMisses() const;
+
+    /*
+     * Demangles all names, spreading the work over the available cores.
+     * Names that cannot be demangled are returned unchanged.
+     */
+    static QStringList demangleAll(const QStringList &mangledNames);
+
 private:
     NameDemanglerPrivate *pImpl;
 };
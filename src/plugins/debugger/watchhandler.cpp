@@ -104,6 +104,8 @@ public:
    
 WatchData::WatchData() :
     hasChildren(false),
+    childCount(-1),
+    childrenStart(0),
     generation(-1),
     valueEnabled(true),
     valueEditable(true),
@@ -620,14 +622,33 @@ static QString formattedValue(const WatchData &data,
 
 bool WatchModel::canFetchMore(const QModelIndex &index) const
 {
-    return index.isValid() && !watchItem(index)->fetchTriggered;
+    if (!index.isValid())
+        return false;
+    const WatchItem *item = watchItem(index);
+    if (!item->fetchTriggered)
+        return true;
+    // The next page of a large container, once the current one arrived.
+    const int count = item->children.size();
+    return count < item->childCount
+        && count >= m_handler->childrenLimit(item->iname);
 }
 
 void WatchModel::fetchMore(const QModelIndex &index)
 {
     QTC_ASSERT(index.isValid(), return);
-    QTC_ASSERT(!watchItem(index)->fetchTriggered, return);
-    if (WatchItem *item = watchItem(index)) {
+    WatchItem *item = watchItem(index);
+    if (item && item->fetchTriggered) {
+        const int count = item->children.size();
+        QTC_ASSERT(count < item->childCount, return);
+        m_handler->m_childrenLimits[item->iname]
+            = count + WatchHandler::ChildrenPageSize;
+        WatchData data = *item;
+        data.childrenStart = count;
+        data.setChildrenNeeded();
+        m_handler->m_manager->updateWatchData(data);
+        return;
+    }
+    if (item) {
         m_handler->m_expandedINames.insert(item->iname);
         item->fetchTriggered = true;
         if (item->children.isEmpty()) {
@@ -822,6 +843,7 @@ bool WatchModel::setData(const QModelIndex &index, const QVariant &value, int ro
             m_handler->m_expandedINames.insert(data.iname);
         } else {
             m_handler->m_expandedINames.remove(data.iname);
+            m_handler->m_childrenLimits.remove(data.iname);
         }
     } else if (role == TypeFormatRole) {
         m_handler->setFormat(data.type, value.toInt());
@@ -1135,6 +1157,7 @@ void WatchHandler::cleanup()
 {
     m_expandedINames.clear();
     m_displayedINames.clear();
+    m_childrenLimits.clear();
     m_locals->reinitialize();
     m_tooltips->reinitialize();
 #if 0
@@ -135,6 +135,8 @@ public:
     QString framekey;     // key for type cache
     QScriptValue scriptValue; // if needed...
     bool hasChildren;
+    int childCount;       // size of a paged container, -1 if unknown
+    int childrenStart;    // first child to fetch of a paged container
     int generation;       // when updated?
     bool valueEnabled;    // value will be greyed out or not
     bool valueEditable;   // value will be editable
@@ -265,6 +267,11 @@ public:
     QSet<QString> expandedINames() const
         { return m_expandedINames; }
 
+    // Children of large containers are fetched in pages of this size.
+    enum { ChildrenPageSize = 100 };
+    int childrenLimit(const QString &iname) const
+        { return m_childrenLimits.value(iname, ChildrenPageSize); }
+
     static QString watcherEditPlaceHolder();
 
 private:
@@ -291,6 +298,7 @@ private:
     void setDisplayedIName(const QString &iname, bool on);
     QSet<QString> m_expandedINames;  // those expanded in the treeview
     QSet<QString> m_displayedINames; // those with "external" viewers
+    QHash<QString, int> m_childrenLimits; // children shown of paged containers
 
     WatchModel *m_locals;
     WatchModel *m_watchers;
@@ -9,7 +9,7 @@
 using namespace DIRECTORYEditor;
 
 DirectoryEditor::DirectoryEditor(QWidget* parent, const char* name, Qt::WindowFlags fl)
-    : QMainWindow(parent, fl)
+    : QMainWindow(parent, fl), item(0), m_ieditor(0), m_catalogues(0)
 {
     setupUi(this);
     //(void)statusBar();
@@ -21,6 +21,8 @@ DirectoryEditor::DirectoryEditor(QWidget* parent, const char* name, Qt::WindowFl
  */
 DirectoryEditor::~DirectoryEditor()
 {
+    if (m_ieditor)
+        disconnect(m_ieditor, 0, this, 0);
     destroy();
     // no need to delete child widgets, Qt does it all for us
 }
@@ -34,8 +36,33 @@ void DirectoryEditor::languageChange()
     retranslateUi(this);
 }
 
+/*
+ * The editor manager deletes the interface when the editor is closed,
+ * that is when the changes are written to the configuration.
+ */
+void DirectoryEditor::setEditorInterface(Core::IEditor *ieditor)
+{
+    if (m_ieditor)
+        disconnect(m_ieditor, 0, this, 0);
+    m_ieditor = ieditor;
+    if (m_ieditor)
+        connect(m_ieditor, SIGNAL(destroyed()), this, SLOT(editorClosed()));
+}
+
+void DirectoryEditor::editorClosed()
+{
+    m_ieditor = 0;
+    updateMD();
+}
+
 void DirectoryEditor::setData( DomCfgItem *o )
 {
+     foreach (QObject *container, m_tables.keys())
+         disconnect(container, 0, this, 0);
+     m_tables.clear();
+     if (m_catalogues)
+         disconnect(m_catalogues, 0, this, 0);
+
      item = o;
      setWindowTitle( tr("Catalogue:") + item->attr( mda_name ) );
      eName->setText( item->attr( mda_name ) );
@@ -78,6 +105,90 @@ void DirectoryEditor::setData( DomCfgItem *o )
         GetGroupAttributesList();
         GetFormsList();
         CatList();
+
+        // The lists follow the configuration row by row from now on
+        watch(item->find(md_element), elementAttributesList);
+        watch(item->find(md_group), groupAttributesList);
+        watch(item->find(md_forms), formsList);
+        m_catalogues = item->root()->find(md_catalogues);
+        watch(m_catalogues, 0);
+}
+
+void DirectoryEditor::watch(DomCfgItem *container, QTableWidget *table)
+{
+    if (!container)
+        return;
+    if (table)
+        m_tables.insert(container, table);
+    connect(container, SIGNAL(childInserted(int)), this, SLOT(containerChildInserted(int)));
+    connect(container, SIGNAL(childRemoved(int)), this, SLOT(containerChildRemoved(int)));
+    connect(container, SIGNAL(childChanged(int)), this, SLOT(containerChildChanged(int)));
+    connect(container, SIGNAL(childrenSwapped(int,int)), this, SLOT(containerChildrenSwapped(int,int)));
+}
+
+void DirectoryEditor::containerChildInserted(int row)
+{
+    DomCfgItem *container = static_cast<DomCfgItem *>(sender());
+    DomCfgItem *child = container->child(row);
+    if (!child)
+        return;
+    if (container == m_catalogues) {
+        eParentCat->insertItem(row + 1, child->cfgName(), QVariant());
+        return;
+    }
+    QTableWidget *table = m_tables.value(container);
+    if (!table || (child->nodeName() != md_field && child->nodeName() != md_form))
+        return;
+    row = qMin(row, table->rowCount());
+    table->insertRow(row);
+    table->setItem(row, 0, new QTableWidgetItem(child->attr(mda_name)));
+    table->setRowHeight(row, 20);
+}
+
+void DirectoryEditor::containerChildRemoved(int row)
+{
+    if (sender() == m_catalogues) {
+        eParentCat->removeItem(row + 1);
+        return;
+    }
+    QTableWidget *table = m_tables.value(sender());
+    if (table && row < table->rowCount())
+        table->removeRow(row);
+}
+
+void DirectoryEditor::containerChildChanged(int row)
+{
+    DomCfgItem *container = static_cast<DomCfgItem *>(sender());
+    DomCfgItem *child = container->child(row);
+    if (!child)
+        return;
+    if (container == m_catalogues) {
+        eParentCat->setItemText(row + 1, child->cfgName());
+        return;
+    }
+    QTableWidget *table = m_tables.value(container);
+    if (!table || row >= table->rowCount())
+        return;
+    if (QTableWidgetItem *tableItem = table->item(row, 0))
+        tableItem->setText(child->attr(mda_name));
+    else
+        table->setItem(row, 0, new QTableWidgetItem(child->attr(mda_name)));
+}
+
+void DirectoryEditor::containerChildrenSwapped(int row, int otherRow)
+{
+    if (sender() == m_catalogues) {
+        const QString text = eParentCat->itemText(row + 1);
+        eParentCat->setItemText(row + 1, eParentCat->itemText(otherRow + 1));
+        eParentCat->setItemText(otherRow + 1, text);
+        return;
+    }
+    QTableWidget *table = m_tables.value(sender());
+    if (!table || row >= table->rowCount() || otherRow >= table->rowCount())
+        return;
+    QTableWidgetItem *tableItem = table->takeItem(row, 0);
+    table->setItem(row, 0, table->takeItem(otherRow, 0));
+    table->setItem(otherRow, 0, tableItem);
 }
 
 void DirectoryEditor::doubleClickedElement ( int row, int ) {
@@ -90,7 +201,6 @@ void DirectoryEditor::doubleClickedElement ( int row, int ) {
         manager->activateEditor(editor);
         QMetaObject::invokeMethod(editor->widget(), "setData",
         Q_ARG(DomCfgItem*, fields->child(row)));
-        connect(manager,SIGNAL(editorsClosed(QList<Core::IEditor*>)),editor->widget(),SLOT(updateMD(QList<Core::IEditor*>)));
     }
 }
 
@@ -105,7 +215,6 @@ void DirectoryEditor::doubleClickedGroup ( int row, int ) {
         manager->activateEditor(editor);
         QMetaObject::invokeMethod(editor->widget(), "setData",
         Q_ARG(DomCfgItem*, fields->child(row)));
-        connect(manager,SIGNAL(editorsClosed(QList<Core::IEditor*>)),editor->widget(),SLOT(updateMD(QList<Core::IEditor*>)));
     }
 }
 
@@ -133,17 +242,9 @@ void DirectoryEditor::init()
 }
 
 
-void DirectoryEditor::updateMD(QList<Core::IEditor*> editor)
+void DirectoryEditor::updateMD()
 {
-  bool findWidget = false;
-  foreach (Core::IEditor* ed, editor)
-  {
-      if (ed->widget()==this) {
-          findWidget=true;
-          break;
-      }
-  }
-  if (findWidget==false)
+  if (!item)
       return;
 
 //     	aCfg *md = item->md;
@@ -472,8 +573,6 @@ void DirectoryEditor::createNewElementAttribute_clicked()
         Q_ARG(DomCfgItem*, field));
     }
 
-    GetElementAttributesList();
-
 //        aListViewItem *newitem, *fielditem;
 //        aCfgItem newobj;
 //        aCfg *md = item->md;
@@ -608,7 +707,6 @@ void DirectoryEditor::editElementAttribute_clicked()
         manager->activateEditor(editor);
         QMetaObject::invokeMethod(editor->widget(), "setData",
         Q_ARG(DomCfgItem*, element->child(currentRow)));
-        connect(manager,SIGNAL(editorsClosed(QList<Core::IEditor*>)),editor->widget(),SLOT(updateMD(QList<Core::IEditor*>)));
     }
 
 
@@ -752,8 +850,6 @@ void DirectoryEditor::createNewGroupAttribute_clicked()
         Q_ARG(DomCfgItem*, field));
     }
 
-    GetGroupAttributesList();
-
 //        aListViewItem *newitem, *fielditem;
 //        aCfgItem newobj;
 //        aCfg *md = item->md;
@@ -855,7 +951,6 @@ void DirectoryEditor::editGroupAttribute_clicked()
         manager->activateEditor(editor);
         QMetaObject::invokeMethod(editor->widget(), "setData",
         Q_ARG(DomCfgItem*, element->child(currentRow)));
-        connect(manager,SIGNAL(editorsClosed(QList<Core::IEditor*>)),editor->widget(),SLOT(updateMD(QList<Core::IEditor*>)));
     }
 
 
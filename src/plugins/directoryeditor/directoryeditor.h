@@ -37,11 +37,11 @@ public:
     bool isModified() const;
 
     Core::IEditor *editorInterface() const { return m_ieditor; }
-    void setEditorInterface(Core::IEditor *ieditor) { m_ieditor = ieditor; }
+    void setEditorInterface(Core::IEditor *ieditor);
     Q_INVOKABLE void setData( DomCfgItem * o );
 public slots:
     //virtual void setData( DomCfgItem * o );
-    virtual void updateMD(QList<Core::IEditor*> editor);
+    virtual void updateMD();
     virtual void eSv_activated( int index );
     virtual void eSvG_activated( int index );
 
@@ -59,7 +59,15 @@ private:
     void GetGroupAttributesList();
     void GetFormsList();
     void CatList();
+    void watch(DomCfgItem *container, QTableWidget *table);
+    QHash<QObject *, QTableWidget *> m_tables;	// containers of the lists
+    DomCfgItem *m_catalogues;
 private slots:
+    void editorClosed();
+    void containerChildInserted(int row);
+    void containerChildRemoved(int row);
+    void containerChildChanged(int row);
+    void containerChildrenSwapped(int row, int otherRow);
     void doubleClickedElement ( int row, int column );
     void doubleClickedGroup ( int row, int column );
     void doubleClickedForm ( int row, int column );
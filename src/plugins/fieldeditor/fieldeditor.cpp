@@ -14,7 +14,7 @@ using namespace FIELDEditor;
  *
  */
 FieldEditor::FieldEditor(QWidget* parent, const char* name, Qt::WindowFlags fl)
-    : QMainWindow(parent, fl)
+    : QMainWindow(parent, fl), item(0), m_ieditor(0)
 {
     setupUi(this);
     init();
@@ -25,6 +25,8 @@ FieldEditor::FieldEditor(QWidget* parent, const char* name, Qt::WindowFlags fl)
  */
 FieldEditor::~FieldEditor()
 {
+    if (m_ieditor)
+        disconnect(m_ieditor, 0, this, 0);
     destroy();
     // no need to delete child widgets, Qt does it all for us
 }
@@ -67,6 +69,25 @@ void FieldEditor::init()
 }
 
 
+/*
+ * The editor manager deletes the interface when the editor is closed,
+ * that is when the changes are written to the configuration.
+ */
+void FieldEditor::setEditorInterface(Core::IEditor *ieditor)
+{
+    if (m_ieditor)
+        disconnect(m_ieditor, 0, this, 0);
+    m_ieditor = ieditor;
+    if (m_ieditor)
+        connect(m_ieditor, SIGNAL(destroyed()), this, SLOT(editorClosed()));
+}
+
+void FieldEditor::editorClosed()
+{
+    m_ieditor = 0;
+    updateMD();
+}
+
 void FieldEditor::setData( DomCfgItem *o )
 {
         item = o;
@@ -228,18 +249,10 @@ void FieldEditor::setData( DomCfgItem *o )
  	typeSelect( type );
 }
 
-void FieldEditor::updateMD(QList<Core::IEditor*> editor)
+void FieldEditor::updateMD()
 {
   QString st;
-  bool findWidget = false;
-  foreach (Core::IEditor* ed, editor)
-  {
-      if (ed->widget()==this) {
-          findWidget=true;
-          break;
-      }
-  }
-  if (findWidget==false)
+  if (!item)
       return;
 // 
 //  aCfg *md = item->md;
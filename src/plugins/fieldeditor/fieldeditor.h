@@ -33,12 +33,12 @@ public:
     DomCfgItem *item;
     //aAliasEditor *al;
     Core::IEditor *editorInterface() const { return m_ieditor; }
-    void setEditorInterface(Core::IEditor *ieditor) { m_ieditor = ieditor; }
+    void setEditorInterface(Core::IEditor *ieditor);
     Q_INVOKABLE void setData( DomCfgItem * o );
 protected:
     void hideEvent (QHideEvent * event);
 public slots:
-    virtual void updateMD(QList<Core::IEditor*> editor);
+    virtual void updateMD();
     virtual void typeSelect( QStringList type );
     virtual void nameChanged();
     virtual void AARegSelect( int i );
@@ -46,6 +46,9 @@ public slots:
 protected slots:
     virtual void languageChange();
 
+private slots:
+    void editorClosed();
+
 private:
     QString capt;
     Core::IEditor *m_ieditor;
@@ -32,7 +32,7 @@
 using namespace Find::Internal;
 
 SearchResultTreeItem::SearchResultTreeItem(SearchResultTreeItem::ItemType type, const SearchResultTreeItem *parent)
-  : m_type(type), m_parent(parent), m_isUserCheckable(false), m_checkState(Qt::Unchecked)
+  : m_type(type), m_parent(parent), m_row(0), m_isUserCheckable(false), m_checkState(Qt::Unchecked)
 {
 }
 
@@ -79,7 +79,7 @@ int SearchResultTreeItem::childrenCount() const
 
 int SearchResultTreeItem::rowOfItem() const
 {
-    return (m_parent ? m_parent->m_children.indexOf(const_cast<SearchResultTreeItem*>(this)):0);
+    return m_row;
 }
 
 SearchResultTreeItem* SearchResultTreeItem::childAt(int index) const
@@ -94,17 +94,19 @@ const SearchResultTreeItem *SearchResultTreeItem::parent() const
 
 void SearchResultTreeItem::appendChild(SearchResultTreeItem *child)
 {
+    child->m_row = m_children.size();
     m_children.append(child);
 }
 
 SearchResultTextRow::SearchResultTextRow(int index, int lineNumber,
-                                         const QString &rowText,
+                                         int textOffset, int textLength,
                                          int searchTermStart, int searchTermLength,
                                          const SearchResultTreeItem *parent):
     SearchResultTreeItem(ResultRow, parent),
     m_index(index),
     m_lineNumber(lineNumber),
-    m_rowText(rowText),
+    m_textOffset(textOffset),
+    m_textLength(textLength),
     m_searchTermStart(searchTermStart),
     m_searchTermLength(searchTermLength)
 {
@@ -115,9 +117,14 @@ int SearchResultTextRow::index() const
     return m_index;
 }
 
-QString SearchResultTextRow::rowText() const
+int SearchResultTextRow::textOffset() const
 {
-    return m_rowText;
+    return m_textOffset;
+}
+
+int SearchResultTextRow::textLength() const
+{
+    return m_textLength;
 }
 
 int SearchResultTextRow::lineNumber() const
@@ -146,10 +153,10 @@ QString SearchResultFile::fileName() const
     return m_fileName;
 }
 
-void SearchResultFile::appendResultLine(int index, int lineNumber, const QString &rowText, int searchTermStart,
-        int searchTermLength)
+void SearchResultFile::appendResultLine(int index, int lineNumber, int textOffset, int textLength,
+        int searchTermStart, int searchTermLength)
 {
-    SearchResultTreeItem *child = new SearchResultTextRow(index, lineNumber, rowText,
+    SearchResultTreeItem *child = new SearchResultTextRow(index, lineNumber, textOffset, textLength,
                                                           searchTermStart, searchTermLength, this);
     if (isUserCheckable()) {
         child->setIsUserCheckable(true);
@@ -70,6 +70,7 @@ private:
     ItemType m_type;
     const SearchResultTreeItem *m_parent;
     QList<SearchResultTreeItem *> m_children;
+    int m_row;
     bool m_isUserCheckable;
     Qt::CheckState m_checkState;
 };
@@ -77,10 +78,13 @@ private:
 class SearchResultTextRow : public SearchResultTreeItem
 {
 public:
-    SearchResultTextRow(int index, int lineNumber, const QString &rowText, int searchTermStart,
-                        int searchTermLength, const SearchResultTreeItem *parent);
+    SearchResultTextRow(int index, int lineNumber, int textOffset, int textLength,
+                        int searchTermStart, int searchTermLength,
+                        const SearchResultTreeItem *parent);
     int index() const;
-    QString rowText() const;
+    // The text is kept in the model's string pool
+    int textOffset() const;
+    int textLength() const;
     int lineNumber() const;
     int searchTermStart() const;
     int searchTermLength() const;
@@ -88,7 +92,8 @@ public:
 private:
     int m_index;
     int m_lineNumber;
-    QString m_rowText;
+    int m_textOffset;
+    int m_textLength;
     int m_searchTermStart;
     int m_searchTermLength;
 };
@@ -98,8 +103,8 @@ class SearchResultFile : public SearchResultTreeItem
 public:
     SearchResultFile(const QString &fileName, const SearchResultTreeItem *parent);
     QString fileName() const;
-    void appendResultLine(int index, int lineNumber, const QString &rowText, int searchTermStart,
-                          int searchTermLength);
+    void appendResultLine(int index, int lineNumber, int textOffset, int textLength,
+                          int searchTermStart, int searchTermLength);
 
 private:
     QString m_fileName;
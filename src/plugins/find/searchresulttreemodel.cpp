@@ -30,6 +30,7 @@
 #include "searchresulttreemodel.h"
 #include "searchresulttreeitems.h"
 #include "searchresulttreeitemroles.h"
+#include "searchresultwindow.h"
 
 #include <QtGui/QApplication>
 #include <QtGui/QFont>
@@ -189,14 +190,14 @@ QVariant SearchResultTreeModel::data(const SearchResultTextRow *row, int role) c
             result = row->checkState();
         break;
     case Qt::ToolTipRole:
-        result = row->rowText().trimmed();
+        result = rowText(row).trimmed();
         break;
     case Qt::FontRole:
         result = m_textEditorFont;
         break;
     case ItemDataRoles::ResultLineRole:
     case Qt::DisplayRole:
-        result = row->rowText();
+        result = rowText(row);
         break;
     case ItemDataRoles::ResultIndexRole:
         result = row->index();
@@ -277,7 +278,8 @@ QVariant SearchResultTreeModel::headerData(int section, Qt::Orientation orientat
     return QVariant();
 }
 
-void SearchResultTreeModel::appendResultFile(const QString &fileName)
+void SearchResultTreeModel::appendResultFile(const QString &fileName, const QList<SearchResultItem> &items,
+                                             int begin, int end)
 {
 #ifdef Q_OS_WIN
     if (fileName.contains(QLatin1Char('\\')))
@@ -290,40 +292,81 @@ void SearchResultTreeModel::appendResultFile(const QString &fileName)
         m_lastAppendedResultFile->setCheckState(Qt::Checked);
     }
 
+    // The lines go in before the file is inserted, so that they do not
+    // need insertions of their own.
+    appendRows(m_lastAppendedResultFile, items, begin, end);
+
     const int childrenCount = m_rootItem->childrenCount();
     beginInsertRows(QModelIndex(), childrenCount, childrenCount);
     m_rootItem->appendChild(m_lastAppendedResultFile);
     endInsertRows();
 }
 
-void SearchResultTreeModel::appendResultLine(int index, int lineNumber, const QString &rowText,
-                                             int searchTermStart, int searchTermLength)
+void SearchResultTreeModel::appendToLastFile(const QList<SearchResultItem> &items, int begin, int end)
 {
-    if (!m_lastAppendedResultFile)
-        return;
-
     QModelIndex lastFile(createIndex(m_lastAppendedResultFile->rowOfItem(), 0, m_lastAppendedResultFile));
 
-    beginInsertRows(lastFile, m_lastAppendedResultFile->childrenCount(), m_lastAppendedResultFile->childrenCount());
-    m_lastAppendedResultFile->appendResultLine(index, lineNumber, rowText, searchTermStart, searchTermLength);
+    const int childrenCount = m_lastAppendedResultFile->childrenCount();
+    beginInsertRows(lastFile, childrenCount, childrenCount + end - begin - 1);
+    appendRows(m_lastAppendedResultFile, items, begin, end);
     endInsertRows();
 
     dataChanged(lastFile, lastFile); // Make sure that the number after the file name gets updated
 }
 
-void SearchResultTreeModel::appendResultLine(int index, const QString &fileName, int lineNumber, const QString &rowText,
-                                             int searchTermStart, int searchTermLength)
+void SearchResultTreeModel::appendRows(SearchResultFile *file, const QList<SearchResultItem> &items,
+                                       int begin, int end)
+{
+    for (int i = begin; i < end; ++i) {
+        const SearchResultItem &item = items.at(i);
+        const int index = m_resultRows.size();
+        file->appendResultLine(index, item.lineNumber, m_textPool.size(), item.lineText.size(),
+                               item.searchTermStart, item.searchTermLength);
+        m_textPool.append(item.lineText);
+        m_resultRows.append(static_cast<SearchResultTextRow *>(file->childAt(file->childrenCount() - 1)));
+    }
+}
+
+void SearchResultTreeModel::appendResultLines(const QList<SearchResultItem> &items)
 {
-    if (!m_lastAppendedResultFile || (m_lastAppendedResultFile->fileName() != fileName))
-        appendResultFile(fileName);
+    // One insertion for each run of lines from the same file
+    int begin = 0;
+    while (begin < items.size()) {
+        const QString &fileName = items.at(begin).fileName;
+        int end = begin + 1;
+        while (end < items.size() && items.at(end).fileName == fileName)
+            ++end;
+
+        if (m_lastAppendedResultFile && m_lastAppendedResultFile->fileName() == fileName)
+            appendToLastFile(items, begin, end);
+        else
+            appendResultFile(fileName, items, begin, end);
+
+        begin = end;
+    }
+}
 
-    appendResultLine(index, lineNumber, rowText, searchTermStart, searchTermLength);
+int SearchResultTreeModel::resultCount() const
+{
+    return m_resultRows.size();
+}
+
+const SearchResultTextRow *SearchResultTreeModel::resultRow(int index) const
+{
+    return m_resultRows.at(index);
+}
+
+QString SearchResultTreeModel::rowText(const SearchResultTextRow *row) const
+{
+    return m_textPool.mid(row->textOffset(), row->textLength());
 }
 
 void SearchResultTreeModel::clear()
 {
     m_lastAppendedResultFile = NULL;
     m_rootItem->clearChildren();
+    m_textPool.clear();
+    m_resultRows.clear();
     reset();
 }
 
@@ -31,9 +31,13 @@
 #define SEARCHRESULTTREEMODEL_H
 
 #include <QtCore/QAbstractItemModel>
+#include <QtCore/QVector>
 #include <QtGui/QFont>
 
 namespace Find {
+
+struct SearchResultItem;
+
 namespace Internal {
 
 class SearchResultTreeItem;
@@ -63,19 +67,27 @@ public:
     QModelIndex next(const QModelIndex &idx) const;
     QModelIndex prev(const QModelIndex &idx) const;
 
+    // Results are numbered in the order they are appended, the index
+    // of the items is ignored.
+    void appendResultLines(const QList<SearchResultItem> &items);
+
+    int resultCount() const;
+    const SearchResultTextRow *resultRow(int index) const;
+    QString rowText(const SearchResultTextRow *row) const;
+
 signals:
     void jumpToSearchResult(const QString &fileName, int lineNumber,
                             int searchTermStart, int searchTermLength);
 
 public slots:
     void clear();
-    void appendResultLine(int index, int lineNumber, const QString &rowText,
-                          int searchTermStart, int searchTermLength);
-    void appendResultLine(int index, const QString &fileName, int lineNumber, const QString &rowText,
-                          int searchTermStart, int searchTermLength);
 
 private:
-    void appendResultFile(const QString &fileName);
+    void appendResultFile(const QString &fileName, const QList<SearchResultItem> &items,
+                          int begin, int end);
+    void appendToLastFile(const QList<SearchResultItem> &items, int begin, int end);
+    void appendRows(SearchResultFile *file, const QList<SearchResultItem> &items,
+                    int begin, int end);
     QVariant data(const SearchResultTextRow *row, int role) const;
     QVariant data(const SearchResultFile *file, int role) const;
     void initializeData();
@@ -83,6 +95,8 @@ private:
 
     SearchResultTreeItem *m_rootItem;
     SearchResultFile *m_lastAppendedResultFile;
+    QString m_textPool; // The text of all result lines
+    QVector<SearchResultTextRow *> m_resultRows; // By result index
     QFont m_textEditorFont;
     bool m_showReplaceUI;
 };
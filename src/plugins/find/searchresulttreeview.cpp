@@ -65,15 +65,16 @@ void SearchResultTreeView::clear()
     m_model->clear();
 }
 
-void SearchResultTreeView::appendResultLine(int index, const QString &fileName, int lineNumber, const QString &rowText,
-                                            int searchTermStart, int searchTermLength)
+void SearchResultTreeView::appendResultLines(const QList<SearchResultItem> &items)
 {
     int rowsBefore = m_model->rowCount();
-    m_model->appendResultLine(index, fileName, lineNumber, rowText, searchTermStart, searchTermLength);
+    m_model->appendResultLines(items);
     int rowsAfter = m_model->rowCount();
 
-    if (m_autoExpandResults && (rowsAfter > rowsBefore))
-        setExpanded(model()->index(model()->rowCount() - 1, 0), true);
+    if (m_autoExpandResults) {
+        for (int row = rowsBefore; row < rowsAfter; ++row)
+            setExpanded(model()->index(row, 0), true);
+    }
 }
 
 void SearchResultTreeView::emitJumpToSearchResult(const QModelIndex &index)
@@ -34,6 +34,9 @@
 #include <QtGui/QKeyEvent>
 
 namespace Find {
+
+struct SearchResultItem;
+
 namespace Internal {
 
 class SearchResultTreeModel;
@@ -50,13 +53,13 @@ public:
 
     SearchResultTreeModel *model() const;
 
+    void appendResultLines(const QList<SearchResultItem> &items);
+
 signals:
     void jumpToSearchResult(int index, bool checked);
 
 public slots:
     void clear();
-    void appendResultLine(int index, const QString &fileName, int lineNumber, const QString &lineText,
-                          int searchTermStart, int searchTermLength);
     void emitJumpToSearchResult(const QModelIndex &index);
 
 protected:
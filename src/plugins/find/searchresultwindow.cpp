@@ -102,7 +102,6 @@ SearchResultWindow::~SearchResultWindow()
     m_currentSearch = 0;
     delete m_widget;
     m_widget = 0;
-    m_items.clear();
 }
 
 void SearchResultWindow::setTextToReplace(const QString &textToReplace)
@@ -146,7 +145,7 @@ QList<SearchResultItem> SearchResultWindow::checkedItems() const
             QModelIndex textIndex = model->index(rowIndex, 0, fileIndex);
             SearchResultTextRow *rowItem = static_cast<SearchResultTextRow *>(textIndex.internalPointer());
             if (rowItem->checkState())
-                result << m_items.at(rowItem->index());
+                result << resultItem(rowItem->index());
         }
     }
     return result;
@@ -177,7 +176,7 @@ SearchResult *SearchResultWindow::startNewSearch(SearchMode searchOrSearchAndRep
 
 void SearchResultWindow::finishSearch()
 {
-    if (m_items.count()) {
+    if (numberOfResults()) {
         m_replaceButton->setEnabled(true);
     } else {
         showNoMatchesFound();
@@ -190,7 +189,7 @@ void SearchResultWindow::clearContents()
     m_replaceButton->setEnabled(false);
     m_replaceTextEdit->clear();
     m_searchResultTreeView->clear();
-    m_items.clear();
+    m_userData.clear();
     m_widget->setCurrentWidget(m_searchResultTreeView);
     navigateStateChanged();
 }
@@ -209,7 +208,7 @@ bool SearchResultWindow::isEmpty() const
 
 int SearchResultWindow::numberOfResults() const
 {
-    return m_items.count();
+    return m_searchResultTreeView->model()->resultCount();
 }
 
 bool SearchResultWindow::hasFocus()
@@ -219,12 +218,12 @@ bool SearchResultWindow::hasFocus()
 
 bool SearchResultWindow::canFocus()
 {
-    return !m_items.isEmpty();
+    return numberOfResults() > 0;
 }
 
 void SearchResultWindow::setFocus()
 {
-    if (!m_items.isEmpty()) {
+    if (numberOfResults() > 0) {
         if (!m_isShowingReplaceUI) {
             m_searchResultTreeView->setFocus();
         } else {
@@ -248,15 +247,27 @@ void SearchResultWindow::setTextEditorFont(const QFont &font)
 void SearchResultWindow::handleJumpToSearchResult(int index, bool /* checked */)
 {
     QTC_ASSERT(m_currentSearch, return);
-    m_currentSearch->activated(m_items.at(index));
+    m_currentSearch->activated(resultItem(index));
+}
+
+SearchResultItem SearchResultWindow::resultItem(int index) const
+{
+    const SearchResultTreeModel *model = m_searchResultTreeView->model();
+    const SearchResultTextRow *row = model->resultRow(index);
+    SearchResultItem item;
+    item.fileName = static_cast<const SearchResultFile *>(row->parent())->fileName();
+    item.lineNumber = row->lineNumber();
+    item.lineText = model->rowText(row);
+    item.searchTermStart = row->searchTermStart();
+    item.searchTermLength = row->searchTermLength();
+    item.userData = m_userData.value(index);
+    item.index = index;
+    return item;
 }
 
 void SearchResultWindow::addResult(const QString &fileName, int lineNumber, const QString &rowText,
     int searchTermStart, int searchTermLength, const QVariant &userData)
 {
-    //qDebug()<<"###"<<fileName;
-    m_widget->setCurrentWidget(m_searchResultTreeView);
-    int index = m_items.size();
     SearchResultItem item;
     item.fileName = fileName;
     item.lineNumber = lineNumber;
@@ -264,10 +275,23 @@ void SearchResultWindow::addResult(const QString &fileName, int lineNumber, cons
     item.searchTermStart = searchTermStart;
     item.searchTermLength = searchTermLength;
     item.userData = userData;
-    item.index = index;
-    m_items.append(item);
-    m_searchResultTreeView->appendResultLine(index, fileName, lineNumber, rowText, searchTermStart, searchTermLength);
-    if (index == 0) {
+    item.index = 0;
+    addResults(QList<SearchResultItem>() << item);
+}
+
+void SearchResultWindow::addResults(const QList<SearchResultItem> &items)
+{
+    if (items.isEmpty())
+        return;
+
+    m_widget->setCurrentWidget(m_searchResultTreeView);
+    const int firstIndex = numberOfResults();
+    for (int i = 0; i < items.size(); ++i) {
+        if (items.at(i).userData.isValid())
+            m_userData.insert(firstIndex + i, items.at(i).userData);
+    }
+    m_searchResultTreeView->appendResultLines(items);
+    if (firstIndex == 0) {
         m_replaceTextEdit->setEnabled(true);
         // We didn't have an item before, set the focus to the search widget
         m_focusReplaceEdit = true;
@@ -314,17 +338,17 @@ int SearchResultWindow::priorityInStatusBar() const
 
 bool SearchResultWindow::canNext()
 {
-    return m_items.count() > 0;
+    return numberOfResults() > 0;
 }
 
 bool SearchResultWindow::canPrevious()
 {
-    return m_items.count() > 0;
+    return numberOfResults() > 0;
 }
 
 void SearchResultWindow::goToNext()
 {
-    if (m_items.count() == 0)
+    if (numberOfResults() == 0)
         return;
     QModelIndex idx = m_searchResultTreeView->model()->next(m_searchResultTreeView->currentIndex());
     if (idx.isValid()) {
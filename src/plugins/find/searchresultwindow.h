@@ -35,6 +35,8 @@
 
 #include <coreplugin/ioutputpane.h>
 
+#include <QtCore/QHash>
+
 
 QT_BEGIN_NAMESPACE
 class QStackedWidget;
@@ -113,6 +115,9 @@ public slots:
     void clearContents();
     void addResult(const QString &fileName, int lineNumber, const QString &lineText,
                    int searchTermStart, int searchTermLength, const QVariant &userData = QVariant());
+    // Adds a batch of results with one insertion per file, the index
+    // of the items is ignored.
+    void addResults(const QList<Find::SearchResultItem> &items);
     void finishSearch();
 
 private slots:
@@ -126,6 +131,7 @@ private:
     void readSettings();
     void writeSettings();
     QList<SearchResultItem> checkedItems() const;
+    SearchResultItem resultItem(int index) const;
 
     Internal::SearchResultTreeView *m_searchResultTreeView;
     QListWidget *m_noMatchesFoundDisplay;
@@ -136,7 +142,7 @@ private:
     static const bool m_initiallyExpand = false;
     QStackedWidget *m_widget;
     SearchResult *m_currentSearch;
-    QList<SearchResultItem> m_items;
+    QHash<int, QVariant> m_userData; // Only for results that have any
     bool m_isShowingReplaceUI;
     bool m_focusReplaceEdit;
 };
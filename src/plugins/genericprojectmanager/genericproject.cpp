@@ -283,9 +283,7 @@ void GenericProject::parseProject(RefreshOptions options)
 
 void GenericProject::refresh(RefreshOptions options)
 {
-    QSet<QString> oldFileList;
-    if (!(options & Configuration))
-        oldFileList = m_files.toSet();
+    const QSet<QString> oldFileList = m_files.toSet();
 
     parseProject(options);
 
@@ -300,6 +298,7 @@ void GenericProject::refresh(RefreshOptions options)
         const QList<ProjectExplorer::HeaderPath> systemHeaderPaths = m_toolChain->systemHeaderPaths();
 
         CppTools::CppModelManagerInterface::ProjectInfo pinfo = modelManager->projectInfo(this);
+        const CppTools::CppModelManagerInterface::ProjectInfo oldPinfo = pinfo;
         pinfo.defines = predefinedMacros;
         pinfo.defines += '\n';
         pinfo.defines += m_defines;
@@ -324,7 +323,14 @@ void GenericProject::refresh(RefreshOptions options)
 
         QStringList filesToUpdate;
 
-        if (options & Configuration) {
+        // All files share the same macros and include paths, so they only
+        // need to be reparsed when one of those actually changed.
+        const bool configurationChanged = (options & Configuration)
+                                          && (pinfo.defines != oldPinfo.defines
+                                              || pinfo.includePaths != oldPinfo.includePaths
+                                              || pinfo.frameworkPaths != oldPinfo.frameworkPaths);
+
+        if (configurationChanged) {
             filesToUpdate = pinfo.sourceFiles;
             filesToUpdate.append(QLatin1String("<configuration>")); // XXX don't hardcode configuration file name
         } else if (options & Files) {
@@ -34,6 +34,7 @@
 #include <projectexplorer/projectexplorer.h>
 
 #include <QFileInfo>
+#include <QSet>
 
 using namespace GenericProjectManager;
 using namespace GenericProjectManager::Internal;
@@ -59,107 +60,143 @@ void GenericProjectNode::refresh()
 {
     using namespace ProjectExplorer;
 
-    // remove the existing nodes.
-    removeFileNodes(fileNodes(), this);
-    removeFolderNodes(subFolderNodes(), this);
+    // Collect the files of every folder, keyed by the folder path relative
+    // to the project directory. The empty key is the project node itself.
+    QHash<QString, QHash<QString, FileType> > filesInPath;
 
-    //ProjectExplorerPlugin::instance()->setCurrentNode(0); // ### remove me
+    QHash<QString, FileType> projectFiles;
+    projectFiles.insert(m_project->filesFileName(), ProjectFileType);
+    projectFiles.insert(m_project->includesFileName(), ProjectFileType);
+    projectFiles.insert(m_project->configFileName(), ProjectFileType);
+    filesInPath.insert(QString(), projectFiles);
 
-    FileNode *projectFilesNode = new FileNode(m_project->filesFileName(),
-                                              ProjectFileType,
-                                              /* generated = */ false);
+    const QString baseDir = QFileInfo(path()).absolutePath();
 
-    FileNode *projectIncludesNode = new FileNode(m_project->includesFileName(),
-                                                 ProjectFileType,
-                                                 /* generated = */ false);
+    foreach (const QString &absoluteFileName, m_project->files()) {
+        if (projectFiles.contains(absoluteFileName))
+            continue;
 
-    FileNode *projectConfigNode = new FileNode(m_project->configFileName(),
-                                               ProjectFileType,
-                                               /* generated = */ false);
+        const QString absoluteFilePath = QFileInfo(absoluteFileName).path();
 
-    QStringList files = m_project->files();
-    files.removeAll(m_project->filesFileName());
-    files.removeAll(m_project->includesFileName());
-    files.removeAll(m_project->configFileName());
-
-    addFileNodes(QList<FileNode *>()
-                 << projectFilesNode
-                 << projectIncludesNode
-                 << projectConfigNode,
-                 this);
-
-    QStringList filePaths;
-    QHash<QString, QStringList> filesInPath;
-
-    foreach (const QString &absoluteFileName, files) {
-        QFileInfo fileInfo(absoluteFileName);
-        const QString absoluteFilePath = fileInfo.path();
-
-        QString baseDir = QFileInfo(path()).absolutePath();
-        if (! absoluteFilePath.startsWith(baseDir))
-            continue; // `file' is not part of the project.
-
-        const QString relativeFilePath = absoluteFilePath.mid(baseDir.length() + 1);
-
-        if (! filePaths.contains(relativeFilePath))
-            filePaths.append(relativeFilePath);
+        QString relativeFilePath;
+        if (absoluteFilePath != baseDir) {
+            if (! absoluteFilePath.startsWith(baseDir + QLatin1Char('/')))
+                continue; // `file' is not part of the project.
+            relativeFilePath = absoluteFilePath.mid(baseDir.length() + 1);
+        }
 
-        filesInPath[relativeFilePath].append(absoluteFileName);
+        filesInPath[relativeFilePath].insert(absoluteFileName, SourceType); // ### FIXME
     }
 
-    foreach (const QString &filePath, filePaths) {
-        FolderNode *folder = findOrCreateFolderByName(filePath);
-
-        QList<FileNode *> fileNodes;
-        foreach (const QString &file, filesInPath.value(filePath)) {
-            FileType fileType = SourceType; // ### FIXME
-            FileNode *fileNode = new FileNode(file, fileType, /*generated = */ false);
-            fileNodes.append(fileNode);
+    // A folder is needed when it, or one of its subfolders, contains files.
+    QSet<QString> neededFolders;
+    foreach (const QString &relativeFilePath, filesInPath.keys()) {
+        QString folderName = relativeFilePath;
+        while (! folderName.isEmpty() && ! neededFolders.contains(folderName)) {
+            neededFolders.insert(folderName);
+            folderName.truncate(qMax(0, folderName.lastIndexOf(QLatin1Char('/'))));
         }
+    }
 
-        addFileNodes(fileNodes, folder);
+    removeStaleFolders(neededFolders);
+    createMissingFolders(neededFolders);
+
+    // Only the changed files of each folder are removed and added.
+    QHashIterator<QString, QHash<QString, FileType> > it(filesInPath);
+    while (it.hasNext()) {
+        it.next();
+        FolderNode *folder = it.key().isEmpty() ? this : m_folderByName.value(it.key());
+        updateFileNodes(it.value(), folder);
     }
 
-    m_folderByName.clear();
+    // Folders kept only for their subfolders lose their own files.
+    QHashIterator<QString, FolderNode *> folderIt(m_folderByName);
+    while (folderIt.hasNext()) {
+        folderIt.next();
+        if (! filesInPath.contains(folderIt.key()))
+            updateFileNodes(QHash<QString, FileType>(), folderIt.value());
+    }
 }
 
-ProjectExplorer::FolderNode *GenericProjectNode::findOrCreateFolderByName(const QStringList &components, int end)
+void GenericProjectNode::removeStaleFolders(const QSet<QString> &neededFolders)
 {
-    if (! end)
-        return 0;
-
-    QString baseDir = QFileInfo(path()).path();
+    // Remove only the topmost stale folders, grouped by their parent;
+    // deleting them takes their stale subfolders along.
+    QHash<FolderNode *, QList<FolderNode *> > staleFoldersByParent;
+    QStringList staleFolderNames;
+
+    QHashIterator<QString, FolderNode *> it(m_folderByName);
+    while (it.hasNext()) {
+        it.next();
+        if (neededFolders.contains(it.key()))
+            continue;
+
+        staleFolderNames.append(it.key());
+
+        const QString parentName = it.key().left(qMax(0, it.key().lastIndexOf(QLatin1Char('/'))));
+        if (parentName.isEmpty() || neededFolders.contains(parentName))
+            staleFoldersByParent[it.value()->parentFolderNode()].append(it.value());
+    }
 
-    QString folderName;
-    for (int i = 0; i < end; ++i) {
-        folderName.append(components.at(i));
-        folderName += QLatin1Char('/'); // ### FIXME
+    QHashIterator<FolderNode *, QList<FolderNode *> > parentIt(staleFoldersByParent);
+    while (parentIt.hasNext()) {
+        parentIt.next();
+        removeFolderNodes(parentIt.value(), parentIt.key());
     }
 
-    const QString component = components.at(end - 1);
+    foreach (const QString &folderName, staleFolderNames)
+        m_folderByName.remove(folderName);
+}
 
-    if (component.isEmpty())
-        return this;
+void GenericProjectNode::createMissingFolders(const QSet<QString> &neededFolders)
+{
+    const QString baseDir = QFileInfo(path()).path();
 
-    else if (FolderNode *folder = m_folderByName.value(folderName))
-        return folder;
+    QStringList missingFolders;
+    foreach (const QString &folderName, neededFolders) {
+        if (! m_folderByName.contains(folderName))
+            missingFolders.append(folderName);
+    }
 
-    FolderNode *folder = new FolderNode(baseDir + "/" + folderName);
-    folder->setFolderName(component);
-    m_folderByName.insert(folderName, folder);
+    // Sorting puts every parent before its subfolders, so the new folders
+    // can be added one level at a time, in one batch per parent.
+    qSort(missingFolders);
+
+    while (! missingFolders.isEmpty()) {
+        QHash<FolderNode *, QList<FolderNode *> > newFoldersByParent;
+        QHash<FolderNode *, QString> newFolderNames;
+        QStringList deeperFolders;
+
+        foreach (const QString &folderName, missingFolders) {
+            const int slash = folderName.lastIndexOf(QLatin1Char('/'));
+            const QString parentName = folderName.left(qMax(0, slash));
+
+            FolderNode *parent = this;
+            if (! parentName.isEmpty()) {
+                parent = m_folderByName.value(parentName);
+                if (! parent) {
+                    deeperFolders.append(folderName); // parent is added in this round
+                    continue;
+                }
+            }
+
+            FolderNode *folder = new FolderNode(baseDir + QLatin1Char('/') + folderName + QLatin1Char('/')); // ### FIXME
+            folder->setFolderName(folderName.mid(slash + 1));
+            newFoldersByParent[parent].append(folder);
+            newFolderNames.insert(folder, folderName);
+        }
 
-    FolderNode *parent = findOrCreateFolderByName(components, end - 1);
-    if (! parent)
-        parent = this;
-    addFolderNodes(QList<FolderNode*>() << folder, parent);
+        QHashIterator<FolderNode *, QList<FolderNode *> > it(newFoldersByParent);
+        while (it.hasNext()) {
+            it.next();
+            addFolderNodes(it.value(), it.key());
 
-    return folder;
-}
+            foreach (FolderNode *folder, it.value())
+                m_folderByName.insert(newFolderNames.value(folder), folder);
+        }
 
-ProjectExplorer::FolderNode *GenericProjectNode::findOrCreateFolderByName(const QString &filePath)
-{
-    QStringList components = filePath.split(QLatin1Char('/'));
-    return findOrCreateFolderByName(components, components.length());
+        missingFolders = deeperFolders;
+    }
 }
 
 bool GenericProjectNode::hasTargets() const
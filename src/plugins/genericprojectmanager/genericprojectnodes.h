@@ -34,6 +34,7 @@
 
 #include <QStringList>
 #include <QHash>
+#include <QSet>
 
 namespace Core {
 class IFile;
@@ -76,13 +77,13 @@ public:
     void refresh();
 
 private:
-    FolderNode *findOrCreateFolderByName(const QString &filePath);
-    FolderNode *findOrCreateFolderByName(const QStringList &components, int end);
+    void removeStaleFolders(const QSet<QString> &neededFolders);
+    void createMissingFolders(const QSet<QString> &neededFolders);
 
 private:
     GenericProject *m_project;
     Core::IFile *m_projectFile;
-    QHash<QString, FolderNode *> m_folderByName;
+    QHash<QString, FolderNode *> m_folderByName; // kept across refreshes
 };
 
 } // namespace Internal
@@ -30,6 +30,7 @@
 #include "branchdialog.h"
 #include "branchmodel.h"
 #include "gitclient.h"
+#include "repositorystatecache.h"
 #include "ui_branchdialog.h"
 
 #include <QtGui/QItemSelectionModel>
@@ -103,9 +104,12 @@ bool BranchDialog::init(GitClient *client, const QString &workingDirectory, QStr
     m_localModel = new LocalBranchModel(client, this);
     connect(m_localModel, SIGNAL(newBranchEntered(QString)), this, SLOT(slotCreateLocalBranch(QString)));
     m_remoteModel = new RemoteBranchModel(client, this);
-    if (!m_localModel->refresh(workingDirectory, errorMessage)
-        || !m_remoteModel->refresh(workingDirectory, errorMessage))
-        return false;
+    // Open right away; listings that are not cached yet are filled in
+    // when their background query finishes.
+    connect(client->stateCache(), SIGNAL(resultAvailable(QString,int)),
+            this, SLOT(slotRepositoryStateAvailable(QString,int)));
+    m_localModel->refreshFromCache(m_repoDirectory);
+    m_remoteModel->refreshFromCache(m_repoDirectory);
 
     m_ui->localBranchListView->setModel(m_localModel);
     m_ui->remoteBranchListView->setModel(m_remoteModel);
@@ -120,6 +124,30 @@ bool BranchDialog::init(GitClient *client, const QString &workingDirectory, QStr
     return true;
 }
 
+void BranchDialog::slotRepositoryStateAvailable(const QString &repository, int query)
+{
+    if (repository != m_repoDirectory)
+        return;
+    switch (query) {
+    case RepositoryStateCache::LocalBranches: {
+        // Keep the selection across background refreshes
+        const int selected = selectedLocalBranchIndex();
+        const QString selectedName = selected != -1 && !m_localModel->isNewBranchRow(selected) ?
+                                     m_localModel->branchName(selected) : QString();
+        m_localModel->refreshFromCache(m_repoDirectory);
+        if (!selectedName.isEmpty())
+            selectLocalBranch(selectedName);
+        slotEnableButtons();
+    }
+        break;
+    case RepositoryStateCache::RemoteBranches:
+        m_remoteModel->refreshFromCache(m_repoDirectory);
+        break;
+    default:
+        break;
+    }
+}
+
 int BranchDialog::selectedLocalBranchIndex() const
 {
     return selectedRow(m_ui->localBranchListView);
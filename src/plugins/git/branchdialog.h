@@ -75,6 +75,7 @@ private slots:
     void slotLocalBranchActivated();
     void slotRemoteBranchActivated(const QModelIndex &);
     void slotCreateLocalBranch(const QString &branchName);
+    void slotRepositoryStateAvailable(const QString &repository, int query);
 
 private:
     bool ask(const QString &title, const QString &what, bool defaultButton);
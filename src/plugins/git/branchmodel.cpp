@@ -29,6 +29,7 @@
 
 #include "branchmodel.h"
 #include "gitclient.h"
+#include "repositorystatecache.h"
 
 #include <QtCore/QDebug>
 #include <QtCore/QRegExp>
@@ -73,6 +74,12 @@ bool RemoteBranchModel::refresh(const QString &workingDirectory, QString *errorM
     return refreshBranches(workingDirectory, true, &currentBranch, errorMessage);
 }
 
+bool RemoteBranchModel::refreshFromCache(const QString &repository)
+{
+    int currentBranch;
+    return refreshBranchesFromCache(repository, true, &currentBranch);
+}
+
 QString RemoteBranchModel::branchName(int row) const
 {
     return m_branches.at(row).name;
@@ -146,8 +153,31 @@ bool RemoteBranchModel::refreshBranches(const QString &workingDirectory, bool re
         branchArgs.push_back(QLatin1String("-r"));
     if (!runGitBranchCommand(workingDirectory, branchArgs, &output, errorMessage))
         return false;
+    setBranches(workingDirectory, output, currentBranch);
+    return true;
+}
+
+bool RemoteBranchModel::refreshBranchesFromCache(const QString &repository, bool remoteBranches,
+                                                 int *currentBranch)
+{
+    RepositoryStateCache *cache = m_client->stateCache();
+    const RepositoryStateCache::Query query = remoteBranches ?
+        RepositoryStateCache::RemoteBranches : RepositoryStateCache::LocalBranches;
+    QByteArray output;
+    if (!cache->lookup(repository, query, &output)) {
+        cache->request(repository, query);
+        return false;
+    }
+    setBranches(repository, QString::fromLocal8Bit(output).remove(QLatin1Char('\r')), currentBranch);
+    return true;
+}
+
+void RemoteBranchModel::setBranches(const QString &workingDirectory, const QString &output,
+                                    int *currentBranch)
+{
     if (debug)
         qDebug() << Q_FUNC_INFO << workingDirectory << output;
+    *currentBranch = -1;
     // Parse output
     m_workingDirectory = workingDirectory;
     m_branches.clear();
@@ -163,7 +193,6 @@ bool RemoteBranchModel::refreshBranches(const QString &workingDirectory, bool re
         }
     }
     reset();
-    return true;
 }
 
 int RemoteBranchModel::findBranchByName(const QString &name) const
@@ -230,6 +259,11 @@ bool LocalBranchModel::refresh(const QString &workingDirectory, QString *errorMe
     return refreshBranches(workingDirectory, false, &m_currentBranch, errorMessage);
 }
 
+bool LocalBranchModel::refreshFromCache(const QString &repository)
+{
+    return refreshBranchesFromCache(repository, false, &m_currentBranch);
+}
+
 bool LocalBranchModel::checkNewBranchName(const QString &name) const
 {
     // Syntax
@@ -50,6 +50,9 @@ public:
     explicit RemoteBranchModel(GitClient *client, QObject *parent = 0);
 
     virtual bool refresh(const QString &workingDirectory, QString *errorMessage);
+    // Populate from the repository state cache without running git. Returns
+    // false if the listing is not cached; it is then queried in the background.
+    virtual bool refreshFromCache(const QString &repository);
 
     QString branchName(int row) const;
 
@@ -76,6 +79,9 @@ protected:
     /* Parse git output and populate m_branches. */
     bool refreshBranches(const QString &workingDirectory, bool remoteBranches,
                          int *currentBranch, QString *errorMessage);
+    bool refreshBranchesFromCache(const QString &repository, bool remoteBranches,
+                                  int *currentBranch);
+    void setBranches(const QString &workingDirectory, const QString &output, int *currentBranch);
     bool runGitBranchCommand(const QString &workingDirectory, const QStringList &additionalArgs, QString *output, QString *errorMessage);
 
 private:
@@ -101,6 +107,7 @@ public:
                          QObject *parent = 0);
 
     virtual bool refresh(const QString &workingDirectory, QString *errorMessage);
+    virtual bool refreshFromCache(const QString &repository);
 
     // is this the "type here" row?
     bool isNewBranchRow(int row) const;
@@ -21,6 +21,7 @@ HEADERS += gitplugin.h \
     branchdialog.h \
     branchmodel.h \
     gitcommand.h \
+    repositorystatecache.h \
     clonewizard.h \
     clonewizardpage.h
 SOURCES += gitplugin.cpp \
@@ -37,6 +38,7 @@ SOURCES += gitplugin.cpp \
     branchdialog.cpp \
     branchmodel.cpp \
     gitcommand.cpp \
+    repositorystatecache.cpp \
     clonewizard.cpp \
     clonewizardpage.cpp
 FORMS += changeselectiondialog.ui \
@@ -35,6 +35,7 @@
 #include "gitplugin.h"
 #include "gitsubmiteditor.h"
 #include "gitversioncontrol.h"
+#include "repositorystatecache.h"
 
 #include <coreplugin/actionmanager/actionmanager.h>
 #include <coreplugin/coreconstants.h>
@@ -108,7 +109,8 @@ GitClient::GitClient(GitPlugin* plugin)
   : m_msgWait(tr("Waiting for data...")),
     m_plugin(plugin),
     m_core(Core::ICore::instance()),
-    m_repositoryChangedSignalMapper(0)
+    m_repositoryChangedSignalMapper(0),
+    m_stateCache(new RepositoryStateCache(this, this))
 {
     if (QSettings *s = m_core->settings()) {
         m_settings.fromSettings(s);
@@ -451,11 +453,21 @@ bool GitClient::synchronousBranchCmd(const QString &workingDirectory, QStringLis
     branchArgs.push_front(QLatin1String("branch"));
     QByteArray outputText;
     QByteArray errorText;
+    // Branch listings are served from the repository state cache if possible
+    const int query = RepositoryStateCache::queryForArguments(branchArgs);
+    const QString repository = query == -1 ? QString() : findRepositoryForDirectory(workingDirectory);
+    if (!repository.isEmpty()
+        && m_stateCache->lookup(repository, RepositoryStateCache::Query(query), &outputText)) {
+        *output = QString::fromLocal8Bit(outputText).remove(QLatin1Char('\r'));
+        return true;
+    }
     const bool rc = synchronousGit(workingDirectory, branchArgs, &outputText, &errorText);
     if (!rc) {
         *errorMessage = tr("Unable to run branch command: %1: %2").arg(workingDirectory, QString::fromLocal8Bit(errorText));
         return false;
     }
+    if (!repository.isEmpty())
+        m_stateCache->store(repository, RepositoryStateCache::Query(query), outputText);
     *output = QString::fromLocal8Bit(outputText).remove(QLatin1Char('\r'));
     return true;
 }
@@ -581,6 +593,12 @@ bool GitClient::synchronousGit(const QString &workingDirectory,
 
     if (Git::Constants::debug)
         qDebug() << "synchronousGit ex=" << process.exitCode();
+
+    // Do not wait for the file system watcher, callers may query right away
+    if (RepositoryStateCache::affectsRefs(gitArguments))
+        m_stateCache->invalidate(findRepositoryForDirectory(workingDirectory));
+    else if (RepositoryStateCache::affectsStatus(gitArguments))
+        m_stateCache->invalidateStatus(findRepositoryForDirectory(workingDirectory));
     return process.exitCode() == 0;
 }
 
@@ -664,7 +682,13 @@ GitClient::StatusResult GitClient::gitStatus(const QString &workingDirectory,
     QStringList statusArgs(QLatin1String("status"));
     if (untracked)
         statusArgs << QLatin1String("-u");
+    // Stash, pull and revert act on the result, so git is always run. The
+    // working tree may have changed without the cache noticing. The plain
+    // status refreshes the cached one that is shown in the UI.
     const bool statusRc = synchronousGit(workingDirectory, statusArgs, &outputText, &errorText);
+    const QString repository = untracked ? QString() : findRepositoryForDirectory(workingDirectory);
+    if (!repository.isEmpty() && (statusRc || outputText.contains(kBranchIndicatorC)))
+        m_stateCache->store(repository, RepositoryStateCache::Status, outputText, statusRc ? 0 : 1);
     GitCommand::removeColorCodes(&outputText);
     if (output)
         *output = QString::fromLocal8Bit(outputText).remove(QLatin1Char('\r'));
@@ -1014,6 +1038,25 @@ void GitClient::setSettings(const GitSettings &s)
     }
 }
 
+void GitClient::prefetchRepositoryState(const QString &workingDirectory)
+{
+    const QString repository = findRepositoryForDirectory(workingDirectory);
+    if (repository.isEmpty())
+        return;
+    for (int q = 0; q < RepositoryStateCache::QueryCount; q++)
+        m_stateCache->request(repository, RepositoryStateCache::Query(q));
+}
+
+RepositoryStateCache *GitClient::stateCache() const
+{
+    return m_stateCache;
+}
+
+void GitClient::invalidateRepositoryState(const QString &workingDirectory)
+{
+    m_stateCache->invalidate(findRepositoryForDirectory(workingDirectory));
+}
+
 void GitClient::connectRepositoryChanged(const QString & repository, GitCommand *cmd)
 {
     // Bind command success termination with repository to changed signal
@@ -1021,6 +1064,8 @@ void GitClient::connectRepositoryChanged(const QString & repository, GitCommand
         m_repositoryChangedSignalMapper = new QSignalMapper(this);
         connect(m_repositoryChangedSignalMapper, SIGNAL(mapped(QString)),
                 m_plugin->versionControl(), SIGNAL(repositoryChanged(QString)));
+        connect(m_repositoryChangedSignalMapper, SIGNAL(mapped(QString)),
+                this, SLOT(invalidateRepositoryState(QString)));
     }
     m_repositoryChangedSignalMapper->setMapping(cmd, repository);
     connect(cmd, SIGNAL(success()), m_repositoryChangedSignalMapper, SLOT(map()),
@@ -57,6 +57,7 @@ namespace Internal {
 class GitPlugin;
 class GitOutputWindow;
 class GitCommand;
+class RepositoryStateCache;
 struct CommitData;
 struct GitSubmitEditorPanelData;
 
@@ -135,6 +136,10 @@ public:
     GitSettings  settings() const;
     void setSettings(const GitSettings &s);
 
+    // Start background queries so that later lookups are served from the cache
+    void prefetchRepositoryState(const QString &workingDirectory);
+    RepositoryStateCache *stateCache() const;
+
     QStringList binary() const; // Executable + basic arguments
     QStringList processEnvironment() const;
 
@@ -145,6 +150,9 @@ public:
 public slots:
     void show(const QString &source, const QString &id);
 
+private slots:
+    void invalidateRepositoryState(const QString &workingDirectory);
+
 private:
     VCSBase::VCSBaseEditor *createVCSEditor(const QString &kind,
                                                  QString title,
@@ -181,6 +189,7 @@ private:
     GitSettings   m_settings;
     QString m_binaryPath;
     QSignalMapper *m_repositoryChangedSignalMapper;
+    RepositoryStateCache *m_stateCache;
 };
 
 
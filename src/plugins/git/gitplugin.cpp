@@ -37,16 +37,19 @@
 #include "gitsubmiteditor.h"
 #include "gitversioncontrol.h"
 #include "branchdialog.h"
+#include "repositorystatecache.h"
 #include "clonewizard.h"
 #include "gitoriousclonewizard.h"
 
 #include <coreplugin/icore.h>
 #include <coreplugin/coreconstants.h>
 #include <coreplugin/filemanager.h>
+#include <coreplugin/ifile.h>
 #include <coreplugin/messagemanager.h>
 #include <coreplugin/uniqueidmanager.h>
 #include <coreplugin/actionmanager/actionmanager.h>
 #include <coreplugin/editormanager/editormanager.h>
+#include <coreplugin/editormanager/ieditor.h>
 
 #include <utils/qtcassert.h>
 #include <utils/parameteraction.h>
@@ -67,6 +70,7 @@
 #include <QtCore/QtPlugin>
 
 #include <QtGui/QAction>
+#include <QtGui/QApplication>
 #include <QtGui/QFileDialog>
 #include <QtGui/QMainWindow>
 #include <QtGui/QMenu>
@@ -391,6 +395,16 @@ bool GitPlugin::initialize(const QStringList &arguments, QString *errorMessage)
         this, SLOT(updateActions()));
     connect(m_core->fileManager(), SIGNAL(currentFileChanged(const QString &)),
         this, SLOT(updateActions()));
+    // Warm the repository state cache so that menus and the branch dialog
+    // do not wait for git, and keep the status in it current
+    connect(m_core->fileManager(), SIGNAL(currentFileChanged(const QString &)),
+        this, SLOT(prefetchRepositoryState(const QString &)));
+    connect(m_gitClient->stateCache(), SIGNAL(resultAvailable(QString,int)),
+        this, SLOT(updateActions()));
+    connect(m_core->editorManager(), SIGNAL(editorOpened(Core::IEditor*)),
+        this, SLOT(editorOpened(Core::IEditor*)));
+    connect(qApp, SIGNAL(focusChanged(QWidget*,QWidget*)),
+        this, SLOT(applicationFocusChanged(QWidget*,QWidget*)));
 
     return true;
 }
@@ -719,6 +733,36 @@ void GitPlugin::branchList()
     dialog.exec();
 }
 
+void GitPlugin::prefetchRepositoryState(const QString &fileName)
+{
+    if (!fileName.isEmpty())
+        m_gitClient->prefetchRepositoryState(QFileInfo(fileName).absolutePath());
+}
+
+// The working tree is not watched: a saved file changes the status
+void GitPlugin::editorOpened(Core::IEditor *editor)
+{
+    if (Core::IFile *file = editor->file())
+        connect(file, SIGNAL(changed()), this, SLOT(fileChanged()));
+}
+
+void GitPlugin::fileChanged()
+{
+    const Core::IFile *file = qobject_cast<const Core::IFile *>(sender());
+    if (!file || file->isModified() || file->fileName().isEmpty())
+        return;
+    const QString repository = m_gitClient->findRepositoryForFile(file->fileName());
+    if (!repository.isEmpty())
+        m_gitClient->stateCache()->invalidateStatus(repository);
+}
+
+// Files may have been changed outside while the application was inactive
+void GitPlugin::applicationFocusChanged(QWidget *old, QWidget *now)
+{
+    if (!old && now)
+        m_gitClient->stateCache()->invalidateAllStatus();
+}
+
 void GitPlugin::stashList()
 {
     const QString workingDirectory = getWorkingDirectory();
@@ -742,6 +786,8 @@ void GitPlugin::updateActions()
     m_stageAction->setParameter(fileName);
     m_unstageAction->setParameter(fileName);
 
+    updateRepositoryStateActions(repository);
+
     bool enabled = !fileName.isEmpty() && !repository.isEmpty();
     m_diffAction->setEnabled(enabled);
     m_statusAction->setEnabled(enabled);
@@ -783,6 +829,33 @@ void GitPlugin::updateActions()
     m_undoProjectAction->setEnabled(enabled);
 }
 
+// Actions showing the cached state of the repository. Nothing is run
+// synchronously; updateActions() is called again once missing results arrive.
+void GitPlugin::updateRepositoryStateActions(const QString &repository)
+{
+    QString branchText = tr("Branches...");
+    bool canStash = true;
+    if (!repository.isEmpty()) {
+        RepositoryStateCache *cache = m_gitClient->stateCache();
+        QByteArray output;
+        if (cache->lookup(repository, RepositoryStateCache::Head, &output)) {
+            const QString head = QString::fromLocal8Bit(output).trimmed();
+            const QString branchPrefix = QLatin1String("refs/heads/");
+            if (head.startsWith(branchPrefix))
+                branchText = tr("Branches (%1)...").arg(head.mid(branchPrefix.size()));
+        } else {
+            cache->request(repository, RepositoryStateCache::Head);
+        }
+        if (cache->lookup(repository, RepositoryStateCache::Status, &output)) {
+            canStash = !output.contains("nothing to commit");
+        } else {
+            cache->request(repository, RepositoryStateCache::Status);
+        }
+    }
+    m_branchListAction->setText(branchText);
+    m_stashAction->setEnabled(canStash);
+}
+
 void GitPlugin::showCommit()
 {
     if (!m_changeSelectionDialog)
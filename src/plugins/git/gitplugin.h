@@ -44,9 +44,11 @@ QT_BEGIN_NAMESPACE
 class QFile;
 class QAction;
 class QFileInfo;
+class QWidget;
 QT_END_NAMESPACE
 
 namespace Core {
+class IEditor;
 class IEditorFactory;
 class ICore;
 class IVersionControl;
@@ -104,6 +106,10 @@ public slots:
     bool editorAboutToClose(Core::IEditor *editor);
 
 private slots:
+    void prefetchRepositoryState(const QString &fileName);
+    void editorOpened(Core::IEditor *editor);
+    void fileChanged();
+    void applicationFocusChanged(QWidget *old, QWidget *now);
     void diffCurrentFile();
     void diffCurrentProject();
     void submitEditorDiff(const QStringList &unstaged, const QStringList &staged);
@@ -130,6 +136,7 @@ private slots:
 private:
     bool isCommitEditorOpen() const;
     QFileInfo currentFile() const;
+    void updateRepositoryStateActions(const QString &repository);
     Core::IEditor *openSubmitEditor(const QString &fileName, const CommitData &cd);
     void cleanCommitMessageFile();
 
@@ -0,0 +1,368 @@
+/**************************************************************************
+**
+** This file is part of Qt Creator
+**
+** Copyright (c) 2009 Nokia Corporation and/or its subsidiary(-ies).
+**
+** Contact: Nokia Corporation (qt-info@nokia.com)
+**
+** Commercial Usage
+**
+** Licensees holding valid Qt Commercial licenses may use this file in
+** accordance with the Qt Commercial License Agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Nokia.
+**
+** GNU Lesser General Public License Usage
+**
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** If you are unsure which license is appropriate for your use, please
+** contact the sales department at http://qt.nokia.com/contact.
+**
+**************************************************************************/
+
+
+#include "repositorystatecache.h"
+#include "gitclient.h"
+#include "gitconstants.h"
+
+#include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QDirIterator>
+#include <QtCore/QFileInfo>
+#include <QtCore/QFileSystemWatcher>
+#include <QtCore/QTimer>
+
+// Delay before re-running queries after a change, git touches
+// several files per operation.
+enum { RefreshDelay = 500 };
+
+namespace Git {
+namespace Internal {
+
+RepositoryStateCache::FileStamp::FileStamp(const QString &fileName) :
+    size(-1)
+{
+    const QFileInfo fi(fileName);
+    if (fi.exists()) {
+        modified = fi.lastModified();
+        size = fi.size();
+    }
+}
+
+RepositoryStateCache::RepositoryStateCache(GitClient *client, QObject *parent) :
+    QObject(parent),
+    m_client(client),
+    m_watcher(new QFileSystemWatcher(this)),
+    m_refreshTimer(new QTimer(this))
+{
+    m_refreshTimer->setSingleShot(true);
+    m_refreshTimer->setInterval(RefreshDelay);
+    connect(m_refreshTimer, SIGNAL(timeout()), this, SLOT(slotRefresh()));
+    connect(m_watcher, SIGNAL(directoryChanged(QString)), this, SLOT(slotWatchedPathChanged(QString)));
+    connect(m_watcher, SIGNAL(fileChanged(QString)), this, SLOT(slotWatchedPathChanged(QString)));
+}
+
+RepositoryStateCache::~RepositoryStateCache()
+{
+    foreach (QProcess *process, m_running.keys()) {
+        process->disconnect(this);
+        process->kill();
+        process->waitForFinished();
+        delete process;
+    }
+}
+
+QStringList RepositoryStateCache::arguments(Query query)
+{
+    QStringList args;
+    switch (query) {
+    case LocalBranches:
+    case RemoteBranches:
+        args << QLatin1String("branch") << QLatin1String(GitClient::noColorOption) << QLatin1String("-v");
+        if (query == RemoteBranches)
+            args << QLatin1String("-r");
+        break;
+    case Head:
+        args << QLatin1String("rev-parse") << QLatin1String("--symbolic-full-name") << QLatin1String("HEAD");
+        break;
+    case Status:
+        args << QLatin1String("status");
+        break;
+    case QueryCount:
+        break;
+    }
+    return args;
+}
+
+int RepositoryStateCache::queryForArguments(const QStringList &args)
+{
+    for (int q = 0; q < QueryCount; q++)
+        if (arguments(Query(q)) == args)
+            return q;
+    return -1;
+}
+
+static bool isReadOnlyCommand(const QStringList &args)
+{
+    if (args.isEmpty())
+        return true;
+    const QString command = args.front();
+    if (command == QLatin1String("branch"))
+        return RepositoryStateCache::queryForArguments(args) != -1;
+    return command == QLatin1String("show") || command == QLatin1String("status")
+           || command == QLatin1String("config") || command == QLatin1String("diff")
+           || command == QLatin1String("log") || command == QLatin1String("blame")
+           || command == QLatin1String("rev-parse") || command == QLatin1String("ls-files");
+}
+
+bool RepositoryStateCache::affectsRefs(const QStringList &args)
+{
+    if (isReadOnlyCommand(args))
+        return false;
+    // Commands that only touch the index and the working tree
+    const QString command = args.front();
+    if (command == QLatin1String("add") || command == QLatin1String("rm")
+        || command == QLatin1String("mv"))
+        return false;
+    if (command == QLatin1String("checkout") || command == QLatin1String("reset"))
+        return !args.contains(QLatin1String("--"));
+    return true;
+}
+
+bool RepositoryStateCache::affectsStatus(const QStringList &args)
+{
+    return !isReadOnlyCommand(args);
+}
+
+QProcess *RepositoryStateCache::runningProcess(const QString &repository, Query query) const
+{
+    QHash<QProcess *, RunningQuery>::const_iterator it;
+    for (it = m_running.constBegin(); it != m_running.constEnd(); ++it)
+        if (it.value().query == query && it.value().repository == repository)
+            return it.key();
+    return 0;
+}
+
+bool RepositoryStateCache::lookup(const QString &repository, Query query,
+                                  QByteArray *output, int *exitCode)
+{
+    QHash<QString, RepositoryState>::iterator it = m_states.find(repository);
+    if (it == m_states.end())
+        return false;
+    Entry &entry = it.value().entries[query];
+    entry.used = true;
+    if (!entry.valid)
+        return false;
+    if (Git::Constants::debug)
+        qDebug() << "RepositoryStateCache: hit" << repository << query;
+    *output = entry.output;
+    if (exitCode)
+        *exitCode = entry.exitCode;
+    return true;
+}
+
+void RepositoryStateCache::store(const QString &repository, Query query,
+                                 const QByteArray &output, int exitCode)
+{
+    watch(repository);
+    setResult(repository, query, output, exitCode);
+}
+
+void RepositoryStateCache::setResult(const QString &repository, Query query,
+                                     const QByteArray &output, int exitCode)
+{
+    RepositoryState &state = m_states[repository];
+    Entry &entry = state.entries[query];
+    entry.output = output;
+    entry.exitCode = exitCode;
+    entry.valid = true;
+    entry.used = true;
+    // 'git status' refreshes the index; that is not a change.
+    if (query == Status)
+        state.index = FileStamp(repository + QLatin1String("/.git/index"));
+}
+
+void RepositoryStateCache::request(const QString &repository, Query query)
+{
+    if (repository.isEmpty() || runningProcess(repository, query))
+        return;
+    watch(repository);
+    Entry &entry = m_states[repository].entries[query];
+    entry.used = true;
+    if (entry.valid)
+        return;
+
+    RunningQuery running;
+    running.repository = repository;
+    running.query = query;
+    running.generation = entry.generation;
+
+    QStringList args = m_client->binary();
+    const QString executable = args.front();
+    args.pop_front();
+    args += arguments(query);
+
+    if (Git::Constants::debug)
+        qDebug() << "RepositoryStateCache: request" << repository << args;
+
+    QProcess *process = new QProcess;
+    process->setWorkingDirectory(repository);
+    process->setEnvironment(m_client->processEnvironment());
+    connect(process, SIGNAL(finished(int,QProcess::ExitStatus)), this, SLOT(slotProcessFinished()));
+    connect(process, SIGNAL(error(QProcess::ProcessError)), this, SLOT(slotProcessError(QProcess::ProcessError)));
+    m_running.insert(process, running);
+    process->start(executable, args);
+    process->closeWriteChannel();
+}
+
+void RepositoryStateCache::slotProcessError(QProcess::ProcessError error)
+{
+    // Crashes and time outs are followed by 'finished'
+    if (error == QProcess::FailedToStart)
+        slotProcessFinished();
+}
+
+void RepositoryStateCache::slotProcessFinished()
+{
+    QProcess *process = qobject_cast<QProcess *>(sender());
+    if (!process || !m_running.contains(process))
+        return;
+    const RunningQuery running = m_running.take(process);
+    const int exitCode = process->exitCode();
+    // git status exits with 1 if there is nothing to commit
+    const bool ok = process->error() != QProcess::FailedToStart
+                    && process->exitStatus() == QProcess::NormalExit
+                    && (exitCode == 0 || (running.query == Status && exitCode == 1));
+    const QByteArray output = ok ? process->readAllStandardOutput() : QByteArray();
+    process->disconnect(this);
+    process->deleteLater();
+
+    QHash<QString, RepositoryState>::iterator it = m_states.find(running.repository);
+    // Discard results of queries that raced with a change
+    if (!ok || it == m_states.end()
+        || it.value().entries[running.query].generation != running.generation)
+        return;
+    setResult(running.repository, running.query, output, exitCode);
+    emit resultAvailable(running.repository, running.query);
+}
+
+void RepositoryStateCache::invalidateQueries(const QString &repository, int firstQuery, int lastQuery)
+{
+    QHash<QString, RepositoryState>::iterator it = m_states.find(repository);
+    if (it == m_states.end())
+        return;
+    RepositoryState &state = it.value();
+    bool wasUsed = false;
+    for (int q = firstQuery; q <= lastQuery; q++) {
+        Entry &entry = state.entries[q];
+        ++entry.generation;
+        entry.valid = false;
+        wasUsed |= entry.used;
+    }
+    if (wasUsed) {
+        m_refreshPending.insert(repository);
+        m_refreshTimer->start();
+    }
+    emit repositoryChanged(repository);
+}
+
+void RepositoryStateCache::invalidate(const QString &repository)
+{
+    invalidateQueries(repository, 0, QueryCount - 1);
+}
+
+void RepositoryStateCache::invalidateStatus(const QString &repository)
+{
+    invalidateQueries(repository, Status, Status);
+}
+
+void RepositoryStateCache::invalidateAllStatus()
+{
+    foreach (const QString &repository, m_states.keys())
+        invalidateStatus(repository);
+}
+
+void RepositoryStateCache::slotRefresh()
+{
+    foreach (const QString &repository, m_refreshPending) {
+        const RepositoryState &state = m_states.value(repository);
+        for (int q = 0; q < QueryCount; q++)
+            if (state.entries[q].used)
+                request(repository, Query(q));
+    }
+    m_refreshPending.clear();
+}
+
+void RepositoryStateCache::slotWatchedPathChanged(const QString &path)
+{
+    const QString repository = m_repositoryForPath.value(path);
+    if (repository.isEmpty())
+        return;
+    if (Git::Constants::debug)
+        qDebug() << "RepositoryStateCache: changed" << path;
+    // Pick up new remotes and directories git may have recreated
+    watch(repository);
+
+    const QString gitDir = repository + QLatin1String("/.git");
+    if (path != gitDir) { // A refs directory
+        invalidate(repository);
+        return;
+    }
+    // Something in .git: find out whether HEAD, the refs or only the index changed
+    RepositoryState &state = m_states[repository];
+    const FileStamp head(gitDir + QLatin1String("/HEAD"));
+    const FileStamp packedRefs(gitDir + QLatin1String("/packed-refs"));
+    const FileStamp index(gitDir + QLatin1String("/index"));
+    const bool refsChanged = head != state.head || packedRefs != state.packedRefs;
+    const bool indexChanged = index != state.index;
+    state.head = head;
+    state.packedRefs = packedRefs;
+    if (refsChanged) {
+        state.index = index;
+        invalidate(repository);
+    } else if (indexChanged && !runningProcess(repository, Status)) {
+        // Index rewrites of a running status are picked up when it finishes
+        state.index = index;
+        invalidateStatus(repository);
+    }
+}
+
+// Watch the .git directory (HEAD, packed-refs and the index are
+// replaced by renaming) and the directories holding branch refs,
+// including the nested ones of branches like "feature/x".
+void RepositoryStateCache::watch(const QString &repository)
+{
+    const QString gitDir = repository + QLatin1String("/.git");
+    if (!m_repositoryForPath.contains(gitDir)) {
+        RepositoryState &state = m_states[repository];
+        state.head = FileStamp(gitDir + QLatin1String("/HEAD"));
+        state.packedRefs = FileStamp(gitDir + QLatin1String("/packed-refs"));
+        state.index = FileStamp(gitDir + QLatin1String("/index"));
+    }
+
+    QStringList paths;
+    paths << gitDir;
+    foreach (const QString &refsDir, QStringList() << QLatin1String("/refs/heads") << QLatin1String("/refs/remotes")) {
+        paths << gitDir + refsDir;
+        QDirIterator it(gitDir + refsDir, QDir::Dirs|QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+        while (it.hasNext())
+            paths << it.next();
+    }
+
+    foreach (const QString &path, paths) {
+        if (m_repositoryForPath.contains(path) || !QFileInfo(path).isDir())
+            continue;
+        m_repositoryForPath.insert(path, repository);
+        m_watcher->addPath(path);
+    }
+}
+
+} // namespace Internal
+} // namespace Git
@@ -0,0 +1,154 @@
+/**************************************************************************
+**
+** This file is part of Qt Creator
+**
+** Copyright (c) 2009 Nokia Corporation and/or its subsidiary(-ies).
+**
+** Contact: Nokia Corporation (qt-info@nokia.com)
+**
+** Commercial Usage
+**
+** Licensees holding valid Qt Commercial licenses may use this file in
+** accordance with the Qt Commercial License Agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Nokia.
+**
+** GNU Lesser General Public License Usage
+**
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** If you are unsure which license is appropriate for your use, please
+** contact the sales department at http://qt.nokia.com/contact.
+**
+**************************************************************************/
+
+
+#ifndef REPOSITORYSTATECACHE_H
+#define REPOSITORYSTATECACHE_H
+
+#include <QtCore/QObject>
+#include <QtCore/QDateTime>
+#include <QtCore/QHash>
+#include <QtCore/QProcess>
+#include <QtCore/QSet>
+#include <QtCore/QStringList>
+
+QT_BEGIN_NAMESPACE
+class QFileSystemWatcher;
+class QTimer;
+QT_END_NAMESPACE
+
+namespace Git {
+namespace Internal {
+
+class GitClient;
+
+/* Caches the output of read-only git queries the UI runs frequently
+ * (local and remote branch lists, the symbolic name of HEAD and 'git status')
+ * per repository, so that menus and the branch dialog do not have to wait
+ * for a git process.
+ * Lookups never block: on a miss, the query is started in the background and
+ * resultAvailable() is emitted once its output is cached.
+ * The .git directory and the refs directories are watched. A change of HEAD
+ * or the refs invalidates everything, a change of the index invalidates only
+ * the status (rewrites of the index by our own status runs are ignored).
+ * The working tree is not watched; owners invalidate the status when files
+ * are saved or the application is reactivated. The cached status is therefore
+ * only a hint for the UI; operations acting on it run git themselves.
+ * Queries that were in use are re-run in the background after an
+ * invalidation, and concurrent requests for the same query share one
+ * git process. */
+
+class RepositoryStateCache : public QObject
+{
+    Q_OBJECT
+public:
+    enum Query { LocalBranches, RemoteBranches, Head, Status, QueryCount };
+
+    explicit RepositoryStateCache(GitClient *client, QObject *parent = 0);
+    ~RepositoryStateCache();
+
+    // Full git arguments of a query ("branch --no-color -v ...")
+    static QStringList arguments(Query query);
+    // Query matching the git arguments or -1 if they are not cached.
+    static int queryForArguments(const QStringList &arguments);
+    // Queries whose output may change when a command with these arguments runs
+    static bool affectsRefs(const QStringList &arguments);
+    static bool affectsStatus(const QStringList &arguments);
+
+    // Return the cached output and exit code. Does not wait or start a query.
+    bool lookup(const QString &repository, Query query, QByteArray *output, int *exitCode = 0);
+    void store(const QString &repository, Query query, const QByteArray &output, int exitCode = 0);
+
+    // Start an asynchronous query unless it is cached or already running.
+    void request(const QString &repository, Query query);
+
+public slots:
+    void invalidate(const QString &repository);
+    void invalidateStatus(const QString &repository);
+    void invalidateAllStatus();
+
+signals:
+    void resultAvailable(const QString &repository, int query);
+    void repositoryChanged(const QString &repository);
+
+private slots:
+    void slotWatchedPathChanged(const QString &path);
+    void slotProcessFinished();
+    void slotProcessError(QProcess::ProcessError error);
+    void slotRefresh();
+
+private:
+    struct Entry {
+        Entry() : exitCode(0), generation(0), valid(false), used(false) {}
+        QByteArray output;
+        int exitCode;
+        int generation;
+        bool valid;
+        bool used; // re-run in the background after invalidation
+    };
+    // Modification time and size of a file in .git
+    struct FileStamp {
+        FileStamp() : size(-1) {}
+        explicit FileStamp(const QString &fileName);
+        bool operator==(const FileStamp &other) const
+            { return size == other.size && modified == other.modified; }
+        bool operator!=(const FileStamp &other) const { return !(*this == other); }
+        QDateTime modified;
+        qint64 size;
+    };
+    struct RepositoryState {
+        Entry entries[QueryCount];
+        FileStamp head;
+        FileStamp packedRefs;
+        FileStamp index;
+    };
+    struct RunningQuery {
+        QString repository;
+        Query query;
+        int generation;
+    };
+
+    void invalidateQueries(const QString &repository, int firstQuery, int lastQuery);
+    void setResult(const QString &repository, Query query, const QByteArray &output, int exitCode);
+    void watch(const QString &repository);
+    QProcess *runningProcess(const QString &repository, Query query) const;
+
+    GitClient *m_client;
+    QHash<QString, RepositoryState> m_states;
+    QHash<QProcess *, RunningQuery> m_running;
+    QFileSystemWatcher *m_watcher;
+    QHash<QString, QString> m_repositoryForPath;
+    QSet<QString> m_refreshPending;
+    QTimer *m_refreshTimer;
+};
+
+} // namespace Internal
+} // namespace Git
+
+#endif // REPOSITORYSTATECACHE_H
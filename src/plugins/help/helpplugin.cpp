@@ -567,9 +567,15 @@ void HelpPlugin::slotHideRightPane()
 void HelpPlugin::extensionsInitialized()
 {
     m_sideBar->readSettings(m_core->settings());
+}
+
+// Registering the documentation opens the help collection and is not needed
+// before the main window is shown
+bool HelpPlugin::delayedInitialize()
+{
     if (!m_helpEngine->setupData()) {
         qWarning() << "Could not initialize help engine: " << m_helpEngine->error();
-        return;
+        return true;
     }
 
     bool assistantInternalDocRegistered = false;
@@ -671,6 +677,7 @@ void HelpPlugin::extensionsInitialized()
             "index.html").arg(IDE_VERSION_MAJOR).arg(IDE_VERSION_MINOR));
     }
     m_helpEngine->setCustomValue(QLatin1String("DefaultHomePage"), url.toString());
+    return true;
 }
 
 void HelpPlugin::shutdown()
@@ -105,6 +105,7 @@ public:
 
     bool initialize(const QStringList &arguments, QString *error_message);
     void extensionsInitialized();
+    bool delayedInitialize();
     void shutdown();
 
     // Necessary to get the unfiltered list in the help index filter
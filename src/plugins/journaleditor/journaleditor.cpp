@@ -9,7 +9,7 @@
 using namespace JOURNALEditor;
 
 JournalEditor::JournalEditor(QWidget* parent, const char* name, Qt::WindowFlags fl)
-    : QMainWindow(parent, fl)
+    : QMainWindow(parent, fl), item(0), docs(0), m_ieditor(0)
 {
     setupUi(this);
     //(void)statusBar();
@@ -21,6 +21,8 @@ JournalEditor::JournalEditor(QWidget* parent, const char* name, Qt::WindowFlags
  */
 JournalEditor::~JournalEditor()
 {
+    if (m_ieditor)
+        disconnect(m_ieditor, 0, this, 0);
     destroy();
     // no need to delete child widgets, Qt does it all for us
 }
@@ -34,8 +36,29 @@ void JournalEditor::languageChange()
     retranslateUi(this);
 }
 
+/*
+ * The editor manager deletes the interface when the editor is closed,
+ * that is when the changes are written to the configuration.
+ */
+void JournalEditor::setEditorInterface(Core::IEditor *ieditor)
+{
+    if (m_ieditor)
+        disconnect(m_ieditor, 0, this, 0);
+    m_ieditor = ieditor;
+    if (m_ieditor)
+        connect(m_ieditor, SIGNAL(destroyed()), this, SLOT(editorClosed()));
+}
+
+void JournalEditor::editorClosed()
+{
+    m_ieditor = 0;
+    updateMD();
+}
+
 void JournalEditor::setData( DomCfgItem *o )
 {
+     if (docs)
+         disconnect(docs, 0, this, 0);
      item = o;
 
      setWindowTitle( tr("Journal:") + item->attr( mda_name ) );
@@ -51,6 +74,51 @@ connect(bMoveUp,SIGNAL(clicked()),this,SLOT(moveUp()));
 connect(bMoveDown,SIGNAL(clicked()),this,SLOT(moveDown()));
 
 GetAllDocsList();
+
+// The list follows the documents row by row from now on
+if (docs) {
+    connect(docs, SIGNAL(childInserted(int)), this, SLOT(docInserted(int)));
+    connect(docs, SIGNAL(childRemoved(int)), this, SLOT(docRemoved(int)));
+    connect(docs, SIGNAL(childChanged(int)), this, SLOT(docChanged(int)));
+    connect(docs, SIGNAL(childrenSwapped(int,int)), this, SLOT(docsSwapped(int,int)));
+}
+}
+
+void JournalEditor::docInserted(int row)
+{
+    DomCfgItem *document = docs->child(row);
+    if (!document)
+        return;
+    row = qMin(row, allDocs->rowCount());
+    allDocs->insertRow(row);
+    allDocs->setItem(row, 0, new QTableWidgetItem(document->attr(mda_name)));
+    allDocs->setRowHeight(row, 20);
+}
+
+void JournalEditor::docRemoved(int row)
+{
+    if (row < allDocs->rowCount())
+        allDocs->removeRow(row);
+}
+
+void JournalEditor::docChanged(int row)
+{
+    DomCfgItem *document = docs->child(row);
+    if (!document || row >= allDocs->rowCount())
+        return;
+    if (QTableWidgetItem *tableItem = allDocs->item(row, 0))
+        tableItem->setText(document->attr(mda_name));
+    else
+        allDocs->setItem(row, 0, new QTableWidgetItem(document->attr(mda_name)));
+}
+
+void JournalEditor::docsSwapped(int row, int otherRow)
+{
+    if (row >= allDocs->rowCount() || otherRow >= allDocs->rowCount())
+        return;
+    QTableWidgetItem *tableItem = allDocs->takeItem(row, 0);
+    allDocs->setItem(row, 0, allDocs->takeItem(otherRow, 0));
+    allDocs->setItem(otherRow, 0, tableItem);
 }
 
 //void JournalEditor::doubleClickedElement ( int row, int ) {
@@ -181,17 +249,9 @@ void JournalEditor::init()
 }
 
 
-void JournalEditor::updateMD(QList<Core::IEditor*> editor)
+void JournalEditor::updateMD()
 {
-  bool findWidget = false;
-  foreach (Core::IEditor* ed, editor)
-  {
-      if (ed->widget()==this) {
-          findWidget=true;
-          break;
-      }
-  }
-  if (findWidget==false)
+  if (!item)
       return;
 
         item->setAttr( mda_name, eName->text().trimmed() );
@@ -38,11 +38,11 @@ public:
     bool isModified() const;
     void GetAllDocsList();
     Core::IEditor *editorInterface() const { return m_ieditor; }
-    void setEditorInterface(Core::IEditor *ieditor) { m_ieditor = ieditor; }
+    void setEditorInterface(Core::IEditor *ieditor);
     Q_INVOKABLE void setData( DomCfgItem * o );
 public slots:
     //virtual void setData( DomCfgItem * o );
-    virtual void updateMD(QList<Core::IEditor*> editor);
+    virtual void updateMD();
     virtual void eSv_activated( int index );
     virtual void eSvG_activated( int index );
 
@@ -62,7 +62,11 @@ private slots:
     void removeDoc();
     void moveUp();
     void moveDown();
-
+    void editorClosed();
+    void docInserted(int row);
+    void docRemoved(int row);
+    void docChanged(int row);
+    void docsSwapped(int row, int otherRow);
 };
 }
 
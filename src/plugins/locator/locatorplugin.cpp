@@ -121,8 +121,6 @@ bool LocatorPlugin::initialize(const QStringList &, QString *)
     addObject(m_fileSystemFilter);
 
     addAutoReleasedObject(new LocatorFiltersFilter(this, m_locatorWidget));
-
-    connect(core, SIGNAL(coreOpened()), this, SLOT(startSettingsLoad()));
     return true;
 }
 
@@ -137,6 +135,12 @@ void LocatorPlugin::extensionsInitialized()
     qSort(m_filters.begin(), m_filters.end(), filterLessThan);
 }
 
+bool LocatorPlugin::delayedInitialize()
+{
+    startSettingsLoad();
+    return true;
+}
+
 void LocatorPlugin::startSettingsLoad()
 {
     m_loadWatcher.setFuture(QtConcurrent::run(this, &LocatorPlugin::loadSettings));
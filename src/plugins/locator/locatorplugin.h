@@ -58,6 +58,7 @@ public:
 
     bool initialize(const QStringList &arguments, QString *error_message);
     void extensionsInitialized();
+    bool delayedInitialize();
 
     QList<ILocatorFilter*> filters();
     QList<ILocatorFilter*> customFilters();
@@ -139,6 +139,9 @@ void AbstractProcessStep::run(QFutureInterface<bool> & fi)
     if (!wd.exists())
         wd.mkpath(wd.absolutePath());
 
+    m_stdOutBuffer.clear();
+    m_stdErrBuffer.clear();
+
     m_process = new QProcess();
     m_process->setWorkingDirectory(m_workingDirectory);
     m_process->setEnvironment(m_environment.toStringList());
@@ -206,10 +209,38 @@ void AbstractProcessStep::processStartupFailed()
 
 void AbstractProcessStep::processReadyReadStdOutput()
 {
-    m_process->setReadChannel(QProcess::StandardOutput);
-    while (m_process->canReadLine()) {
-        QString line = QString::fromLocal8Bit(m_process->readLine()).trimmed();
-        stdOut(line);
+    m_stdOutBuffer += m_process->readAllStandardOutput();
+    processBufferedOutput(m_stdOutBuffer, false, false);
+}
+
+/*
+  Output is read in whatever chunks the process delivers and decoded once per
+  chunk. Only complete lines are handed out; an incomplete trailing line stays
+  in the buffer until more data arrives or \a flush is set.
+*/
+void AbstractProcessStep::processBufferedOutput(QByteArray &buffer, bool isStdError, bool flush)
+{
+    int length = buffer.lastIndexOf('\n') + 1;
+    if (flush)
+        length = buffer.size();
+    if (length == 0)
+        return;
+
+    const QString text = QString::fromLocal8Bit(buffer.constData(), length);
+    buffer.remove(0, length);
+
+    const int size = text.size();
+    int start = 0;
+    while (start < size) {
+        int end = text.indexOf(QLatin1Char('\n'), start);
+        if (end == -1)
+            end = size;
+        const QString line = text.mid(start, end - start).trimmed();
+        if (isStdError)
+            stdError(line);
+        else
+            stdOut(line);
+        start = end + 1;
     }
 }
 
@@ -220,11 +251,8 @@ void AbstractProcessStep::stdOut(const QString &line)
 
 void AbstractProcessStep::processReadyReadStdError()
 {
-    m_process->setReadChannel(QProcess::StandardError);
-    while (m_process->canReadLine()) {
-        QString line = QString::fromLocal8Bit(m_process->readLine()).trimmed();
-        stdError(line);
-    }
+    m_stdErrBuffer += m_process->readAllStandardError();
+    processBufferedOutput(m_stdErrBuffer, true, false);
 }
 
 void AbstractProcessStep::stdError(const QString &line)
@@ -244,13 +272,11 @@ void AbstractProcessStep::checkForCancel()
 
 void AbstractProcessStep::slotProcessFinished(int, QProcess::ExitStatus)
 {
-    QString line = QString::fromLocal8Bit(m_process->readAllStandardError()).trimmed();
-    if (!line.isEmpty())
-        stdOut(line);
+    m_stdErrBuffer += m_process->readAllStandardError();
+    processBufferedOutput(m_stdErrBuffer, true, true);
 
-    line = QString::fromLocal8Bit(m_process->readAllStandardOutput()).trimmed();
-    if (!line.isEmpty())
-        stdError(line);
+    m_stdOutBuffer += m_process->readAllStandardOutput();
+    processBufferedOutput(m_stdOutBuffer, false, true);
 
     m_eventLoop->exit(0);
 }
@@ -33,6 +33,7 @@
 #include "buildstep.h"
 #include "environment.h"
 
+#include <QtCore/QByteArray>
 #include <QtCore/QString>
 #include <QtCore/QProcess>
 
@@ -130,6 +131,7 @@ private slots:
     void slotProcessFinished(int, QProcess::ExitStatus);
     void checkForCancel();
 private:
+    void processBufferedOutput(QByteArray &buffer, bool isStdError, bool flush);
 
     QTimer *m_timer;
     QFutureInterface<bool> *m_futureInterface;
@@ -141,6 +143,8 @@ private:
     QProcess *m_process;
     QEventLoop *m_eventLoop;
     ProjectExplorer::Environment m_environment;
+    QByteArray m_stdOutBuffer;
+    QByteArray m_stdErrBuffer;
 };
 
 } // namespace ProjectExplorer
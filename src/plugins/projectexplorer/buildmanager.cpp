@@ -56,6 +56,8 @@
 using namespace ProjectExplorer;
 using namespace ProjectExplorer::Internal;
 
+static const int TaskFlushInterval = 100; // ms
+
 static inline QString msgProgress(int n, int total)
 {
     return BuildManager::tr("Finished %n of %1 build steps", 0, n).arg(total);
@@ -89,6 +91,12 @@ BuildManager::BuildManager(ProjectExplorerPlugin *parent)
     connect(m_taskWindow, SIGNAL(tasksChanged()),
             this, SIGNAL(tasksChanged()));
 
+    m_taskFlushTimer = new QTimer(this);
+    m_taskFlushTimer->setSingleShot(true);
+    m_taskFlushTimer->setInterval(TaskFlushInterval);
+    connect(m_taskFlushTimer, SIGNAL(timeout()),
+            this, SLOT(flushTasks()));
+
     connect(&m_progressWatcher, SIGNAL(canceled()),
             this, SLOT(cancel()));
 }
@@ -128,6 +136,7 @@ void BuildManager::cancel()
                    this, SLOT(addToTaskWindow(QString, int, int, QString)));
         disconnect(m_currentBuildStep, SIGNAL(addToOutputWindow(QString)),
                    this, SLOT(addToOutputWindow(QString)));
+        flushTasks();
         decrementActiveBuildSteps(m_currentBuildStep->project());
 
         m_progressFutureInterface->setProgressValueAndText(m_progress*100, "Build canceled"); //TODO NBS fix in qtconcurrent
@@ -177,9 +186,16 @@ void BuildManager::toggleTaskWindow()
     m_taskWindow->toggle(false);
 }
 
+// Build issues only, tasks added with a category are not build results.
 bool BuildManager::tasksAvailable() const
 {
-    return m_taskWindow->numberOfTasks() > 0;
+    if (m_taskWindow->numberOfTasks(QString()) > 0)
+        return true;
+    foreach (const TaskItem &task, m_pendingTasks) {
+        if (task.category.isEmpty())
+            return true;
+    }
+    return false;
 }
 
 void BuildManager::gotoTaskWindow()
@@ -210,7 +226,7 @@ void BuildManager::startBuildQueue()
         m_canceling = false;
         m_progressFutureInterface->reportStarted();
         m_outputWindow->clearContents();
-        m_taskWindow->clearContents();
+        clearTasks(QString());
         nextStep();
     } else {
         // Already running
@@ -221,7 +237,8 @@ void BuildManager::startBuildQueue()
 
 void BuildManager::showBuildResults()
 {
-    if (m_taskWindow->numberOfTasks() != 0)
+    flushTasks();
+    if (m_taskWindow->numberOfTasks(QString()) != 0)
         toggleTaskWindow();
     else
         toggleOutputWindow();
@@ -230,7 +247,51 @@ void BuildManager::showBuildResults()
 
 void BuildManager::addToTaskWindow(const QString &file, int type, int line, const QString &description)
 {
-    m_taskWindow->addItem(BuildParserInterface::PatternType(type), description, file, line);
+    TaskItem task;
+    task.description = description;
+    task.file = file;
+    task.line = line;
+    task.type = BuildParserInterface::PatternType(type);
+    task.fileNotFound = false;
+    m_pendingTasks.append(task);
+    if (!m_taskFlushTimer->isActive())
+        m_taskFlushTimer->start();
+}
+
+void BuildManager::addTask(const QString &category, const QString &file, int type, int line, const QString &description)
+{
+    TaskItem task;
+    task.description = description;
+    task.file = file;
+    task.line = line;
+    task.type = BuildParserInterface::PatternType(type);
+    task.fileNotFound = false;
+    task.category = category;
+    m_pendingTasks.append(task);
+    if (!m_taskFlushTimer->isActive())
+        m_taskFlushTimer->start();
+}
+
+void BuildManager::clearTasks(const QString &category)
+{
+    QList<TaskItem>::iterator it = m_pendingTasks.begin();
+    while (it != m_pendingTasks.end()) {
+        if (it->category == category)
+            it = m_pendingTasks.erase(it);
+        else
+            ++it;
+    }
+    m_taskWindow->removeItems(category);
+}
+
+void BuildManager::flushTasks()
+{
+    m_taskFlushTimer->stop();
+    if (m_pendingTasks.isEmpty())
+        return;
+    const QList<TaskItem> tasks = m_pendingTasks;
+    m_pendingTasks.clear();
+    m_taskWindow->addItems(tasks);
 }
 
 void BuildManager::addToOutputWindow(const QString &string)
@@ -247,6 +308,7 @@ void BuildManager::nextBuildQueue()
                 this, SLOT(addToTaskWindow(QString, int, int, QString)));
     disconnect(m_currentBuildStep, SIGNAL(addToOutputWindow(QString)),
                this, SLOT(addToOutputWindow(QString)));
+    flushTasks();
 
     ++m_progress;
     m_progressFutureInterface->setProgressValueAndText(m_progress*100, msgProgress(m_progress, m_maxProgress));
@@ -38,12 +38,17 @@
 #include <QtCore/QHash>
 #include <QtCore/QFutureWatcher>
 
+QT_BEGIN_NAMESPACE
+class QTimer;
+QT_END_NAMESPACE
+
 namespace ProjectExplorer {
 
 namespace Internal {
     class CompileOutputWindow;
     class TaskWindow;
     class BuildProgressFuture;
+    struct TaskItem;
 }
 
 class BuildStep;
@@ -79,6 +84,11 @@ public:
     // Append any build step to the list of build steps (currently only used to add the QMakeStep)
     void appendStep(BuildStep *step, const QString& configuration);
 
+    // Tasks reported outside of a build, e.g. by a validator. They are kept
+    // by category and are not cleared when a build starts.
+    void addTask(const QString &category, const QString &file, int type, int line, const QString &description);
+    void clearTasks(const QString &category);
+
 public slots:
     void cancel();
     // Shows without focus
@@ -94,6 +104,7 @@ signals:
 private slots:
     void addToTaskWindow(const QString &file, int type, int line, const QString &description);
     void addToOutputWindow(const QString &string);
+    void flushTasks();
 
     void nextBuildQueue();
     void progressChanged();
@@ -110,6 +121,9 @@ private:
 
     Internal::CompileOutputWindow *m_outputWindow;
     Internal::TaskWindow *m_taskWindow;
+    // Tasks reported by the running build step, handed to the task window in batches
+    QList<Internal::TaskItem> m_pendingTasks;
+    QTimer *m_taskFlushTimer;
 
     QList<BuildStep *> m_buildQueue;
     QStringList m_configurations; // the corresponding configuration to the m_buildQueue
@@ -82,12 +82,13 @@ void BuildProgress::updateState()
 {
     if (!m_taskWindow)
         return;
-    int errors = m_taskWindow->numberOfErrors();
+    // Only build issues, not those reported by e.g. validators
+    int errors = m_taskWindow->numberOfErrors(QString());
     bool haveErrors = (errors > 0);
     m_errorIcon->setEnabled(haveErrors);
     m_errorLabel->setEnabled(haveErrors);
     m_errorLabel->setText(QString("%1").arg(errors));
-    int warnings = m_taskWindow->numberOfTasks()-errors;
+    int warnings = m_taskWindow->numberOfTasks(QString())-errors;
     bool haveWarnings = (warnings > 0);
     m_warningIcon->setEnabled(haveWarnings);
     m_warningLabel->setEnabled(haveWarnings);
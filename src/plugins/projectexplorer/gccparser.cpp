@@ -34,6 +34,20 @@
 
 using namespace ProjectExplorer;
 
+// All diagnostics matched in stdError() contain a colon followed by white
+// space, or an "In file included from" continuation. Checking for that first
+// keeps the regular expressions off the bulk of the compiler output.
+static inline bool mightBeDiagnostic(const QString &line)
+{
+    const int size = line.size();
+    const QChar *data = line.constData();
+    for (int i = 0; i < size - 1; ++i) {
+        if (data[i] == QLatin1Char(':') && data[i + 1].isSpace())
+            return true;
+    }
+    return line.contains(QLatin1String("from ")) || line.startsWith(QLatin1String("collect2:"));
+}
+
 GccParser::GccParser()
 {
     m_regExp.setPattern("^([^\\(\\)]+[^\\d]):(\\d+):(\\d+:)*(\\s(warning|error):)?\\s(.+)$");
@@ -58,6 +72,8 @@ QString GccParser::name() const
 void GccParser::stdOutput(const QString & line)
 {
     QString lne = line.trimmed();
+    if (!lne.contains(QLatin1String(" directory ")))
+        return;
 
     if (m_makeDir.indexIn(lne) > -1) {
         if (m_makeDir.cap(1) == "Leaving")
@@ -70,7 +86,10 @@ void GccParser::stdOutput(const QString & line)
 void GccParser::stdError(const QString & line)
 {
     QString lne = line.trimmed();
-     if (m_regExpLinker.indexIn(lne) > -1) {
+    if (!mightBeDiagnostic(lne))
+        return;
+
+    if (m_regExpLinker.indexIn(lne) > -1) {
         QString description = m_regExpLinker.cap(2);
         emit addToTaskWindow(
             m_regExpLinker.cap(1), //filename
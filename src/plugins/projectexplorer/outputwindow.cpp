@@ -28,16 +28,24 @@
 **************************************************************************/
 
 #include "outputwindow.h"
+#include "projectexplorer.h"
 #include "projectexplorerconstants.h"
+#include "projectexplorersettings.h"
 #include "runconfiguration.h"
 
 #include <coreplugin/actionmanager/actionmanager.h>
 #include <coreplugin/coreconstants.h>
+#include <coreplugin/editormanager/editormanager.h>
 #include <coreplugin/icore.h>
 #include <coreplugin/uniqueidmanager.h>
 #include <find/basetextfind.h>
 #include <aggregation/aggregate.h>
 
+#include <QtCore/QDir>
+#include <QtCore/QTemporaryFile>
+#include <QtCore/QTextStream>
+#include <QtCore/QTimerEvent>
+
 #include <QtGui/QIcon>
 #include <QtGui/QScrollBar>
 #include <QtGui/QTextLayout>
@@ -55,6 +63,8 @@ using namespace ProjectExplorer::Internal;
 using namespace ProjectExplorer;
 
 static const int MaxBlockCount = 100000;
+static const int MaxQueuedChars = 1024 * 1024;
+static const int FlushInterval = 40; // ms
 
 OutputPane::OutputPane()
     : m_mainWidget(new QWidget)
@@ -200,6 +210,7 @@ void OutputPane::createNewOutputWindow(RunControl *rc)
             m_outputWindows.remove(old);
             OutputWindow *ow = static_cast<OutputWindow *>(m_tabWidget->widget(i));
             ow->appendOutput("");//New line
+            ow->setSpillToDisk(ProjectExplorerPlugin::instance()->projectExplorerSettings().spillOutputToDisk);
             m_outputWindows.insert(rc, ow);
             found = true;
             break;
@@ -207,6 +218,7 @@ void OutputPane::createNewOutputWindow(RunControl *rc)
     }
     if (!found) {
         OutputWindow *ow = new OutputWindow(m_tabWidget);
+        ow->setSpillToDisk(ProjectExplorerPlugin::instance()->projectExplorerSettings().spillOutputToDisk);
         Aggregation::Aggregate *agg = new Aggregation::Aggregate;
         agg->add(ow);
         agg->add(new Find::BaseTextFind(ow));
@@ -337,19 +349,31 @@ bool OutputPane::canNavigate()
 /*******************/
 
 OutputWindow::OutputWindow(QWidget *parent)
-    : QPlainTextEdit(parent)
+    : QPlainTextEdit(parent),
+      m_outputWindowContext(0),
+      m_queuedLines(0),
+      m_spillFile(0),
+      m_spillStream(0)
 {
     m_enforceNewline = false;
     m_scrollToBottom = false;
 
+    // The document acts as a ring buffer of lines; undo would keep every
+    // line that was ever appended alive.
+    setUndoRedoEnabled(false);
+    setMaximumBlockCount(MaxBlockCount);
+
     setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOn);
     //setCenterOnScroll(false);
     setWindowTitle(tr("Application Output Window"));
     setWindowIcon(QIcon(":/qt4projectmanager/images/window.png"));
     setFrameShape(QFrame::NoFrame);
 
-    static uint usedIds = 0;
     Core::ICore *core = Core::ICore::instance();
+    if (!core) // Standalone, e.g. in the output benchmark
+        return;
+
+    static uint usedIds = 0;
     QList<int> context;
     context << core->uniqueIDManager()->uniqueIdentifier(QString(Constants::C_APP_OUTPUT) + QString().setNum(usedIds++));
     m_outputWindowContext = new Core::BaseContext(this, context);
@@ -389,12 +413,16 @@ OutputWindow::OutputWindow(QWidget *parent)
 
 OutputWindow::~OutputWindow()
 {
-    Core::ICore::instance()->removeContextObject(m_outputWindowContext);
-    delete m_outputWindowContext;
+    if (m_outputWindowContext) {
+        Core::ICore::instance()->removeContextObject(m_outputWindowContext);
+        delete m_outputWindowContext;
+    }
+    setSpillToDisk(false);
 }
 
 void OutputWindow::showEvent(QShowEvent *e)
 {
+    flushQueuedOutput();
     QPlainTextEdit::showEvent(e);
     if (m_scrollToBottom) {
         verticalScrollBar()->setValue(verticalScrollBar()->maximum());
@@ -406,59 +434,169 @@ void OutputWindow::appendOutput(const QString &out)
 {
     m_scrollToBottom = true;
     QString s = out;
+    if (s.endsWith(QLatin1Char('\n')))
+        s.chop(1);
+    startNewLine();
+    queueText(s);
     m_enforceNewline = true; // make appendOutputInline put in a newline next time
+}
+
+void OutputWindow::appendOutputInline(const QString &out)
+{
+    m_scrollToBottom = true;
+    if (m_enforceNewline)
+        startNewLine();
+    m_enforceNewline = false;
+
+    QString s = out;
     if (s.endsWith(QLatin1Char('\n'))) {
+        m_enforceNewline = true;
         s.chop(1);
     }
-    setMaximumBlockCount(MaxBlockCount);
-    appendPlainText(out);
-    enableUndoRedo();
+    queueText(s);
 }
 
-
-void OutputWindow::appendOutputInline(const QString &out)
+void OutputWindow::insertLine()
 {
     m_scrollToBottom = true;
-    setMaximumBlockCount(MaxBlockCount);
+    startNewLine();
+}
 
-    int newline = -1;
-    bool enforceNewline = m_enforceNewline;
+void OutputWindow::clear()
+{
+    m_flushTimer.stop();
+    m_queuedOutput.clear();
+    m_queuedLines = 0;
     m_enforceNewline = false;
+    QPlainTextEdit::clear();
+    if (spillToDisk()) {
+        setSpillToDisk(false);
+        setSpillToDisk(true);
+    }
+}
+
+void OutputWindow::startNewLine()
+{
+    // Same semantics as appendPlainText(): a new paragraph, unless there is nothing yet
+    if (!m_queuedOutput.isEmpty() || !document()->isEmpty())
+        queueText(QString(QLatin1Char('\n')));
+}
+
+void OutputWindow::queueText(const QString &text)
+{
+    if (text.isEmpty())
+        return;
+    m_queuedOutput += text;
+    m_queuedLines += text.count(QLatin1Char('\n'));
+
+    if (m_queuedOutput.size() >= MaxQueuedChars)
+        flushQueuedOutput();
+    else if (!m_flushTimer.isActive())
+        m_flushTimer.start(FlushInterval, this);
+}
+
+void OutputWindow::flushQueuedOutput()
+{
+    m_flushTimer.stop();
+    if (m_queuedOutput.isEmpty())
+        return;
 
-    if (!enforceNewline) {
-        newline = out.indexOf(QLatin1Char('\n'));
-        moveCursor(QTextCursor::End);
-        bool atBottom = (blockBoundingRect(document()->lastBlock()).bottom() + contentOffset().y()
-                         <= viewport()->rect().bottom());
-        insertPlainText(newline < 0 ? out : out.left(newline)); // doesn't enforce new paragraph like appendPlainText
-        if (atBottom)
-            verticalScrollBar()->setValue(verticalScrollBar()->maximum());
+    QString text = m_queuedOutput;
+    m_queuedOutput.clear();
+    spill(text);
+
+    if (m_queuedLines >= MaxBlockCount) {
+        // The batch alone fills the buffer, so the current contents and the
+        // head of the batch would be dropped right after being laid out.
+        int skip = m_queuedLines - MaxBlockCount + 1;
+        int pos = -1;
+        while (skip--)
+            pos = text.indexOf(QLatin1Char('\n'), pos + 1);
+        text.remove(0, pos + 1);
+        QPlainTextEdit::clear();
     }
+    m_queuedLines = 0;
 
-    QString s = out.mid(newline+1);
-    if (s.isEmpty()) {
-        m_enforceNewline = true;
-    } else {
-        if (s.endsWith(QLatin1Char('\n'))) {
-            m_enforceNewline = true;
-            s.chop(1);
+    QScrollBar *scrollBar = verticalScrollBar();
+    const bool atBottom = scrollBar->value() >= scrollBar->maximum();
+
+    QTextCursor cursor(document());
+    cursor.movePosition(QTextCursor::End);
+    cursor.beginEditBlock();
+    cursor.insertText(text);
+    cursor.endEditBlock();
+
+    if (atBottom)
+        scrollBar->setValue(scrollBar->maximum());
+}
+
+void OutputWindow::timerEvent(QTimerEvent *e)
+{
+    if (e->timerId() == m_flushTimer.timerId())
+        flushQueuedOutput();
+    else
+        QPlainTextEdit::timerEvent(e);
+}
+
+void OutputWindow::setSpillToDisk(bool spill)
+{
+    if (spill == spillToDisk())
+        return;
+
+    if (spill) {
+        m_spillFile = new QTemporaryFile(QDir::tempPath() + QLatin1String("/qtcreator-output-XXXXXX"));
+        if (!m_spillFile->open()) {
+            qWarning("Unable to create output spill file: %s", qPrintable(m_spillFile->errorString()));
+            delete m_spillFile;
+            m_spillFile = 0;
+            return;
         }
-        appendPlainText(s);
+        m_spillStream = new QTextStream(m_spillFile);
+        m_spillStream->setCodec("UTF-8");
+        // Keep the file consistent with what is already shown
+        *m_spillStream << toPlainText();
+    } else {
+        delete m_spillStream;
+        m_spillStream = 0;
+        delete m_spillFile;
+        m_spillFile = 0;
     }
+}
 
-    enableUndoRedo();
+bool OutputWindow::spillToDisk() const
+{
+    return m_spillFile != 0;
 }
 
-void OutputWindow::insertLine()
+QString OutputWindow::spillFileName() const
 {
-    m_scrollToBottom = true;
-    setMaximumBlockCount(MaxBlockCount);
-    appendPlainText(QString());
-    enableUndoRedo();
+    return m_spillFile ? m_spillFile->fileName() : QString();
 }
 
-void OutputWindow::enableUndoRedo()
+void OutputWindow::spill(const QString &text)
 {
-    setMaximumBlockCount(0);
-    setUndoRedoEnabled(true);
+    if (m_spillStream)
+        *m_spillStream << text;
+}
+
+void OutputWindow::openSpillFile()
+{
+    if (!m_spillStream)
+        return;
+    flushQueuedOutput();
+    m_spillStream->flush();
+    Core::EditorManager *em = Core::EditorManager::instance();
+    em->openEditor(spillFileName());
+    em->ensureEditorManagerVisible();
+}
+
+void OutputWindow::contextMenuEvent(QContextMenuEvent *e)
+{
+    QMenu *menu = createStandardContextMenu();
+    if (spillToDisk()) {
+        menu->addSeparator();
+        menu->addAction(tr("Open Complete Output"), this, SLOT(openSpillFile()));
+    }
+    menu->exec(e->globalPos());
+    delete menu;
 }
@@ -42,6 +42,8 @@
 
 QT_BEGIN_NAMESPACE
 class QTabWidget;
+class QTemporaryFile;
+class QTextStream;
 QT_END_NAMESPACE
 
 namespace ProjectExplorer {
@@ -114,6 +116,14 @@ private:
 };
 
 
+/* The application output is kept in a bounded document: at most
+ * MaxBlockCount lines are retained, older lines are dropped from the top.
+ * Appends are queued and flushed in one edit block on a short timer, so a
+ * process writing many small chunks costs one layout pass per flush instead
+ * of one per chunk. There is no undo stack.
+ * With spilling enabled, everything that was ever flushed is also written to
+ * a temporary file, which can be opened in an editor to search the complete
+ * output of long runs. */
 class OutputWindow : public QPlainTextEdit
 {
     Q_OBJECT
@@ -126,13 +136,36 @@ public:
     void appendOutputInline(const QString &out);
     void insertLine();
 
+    void setSpillToDisk(bool spill);
+    bool spillToDisk() const;
+    QString spillFileName() const;
+
     void showEvent(QShowEvent *);
 
+public slots:
+    void clear();
+    void flushQueuedOutput();
+
+private slots:
+    void openSpillFile();
+
+protected:
+    void timerEvent(QTimerEvent *e);
+    void contextMenuEvent(QContextMenuEvent *e);
+
 private:
+    void queueText(const QString &text);
+    void startNewLine();
+    void spill(const QString &text);
+
     Core::BaseContext *m_outputWindowContext;
-    void enableUndoRedo();
     bool m_enforceNewline;
     bool m_scrollToBottom;
+    QString m_queuedOutput;
+    int m_queuedLines;
+    QBasicTimer m_flushTimer;
+    QTemporaryFile *m_spillFile;
+    QTextStream *m_spillStream;
 };
 
 #if 0
@@ -38,6 +38,7 @@
 
 #include <QtCore/QDebug>
 #include <QtCore/QFileInfo>
+#include <QtCore/QVector>
 
 #include <QtGui/QApplication>
 #include <QtGui/QIcon>
@@ -134,6 +135,57 @@ bool sortNodes(Node *n1, Node *n2)
     return false;
 }
 
+// Sorts like sortNodes(), but computes what is compared only once per
+// node instead of once per comparison.
+struct NodeSortKey
+{
+    int group;
+    QString name;
+    QString path;
+    Node *node;
+
+    bool operator<(const NodeSortKey &other) const
+    {
+        if (group != other.group)
+            return group < other.group;
+        if (name != other.name)
+            return name < other.name;
+        if (path != other.path)
+            return path < other.path;
+        return node < other.node;
+    }
+};
+
+void sortNodeList(QList<Node*> *nodeList)
+{
+    QVector<NodeSortKey> keys;
+    keys.reserve(nodeList->size());
+    foreach (Node *node, *nodeList) {
+        NodeSortKey key;
+        key.node = node;
+        FileNode *file = qobject_cast<FileNode*>(node);
+        if (file && file->fileType() == ProjectFileType) {
+            key.group = 0;
+            key.name = QFileInfo(file->path()).fileName();
+        } else if (node->nodeType() == ProjectNodeType) {
+            key.group = 1;
+            key.name = static_cast<ProjectNode*>(node)->name();
+        } else if (node->nodeType() == FolderNodeType) {
+            key.group = 2;
+            key.name = static_cast<FolderNode*>(node)->name();
+        } else {
+            key.group = 3;
+            key.name = QFileInfo(node->path()).fileName();
+            key.path = node->path();
+        }
+        keys.append(key);
+    }
+    qSort(keys.begin(), keys.end());
+
+    for (int i = 0; i < keys.size(); ++i)
+        (*nodeList)[i] = keys.at(i).node;
+}
+
 } // namespace anon
 
 /*!
@@ -684,7 +736,7 @@ QModelIndex FlatModel::parent(const QModelIndex &idx) const
                     it = m_childNodes.constFind(grandParentNode);
                 }
                 Q_ASSERT(it != m_childNodes.constEnd());
-                const int row = it.value().indexOf(parentNode);
+                const int row = rowOf(parentNode, it.value());
                 Q_ASSERT(row >= 0);
                 parentIndex = createIndex(row, 0, parentNode);
             } else {
@@ -837,17 +889,42 @@ QList<Node*> FlatModel::childNodes(FolderNode *parentNode, const QSet<Node*> &bl
         recursiveAddFolderNodes(parentNode, &nodeList, blackList);
         recursiveAddFileNodes(parentNode, &nodeList, blackList + nodeList.toSet());
     }
-    qSort(nodeList.begin(), nodeList.end(), sortNodes);
+    sortNodeList(&nodeList);
     return nodeList;
 }
 
+void FlatModel::setChildNodes(FolderNode *parentNode, const QList<Node*> &nodeList, int firstChangedRow) const
+{
+    m_childNodes.insert(parentNode, nodeList);
+    for (int row = firstChangedRow; row < nodeList.size(); ++row)
+        m_rows.insert(nodeList.at(row), row);
+}
+
+int FlatModel::rowOf(Node *node, const QList<Node*> &siblings) const
+{
+    QHash<Node*, int>::const_iterator it = m_rows.constFind(node);
+    if (it != m_rows.constEnd()) {
+        const int row = it.value();
+        if (row < siblings.size() && siblings.at(row) == node)
+            return row;
+    }
+
+    // Only while added() or removed() are in the middle of a change are
+    // the rows not numbered yet.
+    const int row = siblings.indexOf(node);
+    if (row != -1) {
+        for (int i = 0; i < siblings.size(); ++i)
+            m_rows.insert(siblings.at(i), i);
+    }
+    return row;
+}
+
 void FlatModel::fetchMore(FolderNode *folderNode) const
 {
     Q_ASSERT(folderNode);
     Q_ASSERT(!m_childNodes.contains(folderNode));
 
-    QList<Node*> nodeList = childNodes(folderNode);
-    m_childNodes.insert(folderNode, nodeList);
+    setChildNodes(folderNode, childNodes(folderNode));
 }
 
 void FlatModel::fetchMore(const QModelIndex &parent)
@@ -874,6 +951,7 @@ void FlatModel::setStartupProject(ProjectNode *projectNode)
 void FlatModel::reset()
 {
     m_childNodes.clear();
+    m_rows.clear();
     QAbstractItemModel::reset();
 }
 
@@ -898,7 +976,7 @@ QModelIndex FlatModel::indexForNode(const Node *node_)
         it = m_childNodes.constFind(parentNode);
     }
     if (it != m_childNodes.constEnd()) {
-        const int row = it.value().indexOf(node);
+        const int row = rowOf(node, it.value());
         if (row != -1)
             return createIndex(row, 0, node);
     }
@@ -982,68 +1060,39 @@ void FlatModel::added(FolderNode* parentNode, const QList<Node*> &newNodeList)
     QHash<FolderNode*, QList<Node*> >::const_iterator it = m_childNodes.constFind(parentNode);
     if (it == m_childNodes.constEnd())
         return;
-    QList<Node *> oldNodeList = it.value();
-
-    // Compare lists and emit signals, and modify m_childNodes on the fly
-    QList<Node *>::const_iterator oldIter = oldNodeList.constBegin();
-    QList<Node *>::const_iterator newIter = newNodeList.constBegin();
-
-    // optimization, check for old list is empty
-    if (oldIter == oldNodeList.constEnd()) {
-        // New Node List is empty, nothing added which intrest us
-        if (newIter == newNodeList.constEnd())
-            return;
-        // So all we need to do is easy
-        beginInsertRows(parentIndex, 0, newNodeList.size() - 1);
-        m_childNodes.insert(parentNode, newNodeList);
-        endInsertRows();
-        return;
-    }
-
-    while (true) {
-        // Skip all that are the same
-        while (*oldIter == *newIter) {
-            ++oldIter;
-            ++newIter;
-            if (oldIter == oldNodeList.constEnd()) {
-                // At end of oldNodeList, sweep up rest of newNodeList
-                QList<Node *>::const_iterator startOfBlock = newIter;
-                newIter = newNodeList.constEnd();
-                int pos = oldIter - oldNodeList.constBegin();
-                int count = newIter - startOfBlock;
-                if (count > 0) {
-                    beginInsertRows(parentIndex, pos, pos+count-1);
-                    while (startOfBlock != newIter) {
-                        oldNodeList.insert(pos, *startOfBlock);
-                        ++pos;
-                        ++startOfBlock;
-                    }
-                    m_childNodes.insert(parentNode, oldNodeList);
-                    endInsertRows();
-                }
-                return; // Done with the lists, leave the function
-            }
+    const QList<Node *> oldNodeList = it.value();
+
+    // The old list is a subsequence of the new one. Each run of new nodes
+    // is inserted into the current list with one beginInsertRows() at its
+    // final row, after the runs before it. The rows are numbered once at
+    // the end.
+    int firstChangedRow = -1;
+    int oldPos = 0;
+    int newPos = 0;
+    while (newPos < newNodeList.size()) {
+        if (oldPos < oldNodeList.size() && oldNodeList.at(oldPos) == newNodeList.at(newPos)) {
+            ++oldPos;
+            ++newPos;
+            continue;
         }
 
-        QList<Node *>::const_iterator startOfBlock = newIter;
-        while (*oldIter != *newIter)
-            ++newIter;
-        // startOfBlock is the first that was diffrent
-        // newIter points to the new position of oldIter
-        // newIter - startOfBlock is number of new items
-        // oldIter is the position where those are...
-        int pos = oldIter - oldNodeList.constBegin();
-        int count = newIter - startOfBlock;
-        beginInsertRows(parentIndex, pos, pos + count - 1);
-        while (startOfBlock != newIter) {
-            oldNodeList.insert(pos, *startOfBlock);
-            ++pos;
-            ++startOfBlock;
-        }
-        m_childNodes.insert(parentNode, oldNodeList);
+        const int startOfBlock = newPos;
+        while (newPos < newNodeList.size()
+               && (oldPos == oldNodeList.size() || newNodeList.at(newPos) != oldNodeList.at(oldPos)))
+            ++newPos;
+
+        if (firstChangedRow == -1)
+            firstChangedRow = startOfBlock;
+
+        beginInsertRows(parentIndex, startOfBlock, newPos - 1);
+        QList<Node *> &nodeList = m_childNodes[parentNode];
+        for (int i = startOfBlock; i < newPos; ++i)
+            nodeList.insert(i, newNodeList.at(i));
         endInsertRows();
-        oldIter = oldNodeList.constBegin() + pos;
     }
+
+    if (firstChangedRow != -1)
+        setChildNodes(parentNode, m_childNodes.value(parentNode), firstChangedRow);
 }
 
 void FlatModel::removed(FolderNode* parentNode, const QList<Node*> &newNodeList)
@@ -1053,66 +1102,43 @@ void FlatModel::removed(FolderNode* parentNode, const QList<Node*> &newNodeList)
     QHash<FolderNode*, QList<Node*> >::const_iterator it = m_childNodes.constFind(parentNode);
     if (it == m_childNodes.constEnd())
         return;
-    QList<Node *> oldNodeList = it.value();
-    // Compare lists and emit signals, and modify m_childNodes on the fly
-    QList<Node *>::const_iterator oldIter = oldNodeList.constBegin();
-    QList<Node *>::const_iterator newIter = newNodeList.constBegin();
-
-    // optimization, check for new list is empty
-    if (newIter == newNodeList.constEnd()) {
-        // New Node List is empty, everything removed
-        if (oldIter == oldNodeList.constEnd())
-            return;
-        // So all we need to do is easy
-        beginRemoveRows(parentIndex, 0, oldNodeList.size() - 1);
-        m_childNodes.insert(parentNode, newNodeList);
-        endRemoveRows();
-        return;
-    }
-
-    while (true) {
-        // Skip all that are the same
-        while (*oldIter == *newIter) {
-            ++oldIter;
-            ++newIter;
-            if (newIter == newNodeList.constEnd()) {
-                // At end of newNodeList, sweep up rest of oldNodeList
-                QList<Node *>::const_iterator startOfBlock = oldIter;
-                oldIter = oldNodeList.constEnd();
-                int pos = startOfBlock - oldNodeList.constBegin();
-                int count = oldIter - startOfBlock;
-                if (count > 0) {
-                    beginRemoveRows(parentIndex, pos, pos+count-1);
-                    while (startOfBlock != oldIter) {
-                        ++startOfBlock;
-                        oldNodeList.removeAt(pos);
-                    }
-
-                    m_childNodes.insert(parentNode, oldNodeList);
-                    endRemoveRows();
-                }
-                return; // Done with the lists, leave the function
-            }
+    const QList<Node *> oldNodeList = it.value();
+
+    // The new list is a subsequence of the old one. Each run of stale nodes
+    // is erased from the current list with one beginRemoveRows(). The rows
+    // are numbered once at the end.
+    int firstChangedRow = -1;
+    int oldPos = 0;
+    int newPos = 0;
+    while (oldPos < oldNodeList.size()) {
+        if (newPos < newNodeList.size() && oldNodeList.at(oldPos) == newNodeList.at(newPos)) {
+            ++oldPos;
+            ++newPos;
+            continue;
         }
 
-        QList<Node *>::const_iterator startOfBlock = oldIter;
-        while (*oldIter != *newIter)
-            ++oldIter;
-        // startOfBlock is the first that was diffrent
-        // oldIter points to the new position of newIter
-        // oldIter - startOfBlock is number of new items
-        // newIter is the position where those are...
-        int pos = startOfBlock - oldNodeList.constBegin();
-        int count = oldIter - startOfBlock;
-        beginRemoveRows(parentIndex, pos, pos + count - 1);
-        while (startOfBlock != oldIter) {
-            ++startOfBlock;
-            oldNodeList.removeAt(pos);
-        }
-        m_childNodes.insert(parentNode, oldNodeList);
+        const int startOfBlock = oldPos;
+        while (oldPos < oldNodeList.size()
+               && (newPos == newNodeList.size() || oldNodeList.at(oldPos) != newNodeList.at(newPos)))
+            ++oldPos;
+
+        // Rows are counted in the current list, where the runs before
+        // this one are already gone.
+        const int row = newPos;
+        const int count = oldPos - startOfBlock;
+        if (firstChangedRow == -1)
+            firstChangedRow = row;
+
+        beginRemoveRows(parentIndex, row, row + count - 1);
+        for (int i = startOfBlock; i < oldPos; ++i)
+            m_rows.remove(oldNodeList.at(i));
+        QList<Node *> &nodeList = m_childNodes[parentNode];
+        nodeList.erase(nodeList.begin() + row, nodeList.begin() + row + count);
         endRemoveRows();
-        oldIter = oldNodeList.constBegin() + pos;
     }
+
+    if (firstChangedRow != -1)
+        setChildNodes(parentNode, m_childNodes.value(parentNode), firstChangedRow);
 }
 
 void FlatModel::foldersAboutToBeAdded(FolderNode *parentFolder, const QList<FolderNode*> &newFolders)
@@ -1149,6 +1175,8 @@ void FlatModel::removeFromCache(QList<FolderNode *> list)
 {
     foreach (FolderNode *fn, list) {
         removeFromCache(fn->subFolderNodes());
+        foreach (Node *node, m_childNodes.value(fn))
+            m_rows.remove(node);
         m_childNodes.remove(fn);
     }
 }
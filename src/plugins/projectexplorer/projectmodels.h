@@ -98,6 +98,7 @@ private:
 
     SessionNode *m_rootNode;
     mutable QHash<FolderNode*, QList<Node*> > m_childNodes;
+    mutable QHash<Node*, int> m_rows; // Row of each node in m_childNodes
     FolderNode *m_folderToAddTo;
 
     friend class DetailedModelManager;
@@ -161,6 +162,8 @@ private:
     void recursiveAddFolderNodesImpl(FolderNode *startNode, QList<Node *> *list, const QSet<Node *> &blackList = QSet<Node*>()) const;
     void recursiveAddFileNodes(FolderNode *startNode, QList<Node *> *list, const QSet<Node *> &blackList = QSet<Node*>()) const;
     QList<Node*> childNodes(FolderNode *parentNode, const QSet<Node*> &blackList = QSet<Node*>()) const;
+    void setChildNodes(FolderNode *parentNode, const QList<Node*> &nodeList, int firstChangedRow = 0) const;
+    int rowOf(Node *node, const QList<Node*> &siblings) const;
 
     FolderNode *visibleFolderNode(FolderNode *node) const;
     bool filter(Node *node) const;
@@ -36,6 +36,7 @@
 #include <utils/qtcassert.h>
 
 #include <QtCore/QFileInfo>
+#include <QtCore/QSet>
 #include <QtGui/QApplication>
 #include <QtGui/QIcon>
 #include <QtGui/QStyle>
@@ -544,6 +545,37 @@ void ProjectNode::removeFileNodes(const QList<FileNode*> &files, FolderNode *fol
     }
 }
 
+/*!
+  Makes the file nodes of folder match the files map of paths to file types.
+  Only files that are new, gone or changed type are touched; they are removed
+  and added in one batch each, so watchers see at most two changes.
+  This method should be called within an implementation of a refresh.
+  */
+void ProjectNode::updateFileNodes(const QHash<QString, FileType> &files, FolderNode *folder)
+{
+    Q_ASSERT(folder);
+
+    QList<FileNode*> staleFiles;
+    QSet<QString> keptFiles;
+    foreach (FileNode *fileNode, folder->fileNodes()) {
+        const QHash<QString, FileType>::const_iterator it = files.constFind(fileNode->path());
+        if (it == files.constEnd() || it.value() != fileNode->fileType())
+            staleFiles.append(fileNode);
+        else
+            keptFiles.insert(fileNode->path());
+    }
+    removeFileNodes(staleFiles, folder);
+
+    QList<FileNode*> newFiles;
+    QHash<QString, FileType>::const_iterator it = files.constBegin();
+    for (; it != files.constEnd(); ++it) {
+        if (!keptFiles.contains(it.key()))
+            newFiles.append(new FileNode(it.key(), it.value(), /* generated = */ false));
+    }
+    qSort(newFiles.begin(), newFiles.end(), sortNodesByPath);
+    addFileNodes(newFiles, folder);
+}
+
 void ProjectNode::watcherDestroyed(QObject *watcher)
 {
     // cannot use qobject_cast here
@@ -30,6 +30,7 @@
 #ifndef PROJECTNODES_H
 #define PROJECTNODES_H
 
+#include <QtCore/QHash>
 #include <QtCore/QObject>
 #include <QtCore/QStringList>
 #include <QtGui/QIcon>
@@ -210,6 +211,7 @@ protected:
 
     void addFileNodes(const QList<FileNode*> &files, FolderNode *parentFolder);
     void removeFileNodes(const QList<FileNode*> &files, FolderNode *parentFolder);
+    void updateFileNodes(const QHash<QString, FileType> &files, FolderNode *parentFolder);
 
 private slots:
     void watcherDestroyed(QObject *watcher);
@@ -56,16 +56,6 @@
 
 using namespace ProjectExplorer::Internal;
 
-// Internal Struct for TaskModel
-struct TaskItem
-{
-    QString description;
-    QString file;
-    int line;
-    bool fileNotFound;
-    ProjectExplorer::BuildParserInterface::PatternType type;
-};
-
 class ProjectExplorer::Internal::TaskModel : public QAbstractItemModel
 {
 public:
@@ -79,6 +69,8 @@ public:
     void clear();
     void addTask(ProjectExplorer::BuildParserInterface::PatternType type,
                          const QString &description, const QString &file, int line);
+    void addTasks(const QList<TaskItem> &tasks);
+    int removeTasks(const QString &category);
     int sizeOfFile();
     int sizeOfLineNumber();
     void setFileNotFound(const QModelIndex &index, bool b);
@@ -172,18 +164,53 @@ void TaskModel::addTask(ProjectExplorer::BuildParserInterface::PatternType type,
     task.line = line;
     task.type = type;
     task.fileNotFound = false;
+    addTasks(QList<TaskItem>() << task);
+}
+
+void TaskModel::addTasks(const QList<TaskItem> &tasks)
+{
+    if (tasks.isEmpty())
+        return;
 
-    beginInsertRows(QModelIndex(), m_items.size(), m_items.size());
-    m_items.append(task);
+    beginInsertRows(QModelIndex(), m_items.size(), m_items.size() + tasks.size() - 1);
+    m_items += tasks;
     endInsertRows();
 
     QFont font;
     QFontMetrics fm(font);
-    QString filename = task.file;
-    int pos = filename.lastIndexOf("/");
-    if (pos != -1)
-        filename = file.mid(pos +1);
-    m_maxSizeOfFileName = qMax(m_maxSizeOfFileName, fm.width(filename));
+    foreach (const TaskItem &task, tasks) {
+        QString filename = task.file;
+        int pos = filename.lastIndexOf("/");
+        if (pos != -1)
+            filename = filename.mid(pos +1);
+        m_maxSizeOfFileName = qMax(m_maxSizeOfFileName, fm.width(filename));
+    }
+}
+
+/*!
+  Removes the tasks of category, one contiguous run at a time.
+  Returns the number of errors removed.
+  */
+int TaskModel::removeTasks(const QString &category)
+{
+    int errors = 0;
+    for (int end = m_items.size(); end > 0; ) {
+        if (m_items.at(end - 1).category != category) {
+            --end;
+            continue;
+        }
+        int begin = end - 1;
+        while (begin > 0 && m_items.at(begin - 1).category == category)
+            --begin;
+        for (int i = begin; i < end; ++i)
+            if (m_items.at(i).type == ProjectExplorer::BuildParserInterface::Error)
+                ++errors;
+        beginRemoveRows(QModelIndex(), begin, end - 1);
+        m_items.erase(m_items.begin() + begin, m_items.begin() + end);
+        endRemoveRows();
+        end = begin;
+    }
+    return errors;
 }
 
 void TaskModel::clear()
@@ -389,6 +416,8 @@ QWidget *TaskWindow::outputWidget(QWidget *)
 void TaskWindow::clearContents()
 {
     m_errorCount = 0;
+    m_categoryTasks.clear();
+    m_categoryErrors.clear();
     m_currentTask = -1;
     m_model->clear();
     m_copyAction->setEnabled(false);
@@ -396,6 +425,20 @@ void TaskWindow::clearContents()
     navigateStateChanged();
 }
 
+void TaskWindow::removeItems(const QString &category)
+{
+    const int count = m_model->rowCount();
+    m_errorCount -= m_model->removeTasks(category);
+    m_categoryTasks.remove(category);
+    m_categoryErrors.remove(category);
+    if (m_model->rowCount() == count)
+        return;
+    m_currentTask = -1;
+    m_copyAction->setEnabled(m_model->rowCount() != 0);
+    emit tasksChanged();
+    navigateStateChanged();
+}
+
 void TaskWindow::visibilityChanged(bool /* b */)
 {
 }
@@ -403,12 +446,31 @@ void TaskWindow::visibilityChanged(bool /* b */)
 void TaskWindow::addItem(ProjectExplorer::BuildParserInterface::PatternType type,
                          const QString &description, const QString &file, int line)
 {
-    m_model->addTask(type, description, file, line);
-    if (type == ProjectExplorer::BuildParserInterface::Error)
-        ++m_errorCount;
+    TaskItem task;
+    task.description = description;
+    task.file = file;
+    task.line = line;
+    task.type = type;
+    task.fileNotFound = false;
+    addItems(QList<TaskItem>() << task);
+}
+
+void TaskWindow::addItems(const QList<TaskItem> &items)
+{
+    if (items.isEmpty())
+        return;
+    const bool wasEmpty = m_model->rowCount() == 0;
+    m_model->addTasks(items);
+    foreach (const TaskItem &task, items) {
+        ++m_categoryTasks[task.category];
+        if (task.type == ProjectExplorer::BuildParserInterface::Error) {
+            ++m_errorCount;
+            ++m_categoryErrors[task.category];
+        }
+    }
     m_copyAction->setEnabled(true);
     emit tasksChanged();
-    if (m_model->rowCount() == 1)
+    if (wasEmpty)
         navigateStateChanged();
 }
 
@@ -467,6 +529,16 @@ int TaskWindow::numberOfErrors() const
     return m_errorCount;
 }
 
+int TaskWindow::numberOfTasks(const QString &category) const
+{
+    return m_categoryTasks.value(category);
+}
+
+int TaskWindow::numberOfErrors(const QString &category) const
+{
+    return m_categoryErrors.value(category);
+}
+
 int TaskWindow::priorityInStatusBar() const
 {
     return 90;
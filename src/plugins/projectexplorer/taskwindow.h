@@ -35,6 +35,7 @@
 #include <coreplugin/ioutputpane.h>
 #include <coreplugin/icontext.h>
 
+#include <QtCore/QHash>
 #include <QtGui/QTreeWidget>
 #include <QtGui/QStyledItemDelegate>
 #include <QtGui/QListView>
@@ -43,6 +44,16 @@
 namespace ProjectExplorer {
 namespace Internal {
 
+struct TaskItem
+{
+    QString description;
+    QString file;
+    int line;
+    bool fileNotFound;
+    ProjectExplorer::BuildParserInterface::PatternType type;
+    QString category; // empty for build issues
+};
+
 class TaskModel;
 class TaskFilterModel;
 class TaskView;
@@ -66,9 +77,14 @@ public:
 
     void addItem(BuildParserInterface::PatternType type,
         const QString &description, const QString &file, int line);
+    void addItems(const QList<TaskItem> &items);
+    void removeItems(const QString &category);
 
     int numberOfTasks() const;
     int numberOfErrors() const;
+    // Counts of a single category, e.g. the empty one for build issues
+    int numberOfTasks(const QString &category) const;
+    int numberOfErrors(const QString &category) const;
 
     bool canFocus();
     bool hasFocus();
@@ -92,6 +108,8 @@ private:
     int sizeHintForColumn(int column) const;
 
     int m_errorCount;
+    QHash<QString, int> m_categoryTasks;
+    QHash<QString, int> m_categoryErrors;
     int m_currentTask;
 
     TaskModel *m_model;
@@ -30,6 +30,9 @@
 #include "qmlcompletionvisitor.h"
 #include "qmlcodecompletion.h"
 #include "qmleditor.h"
+#include "qmlindex.h"
+#include "qmlmodelmanagerinterface.h"
+#include <extensionsystem/pluginmanager.h>
 #include <texteditor/basetexteditor.h>
 #include <QtDebug>
 
@@ -38,6 +41,7 @@ using namespace QmlEditor::Internal;
 
 QmlCodeCompletion::QmlCodeCompletion(QObject *parent)
     : TextEditor::ICompletionCollector(parent),
+      m_modelManager(ExtensionSystem::PluginManager::instance()->getObject<QmlModelManagerInterface>()),
       m_editor(0),
       m_startPosition(0),
       m_caseSensitivity(Qt::CaseSensitive)
@@ -91,6 +95,15 @@ int QmlCodeCompletion::startCompletion(TextEditor::ITextEditable *editor)
         m_completions.append(item);
     }
 
+    // Component types of the whole project
+    if (m_modelManager) {
+        foreach (const QString &name, m_modelManager->index().componentNames()) {
+            TextEditor::CompletionItem item(this);
+            item.text = name;
+            m_completions.append(item);
+        }
+    }
+
     QmlDocument::Ptr qmlDocument = edit->qmlDocument();
     if (!qmlDocument.isNull()) {
         QmlJS::AST::UiProgram *program = qmlDocument->program();
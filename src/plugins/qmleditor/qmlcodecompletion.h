@@ -37,6 +37,9 @@ class ITextEditable;
 }
 
 namespace QmlEditor {
+
+class QmlModelManagerInterface;
+
 namespace Internal {
 
 class QmlCodeCompletion: public TextEditor::ICompletionCollector
@@ -59,6 +62,7 @@ public:
     virtual void cleanup();
 
 private:
+    QmlModelManagerInterface *m_modelManager;
     TextEditor::ITextEditable *m_editor;
     int m_startPosition;
     QList<TextEditor::CompletionItem> m_completions;
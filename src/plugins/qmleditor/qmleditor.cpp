@@ -56,6 +56,7 @@
 
 #include <utils/uncommentselection.h>
 
+#include <QtCore/QDebug>
 #include <QtCore/QTimer>
 
 #include <QtGui/QMenu>
@@ -68,303 +69,14 @@ enum {
     UPDATE_DOCUMENT_DEFAULT_INTERVAL = 250
 };
 
+enum { debug = 0 };
+
 using namespace QmlJS;
 using namespace QmlJS::AST;
 
 namespace QmlEditor {
 namespace Internal {
 
-class FindWords: protected Visitor
-{
-public:
-    QStringList operator()(AST::Node *node)
-    {
-        _words.clear();
-        accept(node);
-        return QStringList(_words.toList());
-    }
-
-protected:
-    void accept(AST::Node *node)
-    { AST::Node::acceptChild(node, this); }
-
-    using Visitor::visit;
-    using Visitor::endVisit;
-
-    void addWords(AST::UiQualifiedId *id)
-    {
-        for (; id; id = id->next) {
-            if (id->name)
-                _words.insert(id->name->asString());
-        }
-    }
-
-    virtual bool visit(AST::UiPublicMember *node)
-    {
-        if (node->name)
-            _words.insert(node->name->asString());
-
-        return true;
-    }
-
-    virtual bool visit(AST::UiQualifiedId *node)
-    {
-        if (node->name)
-            _words.insert(node->name->asString());
-
-        return true;
-    }
-
-    virtual bool visit(AST::IdentifierExpression *node)
-    {
-        if (node->name)
-            _words.insert(node->name->asString());
-
-        return true;
-    }
-
-    virtual bool visit(AST::FieldMemberExpression *node)
-    {
-        if (node->name)
-            _words.insert(node->name->asString());
-
-        return true;
-    }
-
-    virtual bool visit(AST::FunctionExpression *node)
-    {
-        if (node->name)
-            _words.insert(node->name->asString());
-
-        for (AST::FormalParameterList *it = node->formals; it; it = it->next) {
-            if (it->name)
-                _words.insert(it->name->asString());
-        }
-
-        return true;
-    }
-
-    virtual bool visit(AST::FunctionDeclaration *node)
-    {
-        if (node->name)
-            _words.insert(node->name->asString());
-
-        for (AST::FormalParameterList *it = node->formals; it; it = it->next) {
-            if (it->name)
-                _words.insert(it->name->asString());
-        }
-
-        return true;
-    }
-
-    virtual bool visit(AST::VariableDeclaration *node)
-    {
-        if (node->name)
-            _words.insert(node->name->asString());
-
-        return true;
-    }
-
-private:
-    QSet<QString> _words;
-};
-
-class FindIdDeclarations: protected Visitor
-{
-public:
-    typedef QMap<QString, QList<AST::SourceLocation> > Result;
-
-    Result operator()(AST::Node *node)
-    {
-        _ids.clear();
-        _maybeIds.clear();
-        accept(node);
-        return _ids;
-    }
-
-protected:
-    QString asString(AST::UiQualifiedId *id)
-    {
-        QString text;
-        for (; id; id = id->next) {
-            if (id->name)
-                text += id->name->asString();
-            else
-                text += QLatin1Char('?');
-
-            if (id->next)
-                text += QLatin1Char('.');
-        }
-
-        return text;
-    }
-
-    void accept(AST::Node *node)
-    { AST::Node::acceptChild(node, this); }
-
-    using Visitor::visit;
-    using Visitor::endVisit;
-
-    virtual bool visit(AST::UiScriptBinding *node)
-    {
-        if (asString(node->qualifiedId) == QLatin1String("id")) {
-            if (AST::ExpressionStatement *stmt = AST::cast<AST::ExpressionStatement*>(node->statement)) {
-                if (AST::IdentifierExpression *idExpr = AST::cast<AST::IdentifierExpression *>(stmt->expression)) {
-                    if (idExpr->name) {
-                        const QString id = idExpr->name->asString();
-                        QList<AST::SourceLocation> *locs = &_ids[id];
-                        locs->append(idExpr->firstSourceLocation());
-                        locs->append(_maybeIds.value(id));
-                        _maybeIds.remove(id);
-                        return false;
-                    }
-                }
-            }
-        }
-
-        accept(node->statement);
-
-        return false;
-    }
-
-    virtual bool visit(AST::IdentifierExpression *node)
-    {
-        if (node->name) {
-            const QString name = node->name->asString();
-
-            if (_ids.contains(name))
-                _ids[name].append(node->identifierToken);
-            else
-                _maybeIds[name].append(node->identifierToken);
-        }
-        return false;
-    }
-
-private:
-    Result _ids;
-    Result _maybeIds;
-};
-
-class FindDeclarations: protected Visitor
-{
-    QList<Declaration> _declarations;
-    int _depth;
-
-public:
-    QList<Declaration> operator()(AST::Node *node)
-    {
-        _depth = -1;
-        _declarations.clear();
-        accept(node);
-        return _declarations;
-    }
-
-protected:
-    using Visitor::visit;
-    using Visitor::endVisit;
-
-    QString asString(AST::UiQualifiedId *id)
-    {
-        QString text;
-        for (; id; id = id->next) {
-            if (id->name)
-                text += id->name->asString();
-            else
-                text += QLatin1Char('?');
-
-            if (id->next)
-                text += QLatin1Char('.');
-        }
-
-        return text;
-    }
-
-    void accept(AST::Node *node)
-    { AST::Node::acceptChild(node, this); }
-
-    void init(Declaration *decl, AST::UiObjectMember *member)
-    {
-        const SourceLocation first = member->firstSourceLocation();
-        const SourceLocation last = member->lastSourceLocation();
-        decl->startLine = first.startLine;
-        decl->startColumn = first.startColumn;
-        decl->endLine = last.startLine;
-        decl->endColumn = last.startColumn + last.length;
-    }
-
-    virtual bool visit(AST::UiObjectDefinition *node)
-    {
-        ++_depth;
-
-        Declaration decl;
-        init(&decl, node);
-
-        decl.text.fill(QLatin1Char(' '), _depth);
-        if (node->qualifiedTypeNameId)
-            decl.text.append(asString(node->qualifiedTypeNameId));
-        else
-            decl.text.append(QLatin1Char('?'));
-
-        _declarations.append(decl);
-
-        return true; // search for more bindings
-    }
-
-    virtual void endVisit(AST::UiObjectDefinition *)
-    {
-        --_depth;
-    }
-
-    virtual bool visit(AST::UiObjectBinding *node)
-    {
-        ++_depth;
-
-        Declaration decl;
-        init(&decl, node);
-
-        decl.text.fill(QLatin1Char(' '), _depth);
-
-        decl.text.append(asString(node->qualifiedId));
-        decl.text.append(QLatin1String(": "));
-
-        if (node->qualifiedTypeNameId)
-            decl.text.append(asString(node->qualifiedTypeNameId));
-        else
-            decl.text.append(QLatin1Char('?'));
-
-        _declarations.append(decl);
-
-        return true; // search for more bindings
-    }
-
-    virtual void endVisit(AST::UiObjectBinding *)
-    {
-        --_depth;
-    }
-
-#if 0 // ### ignore script bindings for now.
-    virtual bool visit(AST::UiScriptBinding *node)
-    {
-        ++_depth;
-
-        Declaration decl;
-        init(&decl, node);
-
-        decl.text.fill(QLatin1Char(' '), _depth);
-        decl.text.append(asString(node->qualifiedId));
-
-        _declarations.append(decl);
-
-        return false; // more more bindings in this subtree.
-    }
-
-    virtual void endVisit(AST::UiScriptBinding *)
-    {
-        --_depth;
-    }
-#endif
-};
-
 ScriptEditorEditable::ScriptEditorEditable(ScriptEditor *editor)
     : BaseTextEditorEditable(editor)
 {
@@ -398,8 +110,8 @@ ScriptEditor::ScriptEditor(QWidget *parent) :
     m_modelManager = ExtensionSystem::PluginManager::instance()->getObject<QmlModelManagerInterface>();
 
     if (m_modelManager) {
-        connect(m_modelManager, SIGNAL(documentUpdated(QmlDocument::Ptr)),
-                this, SLOT(onDocumentUpdated(QmlDocument::Ptr)));
+        connect(m_modelManager, SIGNAL(semanticInfoUpdated(QmlEditor::Internal::SemanticInfo)),
+                this, SLOT(updateSemanticInfo(QmlEditor::Internal::SemanticInfo)));
     }
 }
 
@@ -433,36 +145,38 @@ ScriptEditor::Context ScriptEditorEditable::context() const
 
 void ScriptEditor::updateDocument()
 {
+    if (!m_editTime.isValid())
+        m_editTime.start();
     m_updateDocumentTimer->start(UPDATE_DOCUMENT_DEFAULT_INTERVAL);
 }
 
 void ScriptEditor::updateDocumentNow()
 {
-    // ### move in the parser thread.
-
     m_updateDocumentTimer->stop();
 
-    const QString fileName = file()->fileName();
-
-    m_modelManager->updateSourceFiles(QStringList() << fileName);
+    if (m_modelManager)
+        m_modelManager->updateEditorDocument(file()->fileName(), toPlainText(),
+                                             document()->revision());
 }
 
-void ScriptEditor::onDocumentUpdated(QmlDocument::Ptr doc)
+void ScriptEditor::updateSemanticInfo(const SemanticInfo &info)
 {
-    if (file()->fileName() != doc->fileName())
+    if (file()->fileName() != info.document->fileName())
         return;
+    if (info.revision != document()->revision())
+        return; // Outdated, the next one is on its way.
 
-    m_document = doc;
+    if (debug && m_editTime.isValid())
+        qDebug() << "QML editor: semantic info updated" << m_editTime.elapsed() << "ms after edit";
+    m_editTime = QTime();
 
-    FindIdDeclarations updateIds;
-    m_ids = updateIds(doc->program());
+    const QmlDocument::Ptr doc = info.document;
+    m_document = doc;
+    m_ids = info.ids;
 
     if (doc->isParsedCorrectly()) {
-        FindDeclarations findDeclarations;
-        m_declarations = findDeclarations(doc->program());
-
-        FindWords findWords;
-        m_words = findWords(doc->program());
+        m_declarations = info.declarations;
+        m_words = info.words;
 
         QStringList items;
         items.append(tr("<Select Symbol>"));
@@ -35,6 +35,9 @@
 #include "qmljsastfwd_p.h"
 #include "qmljsengine_p.h"
 #include "qmldocument.h"
+#include "qmlsemanticinfo.h"
+
+#include <QtCore/QTime>
 
 QT_BEGIN_NAMESPACE
 class QComboBox;
@@ -71,23 +74,6 @@ private:
     QList<int> m_context;
 };
 
-
-struct Declaration
-{
-    QString text;
-    int startLine;
-    int startColumn;
-    int endLine;
-    int endColumn;
-
-    Declaration()
-        : startLine(0),
-        startColumn(0),
-        endLine(0),
-        endColumn(0)
-    { }
-};
-
 class ScriptEditor : public TextEditor::BaseTextEditor
 {
     Q_OBJECT
@@ -113,7 +99,7 @@ public slots:
     virtual void setFontSettings(const TextEditor::FontSettings &);
 
 private slots:
-    void onDocumentUpdated(QmlDocument::Ptr doc);
+    void updateSemanticInfo(const QmlEditor::Internal::SemanticInfo &info);
 
     void updateDocument();
     void updateDocumentNow();
@@ -140,6 +126,7 @@ private:
     const Context m_context;
 
     QTimer *m_updateDocumentTimer;
+    QTime m_editTime; // Started by the first edit not reflected in the semantic info.
     QComboBox *m_methodCombo;
     QList<Declaration> m_declarations;
     QStringList m_words;
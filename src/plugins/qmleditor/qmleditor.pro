@@ -27,7 +27,9 @@ HEADERS += qmleditor.h \
     qmllookupcontext.h \
     qmlresolveexpression.h \
     qmlsymbol.h \
-    qmlfilewizard.h
+    qmlfilewizard.h \
+    qmlsemanticinfo.h \
+    qmlindex.h
 SOURCES += qmleditor.cpp \
     qmleditorfactory.cpp \
     qmleditorplugin.cpp \
@@ -45,6 +47,8 @@ SOURCES += qmleditor.cpp \
     qmllookupcontext.cpp \
     qmlresolveexpression.cpp \
     qmlsymbol.cpp \
-    qmlfilewizard.cpp
+    qmlfilewizard.cpp \
+    qmlsemanticinfo.cpp \
+    qmlindex.cpp
 RESOURCES += qmleditor.qrc
 OTHER_FILES += QmlEditor.pluginspec
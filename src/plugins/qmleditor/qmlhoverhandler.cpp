@@ -29,6 +29,8 @@
 
 #include "qmlhoverhandler.h"
 #include "qmleditor.h"
+#include "qmlindex.h"
+#include "qmlmodelmanagerinterface.h"
 
 #include <coreplugin/icore.h>
 #include <coreplugin/uniqueidmanager.h>
@@ -53,6 +55,8 @@ using namespace Core;
 QmlHoverHandler::QmlHoverHandler(QObject *parent)
     : QObject(parent)
 {
+    m_modelManager = ExtensionSystem::PluginManager::instance()->getObject<QmlModelManagerInterface>();
+
     ICore *core = ICore::instance();
 
     // Listen for editor opened events in order to connect to tooltip/helpid requests
@@ -99,6 +103,25 @@ void QmlHoverHandler::showToolTip(TextEditor::ITextEditor *editor, const QPoint
         }
     }
 
+    // Types defined elsewhere in the project
+    if (m_toolTip.isEmpty() && m_modelManager) {
+        tc.select(QTextCursor::WordUnderCursor);
+        const QString word = tc.selectedText();
+        if (!word.isEmpty() && word.at(0).isUpper()) {
+            QStringList lines;
+            foreach (const QmlIndex::Component &component, m_modelManager->index().components(word)) {
+                QString line = component.name;
+                if (!component.baseType.isEmpty())
+                    line += QLatin1String(" : ") + component.baseType;
+                line += QLatin1String(" (") + QDir::toNativeSeparators(component.fileName) + QLatin1Char(')');
+                if (!component.properties.isEmpty())
+                    line += QLatin1Char('\n') + tr("Properties: %1").arg(component.properties.join(QLatin1String(", ")));
+                lines.append(line);
+            }
+            m_toolTip = lines.join(QLatin1String("\n"));
+        }
+    }
+
     if (m_toolTip.isEmpty())
         QToolTip::hideText();
     else {
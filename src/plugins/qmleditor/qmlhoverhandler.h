@@ -45,6 +45,9 @@ class ITextEditor;
 }
 
 namespace QmlEditor {
+
+class QmlModelManagerInterface;
+
 namespace Internal {
 
 class QmlHoverHandler : public QObject
@@ -62,6 +65,7 @@ private slots:
     void editorOpened(Core::IEditor *editor);
 
 private:
+    QmlModelManagerInterface *m_modelManager;
     QString m_toolTip;
 };
 
@@ -0,0 +1,239 @@
+/**************************************************************************
+**
+** This file is part of Qt Creator
+**
+** Copyright (c) 2009 Nokia Corporation and/or its subsidiary(-ies).
+**
+** Contact: Nokia Corporation (qt-info@nokia.com)
+**
+** Commercial Usage
+**
+** Licensees holding valid Qt Commercial licenses may use this file in
+** accordance with the Qt Commercial License Agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Nokia.
+**
+** GNU Lesser General Public License Usage
+**
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** If you are unsure which license is appropriate for your use, please
+** contact the sales department at http://qt.nokia.com/contact.
+**
+**************************************************************************/
+
+
+#include "qmlindex.h"
+
+#include "qmljsast_p.h"
+
+#include <QtCore/QDataStream>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QtAlgorithms>
+
+using namespace QmlEditor;
+using namespace QmlJS;
+
+enum {
+    IndexMagic = 0x514d4c58,
+    IndexVersion = 1
+};
+
+static QString toString(AST::UiQualifiedId *id)
+{
+    QString text;
+    for (; id; id = id->next) {
+        if (!id->name)
+            continue;
+        text += id->name->asString();
+        if (id->next)
+            text += QLatin1Char('.');
+    }
+    return text;
+}
+
+static QDataStream &operator<<(QDataStream &out, const QmlIndex::Component &component)
+{
+    return out << component.name << component.fileName << component.baseType
+               << component.properties << quint32(component.modified);
+}
+
+static QDataStream &operator>>(QDataStream &in, QmlIndex::Component &component)
+{
+    quint32 modified = 0;
+    in >> component.name >> component.fileName >> component.baseType
+       >> component.properties >> modified;
+    component.modified = modified;
+    return in;
+}
+
+bool QmlIndex::isEmpty() const
+{
+    return m_files.isEmpty();
+}
+
+QList<QmlIndex::Component> QmlIndex::components(const QString &name) const
+{
+    QList<Component> result;
+    QMultiHash<QString, QString>::const_iterator it = m_names.constFind(name);
+    for (; it != m_names.constEnd() && it.key() == name; ++it)
+        result.append(m_files.value(it.value()));
+    return result;
+}
+
+QStringList QmlIndex::componentNames() const
+{
+    return m_componentNames;
+}
+
+QStringList QmlIndex::fileNames() const
+{
+    return m_files.keys();
+}
+
+bool QmlIndex::isUpToDate(const QString &fileName, uint modified) const
+{
+    QHash<QString, Component>::const_iterator it = m_files.constFind(fileName);
+    return it != m_files.constEnd() && it->modified && it->modified == modified;
+}
+
+void QmlIndex::insert(const Component &component)
+{
+    remove(component.fileName);
+    m_files.insert(component.fileName, component);
+    if (component.name.isEmpty())
+        return;
+    if (!m_names.contains(component.name)) {
+        QStringList::iterator pos = qLowerBound(m_componentNames.begin(),
+                                                m_componentNames.end(), component.name);
+        m_componentNames.insert(pos, component.name);
+    }
+    m_names.insert(component.name, component.fileName);
+}
+
+void QmlIndex::remove(const QString &fileName)
+{
+    QHash<QString, Component>::iterator it = m_files.find(fileName);
+    if (it == m_files.end())
+        return;
+    const QString name = it->name;
+    m_files.erase(it);
+    if (name.isEmpty())
+        return;
+    m_names.remove(name, fileName);
+    if (!m_names.contains(name)) {
+        QStringList::iterator pos = qBinaryFind(m_componentNames.begin(),
+                                                m_componentNames.end(), name);
+        if (pos != m_componentNames.end())
+            m_componentNames.erase(pos);
+    }
+}
+
+void QmlIndex::unite(const QmlIndex &other)
+{
+    foreach (const Component &component, other.m_files) {
+        if (!m_files.contains(component.fileName))
+            insert(component);
+    }
+}
+
+QmlIndex QmlIndex::subset(const QSet<QString> &fileNames) const
+{
+    QmlIndex index;
+    foreach (const Component &component, m_files) {
+        if (fileNames.contains(component.fileName))
+            index.insert(component);
+    }
+    return index;
+}
+
+QmlIndex::Component QmlIndex::scan(const QmlDocument::Ptr &doc, uint modified)
+{
+    Component component;
+    component.fileName = doc->fileName();
+    component.modified = modified;
+
+    // Only files starting with an upper case letter define a type.
+    const QString name = doc->componentName();
+    if (name.isEmpty() || !name.at(0).isUpper())
+        return component;
+    component.name = name;
+
+    AST::UiProgram *program = doc->program();
+    if (!program || !program->members)
+        return component;
+
+    AST::UiObjectDefinition *root = AST::cast<AST::UiObjectDefinition *>(program->members->member);
+    if (!root)
+        return component;
+
+    component.baseType = toString(root->qualifiedTypeNameId);
+
+    if (root->initializer) {
+        for (AST::UiObjectMemberList *it = root->initializer->members; it; it = it->next) {
+            AST::UiPublicMember *member = AST::cast<AST::UiPublicMember *>(it->member);
+            if (member && member->type == AST::UiPublicMember::Property && member->name)
+                component.properties.append(member->name->asString());
+        }
+    }
+
+    return component;
+}
+
+bool QmlIndex::load(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream in(&file);
+    quint32 magic = 0;
+    quint32 version = 0;
+    quint32 count = 0;
+    in >> magic >> version >> count;
+    if (magic != IndexMagic || version != IndexVersion)
+        return false;
+
+    QmlIndex index;
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        Component component;
+        in >> component;
+        if (in.status() == QDataStream::Ok && QFile::exists(component.fileName))
+            index.insert(component);
+    }
+    if (in.status() != QDataStream::Ok)
+        return false;
+    *this = index;
+    return true;
+}
+
+bool QmlIndex::save(const QString &fileName) const
+{
+    const QFileInfo fileInfo(fileName);
+    if (!QDir().mkpath(fileInfo.absolutePath()))
+        return false;
+
+    // Write to a temporary file first, a partial index is worse than none.
+    const QString tmpName = fileName + QLatin1String(".tmp");
+    QFile file(tmpName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+    QDataStream out(&file);
+    out << quint32(IndexMagic) << quint32(IndexVersion) << quint32(m_files.size());
+    foreach (const Component &component, m_files)
+        out << component;
+    file.close();
+    if (out.status() != QDataStream::Ok || file.error() != QFile::NoError) {
+        QFile::remove(tmpName);
+        return false;
+    }
+    QFile::remove(fileName);
+    return QFile::rename(tmpName, fileName);
+}
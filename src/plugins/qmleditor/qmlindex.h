@@ -0,0 +1,93 @@
+/**************************************************************************
+**
+** This file is part of Qt Creator
+**
+** Copyright (c) 2009 Nokia Corporation and/or its subsidiary(-ies).
+**
+** Contact: Nokia Corporation (qt-info@nokia.com)
+**
+** Commercial Usage
+**
+** Licensees holding valid Qt Commercial licenses may use this file in
+** accordance with the Qt Commercial License Agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Nokia.
+**
+** GNU Lesser General Public License Usage
+**
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** If you are unsure which license is appropriate for your use, please
+** contact the sales department at http://qt.nokia.com/contact.
+**
+**************************************************************************/
+
+
+#ifndef QMLINDEX_H
+#define QMLINDEX_H
+
+#include <QtCore/QHash>
+#include <QtCore/QSet>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+
+#include "qmldocument.h"
+#include "qmleditor_global.h"
+
+namespace QmlEditor {
+
+// The components defined by the .qml files of the open projects, for
+// completion and hover. Every file is stored with its modification time, so
+// unchanged files need not be parsed again, and the index of a project can be
+// saved to disk and reused by the next session. The sorted list of component
+// names is kept up to date on every change, as completion asks for it on
+// every invocation.
+class QMLEDITOR_EXPORT QmlIndex
+{
+public:
+    struct Component
+    {
+        Component() : modified(0) {}
+
+        QString name;
+        QString fileName;
+        QString baseType;
+        QStringList properties;
+        uint modified; // 0 if taken from an editor
+    };
+
+    bool isEmpty() const;
+
+    // Components with the given name, from all directories
+    QList<Component> components(const QString &name) const;
+    QStringList componentNames() const;
+    QStringList fileNames() const;
+
+    bool isUpToDate(const QString &fileName, uint modified) const;
+    void insert(const Component &component);
+    void remove(const QString &fileName);
+    // Adds the files of other that are not in this index
+    void unite(const QmlIndex &other);
+    // The part of this index made of the given files
+    QmlIndex subset(const QSet<QString> &fileNames) const;
+
+    static Component scan(const QmlDocument::Ptr &doc, uint modified);
+
+    // Files that no longer exist are dropped while loading
+    bool load(const QString &fileName);
+    bool save(const QString &fileName) const;
+
+private:
+    QHash<QString, Component> m_files;
+    QMultiHash<QString, QString> m_names; // component name -> file name
+    QStringList m_componentNames; // sorted unique keys of m_names
+};
+
+} // namespace QmlEditor
+
+#endif // QMLINDEX_H
@@ -27,7 +27,13 @@
 **
 **************************************************************************/
 
+#include <QCryptographicHash>
+#include <QDateTime>
 #include <QFile>
+#include <QFileInfo>
+#include <QSettings>
+#include <QThread>
+#include <QtConcurrentMap>
 #include <QtConcurrentRun>
 #include <qtconcurrent/runextensions.h>
 #include <QTextStream>
@@ -48,13 +54,26 @@ using namespace QmlEditor::Internal;
 
 QmlModelManager::QmlModelManager(QObject *parent):
         QmlModelManagerInterface(parent),
-        m_core(Core::ICore::instance())
+        m_core(Core::ICore::instance()),
+        m_parserThread(this)
 {
     m_synchronizer.setCancelOnWait(true);
 
+    m_indexDirectory = QFileInfo(m_core->settings()->fileName()).path()
+            + QLatin1String("/qtcreator/qmlindex/");
+
     qRegisterMetaType<QmlDocument::Ptr>("QmlDocument::Ptr");
+    qRegisterMetaType<SemanticInfo>("QmlEditor::Internal::SemanticInfo");
 
     connect(this, SIGNAL(documentUpdated(QmlDocument::Ptr)), this, SLOT(onDocumentUpdated(QmlDocument::Ptr)));
+
+    m_parserThread.start();
+}
+
+QmlModelManager::~QmlModelManager()
+{
+    m_parserThread.abort();
+    m_parserThread.wait();
 }
 
 Snapshot QmlModelManager::snapshot() const
@@ -64,12 +83,125 @@ Snapshot QmlModelManager::snapshot() const
     return _snapshot;
 }
 
+QmlIndex QmlModelManager::index() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    return m_index;
+}
+
+void QmlModelManager::updateIndex(const QList<QmlIndex::Component> &components)
+{
+    QMutexLocker locker(&m_mutex);
+
+    // Results for files removed from their project in the meantime,
+    // or for editors on files outside of projects, are not kept.
+    foreach (const QmlIndex::Component &component, components) {
+        if (isProjectFile(component.fileName))
+            m_index.insert(component);
+    }
+}
+
+void QmlModelManager::mergeIndex(const QmlIndex &index)
+{
+    QMutexLocker locker(&m_mutex);
+
+    QSet<QString> fileNames;
+    foreach (const QString &fileName, index.fileNames()) {
+        if (isProjectFile(fileName))
+            fileNames.insert(fileName);
+    }
+    m_index.unite(index.subset(fileNames));
+}
+
+QmlIndex QmlModelManager::projectIndex(const QString &projectFileName) const
+{
+    QMutexLocker locker(&m_mutex);
+
+    return m_index.subset(m_projectFiles.value(projectFileName));
+}
+
 void QmlModelManager::updateSourceFiles(const QStringList &files)
 {
-    refreshSourceFiles(files);
+    refreshSourceFiles(QString(), files);
+}
+
+void QmlModelManager::updateProjectFiles(const QString &projectFileName, const QStringList &files)
+{
+    QStringList removedFiles;
+    {
+        QMutexLocker locker(&m_mutex);
+
+        const QSet<QString> newFiles = files.toSet();
+        const QSet<QString> oldFiles = m_projectFiles.value(projectFileName);
+        m_projectFiles.insert(projectFileName, newFiles);
+        removedFiles = pruneFiles(oldFiles - newFiles);
+    }
+    if (!removedFiles.isEmpty())
+        emit aboutToRemoveFiles(removedFiles);
+
+    refreshSourceFiles(projectFileName, files);
+}
+
+void QmlModelManager::removeProject(const QString &projectFileName)
+{
+    QStringList removedFiles;
+    {
+        QMutexLocker locker(&m_mutex);
+
+        m_loadedIndexes.remove(projectFileName);
+        removedFiles = pruneFiles(m_projectFiles.take(projectFileName));
+    }
+    if (!removedFiles.isEmpty())
+        emit aboutToRemoveFiles(removedFiles);
+}
+
+// Needs m_mutex to be locked.
+bool QmlModelManager::isProjectFile(const QString &fileName) const
+{
+    QHash<QString, QSet<QString> >::const_iterator it = m_projectFiles.constBegin();
+    for (; it != m_projectFiles.constEnd(); ++it) {
+        if (it->contains(fileName))
+            return true;
+    }
+    return false;
+}
+
+// Drops the files that are not part of any open project any more.
+// Needs m_mutex to be locked.
+QStringList QmlModelManager::pruneFiles(const QSet<QString> &files)
+{
+    QStringList removedFiles;
+    foreach (const QString &fileName, files) {
+        if (isProjectFile(fileName))
+            continue;
+        m_index.remove(fileName);
+        _snapshot.remove(fileName);
+        removedFiles.append(fileName);
+    }
+    return removedFiles;
+}
+
+bool QmlModelManager::startLoadingIndex(const QString &projectFileName)
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (projectFileName.isEmpty() || m_loadedIndexes.contains(projectFileName)
+            || !m_projectFiles.contains(projectFileName))
+        return false;
+    m_loadedIndexes.insert(projectFileName);
+    return true;
+}
+
+QString QmlModelManager::indexFileName(const QString &projectFileName) const
+{
+    const QByteArray hash = QCryptographicHash::hash(projectFileName.toUtf8(),
+                                                     QCryptographicHash::Md5);
+    return m_indexDirectory + QString::fromLatin1(hash.toHex()) + QLatin1String(".dat");
 }
 
-QFuture<void> QmlModelManager::refreshSourceFiles(const QStringList &sourceFiles)
+QFuture<void> QmlModelManager::refreshSourceFiles(const QString &projectFileName,
+                                                  const QStringList &sourceFiles)
 {
     if (sourceFiles.isEmpty()) {
         return QFuture<void>();
@@ -79,7 +211,7 @@ QFuture<void> QmlModelManager::refreshSourceFiles(const QStringList &sourceFiles
 
     QFuture<void> result = QtConcurrent::run(&QmlModelManager::parse,
                                               workingCopy, sourceFiles,
-                                              this);
+                                              projectFileName, this);
 
     if (m_synchronizer.futures().size() > 10) {
         QList<QFuture<void> > futures = m_synchronizer.futures();
@@ -119,9 +251,18 @@ QMap<QString, QString> QmlModelManager::buildWorkingCopyList()
     return workingCopy;
 }
 
+void QmlModelManager::updateEditorDocument(const QString &fileName, const QString &contents,
+                                           int revision)
+{
+    m_parserThread.update(fileName, contents, revision);
+}
+
 void QmlModelManager::emitDocumentUpdated(QmlDocument::Ptr doc)
 { emit documentUpdated(doc); }
 
+void QmlModelManager::emitSemanticInfoUpdated(const SemanticInfo &info)
+{ emit semanticInfoUpdated(info); }
+
 void QmlModelManager::onDocumentUpdated(QmlDocument::Ptr doc)
 {
     QMutexLocker locker(&m_mutex);
@@ -129,37 +270,171 @@ void QmlModelManager::onDocumentUpdated(QmlDocument::Ptr doc)
     _snapshot.insert(doc);
 }
 
-void QmlModelManager::parse(QFutureInterface<void> &future,
-                            QMap<QString, QString> workingCopy,
-                            QStringList files,
-                            QmlModelManager *modelManager)
+namespace {
+
+struct ParsedFile
+{
+    QmlDocument::Ptr document;
+    QmlIndex::Component component;
+};
+
+class ParseFile
 {
-    future.setProgressRange(0, files.size());
+public:
+    typedef ParsedFile result_type;
 
-    for (int i = 0; i < files.size(); ++i) {
-        future.setProgressValue(i);
+    ParseFile(const QMap<QString, QString> &workingCopy)
+        : m_workingCopy(workingCopy)
+    {}
 
-        const QString fileName = files.at(i);
+    ParsedFile operator()(const QString &fileName) const
+    {
         QString contents;
+        uint modified = 0;
 
-        if (workingCopy.contains(fileName)) {
-            contents = workingCopy.value(fileName);
+        if (m_workingCopy.contains(fileName)) {
+            contents = m_workingCopy.value(fileName);
         } else {
             QFile inFile(fileName);
 
             if (inFile.open(QIODevice::ReadOnly)) {
+                modified = QFileInfo(inFile).lastModified().toTime_t();
                 QTextStream ins(&inFile);
                 contents = ins.readAll();
                 inFile.close();
             }
         }
 
+        ParsedFile result;
+        result.document = QmlDocument::create(fileName);
+        result.document->setSource(contents);
+        result.document->parse();
+        result.component = QmlIndex::scan(result.document, modified);
+        return result;
+    }
+
+private:
+    QMap<QString, QString> m_workingCopy;
+};
+
+} // anonymous namespace
+
+void QmlModelManager::parse(QFutureInterface<void> &future,
+                            QMap<QString, QString> workingCopy,
+                            QStringList files,
+                            QString projectFileName,
+                            QmlModelManager *modelManager)
+{
+    // One refresh at a time, each one continues with the index of the last.
+    QMutexLocker indexLocker(&modelManager->m_indexFileMutex);
+
+    const QString indexFileName = modelManager->indexFileName(projectFileName);
+    if (modelManager->startLoadingIndex(projectFileName)) {
+        QmlIndex loaded;
+        if (loaded.load(indexFileName))
+            modelManager->mergeIndex(loaded); // Completion works before parsing is done
+    }
+
+    // Files that did not change since they were parsed are kept.
+    const Snapshot snapshot = modelManager->snapshot();
+    const QmlIndex index = modelManager->index();
+    QStringList outdated;
+    foreach (const QString &fileName, files) {
+        if (! workingCopy.contains(fileName) && snapshot.contains(fileName)
+                && index.isUpToDate(fileName, QFileInfo(fileName).lastModified().toTime_t()))
+            continue;
+        outdated.append(fileName);
+    }
+
+    future.setProgressRange(0, outdated.size());
+
+    // Parse in parallel, in batches so that a cancel does not have to wait
+    // for all of them.
+    const int batchSize = qMax(1, QThread::idealThreadCount()) * 4;
+    int processed = 0;
+    while (processed < outdated.size()) {
+        if (future.isCanceled())
+            break;
+
+        const QStringList batch = outdated.mid(processed, batchSize);
+        const QList<ParsedFile> parsed =
+                QtConcurrent::blockingMapped<QList<ParsedFile> >(batch, ParseFile(workingCopy));
+
+        QList<QmlIndex::Component> components;
+        foreach (const ParsedFile &file, parsed) {
+            components.append(file.component);
+            modelManager->emitDocumentUpdated(file.document);
+        }
+        modelManager->updateIndex(components);
+
+        processed += batch.size();
+        future.setProgressValue(processed);
+    }
+
+    // Also keep what was parsed before a cancel
+    if (processed && !projectFileName.isEmpty()) {
+        const QmlIndex projectIndex = modelManager->projectIndex(projectFileName);
+        if (!projectIndex.isEmpty()) // Otherwise the project was closed meanwhile
+            projectIndex.save(indexFileName);
+    }
+}
+
+QmlParserThread::QmlParserThread(QmlModelManager *modelManager)
+    : m_modelManager(modelManager),
+      m_done(false)
+{
+}
+
+void QmlParserThread::abort()
+{
+    QMutexLocker locker(&m_mutex);
+    m_done = true;
+    m_condition.wakeOne();
+}
+
+void QmlParserThread::update(const QString &fileName, const QString &contents, int revision)
+{
+    QMutexLocker locker(&m_mutex);
+    Job &job = m_jobs[fileName];
+    job.contents = contents;
+    job.revision = revision;
+    m_condition.wakeOne();
+}
+
+bool QmlParserThread::isOutdated(const QString &fileName)
+{
+    QMutexLocker locker(&m_mutex);
+    return m_done || m_jobs.contains(fileName);
+}
+
+void QmlParserThread::run()
+{
+    forever {
+        m_mutex.lock();
+
+        while (! (m_done || ! m_jobs.isEmpty()))
+            m_condition.wait(&m_mutex);
+
+        if (m_done) {
+            m_mutex.unlock();
+            break;
+        }
+
+        const QString fileName = m_jobs.begin().key();
+        const Job job = m_jobs.take(fileName);
+
+        m_mutex.unlock();
+
         QmlDocument::Ptr doc = QmlDocument::create(fileName);
-        doc->setSource(contents);
+        doc->setSource(job.contents);
         doc->parse();
 
-        modelManager->emitDocumentUpdated(doc);
-    }
+        const SemanticInfo info = SemanticInfo::create(doc, job.revision);
 
-    future.setProgressValue(files.size());
+        if (! isOutdated(fileName)) {
+            m_modelManager->updateIndex(QList<QmlIndex::Component>() << QmlIndex::scan(doc, 0));
+            m_modelManager->emitDocumentUpdated(doc);
+            m_modelManager->emitSemanticInfoUpdated(info);
+        }
+    }
 }
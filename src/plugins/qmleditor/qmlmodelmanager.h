@@ -32,10 +32,16 @@
 
 #include <QFuture>
 #include <QFutureSynchronizer>
+#include <QHash>
 #include <QMutex>
+#include <QSet>
+#include <QThread>
+#include <QWaitCondition>
 
 #include "qmldocument.h"
+#include "qmlindex.h"
 #include "qmlmodelmanagerinterface.h"
+#include "qmlsemanticinfo.h"
 
 namespace Core {
 class ICore;
@@ -44,22 +50,66 @@ class ICore;
 namespace QmlEditor {
 namespace Internal {
 
+class QmlModelManager;
+
+// Parses the documents of open editors one at a time. A request for a file
+// replaces any pending request for the same file, so while typing only the
+// latest revision is parsed, and results overtaken by a newer request are
+// dropped instead of being published.
+class QmlParserThread: public QThread
+{
+public:
+    QmlParserThread(QmlModelManager *modelManager);
+
+    void abort();
+    void update(const QString &fileName, const QString &contents, int revision);
+
+protected:
+    virtual void run();
+
+private:
+    struct Job
+    {
+        QString contents;
+        int revision;
+    };
+
+    bool isOutdated(const QString &fileName);
+
+    QmlModelManager *m_modelManager;
+    QMutex m_mutex;
+    QWaitCondition m_condition;
+    QMap<QString, Job> m_jobs;
+    bool m_done;
+};
+
 class QmlModelManager: public QmlModelManagerInterface
 {
     Q_OBJECT
 
 public:
     QmlModelManager(QObject *parent = 0);
+    virtual ~QmlModelManager();
 
     virtual Snapshot snapshot() const;
+    virtual QmlIndex index() const;
     virtual void updateSourceFiles(const QStringList &files);
+    virtual void updateProjectFiles(const QString &projectFileName, const QStringList &files);
+    virtual void removeProject(const QString &projectFileName);
+    virtual void updateEditorDocument(const QString &fileName, const QString &contents,
+                                      int revision);
 
     void emitDocumentUpdated(QmlDocument::Ptr doc);
+    void emitSemanticInfoUpdated(const SemanticInfo &info);
+    void updateIndex(const QList<QmlIndex::Component> &components);
+    void mergeIndex(const QmlIndex &index);
+    QmlIndex projectIndex(const QString &projectFileName) const;
 
 Q_SIGNALS:
     void projectPathChanged(const QString &projectPath);
 
     void documentUpdated(QmlDocument::Ptr doc);
+    void semanticInfoUpdated(const QmlEditor::Internal::SemanticInfo &info);
     void aboutToRemoveFiles(const QStringList &files);
 
 private Q_SLOTS:
@@ -67,20 +117,34 @@ private Q_SLOTS:
     void onDocumentUpdated(QmlDocument::Ptr doc);
 
 protected:
-    QFuture<void> refreshSourceFiles(const QStringList &sourceFiles);
+    QFuture<void> refreshSourceFiles(const QString &projectFileName,
+                                     const QStringList &sourceFiles);
     QMap<QString, QString> buildWorkingCopyList();
 
     static void parse(QFutureInterface<void> &future,
                       QMap<QString, QString> workingCopy,
                       QStringList files,
+                      QString projectFileName,
                       QmlModelManager *modelManager);
 
 private:
+    QString indexFileName(const QString &projectFileName) const;
+    bool isProjectFile(const QString &fileName) const;
+    QStringList pruneFiles(const QSet<QString> &files);
+    bool startLoadingIndex(const QString &projectFileName);
+
     mutable QMutex m_mutex;
     Core::ICore *m_core;
     Snapshot _snapshot;
+    QmlIndex m_index; // files of open projects only
+    QHash<QString, QSet<QString> > m_projectFiles; // by project file name
+    QSet<QString> m_loadedIndexes; // projects whose saved index was read
+
+    QMutex m_indexFileMutex; // one refresh at a time
+    QString m_indexDirectory;
 
     QFutureSynchronizer<void> m_synchronizer;
+    QmlParserThread m_parserThread;
 };
 
 } // namespace Internal
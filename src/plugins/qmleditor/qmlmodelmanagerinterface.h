@@ -37,6 +37,7 @@
 
 namespace QmlEditor {
 
+class QmlIndex;
 class Snapshot;
 
 class QMLEDITOR_EXPORT QmlModelManagerInterface: public QObject
@@ -48,7 +49,19 @@ public:
     virtual ~QmlModelManagerInterface();
 
     virtual Snapshot snapshot() const = 0;
+    virtual QmlIndex index() const = 0;
     virtual void updateSourceFiles(const QStringList &files) = 0;
+
+    // Sets the files of a project and reparses them. The index only
+    // covers files of open projects, files no longer part of any are
+    // dropped from it.
+    virtual void updateProjectFiles(const QString &projectFileName,
+                                    const QStringList &files) = 0;
+    virtual void removeProject(const QString &projectFileName) = 0;
+
+    // Reparses the contents of an open editor in the background.
+    virtual void updateEditorDocument(const QString &fileName, const QString &contents,
+                                      int revision) = 0;
 };
 
 }
@@ -0,0 +1,86 @@
+/**************************************************************************
+**
+** This file is part of Qt Creator
+**
+** Copyright (c) 2009 Nokia Corporation and/or its subsidiary(-ies).
+**
+** Contact: Nokia Corporation (qt-info@nokia.com)
+**
+** Commercial Usage
+**
+** Licensees holding valid Qt Commercial licenses may use this file in
+** accordance with the Qt Commercial License Agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Nokia.
+**
+** GNU Lesser General Public License Usage
+**
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** If you are unsure which license is appropriate for your use, please
+** contact the sales department at http://qt.nokia.com/contact.
+**
+**************************************************************************/
+
+
+#ifndef QMLSEMANTICINFO_H
+#define QMLSEMANTICINFO_H
+
+#include "qmldocument.h"
+#include "qmljsastfwd_p.h"
+
+#include <QtCore/QList>
+#include <QtCore/QMap>
+#include <QtCore/QMetaType>
+#include <QtCore/QStringList>
+
+namespace QmlEditor {
+namespace Internal {
+
+struct Declaration
+{
+    QString text;
+    int startLine;
+    int startColumn;
+    int endLine;
+    int endColumn;
+
+    Declaration()
+        : startLine(0),
+        startColumn(0),
+        endLine(0),
+        endColumn(0)
+    { }
+};
+
+// What the editor needs to know about one revision of its document.
+// Computed by the model manager's parser thread.
+class SemanticInfo
+{
+public:
+    typedef QMap<QString, QList<QmlJS::AST::SourceLocation> > IdMap; // ### use QMultiMap
+
+    SemanticInfo()
+        : revision(-1)
+    { }
+
+    static SemanticInfo create(QmlDocument::Ptr document, int revision);
+
+    int revision;
+    QmlDocument::Ptr document;
+    IdMap ids;
+    QList<Declaration> declarations; // Only set if the document parsed correctly.
+    QStringList words;               // Ditto.
+};
+
+} // namespace Internal
+} // namespace QmlEditor
+
+Q_DECLARE_METATYPE(QmlEditor::Internal::SemanticInfo)
+
+#endif // QMLSEMANTICINFO_H
@@ -83,6 +83,7 @@ QmlProject::QmlProject(Manager *manager, const QString &fileName)
 QmlProject::~QmlProject()
 {
     m_manager->unregisterProject(this);
+    m_modelManager->removeProject(m_fileName);
 
     delete m_rootNode;
 }
@@ -125,7 +126,7 @@ void QmlProject::parseProject(RefreshOptions options)
     if (options & Files) {
         m_files = convertToAbsoluteFiles(readLines(filesFileName()));
         m_files.removeDuplicates();
-        m_modelManager->updateSourceFiles(m_files);
+        m_modelManager->updateProjectFiles(m_fileName, m_files);
     }
 
     if (options & Configuration) {
@@ -60,7 +60,7 @@ BaseFileFind::BaseFileFind(SearchResultWindow *resultWindow)
     m_useRegExpCheckBox(0)
 {
     m_watcher.setPendingResultsLimit(1);
-    connect(&m_watcher, SIGNAL(resultReadyAt(int)), this, SLOT(displayResult(int)));
+    connect(&m_watcher, SIGNAL(resultsReadyAt(int,int)), this, SLOT(displayResults(int,int)));
     connect(&m_watcher, SIGNAL(finished()), this, SLOT(searchFinished()));
 }
 
@@ -95,9 +95,9 @@ void BaseFileFind::findAll(const QString &txt, QTextDocument::FindFlags findFlag
     connect(result, SIGNAL(activated(Find::SearchResultItem)), this, SLOT(openEditor(Find::SearchResultItem)));
     m_resultWindow->popup(true);
     if (m_useRegExp)
-        m_watcher.setFuture(Utils::findInFilesRegExp(txt, files(), findFlags, ITextEditor::openedTextEditorsContents()));
+        m_watcher.setFuture(Utils::findInFilesRegExp(txt, files(), findFlags, ITextEditor::openedTextEditorsUtf8Contents()));
     else
-        m_watcher.setFuture(Utils::findInFiles(txt, files(), findFlags, ITextEditor::openedTextEditorsContents()));
+        m_watcher.setFuture(Utils::findInFiles(txt, files(), findFlags, ITextEditor::openedTextEditorsUtf8Contents()));
     Core::FutureProgress *progress = 
         Core::ICore::instance()->progressManager()->addTask(m_watcher.future(),
                                                                         "Search",
@@ -108,13 +108,21 @@ void BaseFileFind::findAll(const QString &txt, QTextDocument::FindFlags findFlag
     connect(progress, SIGNAL(clicked()), m_resultWindow, SLOT(popup()));
 }
 
-void BaseFileFind::displayResult(int index) {
-    Utils::FileSearchResult result = m_watcher.future().resultAt(index);
-    m_resultWindow->addResult(result.fileName,
-                              result.lineNumber,
-                              result.matchingLine,
-                              result.matchStart,
-                              result.matchLength);
+void BaseFileFind::displayResults(int begin, int end)
+{
+    QList<Find::SearchResultItem> items;
+    for (int index = begin; index < end; ++index) {
+        const Utils::FileSearchResult result = m_watcher.future().resultAt(index);
+        Find::SearchResultItem item;
+        item.fileName = result.fileName;
+        item.lineNumber = result.lineNumber;
+        item.lineText = result.matchingLine;
+        item.searchTermStart = result.matchStart;
+        item.searchTermLength = result.matchLength;
+        item.index = index;
+        items.append(item);
+    }
+    m_resultWindow->addResults(items);
     if (m_resultLabel)
         m_resultLabel->setText(tr("%1 found").arg(m_resultWindow->numberOfResults()));
 }
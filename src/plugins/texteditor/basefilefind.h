@@ -75,7 +75,7 @@ protected:
     QStringList fileNameFilters() const;
 
 private slots:
-    void displayResult(int index);
+    void displayResults(int begin, int end);
     void searchFinished();
     void openEditor(const Find::SearchResultItem &item);
     void syncRegExpSetting(bool useRegExp);
@@ -63,6 +63,9 @@ BaseTextDocument::BaseTextDocument()
     m_isBinaryData = false;
     m_codec = QTextCodec::codecForLocale();
     m_hasDecodingError = false;
+    m_revision = 0;
+    m_snapshotRevision = -1;
+    connect(m_document, SIGNAL(contentsChanged()), this, SLOT(documentContentsChanged()));
 }
 
 BaseTextDocument::~BaseTextDocument()
@@ -130,6 +133,27 @@ bool BaseTextDocument::save(const QString &fileName)
     return true;
 }
 
+/*
+ * Returns the contents of the document. The UTF-8 text is kept until the
+ * document changes, so taking snapshots repeatedly does not copy it again.
+ */
+DocumentSnapshot BaseTextDocument::snapshot() const
+{
+    if (m_snapshotRevision != m_revision) {
+        m_snapshotContents = m_document->toPlainText().toUtf8();
+        m_snapshotRevision = m_revision;
+    }
+    return DocumentSnapshot(m_fileName, m_revision, m_snapshotContents);
+}
+
+void BaseTextDocument::documentContentsChanged()
+{
+    ++m_revision;
+    // Snapshots handed out keep the old text alive
+    m_snapshotContents.clear();
+    m_snapshotRevision = -1;
+}
+
 bool BaseTextDocument::isReadOnly() const
 {
     if (m_isBinaryData || m_hasDecodingError)
@@ -63,6 +63,27 @@ private:
 };
 
 
+/* The UTF-8 text of a document at one revision. Copies share the text,
+ * so a snapshot can be handed to worker threads without copying it. */
+class TEXTEDITOR_EXPORT DocumentSnapshot
+{
+public:
+    DocumentSnapshot() : m_revision(-1) {}
+    DocumentSnapshot(const QString &fileName, int revision, const QByteArray &utf8Contents)
+        : m_fileName(fileName), m_revision(revision), m_utf8Contents(utf8Contents) {}
+
+    inline bool isNull() const { return m_revision < 0; }
+    inline QString fileName() const { return m_fileName; }
+    inline int revision() const { return m_revision; }
+    inline QByteArray utf8Contents() const { return m_utf8Contents; }
+
+private:
+    QString m_fileName;
+    int m_revision;
+    QByteArray m_utf8Contents;
+};
+
+
 class TEXTEDITOR_EXPORT BaseTextDocument : public Core::IFile
 {
     Q_OBJECT
@@ -113,11 +134,17 @@ public:
 
     void cleanWhitespace(const QTextCursor &cursor);
 
+    inline int revision() const { return m_revision; }
+    DocumentSnapshot snapshot() const;
+
 signals:
     void titleChanged(QString title);
     void aboutToReload();
     void reloaded();
 
+private slots:
+    void documentContentsChanged();
+
 private:
     QString m_fileName;
     QString m_defaultPath;
@@ -147,6 +174,10 @@ private:
     bool m_hasDecodingError;
     QByteArray m_decodingErrorSample;
 
+    int m_revision;
+    mutable int m_snapshotRevision;
+    mutable QByteArray m_snapshotContents;
+
     void cleanWhitespace(QTextCursor& cursor, bool cleanIndentation, bool inEntireDocument);
     void ensureFinalNewLine(QTextCursor& cursor);
 };
@@ -28,20 +28,30 @@
 **************************************************************************/
 
 #include "itexteditor.h"
+#include "basetextdocument.h"
 
 #include <coreplugin/editormanager/editormanager.h>
 
 using namespace TextEditor;
 
-QMap<QString, QString> ITextEditor::openedTextEditorsContents()
+/*
+ * Returns the UTF-8 text of the open text editors. The text is shared with
+ * the snapshots of the documents, see BaseTextDocument::snapshot().
+ */
+QMap<QString, QByteArray> ITextEditor::openedTextEditorsUtf8Contents()
 {
-    QMap<QString, QString> workingCopy;
+    QMap<QString, QByteArray> workingCopy;
     foreach (Core::IEditor *editor, Core::EditorManager::instance()->openedEditors()) {
         ITextEditor *textEditor = qobject_cast<ITextEditor *>(editor);
         if (!textEditor)
             continue;
         QString fileName = textEditor->file()->fileName();
-        workingCopy[fileName] = textEditor->contents();
+        if (workingCopy.contains(fileName))
+            continue;
+        if (BaseTextDocument *document = qobject_cast<BaseTextDocument *>(textEditor->file()))
+            workingCopy[fileName] = document->snapshot().utf8Contents();
+        else
+            workingCopy[fileName] = textEditor->contents().toUtf8();
     }
     return workingCopy;
 }
@@ -120,7 +120,7 @@ public:
     virtual void setTextCodec(QTextCodec *) = 0;
     virtual QTextCodec *textCodec() const = 0;
 
-    static QMap<QString, QString> openedTextEditorsContents();
+    static QMap<QString, QByteArray> openedTextEditorsUtf8Contents();
 
 signals:
     void contentsChanged();
@@ -0,0 +1,24 @@
+TARGET = ananasquery
+TEMPLATE = app
+QT += xml
+CONFIG += console
+macx:CONFIG -= app_bundle
+
+include(../../../qtcreator.pri)
+
+LIBANANASDIR = ../../plugins/ananasprojectmanager/libananas
+
+DEFINES += ANANAS_NO_DLL
+
+INCLUDEPATH += $$IDE_SOURCE_TREE/src/plugins $$LIBANANASDIR
+
+SOURCES += \
+    main.cpp \
+    $$LIBANANASDIR/acfg.cpp \
+    $$LIBANANASDIR/acfgvalidator.cpp
+
+HEADERS += \
+    $$LIBANANASDIR/acfg.h \
+    $$LIBANANASDIR/acfgvalidator.h
+
+DESTDIR = $$IDE_APP_PATH
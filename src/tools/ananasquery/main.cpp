@@ -0,0 +1,459 @@
+/**************************************************************************
+**
+** This file is part of Qt Creator
+**
+** Copyright (c) 2009 Nokia Corporation and/or its subsidiary(-ies).
+**
+** Contact: Nokia Corporation (qt-info@nokia.com)
+**
+** Commercial Usage
+**
+** Licensees holding valid Qt Commercial licenses may use this file in
+** accordance with the Qt Commercial License Agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Nokia.
+**
+** GNU Lesser General Public License Usage
+**
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** If you are unsure which license is appropriate for your use, please
+** contact the sales department at http://qt.nokia.com/contact.
+**
+**************************************************************************/
+
+
+/* A headless query tool for Ananas configurations. It loads a configuration
+ * through DomCfgItem and prints objects, fields, reverse references and
+ * diagnostics as JSON, or times loading, traversal and random lookups.
+ * See usage(). */
+
+#include "acfg.h"
+#include "acfgvalidator.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QFile>
+#include <QtCore/QRegExp>
+#include <QtCore/QStringList>
+#include <QtCore/QTextStream>
+#include <QtCore/QTime>
+#include <QtXml/QDomDocument>
+
+#include <iostream>
+
+enum { LookupBatchSize = 1000 };
+
+enum Command { IdCommand, NameCommand, FieldsCommand, RefsCommand,
+               ValidateCommand, BenchmarkCommand };
+
+Command optCommand = IdCommand;
+QString optFileName;
+QString optArgument;
+int optLookups = 10000;
+
+static void usage(const QString &binary, const QString &message = QString())
+{
+    std::cerr << "Usage: " << qPrintable(binary) << " <configuration> <command> [argument]\n\n"
+              << "Commands:\n"
+              << "  id <id>              Print the object with the id\n"
+              << "  name <name>          Print the object with the qualified name,\n"
+              << "                       for example Catalogue.Goods\n"
+              << "  fields <id|name>     List the fields of an object\n"
+              << "  refs <id|name>       List the fields referring to an object\n"
+              << "  validate             List the problems of the configuration,\n"
+              << "                       exits with 2 if there are any\n"
+              << "  benchmark [lookups]  Time loading, a full traversal and random\n"
+              << "                       lookups by id and name (default "
+              << optLookups << ")\n\n"
+              << "Results are written to standard output as JSON.\n";
+    if (!message.isEmpty())
+        std::cerr << '\n' << qPrintable(message) << '\n';
+}
+
+static bool parseArguments(const QStringList &args, QString *errorMessage)
+{
+    if (args.size() < 3) {
+        *errorMessage = QString::fromLatin1("Missing arguments.");
+        return false;
+    }
+    optFileName = args.at(1);
+    const QString command = args.at(2);
+    if (command == QLatin1String("id")) {
+        optCommand = IdCommand;
+    } else if (command == QLatin1String("name")) {
+        optCommand = NameCommand;
+    } else if (command == QLatin1String("fields")) {
+        optCommand = FieldsCommand;
+    } else if (command == QLatin1String("refs")) {
+        optCommand = RefsCommand;
+    } else if (command == QLatin1String("validate")) {
+        optCommand = ValidateCommand;
+    } else if (command == QLatin1String("benchmark")) {
+        optCommand = BenchmarkCommand;
+    } else {
+        *errorMessage = QString::fromLatin1("Unknown command: %1").arg(command);
+        return false;
+    }
+
+    const bool needsArgument = optCommand != ValidateCommand && optCommand != BenchmarkCommand;
+    if (args.size() > 4 || (needsArgument && args.size() != 4)) {
+        *errorMessage = QString::fromLatin1("Wrong number of arguments for %1.").arg(command);
+        return false;
+    }
+    if (args.size() == 4)
+        optArgument = args.at(3);
+    if (optCommand == BenchmarkCommand && !optArgument.isEmpty()) {
+        bool ok = false;
+        optLookups = optArgument.toInt(&ok);
+        if (!ok || optLookups < 0) {
+            *errorMessage = QString::fromLatin1("Invalid number of lookups: %1").arg(optArgument);
+            return false;
+        }
+    }
+    return true;
+}
+
+// --------------- JSON output
+
+static QString jsonString(const QString &s)
+{
+    QString rc = QLatin1String("\"");
+    foreach (const QChar c, s) {
+        switch (c.unicode()) {
+        case '"':
+            rc += QLatin1String("\\\"");
+            break;
+        case '\\':
+            rc += QLatin1String("\\\\");
+            break;
+        case '\n':
+            rc += QLatin1String("\\n");
+            break;
+        case '\r':
+            rc += QLatin1String("\\r");
+            break;
+        case '\t':
+            rc += QLatin1String("\\t");
+            break;
+        default:
+            if (c.unicode() < 0x20)
+                rc += QString::fromLatin1("\\u%1").arg(c.unicode(), 4, 16, QLatin1Char('0'));
+            else
+                rc += c;
+            break;
+        }
+    }
+    rc += QLatin1Char('"');
+    return rc;
+}
+
+static inline QString jsonMember(const char *name, const QString &json)
+{
+    return jsonString(QLatin1String(name)) + QLatin1Char(':') + json;
+}
+
+static inline QString jsonMember(const char *name, qint64 value)
+{
+    return jsonMember(name, QString::number(value));
+}
+
+static inline QString jsonObject(const QStringList &members)
+{
+    return QLatin1Char('{') + members.join(QLatin1String(",")) + QLatin1Char('}');
+}
+
+static inline QString jsonArray(const QStringList &elements)
+{
+    return QLatin1Char('[') + elements.join(QLatin1String(",")) + QLatin1Char(']');
+}
+
+// --------------- Configuration access
+
+static inline bool isSectionTag(const QString &tagName)
+{
+    return tagName == QLatin1String(md_catalogue) || tagName == QLatin1String(md_document)
+        || tagName == QLatin1String(md_journal) || tagName == QLatin1String(md_report)
+        || tagName == QLatin1String(md_iregister) || tagName == QLatin1String(md_aregister);
+}
+
+static QString elementJson(const QDomElement &element)
+{
+    QStringList members;
+    members << jsonMember("id", jsonString(element.attribute(QLatin1String(mda_id))))
+            << jsonMember("tag", jsonString(element.tagName()))
+            << jsonMember("name", jsonString(element.attribute(QLatin1String(mda_name))))
+            << jsonMember("line", element.lineNumber());
+    return jsonObject(members);
+}
+
+static QString objectJson(DomCfgItem *item)
+{
+    const QDomElement element = item->node().toElement();
+    QStringList members;
+    members << jsonMember("id", jsonString(element.attribute(QLatin1String(mda_id))))
+            << jsonMember("tag", jsonString(element.tagName()))
+            << jsonMember("name", jsonString(element.attribute(QLatin1String(mda_name))))
+            << jsonMember("configName", jsonString(item->configName()))
+            << jsonMember("line", element.lineNumber());
+    return jsonObject(members);
+}
+
+static QString fieldJson(DomCfgItem *root, const QDomElement &field, const QString &ownerJson)
+{
+    const QString type = field.attribute(QLatin1String(mda_type));
+    // The split of the field editor: "O 12" gives "", "O", " ", "12"
+    const QStringList typeParts = type.split(QRegExp(QLatin1String("\\b")));
+    QString typeName;
+    if (typeParts.size() >= 4 || (typeParts.size() >= 2 && typeParts.at(1) != QLatin1String("O")))
+        typeName = root->getNameByType(typeParts);
+
+    QStringList members;
+    members << jsonMember("id", jsonString(field.attribute(QLatin1String(mda_id))))
+            << jsonMember("name", jsonString(field.attribute(QLatin1String(mda_name))))
+            << jsonMember("type", jsonString(type))
+            << jsonMember("typeName", jsonString(typeName))
+            << jsonMember("line", field.lineNumber())
+            << jsonMember("owner", ownerJson);
+    return jsonObject(members);
+}
+
+// The catalogue, document, register etc. containing element.
+static QDomElement sectionOf(const QDomElement &element)
+{
+    for (QDomElement e = element.parentNode().toElement(); !e.isNull(); e = e.parentNode().toElement())
+        if (isSectionTag(e.tagName()))
+            return e;
+    return QDomElement();
+}
+
+// The element containing a field, for example a table of a document.
+static inline QDomElement ownerOf(const QDomElement &field)
+{
+    return field.parentNode().toElement();
+}
+
+static DomCfgItem *lookup(DomCfgItem *root, const QString &key)
+{
+    bool isId = false;
+    key.toLongLong(&isId);
+    return isId ? root->findObjectById(key) : root->findByName(key);
+}
+
+static bool load(const QString &fileName, QDomDocument *document, QString *errorMessage)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        *errorMessage = QString::fromLatin1("Cannot open %1: %2").arg(fileName, file.errorString());
+        return false;
+    }
+    QString error;
+    int line = 0;
+    int column = 0;
+    if (!document->setContent(file.readAll(), false, &error, &line, &column)) {
+        *errorMessage = QString::fromLatin1("%1:%2:%3: %4").arg(fileName).arg(line).arg(column).arg(error);
+        return false;
+    }
+    return true;
+}
+
+// Visits every item below item the way the configuration tree does.
+static int traverse(DomCfgItem *item)
+{
+    int count = 0;
+    const int childCount = item->childCount();
+    for (int i = 0; i < childCount; ++i) {
+        DomCfgItem *child = item->child(i);
+        if (!child)
+            continue;
+        ++count;
+        if (child->hasChildren())
+            count += traverse(child);
+    }
+    return count;
+}
+
+static void collectKeys(const QDomElement &element, QStringList *ids, QStringList *names)
+{
+    for (QDomElement child = element.firstChildElement(); !child.isNull(); child = child.nextSiblingElement()) {
+        const QString id = child.attribute(QLatin1String(mda_id));
+        if (!id.isEmpty())
+            ids->append(id);
+        if (child.tagName() == QLatin1String(md_catalogue))
+            names->append(QLatin1String("Catalogue.") + child.attribute(QLatin1String(mda_name)));
+        else if (child.tagName() == QLatin1String(md_document))
+            names->append(QLatin1String("Document.") + child.attribute(QLatin1String(mda_name)));
+        collectKeys(child, ids, names);
+    }
+}
+
+// Looks up count random keys in batches, returns the JSON statistics.
+template <class Lookup>
+static QString timeLookups(const QStringList &keys, int count, Lookup lookupFunction)
+{
+    int found = 0;
+    int totalMs = 0;
+    int slowestBatchMs = 0;
+    for (int done = 0; done < count && !keys.isEmpty(); ) {
+        const int batch = qMin(int(LookupBatchSize), count - done);
+        QTime timer;
+        timer.start();
+        for (int i = 0; i < batch; ++i)
+            if (lookupFunction(keys.at(qrand() % keys.size())))
+                ++found;
+        const int ms = timer.elapsed();
+        totalMs += ms;
+        slowestBatchMs = qMax(slowestBatchMs, ms);
+        done += batch;
+    }
+
+    QStringList members;
+    members << jsonMember("keys", keys.size())
+            << jsonMember("lookups", keys.isEmpty() ? 0 : count)
+            << jsonMember("found", found)
+            << jsonMember("ms", totalMs)
+            << jsonMember("slowestBatchMs", slowestBatchMs);
+    return jsonObject(members);
+}
+
+struct IdLookup
+{
+    explicit IdLookup(DomCfgItem *root) : m_root(root) {}
+    bool operator()(const QString &id) const { return m_root->findObjectById(id) != 0; }
+    DomCfgItem *m_root;
+};
+
+struct NameLookup
+{
+    explicit NameLookup(DomCfgItem *root) : m_root(root) {}
+    bool operator()(const QString &name) const { return m_root->findByName(name) != 0; }
+    DomCfgItem *m_root;
+};
+
+static int benchmark(QTextStream &out, QString *errorMessage)
+{
+    QTime timer;
+    timer.start();
+    QDomDocument document;
+    if (!load(optFileName, &document, errorMessage))
+        return 1;
+    DomCfgItem *root = new DomCfgItem(document, 0);
+    const int loadMs = timer.elapsed();
+
+    QStringList ids;
+    QStringList names;
+    collectKeys(document.documentElement(), &ids, &names);
+
+    // Before the traversal the id lookups have to walk the tree.
+    qsrand(1);
+    const QString coldIdLookups = timeLookups(ids, qMin(optLookups, int(LookupBatchSize)), IdLookup(root));
+
+    timer.start();
+    const int items = traverse(root);
+    const int traversalMs = timer.elapsed();
+
+    qsrand(1);
+    const QString idLookups = timeLookups(ids, optLookups, IdLookup(root));
+    const QString nameLookups = timeLookups(names, optLookups, NameLookup(root));
+
+    QStringList members;
+    members << jsonMember("file", jsonString(optFileName))
+            << jsonMember("loadMs", loadMs)
+            << jsonMember("items", items)
+            << jsonMember("traversalMs", traversalMs)
+            << jsonMember("coldIdLookups", coldIdLookups)
+            << jsonMember("idLookups", idLookups)
+            << jsonMember("nameLookups", nameLookups);
+    out << jsonObject(members) << '\n';
+    // The items are owned by their parents and by the id hash of the root,
+    // so the tree is not deleted before exiting.
+    return 0;
+}
+
+static int query(QTextStream &out, QString *errorMessage)
+{
+    QDomDocument document;
+    if (!load(optFileName, &document, errorMessage))
+        return 1;
+    DomCfgItem *root = new DomCfgItem(document, 0);
+
+    if (optCommand == ValidateCommand) {
+        aCfgValidator validator(root);
+        QStringList diagnostics;
+        foreach (const aCfgDiagnostic &diagnostic, validator.validate()) {
+            QStringList members;
+            members << jsonMember("type", jsonString(QLatin1String(diagnostic.type == aCfgDiagnostic::Error ? "error" : "warning")))
+                    << jsonMember("line", diagnostic.line)
+                    << jsonMember("description", jsonString(diagnostic.description));
+            diagnostics.append(jsonObject(members));
+        }
+        out << jsonArray(diagnostics) << '\n';
+        return diagnostics.isEmpty() ? 0 : 2;
+    }
+
+    DomCfgItem *item = lookup(root, optArgument);
+    if (!item || !item->node().isElement()) {
+        *errorMessage = QString::fromLatin1("No object %1").arg(optArgument);
+        return 1;
+    }
+
+    switch (optCommand) {
+    case IdCommand:
+    case NameCommand:
+        out << objectJson(item) << '\n';
+        break;
+    case FieldsCommand: {
+        QStringList fields;
+        const QDomNodeList fieldNodes = item->node().toElement().elementsByTagName(QLatin1String(md_field));
+        for (int i = 0; i < fieldNodes.count(); ++i) {
+            const QDomElement field = fieldNodes.item(i).toElement();
+            fields.append(fieldJson(root, field, elementJson(ownerOf(field))));
+        }
+        out << jsonObject(QStringList() << jsonMember("object", objectJson(item))
+                                        << jsonMember("fields", jsonArray(fields))) << '\n';
+        break;
+    }
+    case RefsCommand: {
+        const QString id = item->node().toElement().attribute(QLatin1String(mda_id));
+        QStringList references;
+        const QDomNodeList fieldNodes = document.elementsByTagName(QLatin1String(md_field));
+        for (int i = 0; i < fieldNodes.count(); ++i) {
+            const QDomElement field = fieldNodes.item(i).toElement();
+            const QString type = field.attribute(QLatin1String(mda_type));
+            if (type.startsWith(QLatin1String("O ")) && type.section(QLatin1Char(' '), 1, 1) == id) {
+                const QDomElement section = sectionOf(field);
+                references.append(fieldJson(root, field, elementJson(section.isNull() ? ownerOf(field) : section)));
+            }
+        }
+        out << jsonObject(QStringList() << jsonMember("object", objectJson(item))
+                                        << jsonMember("references", jsonArray(references))) << '\n';
+        break;
+    }
+    default:
+        break;
+    }
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QString errorMessage;
+    if (!parseArguments(app.arguments(), &errorMessage)) {
+        usage(QCoreApplication::applicationName(), errorMessage);
+        return 1;
+    }
+
+    QTextStream out(stdout);
+    out.setCodec("UTF-8");
+    const int rc = optCommand == BenchmarkCommand ? benchmark(out, &errorMessage)
+                                                  : query(out, &errorMessage);
+    if (!errorMessage.isEmpty())
+        std::cerr << qPrintable(errorMessage) << '\n';
+    return rc;
+}
@@ -1,2 +1,3 @@
 TEMPLATE = subdirs
-win32:SUBDIRS = qtcdebugger
+SUBDIRS = ananasquery
+win32:SUBDIRS += qtcdebugger
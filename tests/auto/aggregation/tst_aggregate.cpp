@@ -40,6 +40,7 @@ private slots:
     void queryAggregation();
     void queryAll();
     void parentAggregate();
+    void observedRevision();
 };
 
 class Interface1 : public QObject
@@ -191,6 +192,40 @@ void tst_Aggregate::parentAggregate()
     QCOMPARE(Aggregation::Aggregate::parentAggregate(component2), (Aggregation::Aggregate *)0);
 }
 
+void tst_Aggregate::observedRevision()
+{
+    QObject *observed = new QObject;
+    Aggregation::Aggregate::setObserved(observed, true);
+
+    // Aggregates without observed objects do not change the revision
+    int revision = Aggregation::Aggregate::revision();
+    {
+        Aggregation::Aggregate aggregation;
+        aggregation.add(new Interface1);
+        aggregation.add(new Interface2);
+    }
+    QCOMPARE(Aggregation::Aggregate::revision(), revision);
+
+    // Aggregating an observed object later, and changing its aggregate, does
+    Aggregation::Aggregate *aggregation = new Aggregation::Aggregate;
+    Interface1 *component1 = new Interface1;
+    aggregation->add(component1);
+    QCOMPARE(Aggregation::Aggregate::revision(), revision);
+    aggregation->add(observed);
+    QVERIFY(Aggregation::Aggregate::revision() != revision);
+    revision = Aggregation::Aggregate::revision();
+    aggregation->remove(component1);
+    QVERIFY(Aggregation::Aggregate::revision() != revision);
+    revision = Aggregation::Aggregate::revision();
+    delete component1;
+    QCOMPARE(Aggregation::Aggregate::revision(), revision);
+
+    Aggregation::Aggregate::setObserved(observed, false);
+    aggregation->add(new Interface2);
+    QCOMPARE(Aggregation::Aggregate::revision(), revision);
+    delete aggregation; // deletes observed
+}
+
 QTEST_MAIN(tst_Aggregate)
 
 #include "tst_aggregate.moc"
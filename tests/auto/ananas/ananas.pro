@@ -0,0 +1,3 @@
+TEMPLATE = subdirs
+
+SUBDIRS = validator.pro domcfgitem.pro
@@ -0,0 +1,18 @@
+include(../../../qtcreator.pri)
+
+QT += testlib xml
+
+LIBANANASDIR = ../../../src/plugins/ananasprojectmanager/libananas
+
+DEFINES += ANANAS_NO_DLL
+
+INCLUDEPATH += $$IDE_SOURCE_TREE/src/plugins $$LIBANANASDIR
+
+SOURCES += \
+    tst_domcfgitem.cpp \
+    $$LIBANANASDIR/acfg.cpp
+
+HEADERS += \
+    $$LIBANANASDIR/acfg.h
+
+TARGET = tst_$$TARGET
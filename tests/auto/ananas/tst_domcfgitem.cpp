@@ -0,0 +1,155 @@
+/**************************************************************************
+**
+** This file is part of Qt Creator
+**
+** Copyright (c) 2009 Nokia Corporation and/or its subsidiary(-ies).
+**
+** Contact: Nokia Corporation (qt-info@nokia.com)
+**
+** Commercial Usage
+**
+** Licensees holding valid Qt Commercial licenses may use this file in
+** accordance with the Qt Commercial License Agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Nokia.
+**
+** GNU Lesser General Public License Usage
+**
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** If you are unsure which license is appropriate for your use, please
+** contact the sales department at http://qt.nokia.com/contact.
+**
+**************************************************************************/
+
+
+// Checks the notifications DomCfgItem sends to the editors showing it.
+
+#include "acfg.h"
+
+#include <QtCore/QObject>
+#include <QtTest/QtTest>
+#include <QtXml/QDomDocument>
+
+class tst_DomCfgItem : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void changedField();
+    void insertedField();
+    void removedField();
+    void swappedFields();
+
+private:
+    QDomDocument m_document;
+    DomCfgItem *m_root;
+    DomCfgItem *m_element;
+};
+
+// The items are owned by their parents and by the id hash of the root at
+// the same time, so they are not deleted here.
+void tst_DomCfgItem::init()
+{
+    QVERIFY(m_document.setContent(QString(
+        "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        "<ananas_configuration>\n"
+        "<info><name>test</name><lastid>200</lastid></info>\n"
+        "<metadata><catalogues>\n"
+        "<catalogue id=\"101\" name=\"c\"><element>\n"
+        "<field id=\"102\" name=\"a\" type=\"C 10 0 *\"/>\n"
+        "<field id=\"103\" name=\"b\" type=\"C 10 0 *\"/>\n"
+        "<field id=\"104\" name=\"c\" type=\"C 10 0 *\"/>\n"
+        "</element></catalogue>\n"
+        "</catalogues></metadata>\n"
+        "</ananas_configuration>\n")));
+    m_root = new DomCfgItem(m_document, 0, 0);
+    DomCfgItem *catalogues = m_root->find(md_catalogues);
+    QVERIFY(catalogues);
+    m_element = catalogues->child(0)->find(md_element);
+    QVERIFY(m_element);
+    QCOMPARE(m_element->childCount(), 3);
+}
+
+void tst_DomCfgItem::changedField()
+{
+    DomCfgItem *field = m_element->child(1);
+    QSignalSpy dataSpy(field, SIGNAL(dataChanged(QString)));
+    QSignalSpy rowSpy(m_element, SIGNAL(childChanged(int)));
+
+    field->setAttr(mda_name, "renamed");
+
+    QCOMPARE(dataSpy.count(), 1);
+    QCOMPARE(dataSpy.first().at(0).toString(), QString(mda_name));
+    QCOMPARE(rowSpy.count(), 1);
+    QCOMPARE(rowSpy.first().at(0).toInt(), 1);
+}
+
+void tst_DomCfgItem::insertedField()
+{
+    // Items held by open editors must survive the insertion.
+    DomCfgItem *first = m_element->child(0);
+    DomCfgItem *second = m_element->child(1);
+    DomCfgItem *third = m_element->child(2);
+    QSignalSpy insertSpy(m_element, SIGNAL(childInserted(int)));
+
+    DomCfgItem *field = m_element->newElement();
+
+    QCOMPARE(insertSpy.count(), 1);
+    QCOMPARE(insertSpy.first().at(0).toInt(), 3);
+    QCOMPARE(field->row(), 3);
+    QCOMPARE(m_element->child(3), field);
+    QCOMPARE(m_element->child(0), first);
+    QCOMPARE(m_element->child(1), second);
+    QCOMPARE(m_element->child(2), third);
+    QCOMPARE(third->row(), 2);
+}
+
+void tst_DomCfgItem::removedField()
+{
+    DomCfgItem *second = m_element->child(1);
+    DomCfgItem *third = m_element->child(2);
+    QSignalSpy removeSpy(m_element, SIGNAL(childRemoved(int)));
+
+    QVERIFY(m_element->remove(0));
+
+    QCOMPARE(removeSpy.count(), 1);
+    QCOMPARE(removeSpy.first().at(0).toInt(), 0);
+    QCOMPARE(m_element->childCount(), 2);
+    // The items below keep their identity and move up
+    QCOMPARE(m_element->child(0), second);
+    QCOMPARE(m_element->child(1), third);
+    QCOMPARE(second->row(), 0);
+    QCOMPARE(third->row(), 1);
+    QVERIFY(!m_root->findObjectById("102"));
+}
+
+void tst_DomCfgItem::swappedFields()
+{
+    DomCfgItem *first = m_element->child(0);
+    DomCfgItem *second = m_element->child(1);
+    QSignalSpy swapSpy(m_element, SIGNAL(childrenSwapped(int,int)));
+
+    QVERIFY(second->moveUp());
+
+    QCOMPARE(swapSpy.count(), 1);
+    QCOMPARE(swapSpy.first().at(0).toInt(), 0);
+    QCOMPARE(swapSpy.first().at(1).toInt(), 1);
+    QCOMPARE(m_element->child(0), second);
+    QCOMPARE(m_element->child(1), first);
+    QCOMPARE(m_element->node().firstChildElement().attribute(mda_name), QString("b"));
+
+    QSignalSpy rowSpy(m_element, SIGNAL(childChanged(int)));
+    first->setAttr(mda_name, "moved");
+    QCOMPARE(rowSpy.first().at(0).toInt(), 1);
+}
+
+QTEST_MAIN(tst_DomCfgItem)
+
+#include "tst_domcfgitem.moc"
@@ -0,0 +1,234 @@
+/**************************************************************************
+**
+** This file is part of Qt Creator
+**
+** Copyright (c) 2009 Nokia Corporation and/or its subsidiary(-ies).
+**
+** Contact: Nokia Corporation (qt-info@nokia.com)
+**
+** Commercial Usage
+**
+** Licensees holding valid Qt Commercial licenses may use this file in
+** accordance with the Qt Commercial License Agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Nokia.
+**
+** GNU Lesser General Public License Usage
+**
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** If you are unsure which license is appropriate for your use, please
+** contact the sales department at http://qt.nokia.com/contact.
+**
+**************************************************************************/
+
+
+// Checks the configuration validator and measures a full and an
+// incremental pass over a configuration with 10k objects.
+
+#include "acfg.h"
+#include "acfgvalidator.h"
+
+#include <QtCore/QObject>
+#include <QtTest/QtTest>
+#include <QtXml/QDomDocument>
+
+class tst_Validator : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void cleanConfiguration();
+    void duplicateIds();
+    void danglingReference();
+    void missingDefaultForms();
+    void staleLastId();
+    void incrementalRecheck();
+    void fullPass();
+    void incrementalPass();
+
+private:
+    static QString configuration(const QString &metadata, int lastId = 1000);
+    static QString catalogue(int id, const QString &name, const QString &fields = QString());
+    static QString field(int id, const QString &type = QLatin1String("C 10 0 *"));
+    static QString largeConfiguration(int catalogues, int fieldsPerCatalogue);
+    static int count(const QList<aCfgDiagnostic> &diagnostics, aCfgDiagnostic::Type type);
+};
+
+QString tst_Validator::configuration(const QString &metadata, int lastId)
+{
+    return QString("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                   "<ananas_configuration>\n"
+                   "<info><name>test</name><lastid>%1</lastid></info>\n"
+                   "<metadata>\n<catalogues>\n%2</catalogues>\n</metadata>\n"
+                   "</ananas_configuration>\n").arg(lastId).arg(metadata);
+}
+
+QString tst_Validator::catalogue(int id, const QString &name, const QString &fields)
+{
+    return QString("<catalogue id=\"%1\" name=\"%2\">\n<element>\n%3</element>\n</catalogue>\n")
+            .arg(id).arg(name, fields);
+}
+
+QString tst_Validator::field(int id, const QString &type)
+{
+    return QString("<field id=\"%1\" name=\"f%1\" type=\"%2\"/>\n").arg(id).arg(type);
+}
+
+QString tst_Validator::largeConfiguration(int catalogues, int fieldsPerCatalogue)
+{
+    QString metadata;
+    int id = 100;
+    for (int i = 0; i < catalogues; ++i) {
+        const int catalogueId = ++id;
+        QString fields;
+        for (int j = 0; j < fieldsPerCatalogue; ++j)
+            fields += field(++id, j == 0 && i > 0 ? QString("O %1 0 *").arg(catalogueId - fieldsPerCatalogue - 1)
+                                                  : QString("C 10 0 *"));
+        metadata += catalogue(catalogueId, QString("c%1").arg(i), fields);
+    }
+    return configuration(metadata, id);
+}
+
+int tst_Validator::count(const QList<aCfgDiagnostic> &diagnostics, aCfgDiagnostic::Type type)
+{
+    int n = 0;
+    foreach (const aCfgDiagnostic &diagnostic, diagnostics)
+        if (diagnostic.type == type)
+            ++n;
+    return n;
+}
+
+void tst_Validator::cleanConfiguration()
+{
+    QDomDocument document;
+    QVERIFY(document.setContent(configuration(catalogue(101, "a", field(102))
+                                              + catalogue(103, "b", field(104, "O 101 0 *")))));
+    DomCfgItem *root = new DomCfgItem(document, 0, 0);
+    aCfgValidator validator(root);
+    QVERIFY(validator.validate().isEmpty());
+    delete root;
+}
+
+void tst_Validator::duplicateIds()
+{
+    QDomDocument document;
+    QVERIFY(document.setContent(configuration(catalogue(101, "a", field(102))
+                                              + catalogue(103, "b", field(102)))));
+    DomCfgItem *root = new DomCfgItem(document, 0, 0);
+    aCfgValidator validator(root);
+    const QList<aCfgDiagnostic> diagnostics = validator.validate();
+    QCOMPARE(diagnostics.size(), 1);
+    QCOMPARE(diagnostics.first().type, aCfgDiagnostic::Error);
+    QVERIFY(diagnostics.first().description.contains("102"));
+    QVERIFY(diagnostics.first().line > 0);
+    delete root;
+}
+
+void tst_Validator::danglingReference()
+{
+    QDomDocument document;
+    QVERIFY(document.setContent(configuration(catalogue(101, "a", field(102, "O 999 0 *")))));
+    DomCfgItem *root = new DomCfgItem(document, 0, 0);
+    aCfgValidator validator(root);
+    const QList<aCfgDiagnostic> diagnostics = validator.validate();
+    QCOMPARE(diagnostics.size(), 1);
+    QVERIFY(diagnostics.first().description.contains("999"));
+    delete root;
+}
+
+void tst_Validator::missingDefaultForms()
+{
+    QDomDocument document;
+    QVERIFY(document.setContent(configuration(
+        "<catalogue id=\"101\" name=\"a\"><forms>"
+        "<form id=\"102\" name=\"list\"><defaultmod>2</defaultmod></form>"
+        "</forms></catalogue>\n")));
+    DomCfgItem *root = new DomCfgItem(document, 0, 0);
+    aCfgValidator validator(root);
+    const QList<aCfgDiagnostic> diagnostics = validator.validate();
+    // Only the "new" bit is set, viewing and editing have no default form
+    QCOMPARE(count(diagnostics, aCfgDiagnostic::Warning), 2);
+    QCOMPARE(count(diagnostics, aCfgDiagnostic::Error), 0);
+    delete root;
+}
+
+void tst_Validator::staleLastId()
+{
+    QDomDocument document;
+    QVERIFY(document.setContent(configuration(catalogue(101, "a", field(150)), 120)));
+    DomCfgItem *root = new DomCfgItem(document, 0, 0);
+    aCfgValidator validator(root);
+    const QList<aCfgDiagnostic> diagnostics = validator.validate();
+    QCOMPARE(diagnostics.size(), 1);
+    QVERIFY(diagnostics.first().description.contains("150"));
+    delete root;
+}
+
+void tst_Validator::incrementalRecheck()
+{
+    QDomDocument document;
+    QVERIFY(document.setContent(configuration(catalogue(101, "a", field(102))
+                                              + catalogue(103, "b", field(104, "O 999 0 *")))));
+    DomCfgItem *root = new DomCfgItem(document, 0, 0);
+    aCfgValidator validator(root);
+    QCOMPARE(validator.validate().size(), 1);
+
+    QDomNode fieldNode = document.elementsByTagName("field").item(1);
+    DomCfgItem *fieldItem = new DomCfgItem(fieldNode, 0, root);
+    fieldItem->setAttr(mda_type, "O 101 0 *");
+    QVERIFY(validator.validate().isEmpty());
+
+    fieldItem->setAttr(mda_id, "102");
+    QCOMPARE(validator.validate().size(), 1);
+
+    // Removing the first catalogue shifts the second one in its group
+    QDomNode catalogues = document.elementsByTagName("catalogues").item(0);
+    catalogues.removeChild(catalogues.firstChild());
+    root->setModified(catalogues, true);
+    const QList<aCfgDiagnostic> diagnostics = validator.validate();
+    QCOMPARE(diagnostics.size(), 1);
+    QVERIFY(diagnostics.first().description.contains("101"));
+    delete root;
+}
+
+void tst_Validator::fullPass()
+{
+    // 2000 catalogues with 4 fields each, 10k objects
+    QDomDocument document;
+    QVERIFY(document.setContent(largeConfiguration(2000, 4)));
+    DomCfgItem *root = new DomCfgItem(document, 0, 0);
+
+    QBENCHMARK {
+        aCfgValidator validator(root);
+        QVERIFY(validator.validate().isEmpty());
+    }
+    delete root;
+}
+
+void tst_Validator::incrementalPass()
+{
+    QDomDocument document;
+    QVERIFY(document.setContent(largeConfiguration(2000, 4)));
+    DomCfgItem *root = new DomCfgItem(document, 0, 0);
+    aCfgValidator validator(root);
+    QVERIFY(validator.validate().isEmpty());
+
+    QDomNode fieldNode = document.elementsByTagName("field").item(5000);
+    DomCfgItem *fieldItem = new DomCfgItem(fieldNode, 0, root);
+
+    QBENCHMARK {
+        fieldItem->setAttr(mda_name, "renamed");
+        QVERIFY(validator.validate().isEmpty());
+    }
+    delete root;
+}
+
+QTEST_MAIN(tst_Validator)
+
+#include "tst_validator.moc"
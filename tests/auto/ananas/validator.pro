@@ -0,0 +1,20 @@
+include(../../../qtcreator.pri)
+
+QT += testlib xml
+
+LIBANANASDIR = ../../../src/plugins/ananasprojectmanager/libananas
+
+DEFINES += ANANAS_NO_DLL
+
+INCLUDEPATH += $$IDE_SOURCE_TREE/src/plugins $$LIBANANASDIR
+
+SOURCES += \
+    tst_validator.cpp \
+    $$LIBANANASDIR/acfg.cpp \
+    $$LIBANANASDIR/acfgvalidator.cpp
+
+HEADERS += \
+    $$LIBANANASDIR/acfg.h \
+    $$LIBANANASDIR/acfgvalidator.h
+
+TARGET = tst_$$TARGET
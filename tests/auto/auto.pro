@@ -1,8 +1,11 @@
 TEMPLATE = subdirs
 
 SUBDIRS += \
+    ananas \
     cplusplus \
     debugger \
     fakevim \
 #    profilereader \
-    aggregation
+    aggregation \
+    projectexplorer \
+    settingsdatabase
@@ -1,14 +1,24 @@
 
 #include <QtTest>
 #include <QObject>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QLibraryInfo>
 
 #include <AST.h>
 #include <ASTVisitor.h>
 #include <TranslationUnit.h>
+#include <CppBindings.h>
 #include <CppDocument.h>
 #include <LookupContext.h>
 #include <Symbols.h>
 #include <Overview.h>
+#include <Scope.h>
+#include <TypeOfExpression.h>
+#include <PreprocessorClient.h>
+#include <PreprocessorEnvironment.h>
+#include <pp-engine.h>
 
 using namespace CPlusPlus;
 
@@ -49,12 +59,93 @@ protected:
     }
 };
 
+// Preprocesses and parses a file with all its includes into a snapshot.
+class SnapshotBuilder: public Client
+{
+public:
+    SnapshotBuilder(const QStringList &includePaths)
+        : m_includePaths(includePaths), m_preprocess(this, &m_env)
+    { }
+
+    Snapshot snapshot() const
+    { return m_snapshot; }
+
+    Document::Ptr process(const QString &fileName, const QByteArray &source)
+    {
+        Document::Ptr doc = Document::create(fileName);
+        m_snapshot.insert(fileName, doc);
+
+        Document::Ptr previousDoc = m_currentDoc;
+        m_currentDoc = doc;
+        const QByteArray preprocessed = m_preprocess(fileName, source);
+        m_currentDoc = previousDoc;
+
+        doc->setSource(preprocessed);
+        doc->parse();
+        doc->check();
+        return doc;
+    }
+
+    virtual void sourceNeeded(QString &fileName, IncludeType mode, unsigned line)
+    {
+        const QString path = resolve(fileName, mode);
+        if (path.isEmpty())
+            return;
+
+        fileName = path;
+        m_currentDoc->addIncludeFile(path, line);
+        if (m_snapshot.contains(path))
+            return;
+
+        QFile file(path);
+        if (file.open(QFile::ReadOnly))
+            process(path, file.readAll());
+    }
+
+    virtual void macroAdded(const Macro &) {}
+    virtual void passedMacroDefinitionCheck(unsigned, const Macro &) {}
+    virtual void failedMacroDefinitionCheck(unsigned, const QByteArray &) {}
+    virtual void startExpandingMacro(unsigned, const Macro &, const QByteArray &, bool,
+                                     const QVector<MacroArgumentReference> &) {}
+    virtual void stopExpandingMacro(unsigned, const Macro &) {}
+    virtual void startSkippingBlocks(unsigned) {}
+    virtual void stopSkippingBlocks(unsigned) {}
+
+private:
+    QString resolve(const QString &fileName, IncludeType mode) const
+    {
+        QStringList paths = m_includePaths;
+        if (mode == IncludeLocal)
+            paths.prepend(QFileInfo(m_currentDoc->fileName()).absolutePath());
+
+        foreach (const QString &path, paths) {
+            const QFileInfo info(path + QLatin1Char('/') + fileName);
+            if (info.isFile())
+                return QDir::cleanPath(info.absoluteFilePath());
+        }
+        return QString();
+    }
+
+    QStringList m_includePaths;
+    Environment m_env;
+    Preprocessor m_preprocess;
+    Snapshot m_snapshot;
+    Document::Ptr m_currentDoc;
+};
+
 class tst_Lookup: public QObject
 {
     Q_OBJECT
 
 private Q_SLOTS:
     void base_class_defined_1();
+    void visible_scopes_follow_includes();
+    void local_using_directives_expand_until_fixpoint();
+    void bindings_follow_includes();
+
+    // benchmarks
+    void completion_qt_headers_data();
+    void completion_qt_headers();
 };
 
 void tst_Lookup::base_class_defined_1()
@@ -110,5 +201,193 @@ void tst_Lookup::base_class_defined_1()
     QVERIFY(classToAST.value(derivedClass) != 0);
 }
 
+void tst_Lookup::visible_scopes_follow_includes()
+{
+    Document::Ptr header = Document::create("header.h");
+    header->setSource("class Base {};\n");
+    header->parse();
+    header->check();
+
+    Document::Ptr doc = Document::create("visible_scopes_follow_includes");
+    doc->setSource("\nclass Derived: public Base {};\n");
+    doc->addIncludeFile(header->fileName(), 1);
+    doc->parse();
+    doc->check();
+
+    Snapshot snapshot;
+    snapshot.insert(header->fileName(), header);
+    snapshot.insert(doc->fileName(), doc);
+
+    Document::Ptr emptyDoc = Document::create("<empty>");
+    Class *derivedClass = doc->globalSymbolAt(0)->asClass();
+    QVERIFY(derivedClass);
+    Name *baseName = derivedClass->baseClassAt(0)->name();
+
+    LookupContext ctx(derivedClass, emptyDoc, doc, snapshot);
+    QList<Symbol *> candidates = ctx.resolveClass(baseName);
+    QCOMPARE(candidates.size(), 1);
+    QCOMPARE(candidates.at(0), header->globalSymbolAt(0));
+
+    // the same documents reuse the cached global scopes
+    LookupContext sameCtx(derivedClass, emptyDoc, doc, snapshot);
+    QCOMPARE(sameCtx.visibleScopes(), ctx.visibleScopes());
+
+    // a changed include is picked up
+    Document::Ptr newHeader = Document::create("header.h");
+    newHeader->setSource("class Other {};\nclass Base {};\n");
+    newHeader->parse();
+    newHeader->check();
+    snapshot.insert(newHeader->fileName(), newHeader);
+
+    LookupContext newCtx(derivedClass, emptyDoc, doc, snapshot);
+    candidates = newCtx.resolveClass(baseName);
+    QCOMPARE(candidates.size(), 1);
+    QCOMPARE(candidates.at(0), newHeader->globalSymbolAt(1));
+}
+
+void tst_Lookup::local_using_directives_expand_until_fixpoint()
+{
+    // N is expanded with the global scopes already, A is only found in
+    // the block of f(), and C only once A is visible.
+    const QByteArray source =
+        "namespace N {}\n"
+        "using namespace N;\n"
+        "namespace A { namespace C { class Base {}; } using namespace C; }\n"
+        "namespace N {\n"
+        "void f()\n"
+        "{\n"
+        "    using namespace A;\n"
+        "    int x;\n"
+        "}\n"
+        "}\n";
+
+    Document::Ptr doc = Document::create("local_using_directives_expand_until_fixpoint");
+    doc->setSource(source);
+    doc->parse();
+    doc->check();
+    QVERIFY(doc->diagnosticMessages().isEmpty());
+
+    Snapshot snapshot;
+    snapshot.insert(doc->fileName(), doc);
+
+    Symbol *x = doc->findSymbolAt(9, 1);
+    QVERIFY(x);
+
+    Document::Ptr emptyDoc = Document::create("<empty>");
+    LookupContext ctx(x, emptyDoc, doc, snapshot);
+
+    Control *control = doc->control();
+    Name *baseName = control->nameId(control->findOrInsertIdentifier("Base"));
+    const QList<Symbol *> candidates = ctx.resolveClass(baseName);
+    QCOMPARE(candidates.size(), 1);
+    QVERIFY(candidates.at(0)->isClass());
+}
+
+void tst_Lookup::bindings_follow_includes()
+{
+    Document::Ptr header = Document::create("bindings_header.h");
+    header->setSource("namespace NS { class Base {}; }\n");
+    header->parse();
+    header->check();
+
+    Document::Ptr doc = Document::create("bindings_follow_includes");
+    doc->setSource("\nnamespace NS { class Derived: public Base {}; }\n");
+    doc->addIncludeFile(header->fileName(), 1);
+    doc->parse();
+    doc->check();
+
+    Snapshot snapshot;
+    snapshot.insert(header->fileName(), header);
+    snapshot.insert(doc->fileName(), doc);
+
+    Namespace *ns = doc->globalSymbolAt(0)->asNamespace();
+    QVERIFY(ns);
+    Class *derivedClass = ns->memberAt(0)->asClass();
+    QVERIFY(derivedClass);
+    Class *baseClass = header->globalSymbolAt(0)->asNamespace()->memberAt(0)->asClass();
+    QVERIFY(baseClass);
+
+    NamespaceBindingPtr global = bind(doc, snapshot);
+    QVERIFY(global);
+
+    ClassBinding *derivedBinding = NamespaceBinding::find(derivedClass, global.data());
+    QVERIFY(derivedBinding);
+    QCOMPARE(derivedBinding->baseClassBindings.size(), 1);
+    QCOMPARE(derivedBinding->baseClassBindings.at(0),
+             NamespaceBinding::find(baseClass, global.data()));
+    QCOMPARE(NamespaceBinding::find(ns, global.data()),
+             derivedBinding->parent->asNamespaceBinding());
+
+    // the same documents share the cached bindings
+    QCOMPARE(bind(doc, snapshot), global);
+
+    // a new revision of the document is bound on top of its includes
+    Document::Ptr newDoc = Document::create("bindings_follow_includes");
+    newDoc->setSource("\nnamespace NS { class Derived: public Base {}; }\n");
+    newDoc->addIncludeFile(header->fileName(), 1);
+    newDoc->parse();
+    newDoc->check();
+    snapshot.insert(newDoc->fileName(), newDoc);
+
+    NamespaceBindingPtr newGlobal = bind(newDoc, snapshot);
+    QVERIFY(newGlobal != global);
+
+    Class *newDerivedClass = newDoc->globalSymbolAt(0)->asNamespace()->memberAt(0)->asClass();
+    ClassBinding *newDerivedBinding = NamespaceBinding::find(newDerivedClass, newGlobal.data());
+    QVERIFY(newDerivedBinding);
+    QCOMPARE(newDerivedBinding->baseClassBindings.size(), 1);
+    QVERIFY(newDerivedBinding->baseClassBindings.at(0) != 0);
+    QCOMPARE(newDerivedBinding->baseClassBindings.at(0)->symbols.first(), baseClass);
+
+    // the previous bindings are left untouched
+    QCOMPARE(NamespaceBinding::find(derivedClass, global.data()), derivedBinding);
+    QCOMPARE(derivedBinding->baseClassBindings.at(0)->symbols.first(), baseClass);
+}
+
+void tst_Lookup::completion_qt_headers_data()
+{
+    QTest::addColumn<QString>("expression");
+
+    QTest::newRow("variable") << QString("str");
+    QTest::newRow("member call") << QString("str.toLatin1()");
+    QTest::newRow("template") << QString("list.first()");
+    QTest::newRow("qualified") << QString("QString::number(42)");
+}
+
+void tst_Lookup::completion_qt_headers()
+{
+    QFETCH(QString, expression);
+
+    const QString headers = QLibraryInfo::location(QLibraryInfo::HeadersPath);
+    if (! QFileInfo(headers + QLatin1String("/QtCore/QString")).exists())
+        QSKIP("Qt headers not found", SkipAll);
+
+    SnapshotBuilder builder(QStringList() << headers << headers + QLatin1String("/QtCore"));
+    const QByteArray source = "\n"
+        "#include <QtCore/QString>\n"
+        "#include <QtCore/QStringList>\n"
+        "#include <QtCore/QHash>\n"
+        "void completion()\n"
+        "{\n"
+        "    QString str;\n"
+        "    QStringList list;\n"
+        "}\n";
+    Document::Ptr doc = builder.process("completion.cpp", source);
+    const Snapshot snapshot = builder.snapshot();
+    QVERIFY(snapshot.size() > 10);
+
+    Symbol *lastVisibleSymbol = doc->findSymbolAt(9, 1);
+    QVERIFY(lastVisibleSymbol);
+
+    TypeOfExpression typeOfExpression;
+    typeOfExpression.setSnapshot(snapshot);
+
+    QList<TypeOfExpression::Result> results;
+    QBENCHMARK {
+        results = typeOfExpression(expression, doc, lastVisibleSymbol);
+    }
+    QVERIFY(! results.isEmpty());
+}
+
 QTEST_APPLESS_MAIN(tst_Lookup)
 #include "tst_lookup.moc"
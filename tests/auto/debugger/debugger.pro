@@ -1,5 +1,5 @@
 
 TEMPLATE = subdirs
 
-SUBDIRS = dumpers.pro plugin.pro gdb.pro
+SUBDIRS = dumpers.pro plugin.pro gdb.pro replay.pro replayengine.pro namedemangler.pro
 
@@ -0,0 +1,13 @@
+
+QT -= gui
+QT += testlib
+
+DEBUGGERDIR = ../../../src/plugins/debugger
+
+INCLUDEPATH += $$DEBUGGERDIR
+
+SOURCES += \
+    tst_namedemangler.cpp \
+    $$DEBUGGERDIR/name_demangler.cpp \
+
+TARGET = tst_$$TARGET
@@ -0,0 +1,16 @@
+
+QT -= gui
+QT += testlib
+
+UTILSDIR    = ../../../src/libs
+
+DEBUGGERDIR = ../../../src/plugins/debugger
+
+INCLUDEPATH += $$DEBUGGERDIR $$UTILSDIR
+
+SOURCES += \
+    tst_replay.cpp \
+    $$DEBUGGERDIR/gdb/gdbmi.cpp \
+    $$DEBUGGERDIR/gdb/gdbtranscript.cpp \
+
+TARGET = tst_$$TARGET
@@ -0,0 +1,14 @@
+include(../../../qtcreator.pri)
+include(../../../src/plugins/debugger/debugger.pri)
+
+QT += testlib
+
+DEBUGGERDIR = ../../../src/plugins/debugger
+
+INCLUDEPATH += $$IDE_SOURCE_TREE/src/plugins $$IDE_SOURCE_TREE/src/libs $$DEBUGGERDIR
+LIBS += -L$$IDE_PLUGIN_PATH/Nokia
+
+SOURCES += \
+    tst_replayengine.cpp \
+
+TARGET = tst_$$TARGET
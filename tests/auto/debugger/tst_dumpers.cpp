@@ -145,6 +145,7 @@ private slots:
     void dumpQImageData();
     void dumpQLinkedList();
     void dumpQList_int();
+    void dumpQList_int_paged();
     void dumpQList_int_star();
     void dumpQList_char();
     void dumpQList_QString();
@@ -382,11 +383,14 @@ void tst_Debugger::niceType_data()
 
 static void testDumper(QByteArray expected0, const void *data, QByteArray outertype,
     bool dumpChildren, QByteArray innertype = "", QByteArray exp = "",
-    int extraInt0 = 0, int extraInt1 = 0, int extraInt2 = 0, int extraInt3 = 0)
+    int extraInt0 = 0, int extraInt1 = 0, int extraInt2 = 0, int extraInt3 = 0,
+    int childrenStart = -1, int childrenEnd = -1)
 {
-    sprintf(xDumpInBuffer, "%s%c%s%c%s%c%s%c%s%c",
+    const int n = sprintf(xDumpInBuffer, "%s%c%s%c%s%c%s%c%s%c",
         outertype.data(), 0, "iname", 0, exp.data(), 0,
         innertype.data(), 0, "iname", 0);
+    if (childrenStart >= 0)
+        sprintf(xDumpInBuffer + n, "%d%c%d%c", childrenStart, 0, childrenEnd, 0);
     //qDebug() << "FIXME qDumpObjectData440 signature to use const void *";
     void *res = qDumpObjectData440(2, 42, data, dumpChildren,
         extraInt0, extraInt1, extraInt2, extraInt3);
@@ -426,6 +430,20 @@ QByteArray str(const void *p)
     return buf;
 }
 
+// Mirrors QDumper::putChildrenChecksum() in the dumpers.
+static QByteArray childrenChecksum(const void *base, int size, int begin, int end)
+{
+    const unsigned char *bytes = static_cast<const unsigned char *>(base);
+    unsigned sum = 0;
+    for (int i = begin; i < end; ++i) {
+        unsigned hash = 2166136261u ^ unsigned(i);
+        for (int j = 0; j != size; ++j)
+            hash = (hash ^ bytes[i * size + j]) * 16777619u;
+        sum += hash;
+    }
+    return QByteArray::number(sum);
+}
+
 static const void *deref(const void *p)
 {
     return *reinterpret_cast<const char* const*>(p);
@@ -1400,6 +1418,33 @@ void tst_Debugger::dumpQList_int()
         &ilist, NS"QList", true, "int");
 }
 
+void tst_Debugger::dumpQList_int_paged()
+{
+    QList<int> ilist;
+    for (int i = 0; i != 5; ++i)
+        ilist.append(i);
+    testDumper("value='<5 items>',valueeditable='false',numchild='5',"
+        "datapointer='" + str(&ilist.at(0)) + "',"
+        "childrenchecksum='" + childrenChecksum(&ilist.at(0), sizeof(void*), 2, 4) + "',"
+        "internal='1',childrenstart='2',childtype='int',childnumchild='0',children=["
+        "{addr='" + str(&ilist.at(2)) + "',value='2'},"
+        "{addr='" + str(&ilist.at(3)) + "',value='3'}]",
+        &ilist, NS"QList", true, "int", "", 0, 0, 0, 0, 2, 4);
+    // A window past the end has no children.
+    testDumper("value='<5 items>',valueeditable='false',numchild='5',"
+        "datapointer='" + str(&ilist.at(0)) + "',childrenchecksum='0',"
+        "internal='1',childrenstart='5',children=[]",
+        &ilist, NS"QList", true, "int", "", 0, 0, 0, 0, 7, 9);
+    // Changing a value in place changes the checksum of its window.
+    const QByteArray before = childrenChecksum(&ilist.at(0), sizeof(void*), 2, 4);
+    ilist[3] = 5;
+    QVERIFY(childrenChecksum(&ilist.at(0), sizeof(void*), 2, 4) != before);
+    testDumper("value='<5 items>',valueeditable='false',numchild='5',"
+        "datapointer='" + str(&ilist.at(0)) + "',"
+        "childrenchecksum='" + childrenChecksum(&ilist.at(0), sizeof(void*), 2, 4) + "'",
+        &ilist, NS"QList", false, "int", "", 0, 0, 0, 0, 2, 4);
+}
+
 void tst_Debugger::dumpQList_int_star()
 {
     QList<int *> ilist;
@@ -0,0 +1,237 @@
+/**************************************************************************
+**
+** This file is part of Qt Creator
+**
+** Copyright (c) 2009 Nokia Corporation and/or its subsidiary(-ies).
+**
+** Contact: Nokia Corporation (qt-info@nokia.com)
+**
+** Commercial Usage
+**
+** Licensees holding valid Qt Commercial licenses may use this file in
+** accordance with the Qt Commercial License Agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Nokia.
+**
+** GNU Lesser General Public License Usage
+**
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** If you are unsure which license is appropriate for your use, please
+** contact the sales department at http://qt.nokia.com/contact.
+**
+**************************************************************************/
+
+
+// Measures the throughput of the name demangler on a corpus of symbols as
+// found in a large Qt application, where the same names are demangled
+// over and over.
+
+#include "name_demangler.h"
+
+#include <QtCore/QObject>
+#include <QtCore/QStringList>
+#include <QtTest/QtTest>
+
+using namespace Debugger::Internal;
+
+static const char *qtSymbols[] = {
+    "_ZN7QObject7connectEPKS_PKcS1_S3_N2Qt14ConnectionTypeE",
+    "_ZN7QString6appendERKS_",
+    "_ZNK7QString3argERKS_iRK5QChar",
+    "_ZN10QByteArray6appendEc",
+    "_ZNK10QByteArray7indexOfEPKci",
+    "_ZN9QListData6appendEv",
+    "_ZN7QWidget4showEv",
+    "_ZN7QWidget10setVisibleEb",
+    "_ZN11QMetaObject8activateEP7QObjectiiPPv",
+    "_ZNK7QObject8propertyEPKc",
+    "_ZN12QApplication4execEv",
+    "_ZN14QPlainTextEdit12setPlainTextERK7QString",
+    "_ZN8QVariantC1ERK7QString",
+    "_ZNK8QVariant8toStringEv",
+    "_ZN7QStringD1Ev",
+    "_ZN10QByteArrayD1Ev",
+    "_ZN4QMapI7QString8QVariantE6detachEv",
+    "_ZN5QHashI7QStringiE11deleteNode2EPN9QHashData4NodeE",
+    "_ZN5QListI7QStringE6appendERKS0_",
+    "_ZNK5QListI10QByteArrayE5valueEi",
+    "_ZN7QVectorIiE7reallocEii",
+    "_ZN9QTextEdit6appendERK7QString",
+    "_ZN7QPixmapC1ERK7QStringPKc6QFlagsIN2Qt19ImageConversionFlagEE",
+    "_ZN15QTreeWidgetItem7setDataEiiRK8QVariant",
+    "_ZN6QTimer10singleShotEiP7QObjectPKc",
+    "_ZN6QMutex4lockEv",
+    "_ZN9QFileInfoC1ERK7QString",
+    "_ZNK9QFileInfo16absoluteFilePathEv",
+    "_ZN4Core13EditorManager8instanceEv",
+    "_ZN10TextEditor14BaseTextEditor13keyPressEventEP9QKeyEvent",
+    0
+};
+
+static QString sourceName(const QString &name)
+{
+    return QString::number(name.size()) + name;
+}
+
+// A few thousand distinct symbols, every one of them used several times
+// the way the same functions show up in stacks and symbol lists.
+static QStringList corpus()
+{
+    QStringList distinct;
+    for (int i = 0; qtSymbols[i]; ++i)
+        distinct.append(QLatin1String(qtSymbols[i]));
+    for (int c = 0; c != 100; ++c) {
+        const QString className = sourceName(QString::fromLatin1("Class%1").arg(c));
+        for (int m = 0; m != 20; ++m) {
+            const QString methodName = sourceName(QString::fromLatin1("method%1").arg(m));
+            distinct.append(QLatin1String("_ZN8Debugger8Internal") + className
+                + methodName + QLatin1String("ERK7QStringi"));
+        }
+    }
+
+    QStringList names;
+    for (int round = 0; round != 4; ++round)
+        for (int i = round; i < distinct.size(); i += 1 + round)
+            names.append(distinct.at(i));
+    return names;
+}
+
+class tst_NameDemangler : public QObject
+{
+    Q_OBJECT
+
+public:
+    tst_NameDemangler() {}
+
+private slots:
+    void demangle_data();
+    void demangle();
+    void cache();
+    void batch();
+    void benchmark_single();
+    void benchmark_batch();
+};
+
+void tst_NameDemangler::demangle_data()
+{
+    QTest::addColumn<QString>("mangled");
+    QTest::addColumn<QString>("demangled");
+
+    QTest::newRow("method")
+        << QString::fromLatin1("_ZN7QWidget4showEv")
+        << QString::fromLatin1("QWidget::show()");
+    QTest::newRow("const method")
+        << QString::fromLatin1("_ZNK8QVariant8toStringEv")
+        << QString::fromLatin1("QVariant::toString() const");
+    QTest::newRow("builtin argument")
+        << QString::fromLatin1("_ZN10QByteArray6appendEc")
+        << QString::fromLatin1("QByteArray::append(char)");
+    QTest::newRow("substitution")
+        << QString::fromLatin1("_ZN7QString6appendERKS_")
+        << QString::fromLatin1("QString::append(QString const &)");
+    QTest::newRow("pointers")
+        << QString::fromLatin1("_ZN6QTimer10singleShotEiP7QObjectPKc")
+        << QString::fromLatin1("QTimer::singleShot(int, QObject *, char const *)");
+    QTest::newRow("constructor")
+        << QString::fromLatin1("_ZN9QFileInfoC1ERK7QString")
+        << QString::fromLatin1("QFileInfo::QFileInfo(QString const &)");
+    QTest::newRow("destructor")
+        << QString::fromLatin1("_ZN7QStringD1Ev")
+        << QString::fromLatin1("QString::~QString()");
+    QTest::newRow("namespace")
+        << QString::fromLatin1("_ZN4Core13EditorManager8instanceEv")
+        << QString::fromLatin1("Core::EditorManager::instance()");
+}
+
+void tst_NameDemangler::demangle()
+{
+    QFETCH(QString, mangled);
+    QFETCH(QString, demangled);
+
+    NameDemangler demangler;
+    QVERIFY(demangler.demangle(mangled));
+    QCOMPARE(demangler.demangledName(), demangled);
+    // The same again, this time from the cache.
+    QVERIFY(demangler.demangle(mangled));
+    QCOMPARE(demangler.demangledName(), demangled);
+    QCOMPARE(NameDemangler::demangleAll(QStringList() << mangled),
+        QStringList() << demangled);
+}
+
+void tst_NameDemangler::cache()
+{
+    NameDemangler demangler;
+    // Not used by other tests before, so not cached yet.
+    const QString name = QLatin1String(qtSymbols[0]);
+    const bool ok = demangler.demangle(name);
+    const QString demangled = demangler.demangledName();
+    QCOMPARE(demangler.cacheMisses(), 1);
+    QCOMPARE(demangler.cacheHits(), 0);
+
+    QCOMPARE(demangler.demangle(name), ok);
+    QCOMPARE(demangler.demangledName(), demangled);
+    QCOMPARE(demangler.cacheMisses(), 1);
+    QCOMPARE(demangler.cacheHits(), 1);
+
+    // The cache is shared, so a fresh demangler does not parse again.
+    NameDemangler fresh;
+    QCOMPARE(fresh.demangle(name), ok);
+    QCOMPARE(fresh.demangledName(), demangled);
+    QCOMPARE(fresh.cacheMisses(), 0);
+    QCOMPARE(fresh.cacheHits(), 1);
+}
+
+void tst_NameDemangler::batch()
+{
+    const QStringList names = corpus();
+    const QStringList demangled = NameDemangler::demangleAll(names);
+    QCOMPARE(demangled.size(), names.size());
+
+    NameDemangler demangler;
+    for (int i = 0; i != names.size(); ++i) {
+        const QString expected = demangler.demangle(names.at(i))
+            ? demangler.demangledName() : names.at(i);
+        QCOMPARE(demangled.at(i), expected);
+    }
+}
+
+void tst_NameDemangler::benchmark_single()
+{
+    const QStringList names = corpus();
+    int hits = 0;
+    int misses = 0;
+    QBENCHMARK {
+        NameDemangler demangler;
+        foreach (const QString &name, names)
+            demangler.demangle(name);
+        hits = demangler.cacheHits();
+        misses = demangler.cacheMisses();
+    }
+    QCOMPARE(hits + misses, names.size());
+    qDebug() << names.size() << "names, cache hit rate"
+        << (100 * hits / names.size()) << "%";
+}
+
+void tst_NameDemangler::benchmark_batch()
+{
+    const QStringList names = corpus();
+    QTime timer;
+    int runs = 0;
+    timer.start();
+    QBENCHMARK {
+        NameDemangler::demangleAll(names);
+        ++runs;
+    }
+    const int msecs = qMax(1, timer.elapsed());
+    qDebug() << (qint64(runs) * names.size() * 1000 / msecs) << "names per second";
+}
+
+QTEST_MAIN(tst_NameDemangler)
+
+#include "tst_namedemangler.moc"
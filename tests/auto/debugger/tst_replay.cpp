@@ -0,0 +1,266 @@
+/**************************************************************************
+**
+** This file is part of Qt Creator
+**
+** Copyright (c) 2009 Nokia Corporation and/or its subsidiary(-ies).
+**
+** Contact: Nokia Corporation (qt-info@nokia.com)
+**
+** Commercial Usage
+**
+** Licensees holding valid Qt Commercial licenses may use this file in
+** accordance with the Qt Commercial License Agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Nokia.
+**
+** GNU Lesser General Public License Usage
+**
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** If you are unsure which license is appropriate for your use, please
+** contact the sales department at http://qt.nokia.com/contact.
+**
+**************************************************************************/
+
+
+// Exercises the recorded gdb transcripts used by the replay adapter and
+// measures how fast typical large MI records are parsed. No gdb needed.
+
+#include "gdb/gdbmi.h"
+#include "gdb/gdbtranscript.h"
+
+#include <QtCore/QObject>
+#include <QtTest/QtTest>
+
+using namespace Debugger::Internal;
+
+static QByteArray largeLocals(int count)
+{
+    QByteArray ba = "locals=[";
+    for (int i = 0; i != count; ++i) {
+        if (i)
+            ba += ',';
+        const QByteArray n = QByteArray::number(i);
+        ba += "{name=\"v" + n + "\",type=\"int\",value=\"" + n + "\",numchild=\"0\"}";
+    }
+    ba += ']';
+    return ba;
+}
+
+static QByteArray deepStack(int count)
+{
+    QByteArray ba = "stack=[";
+    for (int i = 0; i != count; ++i) {
+        if (i)
+            ba += ',';
+        const QByteArray n = QByteArray::number(i);
+        ba += "frame={level=\"" + n + "\",addr=\"0x0804" + n.rightJustified(4, '0')
+            + "\",func=\"recurse\",file=\"main.cpp\",fullname=\"/tmp/main.cpp\","
+              "line=\"" + n + "\"}";
+    }
+    ba += ']';
+    return ba;
+}
+
+static QByteArray manyModules(int count)
+{
+    QByteArray ba = "shlib-info=[";
+    for (int i = 0; i != count; ++i) {
+        if (i)
+            ba += ',';
+        const QByteArray n = QByteArray::number(i);
+        ba += "{num=\"" + n + "\",name=\"/usr/lib/libmodule" + n + ".so\","
+              "kind=\"-\",dyld-addr=\"0x1000\",reason=\"dyld\",requested-state=\"Y\","
+              "state=\"Y\",path=\"/usr/lib/libmodule" + n + ".so\"}";
+    }
+    ba += ']';
+    return ba;
+}
+
+// Rough estimate of the heap retained by a parsed record.
+static int retainedSize(const GdbMi &mi)
+{
+    int size = sizeof(GdbMi) + mi.m_name.size() + mi.m_data.size();
+    foreach (const GdbMi &child, mi.children())
+        size += retainedSize(child);
+    return size;
+}
+
+class tst_Replay : public QObject
+{
+    Q_OBJECT
+
+public:
+    tst_Replay() {}
+
+private slots:
+    void transcript_load();
+    void transcript_reply();
+    void transcript_embeddedToken();
+    void transcript_unknownCommand();
+
+    void parse_locals();
+    void parse_stack();
+    void parse_modules();
+    void parse_locals_memory();
+    void replay_stop();
+};
+
+static const char transcriptLog[] =
+    ">~\"GNU gdb 6.8\\n\"\n"
+    "<1show version\n"
+    ">~\"GNU gdb 6.8\\n\"\n"
+    ">1^done\n"
+    "<2-exec-run\n"
+    ">2^running\n"
+    ">*stopped,reason=\"breakpoint-hit\",bkptno=\"1\",thread-id=\"1\"\n"
+    "sSTOPPED\n"
+    "<3-stack-list-frames\n"
+    "<4-stack-list-locals 1\n"
+    ">4^done,locals=[{name=\"i\"}]\n"
+    ">3^done,stack=[frame={level=\"0\"}]\n"
+    "<5call (void*)qDumpObjectData440(2,5+1,&(i),0,0,0,0,0)\n"
+    ">&\"call (void*)qDumpObjectData440(2,5+1,&(i),0,0,0,0,0)\\n\"\n"
+    ">5^done,value=\"0x1\"\n";
+
+void tst_Replay::transcript_load()
+{
+    GdbTranscript transcript;
+    QVERIFY(transcript.load(transcriptLog));
+    QCOMPARE(transcript.size(), 5);
+    QCOMPARE(transcript.initialOutput(), QList<QByteArray>() << "~\"GNU gdb 6.8\\n\"");
+}
+
+void tst_Replay::transcript_reply()
+{
+    GdbTranscript transcript;
+    transcript.load(transcriptLog);
+
+    QCOMPARE(transcript.reply("11show version\r\n"),
+        QList<QByteArray>() << "~\"GNU gdb 6.8\\n\"" << "11^done");
+    QCOMPARE(transcript.reply("12-exec-run"), QList<QByteArray>() << "12^running"
+        << "*stopped,reason=\"breakpoint-hit\",bkptno=\"1\",thread-id=\"1\"");
+    // Out of order.
+    QCOMPARE(transcript.reply("13-stack-list-locals 1"),
+        QList<QByteArray>() << "13^done,locals=[{name=\"i\"}]");
+    QCOMPARE(transcript.reply("14-stack-list-frames"),
+        QList<QByteArray>() << "14^done,stack=[frame={level=\"0\"}]");
+
+    // Replayed exchanges are used up until rewound.
+    QCOMPARE(transcript.reply("15-stack-list-frames"), QList<QByteArray>() << "15^done");
+    transcript.rewind();
+    QCOMPARE(transcript.reply("16-stack-list-frames"),
+        QList<QByteArray>() << "16^done,stack=[frame={level=\"0\"}]");
+}
+
+void tst_Replay::transcript_embeddedToken()
+{
+    GdbTranscript transcript;
+    transcript.load(transcriptLog);
+    const QList<QByteArray> reply =
+        transcript.reply("45call (void*)qDumpObjectData440(2,45+1,&(i),0,0,0,0,0)");
+    QCOMPARE(reply.size(), 2);
+    QCOMPARE(reply.at(1), QByteArray("45^done,value=\"0x1\""));
+}
+
+void tst_Replay::transcript_unknownCommand()
+{
+    GdbTranscript transcript;
+    transcript.load(transcriptLog);
+    QCOMPARE(transcript.reply("7-break-list"), QList<QByteArray>() << "7^done");
+    // Same command, different arguments.
+    QCOMPARE(transcript.reply("8-stack-list-locals 0"), QList<QByteArray>() << "8^done");
+}
+
+void tst_Replay::parse_locals()
+{
+    const QByteArray data = '{' + largeLocals(10000) + '}';
+    GdbMi mi;
+    QBENCHMARK {
+        mi.fromString(data);
+    }
+    QCOMPARE(mi.findChild("locals").childCount(), 10000);
+}
+
+void tst_Replay::parse_stack()
+{
+    const QByteArray data = '{' + deepStack(5000) + '}';
+    GdbMi mi;
+    QBENCHMARK {
+        mi.fromString(data);
+    }
+    QCOMPARE(mi.findChild("stack").childCount(), 5000);
+}
+
+void tst_Replay::parse_modules()
+{
+    const QByteArray data = '{' + manyModules(2000) + '}';
+    GdbMi mi;
+    QBENCHMARK {
+        mi.fromString(data);
+    }
+    QCOMPARE(mi.findChild("shlib-info").childCount(), 2000);
+}
+
+void tst_Replay::parse_locals_memory()
+{
+    const QByteArray data = '{' + largeLocals(10000) + '}';
+    GdbMi mi(data);
+    QCOMPARE(mi.findChild("locals").childCount(), 10000);
+    const int size = retainedSize(mi);
+    qDebug() << data.size() << "bytes of input retain about" << size << "bytes";
+}
+
+void tst_Replay::replay_stop()
+{
+    // A stop followed by the usual requests for stack and locals.
+    QByteArray log;
+    log += "<1-exec-continue\n";
+    log += ">1^running\n";
+    log += ">*stopped,reason=\"end-stepping-range\",thread-id=\"1\"\n";
+    log += "<2-stack-list-frames\n";
+    log += ">2^done," + deepStack(200) + '\n';
+    log += "<3-stack-list-locals 1\n";
+    log += ">3^done," + largeLocals(2000) + '\n';
+    log += "<4-file-list-exec-source-files\n";
+    log += ">4^done," + manyModules(500) + '\n';
+
+    GdbTranscript transcript;
+    QVERIFY(transcript.load(log));
+    QList<QByteArray> commands;
+    commands << "-exec-continue" << "-stack-list-frames"
+        << "-stack-list-locals 1" << "-file-list-exec-source-files";
+
+    int token = 100;
+    int bytes = 0;
+    QBENCHMARK {
+        transcript.rewind();
+        bytes = 0;
+        foreach (const QByteArray &command, commands) {
+            foreach (const QByteArray &line,
+                    transcript.reply(QByteArray::number(++token) + command)) {
+                bytes += line.size();
+                const int pos = line.indexOf(',');
+                if (pos == -1)
+                    continue;
+                GdbMi mi('{' + line.mid(pos + 1) + '}');
+                QVERIFY(mi.isValid());
+            }
+        }
+    }
+    QVERIFY(bytes > log.size() / 2);
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    tst_Replay test;
+    return QTest::qExec(&test, argc, argv);
+}
+
+#include "tst_replay.moc"
@@ -0,0 +1,267 @@
+/**************************************************************************
+**
+** This file is part of Qt Creator
+**
+** Copyright (c) 2009 Nokia Corporation and/or its subsidiary(-ies).
+**
+** Contact: Nokia Corporation (qt-info@nokia.com)
+**
+** Commercial Usage
+**
+** Licensees holding valid Qt Commercial licenses may use this file in
+** accordance with the Qt Commercial License Agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Nokia.
+**
+** GNU Lesser General Public License Usage
+**
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** If you are unsure which license is appropriate for your use, please
+** contact the sales department at http://qt.nokia.com/contact.
+**
+**************************************************************************/
+
+
+// Replays a recorded gdb session through GdbEngine and the replay adapter
+// and measures how long it takes from a stop until the stack and locals
+// views are populated. No gdb needed.
+
+#include "debuggermanager.h"
+#include "debuggeractions.h"
+#include "stackhandler.h"
+#include "watchhandler.h"
+
+#include <utils/savedaction.h>
+
+#include <QtCore/QObject>
+#include <QtCore/QTemporaryFile>
+#include <QtCore/QTime>
+#include <QtTest/QtTest>
+
+using namespace Debugger;
+using namespace Debugger::Internal;
+
+enum { StackDepth = 200, LocalCount = 2000, StopCount = 20, Timeout = 10000 };
+
+static QByteArray frameRecord(int level, const QByteArray &fileName)
+{
+    const QByteArray n = QByteArray::number(level);
+    return "{level=\"" + n + "\",addr=\"0x0804" + n.rightJustified(4, '0')
+        + "\",func=\"recurse\",file=\"replay.cpp\",fullname=\"" + fileName
+        + "\",line=\"" + QByteArray::number(level + 1) + "\"}";
+}
+
+static QByteArray stopRecord(const QByteArray &fileName)
+{
+    return "*stopped,reason=\"breakpoint-hit\",bkptno=\"1\",thread-id=\"1\",frame="
+        + frameRecord(0, fileName);
+}
+
+static QByteArray stackRecord(const QByteArray &fileName)
+{
+    QByteArray ba = "^done,stack=[";
+    for (int i = 0; i != StackDepth; ++i) {
+        if (i)
+            ba += ',';
+        ba += "frame=" + frameRecord(i, fileName);
+    }
+    ba += ']';
+    return ba;
+}
+
+static QByteArray localsRecord()
+{
+    QByteArray ba = "^done,locals=[";
+    for (int i = 0; i != LocalCount; ++i) {
+        if (i)
+            ba += ',';
+        const QByteArray n = QByteArray::number(i);
+        ba += "{name=\"v" + n + "\",type=\"int\",value=\"" + n + "\",numchild=\"0\"}";
+    }
+    ba += ']';
+    return ba;
+}
+
+// A session that runs to a breakpoint and then continues StopCount
+// times, each stop being followed by the requests for stack and locals.
+static QByteArray transcript(const QByteArray &fileName)
+{
+    QByteArray log;
+    log += ">~\"GNU gdb 6.8\\n\"\n";
+    log += "<1show version\n";
+    log += ">~\"GNU gdb 6.8\\n\"\n";
+    log += ">1^done\n";
+    // Answering this one with the default "^done" would make
+    // the engine use the synchronous 'bb' code path.
+    log += "<2-interpreter-exec console \"help bb\"\n";
+    log += ">2^error,msg=\"Undefined command: \\\"bb\\\".  Try \\\"help\\\".\"\n";
+    log += "<3-exec-run\n";
+    log += ">3^running\n";
+    log += '>' + stopRecord(fileName) + '\n';
+
+    const QByteArray stack = stackRecord(fileName);
+    const QByteArray locals = localsRecord();
+    int token = 4;
+    for (int i = 0; i != StopCount + 1; ++i) {
+        if (i) {
+            log += '<' + QByteArray::number(token) + "-exec-continue\n";
+            log += '>' + QByteArray::number(token) + "^running\n";
+            log += '>' + stopRecord(fileName) + '\n';
+            ++token;
+        }
+        log += '<' + QByteArray::number(token) + "-stack-list-frames 0 "
+            + QByteArray::number(int(StackDepth)) + '\n';
+        log += '>' + QByteArray::number(token) + stack + '\n';
+        ++token;
+        log += '<' + QByteArray::number(token) + "-stack-list-arguments 2 0 0\n";
+        log += '>' + QByteArray::number(token)
+            + "^done,stack-args=[frame={level=\"0\",args=[{name=\"depth\","
+              "type=\"int\",value=\"0\",numchild=\"0\"}]}]\n";
+        ++token;
+        log += '<' + QByteArray::number(token) + "-stack-list-locals 2\n";
+        log += '>' + QByteArray::number(token) + locals + '\n';
+        ++token;
+    }
+    return log;
+}
+
+class tst_ReplayEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    tst_ReplayEngine() : m_manager(0), m_stopsHandled(0), m_msecsHandling(0) {}
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void stopPopulatesViews();
+    void stopToViews();
+
+public slots:
+    void showOutput(int channel, const QString &msg);
+
+private:
+    bool waitForStop();
+    int stackSize() const;
+    int localsCount() const;
+
+    QTemporaryFile m_source;
+    QTemporaryFile m_transcript;
+    DebuggerManager *m_manager;
+    int m_stopsHandled;
+    int m_msecsHandling;
+};
+
+void tst_ReplayEngine::initTestCase()
+{
+    // Frames need a readable file, otherwise the engine would
+    // ask for disassembly.
+    QVERIFY(m_source.open());
+    m_source.write("int main() {}\n");
+    m_source.flush();
+    QVERIFY(m_transcript.open());
+    m_transcript.write(transcript(QFile::encodeName(m_source.fileName())));
+    m_transcript.flush();
+
+    theDebuggerAction(UseDebuggingHelpers)->setValue(false);
+    theDebuggerAction(UseCodeModel)->setValue(false);
+    theDebuggerAction(SkipKnownFrames)->setValue(false);
+    theDebuggerAction(MaximalStackDepth)->setValue(int(StackDepth));
+
+    m_manager = new DebuggerManager;
+    qDeleteAll(m_manager->initializeEngines(GdbEngineType));
+    connect(m_manager, SIGNAL(emitShowOutput(int,QString)),
+        this, SLOT(showOutput(int,QString)));
+
+    DebuggerStartParametersPtr sp(new DebuggerStartParameters);
+    sp->executable = QLatin1String("replay");
+    sp->startMode = StartInternal;
+    sp->replayTranscript = m_transcript.fileName();
+    m_manager->startNewDebugger(sp);
+    QVERIFY(waitForStop());
+    QCOMPARE(m_manager->state(), InferiorStopped);
+}
+
+void tst_ReplayEngine::cleanupTestCase()
+{
+    if (!m_manager)
+        return;
+    m_manager->exitDebugger();
+    QTime timer;
+    timer.start();
+    while (m_manager->state() != DebuggerNotReady && timer.elapsed() < Timeout)
+        QCoreApplication::processEvents();
+    delete m_manager;
+    m_manager = 0;
+}
+
+void tst_ReplayEngine::showOutput(int channel, const QString &msg)
+{
+    Q_UNUSED(channel)
+    // Written by the replay adapter once all commands
+    // triggered by a stop have been answered.
+    static const QRegExp re(QLatin1String("REPLAY: STOP HANDLED IN (\\d+) MS"));
+    if (re.indexIn(msg) == -1)
+        return;
+    ++m_stopsHandled;
+    m_msecsHandling += re.cap(1).toInt();
+}
+
+bool tst_ReplayEngine::waitForStop()
+{
+    const int stops = m_stopsHandled;
+    QTime timer;
+    timer.start();
+    while (m_stopsHandled == stops && timer.elapsed() < Timeout)
+        QCoreApplication::processEvents();
+    return m_stopsHandled != stops;
+}
+
+int tst_ReplayEngine::stackSize() const
+{
+    return m_manager->stackHandler()->stackSize();
+}
+
+int tst_ReplayEngine::localsCount() const
+{
+    const QAbstractItemModel *model = m_manager->watchHandler()->model(LocalsWatch);
+    return model->rowCount(QModelIndex());
+}
+
+void tst_ReplayEngine::stopPopulatesViews()
+{
+    QCOMPARE(stackSize(), int(StackDepth));
+    QCOMPARE(m_manager->stackHandler()->currentIndex(), 0);
+    // The argument shows up among the locals.
+    QCOMPARE(localsCount(), LocalCount + 1);
+}
+
+void tst_ReplayEngine::stopToViews()
+{
+    const int stops = m_stopsHandled;
+    const int msecs = m_msecsHandling;
+    QBENCHMARK_ONCE {
+        for (int i = 0; i != StopCount; ++i) {
+            QCOMPARE(m_manager->state(), InferiorStopped);
+            m_manager->continueExec();
+            QVERIFY(waitForStop());
+        }
+    }
+    QCOMPARE(m_stopsHandled - stops, int(StopCount));
+    QCOMPARE(stackSize(), int(StackDepth));
+    QCOMPARE(localsCount(), LocalCount + 1);
+    qDebug() << StopCount << "stops with" << StackDepth << "frames and" << LocalCount
+        << "locals handled in" << m_msecsHandling - msecs << "ms";
+}
+
+QTEST_MAIN(tst_ReplayEngine)
+
+#include "tst_replayengine.moc"
@@ -0,0 +1,23 @@
+include(../../../qtcreator.pri)
+include(../../../src/plugins/coreplugin/coreplugin.pri)
+
+QT += testlib
+
+PROJECTEXPLORERDIR = ../../../src/plugins/projectexplorer
+
+DEFINES += PROJECTEXPLORER_LIBRARY
+
+INCLUDEPATH += $$IDE_SOURCE_TREE/src/plugins $$PROJECTEXPLORERDIR
+LIBS += -L$$IDE_PLUGIN_PATH/Nokia
+
+SOURCES += \
+    tst_flatmodel.cpp \
+    $$PROJECTEXPLORERDIR/projectmodels.cpp \
+    $$PROJECTEXPLORERDIR/projectnodes.cpp \
+    $$PROJECTEXPLORERDIR/nodesvisitor.cpp
+
+HEADERS += \
+    $$PROJECTEXPLORERDIR/projectmodels.h \
+    $$PROJECTEXPLORERDIR/projectnodes.h
+
+TARGET = tst_$$TARGET
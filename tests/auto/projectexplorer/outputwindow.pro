@@ -0,0 +1,18 @@
+include(../../../qtcreator.pri)
+include(../../../src/plugins/projectexplorer/projectexplorer.pri)
+
+QT += testlib
+
+PROJECTEXPLORERDIR = ../../../src/plugins/projectexplorer
+
+INCLUDEPATH += $$IDE_SOURCE_TREE/src/plugins $$PROJECTEXPLORERDIR
+LIBS += -L$$IDE_PLUGIN_PATH/Nokia
+
+SOURCES += \
+    tst_outputwindow.cpp \
+    $$PROJECTEXPLORERDIR/outputwindow.cpp
+
+HEADERS += \
+    $$PROJECTEXPLORERDIR/outputwindow.h
+
+TARGET = tst_$$TARGET
@@ -0,0 +1,218 @@
+/**************************************************************************
+**
+** This file is part of Qt Creator
+**
+** Copyright (c) 2009 Nokia Corporation and/or its subsidiary(-ies).
+**
+** Contact: Nokia Corporation (qt-info@nokia.com)
+**
+** Commercial Usage
+**
+** Licensees holding valid Qt Commercial licenses may use this file in
+** accordance with the Qt Commercial License Agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Nokia.
+**
+** GNU Lesser General Public License Usage
+**
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** If you are unsure which license is appropriate for your use, please
+** contact the sales department at http://qt.nokia.com/contact.
+**
+**************************************************************************/
+
+
+// Checks the row bookkeeping of the flat project model and measures it on
+// a project with 100k files in one folder.
+
+#include "projectmodels.h"
+#include "projectnodes.h"
+
+#include <QtCore/QObject>
+#include <QtTest/QtTest>
+
+using namespace ProjectExplorer;
+using namespace ProjectExplorer::Internal;
+
+class TestProjectNode : public ProjectNode
+{
+public:
+    TestProjectNode(const QString &path) : ProjectNode(path) {}
+
+    bool hasTargets() const { return true; }
+    QList<ProjectAction> supportedActions() const { return QList<ProjectAction>(); }
+    bool addSubProjects(const QStringList &) { return false; }
+    bool removeSubProjects(const QStringList &) { return false; }
+    bool addFiles(const FileType, const QStringList &, QStringList *) { return false; }
+    bool removeFiles(const FileType, const QStringList &, QStringList *) { return false; }
+    bool renameFile(const FileType, const QString &, const QString &) { return false; }
+
+    using ProjectNode::addFileNodes;
+    using ProjectNode::removeFileNodes;
+};
+
+class TestSessionNode : public SessionNode
+{
+public:
+    TestSessionNode() : SessionNode(QLatin1String("/session.qws"), 0) {}
+
+    using SessionNode::addProjectNodes;
+};
+
+class tst_FlatModel : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void rows();
+    void addAndRemove();
+
+    void benchmarkPopulate();
+    void benchmarkIndexForNode();
+    void benchmarkAddFiles();
+    void benchmarkRemoveFiles();
+
+private:
+    QList<FileNode *> createFiles(int first, int count, int step = 1) const;
+    QModelIndex projectIndex() const;
+    void checkRows() const;
+
+    TestSessionNode *m_session;
+    TestProjectNode *m_project;
+    FlatModel *m_model;
+};
+
+QList<FileNode *> tst_FlatModel::createFiles(int first, int count, int step) const
+{
+    QList<FileNode *> files;
+    for (int i = 0; i < count; ++i) {
+        const QString path = QString::fromLatin1("/project/file%1.cpp")
+                .arg(first + i * step, 6, 10, QLatin1Char('0'));
+        files.append(new FileNode(path, SourceType, false));
+    }
+    return files;
+}
+
+QModelIndex tst_FlatModel::projectIndex() const
+{
+    const QModelIndex index = m_model->index(0, 0, m_model->index(0, 0));
+    m_model->hasChildren(index); // Makes the model fetch the files
+    return index;
+}
+
+void tst_FlatModel::checkRows() const
+{
+    const QModelIndex parent = projectIndex();
+    QCOMPARE(m_model->rowCount(parent), m_project->fileNodes().size());
+    QString lastName;
+    for (int row = 0; row < m_model->rowCount(parent); ++row) {
+        const QModelIndex index = m_model->index(row, 0, parent);
+        Node *node = m_model->nodeForIndex(index);
+        QVERIFY(node);
+        QCOMPARE(m_model->parent(index), parent);
+        QCOMPARE(m_model->indexForNode(node), index);
+        QVERIFY(lastName < node->path());
+        lastName = node->path();
+    }
+}
+
+void tst_FlatModel::init()
+{
+    m_session = new TestSessionNode;
+    m_model = new FlatModel(m_session, 0);
+    m_project = new TestProjectNode(QLatin1String("/project/project.pro"));
+    m_session->addProjectNodes(QList<ProjectNode *>() << m_project);
+}
+
+void tst_FlatModel::cleanup()
+{
+    delete m_model;
+    delete m_session;
+    m_model = 0;
+    m_session = 0;
+    m_project = 0;
+}
+
+void tst_FlatModel::rows()
+{
+    m_project->addFileNodes(createFiles(0, 1000), m_project);
+    checkRows();
+}
+
+void tst_FlatModel::addAndRemove()
+{
+    m_project->addFileNodes(createFiles(0, 500, 2), m_project);
+    checkRows();
+
+    // Interleaved with the existing files, so that there are many runs
+    m_project->addFileNodes(createFiles(1, 100, 4), m_project);
+    checkRows();
+
+    QList<FileNode *> stale;
+    const QList<FileNode *> files = m_project->fileNodes();
+    for (int i = 0; i < files.size(); i += 3)
+        stale.append(files.at(i));
+    m_project->removeFileNodes(stale, m_project);
+    checkRows();
+}
+
+void tst_FlatModel::benchmarkPopulate()
+{
+    m_project->addFileNodes(createFiles(0, 100000), m_project);
+    QBENCHMARK {
+        m_model->reset();
+        const QModelIndex parent = projectIndex();
+        const int rows = m_model->rowCount(parent);
+        for (int row = 0; row < rows; ++row)
+            m_model->parent(m_model->index(row, 0, parent));
+    }
+}
+
+void tst_FlatModel::benchmarkIndexForNode()
+{
+    m_project->addFileNodes(createFiles(0, 100000), m_project);
+    projectIndex();
+    const QList<FileNode *> files = m_project->fileNodes();
+    QBENCHMARK {
+        foreach (FileNode *file, files)
+            m_model->indexForNode(file);
+    }
+}
+
+void tst_FlatModel::benchmarkAddFiles()
+{
+    m_project->addFileNodes(createFiles(0, 100000, 2), m_project);
+    projectIndex();
+    const QList<FileNode *> files = createFiles(1, 1000, 100);
+    QBENCHMARK_ONCE {
+        m_project->addFileNodes(files, m_project);
+    }
+    QCOMPARE(m_model->rowCount(projectIndex()), 101000);
+}
+
+void tst_FlatModel::benchmarkRemoveFiles()
+{
+    m_project->addFileNodes(createFiles(0, 100000), m_project);
+    projectIndex();
+    QList<FileNode *> stale;
+    const QList<FileNode *> files = m_project->fileNodes();
+    for (int i = 0; i < files.size(); i += 100)
+        stale.append(files.at(i));
+    QBENCHMARK_ONCE {
+        m_project->removeFileNodes(stale, m_project);
+    }
+    QCOMPARE(m_model->rowCount(projectIndex()), 99000);
+}
+
+QTEST_MAIN(tst_FlatModel)
+
+#include "tst_flatmodel.moc"
@@ -0,0 +1,153 @@
+/**************************************************************************
+**
+** This file is part of Qt Creator
+**
+** Copyright (c) 2009 Nokia Corporation and/or its subsidiary(-ies).
+**
+** Contact: Nokia Corporation (qt-info@nokia.com)
+**
+** Commercial Usage
+**
+** Licensees holding valid Qt Commercial licenses may use this file in
+** accordance with the Qt Commercial License Agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Nokia.
+**
+** GNU Lesser General Public License Usage
+**
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** If you are unsure which license is appropriate for your use, please
+** contact the sales department at http://qt.nokia.com/contact.
+**
+**************************************************************************/
+
+
+// Checks the bounded, batched application output window and measures how
+// many lines per second it sustains while the event loop keeps running.
+
+#include "outputwindow.h"
+
+#include <QtCore/QObject>
+#include <QtCore/QTime>
+#include <QtGui/QTextDocument>
+#include <QtTest/QtTest>
+
+using namespace ProjectExplorer::Internal;
+
+class tst_OutputWindow : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void appendLines();
+    void boundedLines();
+
+    void appendThroughput_data();
+    void appendThroughput();
+    void sustainedThroughput();
+};
+
+static QString makeChunk(int lines)
+{
+    QString chunk;
+    for (int i = 0; i < lines; ++i)
+        chunk += QString::fromLatin1("line %1: the quick brown fox jumps over the lazy dog\n").arg(i);
+    return chunk;
+}
+
+void tst_OutputWindow::appendLines()
+{
+    OutputWindow window;
+    window.appendOutput(QLatin1String("first\n"));
+    window.appendOutputInline(QLatin1String("second "));
+    window.appendOutputInline(QLatin1String("part\n"));
+    window.appendOutputInline(QLatin1String("third"));
+    window.flushQueuedOutput();
+
+    QCOMPARE(window.toPlainText(), QString::fromLatin1("first\nsecond part\nthird"));
+}
+
+void tst_OutputWindow::boundedLines()
+{
+    OutputWindow window;
+    const int maximum = window.maximumBlockCount();
+    QVERIFY(maximum > 0);
+
+    // One batch larger than the buffer, then a few more small ones
+    window.appendOutputInline(makeChunk(maximum + 100));
+    window.flushQueuedOutput();
+    QCOMPARE(window.document()->blockCount(), maximum);
+    for (int i = 0; i < 10; ++i)
+        window.appendOutput(QLatin1String("tail"));
+    window.flushQueuedOutput();
+    QCOMPARE(window.document()->blockCount(), maximum);
+    QVERIFY(window.toPlainText().endsWith(QLatin1String("tail\ntail")));
+}
+
+void tst_OutputWindow::appendThroughput_data()
+{
+    QTest::addColumn<int>("linesPerCall");
+    QTest::newRow("1 line per call") << 1;
+    QTest::newRow("100 lines per call") << 100;
+}
+
+void tst_OutputWindow::appendThroughput()
+{
+    QFETCH(int, linesPerCall);
+    const int totalLines = 200000;
+    const QString chunk = makeChunk(linesPerCall);
+
+    OutputWindow window;
+    window.resize(800, 600);
+    window.show();
+    QApplication::processEvents();
+
+    QBENCHMARK {
+        for (int lines = 0; lines < totalLines; lines += linesPerCall)
+            window.appendOutputInline(chunk);
+        window.flushQueuedOutput();
+        QApplication::processEvents();
+    }
+}
+
+// Feeds output the way a chatty process does, one read per event loop
+// iteration, and reports the sustained rate and the longest iteration.
+void tst_OutputWindow::sustainedThroughput()
+{
+    const int totalLines = 500000;
+    const int linesPerRead = 50;
+    const QString chunk = makeChunk(linesPerRead);
+
+    OutputWindow window;
+    window.resize(800, 600);
+    window.show();
+    QApplication::processEvents();
+
+    int longestIteration = 0;
+    QTime total;
+    total.start();
+    QTime iteration;
+    for (int lines = 0; lines < totalLines; lines += linesPerRead) {
+        iteration.start();
+        window.appendOutputInline(chunk);
+        QApplication::processEvents();
+        longestIteration = qMax(longestIteration, iteration.elapsed());
+    }
+    window.flushQueuedOutput();
+    QApplication::processEvents();
+    const int elapsed = qMax(total.elapsed(), 1);
+
+    qDebug("%d lines in %d ms: %d lines/s, longest event loop iteration %d ms",
+           totalLines, elapsed, int(qint64(totalLines) * 1000 / elapsed), longestIteration);
+    QVERIFY(window.document()->blockCount() <= window.maximumBlockCount());
+}
+
+QTEST_MAIN(tst_OutputWindow)
+
+#include "tst_outputwindow.moc"
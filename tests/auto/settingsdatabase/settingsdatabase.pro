@@ -0,0 +1,16 @@
+CONFIG += qtestlib
+TEMPLATE = app
+CONFIG -= app_bundle
+QT += sql
+DEFINES += CORE_LIBRARY
+
+COREPLUGIN_PATH = ../../../src/plugins/coreplugin
+
+INCLUDEPATH += $$COREPLUGIN_PATH
+# Input
+SOURCES += tst_settingsdatabase.cpp \
+    $$COREPLUGIN_PATH/settingsdatabase.cpp
+HEADERS += $$COREPLUGIN_PATH/settingsdatabase.h \
+    $$COREPLUGIN_PATH/core_global.h
+
+TARGET=tst_$$TARGET
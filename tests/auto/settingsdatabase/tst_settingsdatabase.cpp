@@ -0,0 +1,151 @@
+/**************************************************************************
+**
+** This file is part of Qt Creator
+**
+** Copyright (c) 2009 Nokia Corporation and/or its subsidiary(-ies).
+**
+** Contact: Nokia Corporation (qt-info@nokia.com)
+**
+** Commercial Usage
+**
+** Licensees holding valid Qt Commercial licenses may use this file in
+** accordance with the Qt Commercial License Agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Nokia.
+**
+** GNU Lesser General Public License Usage
+**
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** If you are unsure which license is appropriate for your use, please
+** contact the sales department at http://qt.nokia.com/contact.
+**
+**************************************************************************/
+
+#include <settingsdatabase.h>
+
+#include <QtCore/QDir>
+#include <QtTest/QtTest>
+
+using Core::SettingsDatabase;
+
+class tst_SettingsDatabase : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void persistence();
+    void removeGroup();
+    void childKeys();
+    void writeThroughput_data();
+    void writeThroughput();
+
+private:
+    QString m_path;
+};
+
+static const char application[] = "tst_settingsdatabase";
+
+void tst_SettingsDatabase::init()
+{
+    m_path = QDir::tempPath() + QLatin1String("/tst_settingsdatabase");
+    QDir().mkpath(m_path);
+    QFile::remove(m_path + QLatin1Char('/') + QLatin1String(application) + QLatin1String(".db"));
+}
+
+void tst_SettingsDatabase::cleanup()
+{
+    QFile::remove(m_path + QLatin1Char('/') + QLatin1String(application) + QLatin1String(".db"));
+}
+
+void tst_SettingsDatabase::persistence()
+{
+    {
+        SettingsDatabase db(m_path, QLatin1String(application));
+        db.setValue(QLatin1String("a/b"), 1);
+        db.setValue(QLatin1String("a/c"), QLatin1String("text"));
+        db.remove(QLatin1String("a/c"));
+        db.setValue(QLatin1String("a/c"), 3);
+        // Written on destruction
+    }
+
+    SettingsDatabase db(m_path, QLatin1String(application));
+    QCOMPARE(db.value(QLatin1String("a/b")).toInt(), 1);
+    QCOMPARE(db.value(QLatin1String("a/c")).toInt(), 3);
+    QVERIFY(!db.contains(QLatin1String("a/d")));
+    QCOMPARE(db.value(QLatin1String("a/d"), 42).toInt(), 42);
+    QVERIFY(!db.contains(QLatin1String("a/d")));
+}
+
+void tst_SettingsDatabase::removeGroup()
+{
+    {
+        SettingsDatabase db(m_path, QLatin1String(application));
+        db.setValue(QLatin1String("group/x"), 1);
+        db.setValue(QLatin1String("group/sub/y"), 2);
+        db.setValue(QLatin1String("group-other"), 3);
+        db.setValue(QLatin1String("groupie"), 4);
+        db.sync();
+        db.remove(QLatin1String("group"));
+        QVERIFY(!db.contains(QLatin1String("group/x")));
+        QVERIFY(!db.contains(QLatin1String("group/sub/y")));
+        QVERIFY(db.contains(QLatin1String("group-other")));
+        QVERIFY(db.contains(QLatin1String("groupie")));
+    }
+
+    SettingsDatabase db(m_path, QLatin1String(application));
+    QVERIFY(!db.contains(QLatin1String("group/x")));
+    QVERIFY(!db.contains(QLatin1String("group/sub/y")));
+    QCOMPARE(db.value(QLatin1String("group-other")).toInt(), 3);
+    QCOMPARE(db.value(QLatin1String("groupie")).toInt(), 4);
+}
+
+void tst_SettingsDatabase::childKeys()
+{
+    SettingsDatabase db(m_path, QLatin1String(application));
+    db.setValue(QLatin1String("g/a"), 1);
+    db.setValue(QLatin1String("g/sub"), 2);
+    db.setValue(QLatin1String("g/sub/x"), 3);
+    db.setValue(QLatin1String("g/sub-a"), 4);
+    db.setValue(QLatin1String("g/z"), 5);
+    db.setValue(QLatin1String("gz"), 6);
+
+    db.beginGroup(QLatin1String("g"));
+    QCOMPARE(db.childKeys(), QStringList() << QLatin1String("a") << QLatin1String("sub")
+             << QLatin1String("sub-a") << QLatin1String("z"));
+    db.endGroup();
+}
+
+void tst_SettingsDatabase::writeThroughput_data()
+{
+    QTest::addColumn<int>("keyCount");
+
+    QTest::newRow("100") << 100;
+    QTest::newRow("1000") << 1000;
+}
+
+void tst_SettingsDatabase::writeThroughput()
+{
+    QFETCH(int, keyCount);
+
+    SettingsDatabase db(m_path, QLatin1String(application));
+    db.beginGroup(QLatin1String("benchmark"));
+    QBENCHMARK {
+        for (int i = 0; i < keyCount; ++i)
+            db.setValue(QString::number(i), QByteArray(64, 'x'));
+        db.sync();
+    }
+    db.endGroup();
+}
+
+QTEST_MAIN(tst_SettingsDatabase)
+
+#include "tst_settingsdatabase.moc"